@@ -0,0 +1 @@
+#include "/root/repo/src/bridge/model/bridge-channel.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/bridge/helper/bridge-helper.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/core/helper/csv-reader.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/traffic-control/model/fifo-queue-disc.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/applications/model/flow-schedule-generator.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/applications/helper/flow-schedule-helper.h"
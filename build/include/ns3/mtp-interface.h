@@ -0,0 +1 @@
+#include "/root/repo/src/mtp/model/mtp-interface.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/internet/model/udp-l4-protocol.h"
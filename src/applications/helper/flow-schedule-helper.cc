@@ -0,0 +1,79 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-schedule-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/flow-schedule-application.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4.h"
+#include "ns3/string.h"
+
+#include <memory>
+
+namespace ns3
+{
+
+FlowScheduleHelper::FlowScheduleHelper(std::string protocol, uint16_t port)
+    : m_port(port)
+{
+    m_factory.SetTypeId("ns3::FlowScheduleApplication");
+    m_factory.Set("Protocol", StringValue(protocol));
+}
+
+void
+FlowScheduleHelper::SetAttribute(std::string name, const AttributeValue& value)
+{
+    m_factory.Set(name, value);
+}
+
+ApplicationContainer
+FlowScheduleHelper::Install(NodeContainer hosts, Ptr<const FlowSchedule> schedule) const
+{
+    std::vector<Address> addresses;
+    addresses.reserve(hosts.GetN());
+    for (auto i = hosts.Begin(); i != hosts.End(); ++i)
+    {
+        Ptr<Ipv4> ipv4 = (*i)->GetObject<Ipv4>();
+        NS_ABORT_MSG_IF(!ipv4 || ipv4->GetNInterfaces() < 2,
+                        "Host " << (*i)->GetId() << " has no Ipv4 address");
+        addresses.emplace_back(InetSocketAddress(ipv4->GetAddress(1, 0).GetLocal(), m_port));
+    }
+    return Install(hosts, schedule, addresses);
+}
+
+ApplicationContainer
+FlowScheduleHelper::Install(NodeContainer hosts,
+                            Ptr<const FlowSchedule> schedule,
+                            const std::vector<Address>& addresses) const
+{
+    NS_ABORT_MSG_IF(addresses.size() != hosts.GetN(), "One address per host is needed");
+    NS_ABORT_MSG_IF(schedule->GetNSources() > hosts.GetN(),
+                    "The schedule has " << schedule->GetNSources() << " sources for "
+                                        << hosts.GetN() << " hosts");
+    auto peers = std::make_shared<const std::vector<Address>>(addresses);
+
+    ApplicationContainer apps;
+    for (uint32_t i = 0; i < hosts.GetN(); i++)
+    {
+        Ptr<FlowScheduleApplication> app = m_factory.Create<FlowScheduleApplication>();
+        app->SetSchedule(schedule, i, peers);
+        hosts.Get(i)->AddApplication(app);
+        apps.Add(app);
+    }
+    return apps;
+}
+
+} // namespace ns3
@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_SCHEDULE_HELPER_H
+#define FLOW_SCHEDULE_HELPER_H
+
+#include "ns3/address.h"
+#include "ns3/application-container.h"
+#include "ns3/attribute.h"
+#include "ns3/flow-schedule.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup flowschedule
+ * \brief A helper to make it easier to instantiate an
+ * ns3::FlowScheduleApplication on each host of a FlowSchedule.
+ */
+class FlowScheduleHelper
+{
+  public:
+    /**
+     * Create a FlowScheduleHelper to make it easier to work with
+     * FlowScheduleApplications
+     *
+     * \param protocol the name of the protocol to use to send traffic
+     *        by the applications. This string identifies the socket
+     *        factory type used to create sockets for the applications.
+     *        A typical value would be ns3::TcpSocketFactory.
+     * \param port the port on which the hosts accept the flows.
+     */
+    FlowScheduleHelper(std::string protocol, uint16_t port);
+
+    /**
+     * Helper function used to set the underlying application attributes,
+     * _not_ the socket attributes.
+     *
+     * \param name the name of the application attribute to set
+     * \param value the value of the application attribute to set
+     */
+    void SetAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * Install an ns3::FlowScheduleApplication on each host, the i-th host
+     * starting the flows of source i of the schedule.  The flows to host i
+     * are sent to the address of its first Ipv4 interface after the
+     * loopback.
+     *
+     * \param hosts The hosts, in the order of the schedule.
+     * \param schedule The schedule, shared by the applications.
+     * \returns Container of Ptr to the applications installed.
+     */
+    ApplicationContainer Install(NodeContainer hosts, Ptr<const FlowSchedule> schedule) const;
+
+    /**
+     * Install an ns3::FlowScheduleApplication on each host, the i-th host
+     * starting the flows of source i of the schedule.
+     *
+     * \param hosts The hosts, in the order of the schedule.
+     * \param schedule The schedule, shared by the applications.
+     * \param addresses The socket addresses of the hosts, in the same order.
+     * \returns Container of Ptr to the applications installed.
+     */
+    ApplicationContainer Install(NodeContainer hosts,
+                                 Ptr<const FlowSchedule> schedule,
+                                 const std::vector<Address>& addresses) const;
+
+  private:
+    ObjectFactory m_factory; //!< Object factory.
+    uint16_t m_port;         //!< Port of the hosts
+};
+
+} // namespace ns3
+
+#endif /* FLOW_SCHEDULE_HELPER_H */
@@ -0,0 +1,404 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-schedule-application.h"
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowScheduleApplication");
+
+NS_OBJECT_ENSURE_REGISTERED(FlowScheduleApplication);
+
+TypeId
+FlowScheduleApplication::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FlowScheduleApplication")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<FlowScheduleApplication>()
+            .AddAttribute("SendSize",
+                          "The amount of data to send each time.",
+                          UintegerValue(512),
+                          MakeUintegerAccessor(&FlowScheduleApplication::m_sendSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxIdleConnections",
+                          "The maximum number of idle connections kept open for the next "
+                          "flows. The value zero closes each connection once its flows "
+                          "are acknowledged.",
+                          UintegerValue(16),
+                          MakeUintegerAccessor(&FlowScheduleApplication::m_maxIdle),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Protocol",
+                          "The type of protocol to use.",
+                          TypeIdValue(TcpSocketFactory::GetTypeId()),
+                          MakeTypeIdAccessor(&FlowScheduleApplication::m_tid),
+                          MakeTypeIdChecker())
+            .AddTraceSource("Tx",
+                            "A new packet is sent",
+                            MakeTraceSourceAccessor(&FlowScheduleApplication::m_txTrace),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("FlowStart",
+                            "A flow is started",
+                            MakeTraceSourceAccessor(&FlowScheduleApplication::m_flowStartTrace),
+                            "ns3::FlowScheduleApplication::FlowTracedCallback");
+    return tid;
+}
+
+FlowScheduleApplication::FlowScheduleApplication()
+    : m_source(0),
+      m_nextFlow(0),
+      m_nIdle(0),
+      m_flowsStarted(0),
+      m_connectionsOpened(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FlowScheduleApplication::~FlowScheduleApplication()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FlowScheduleApplication::SetSchedule(Ptr<const FlowSchedule> schedule,
+                                     uint32_t source,
+                                     std::shared_ptr<const std::vector<Address>> peers)
+{
+    NS_LOG_FUNCTION(this << schedule << source);
+    m_schedule = schedule;
+    m_source = source;
+    m_peers = peers;
+    m_nextFlow = 0;
+}
+
+uint64_t
+FlowScheduleApplication::GetFlowsStarted() const
+{
+    return m_flowsStarted;
+}
+
+uint64_t
+FlowScheduleApplication::GetConnectionsOpened() const
+{
+    return m_connectionsOpened;
+}
+
+void
+FlowScheduleApplication::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_startEvent.Cancel();
+    m_connections.clear();
+    m_connectionIds.clear();
+    m_idle.clear();
+    m_schedule = nullptr;
+    m_peers = nullptr;
+    // chain up
+    Application::DoDispose();
+}
+
+// Application Methods
+void
+FlowScheduleApplication::StartApplication() // Called at time specified by Start
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(!m_schedule || !m_peers, "No flow schedule set");
+    ScheduleNextFlow();
+}
+
+void
+FlowScheduleApplication::StopApplication() // Called at time specified by Stop
+{
+    NS_LOG_FUNCTION(this);
+
+    m_startEvent.Cancel();
+    // closed in the order they were opened, as the segments sent depend on it
+    for (auto& [id, connection] : m_connections)
+    {
+        Ptr<Socket> socket = connection.socket;
+        socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+        socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket>>(),
+                                  MakeNullCallback<void, Ptr<Socket>>());
+        socket->Close();
+    }
+    m_connections.clear();
+    m_connectionIds.clear();
+    m_idle.clear();
+    m_nIdle = 0;
+}
+
+// Private helpers
+
+void
+FlowScheduleApplication::ScheduleNextFlow()
+{
+    const auto& flows = m_schedule->GetFlows(m_source);
+    if (m_nextFlow < flows.size())
+    {
+        Time start = Max(TimeStep(flows[m_nextFlow].start), Simulator::Now());
+        m_startEvent = Simulator::Schedule(start - Simulator::Now(),
+                                           &FlowScheduleApplication::StartFlows,
+                                           this);
+    }
+}
+
+void
+FlowScheduleApplication::StartFlows()
+{
+    NS_LOG_FUNCTION(this);
+
+    const auto& flows = m_schedule->GetFlows(m_source);
+    int64_t now = Simulator::Now().GetTimeStep();
+    for (; m_nextFlow < flows.size() && flows[m_nextFlow].start <= now; m_nextFlow++)
+    {
+        const auto& flow = flows[m_nextFlow];
+        NS_ABORT_MSG_IF(flow.dst >= m_peers->size(), "No address for host " << flow.dst);
+        NS_LOG_LOGIC("flow of " << flow.size << " bytes to host " << flow.dst);
+        m_flowsStarted++;
+        m_flowStartTrace(flow.dst, flow.size);
+        Ptr<Socket> socket = GetConnection(flow.dst);
+        FindConnection(socket)->pending += flow.size;
+        SendData(socket);
+    }
+    ScheduleNextFlow();
+}
+
+Ptr<Socket>
+FlowScheduleApplication::GetConnection(uint32_t dst)
+{
+    NS_LOG_FUNCTION(this << dst);
+
+    auto idle = m_idle.find(dst);
+    if (idle != m_idle.end() && !idle->second.empty())
+    {
+        Ptr<Socket> socket = idle->second.back();
+        idle->second.pop_back();
+        m_nIdle--;
+        NS_LOG_LOGIC("reusing connection " << socket);
+        return socket;
+    }
+
+    const Address& peer = (*m_peers)[dst];
+    Ptr<Socket> socket = Socket::CreateSocket(GetNode(), m_tid);
+
+    // Fatal error if socket type is not NS3_SOCK_STREAM or NS3_SOCK_SEQPACKET
+    if (socket->GetSocketType() != Socket::NS3_SOCK_STREAM &&
+        socket->GetSocketType() != Socket::NS3_SOCK_SEQPACKET)
+    {
+        NS_FATAL_ERROR("Using FlowScheduleApplication with an incompatible socket type. "
+                       "FlowScheduleApplication requires SOCK_STREAM or SOCK_SEQPACKET. "
+                       "In other words, use TCP instead of UDP.");
+    }
+
+    int ret = -1;
+    if (Inet6SocketAddress::IsMatchingType(peer))
+    {
+        ret = socket->Bind6();
+    }
+    else if (InetSocketAddress::IsMatchingType(peer))
+    {
+        ret = socket->Bind();
+    }
+    if (ret == -1)
+    {
+        NS_FATAL_ERROR("Failed to bind socket");
+    }
+
+    m_connections[m_connectionsOpened] =
+        Connection{socket, dst, 0, socket->GetTxAvailable(), false};
+    m_connectionIds[PeekPointer(socket)] = m_connectionsOpened;
+    m_connectionsOpened++;
+    socket->Connect(peer);
+    socket->ShutdownRecv();
+    socket->SetConnectCallback(MakeCallback(&FlowScheduleApplication::ConnectionSucceeded, this),
+                               MakeCallback(&FlowScheduleApplication::ConnectionFailed, this));
+    socket->SetSendCallback(MakeCallback(&FlowScheduleApplication::DataSend, this));
+    socket->SetCloseCallbacks(MakeCallback(&FlowScheduleApplication::ConnectionClosed, this),
+                              MakeCallback(&FlowScheduleApplication::ConnectionClosed, this));
+    return socket;
+}
+
+FlowScheduleApplication::Connection*
+FlowScheduleApplication::FindConnection(Ptr<Socket> socket)
+{
+    auto it = m_connectionIds.find(PeekPointer(socket));
+    if (it == m_connectionIds.end())
+    {
+        return nullptr;
+    }
+    return &m_connections.at(it->second);
+}
+
+void
+FlowScheduleApplication::SendData(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+
+    Connection* found = FindConnection(socket);
+    if (!found || !found->connected)
+    {
+        return;
+    }
+    Connection& connection = *found;
+
+    while (connection.pending > 0)
+    {
+        Ptr<Packet> packet = connection.unsent;
+        if (!packet)
+        {
+            packet = Create<Packet>(std::min<uint64_t>(connection.pending, m_sendSize));
+        }
+        uint32_t toSend = packet->GetSize();
+
+        int actual = socket->Send(packet);
+        if ((unsigned)actual == toSend)
+        {
+            connection.pending -= actual;
+            m_txTrace(packet);
+            connection.unsent = nullptr;
+        }
+        else if (actual == -1)
+        {
+            // The send side buffer is full. The "DataSent" callback will
+            // pop when some buffer space has freed up.
+            NS_LOG_DEBUG("Unable to send packet; caching for later attempt");
+            connection.unsent = packet;
+            return;
+        }
+        else if (actual > 0 && (unsigned)actual < toSend)
+        {
+            // A Linux socket (non-blocking, such as in DCE) may return
+            // a quantity less than the packet size.
+            Ptr<Packet> sent = packet->CreateFragment(0, actual);
+            connection.pending -= actual;
+            m_txTrace(sent);
+            connection.unsent = packet->CreateFragment(actual, toSend - (unsigned)actual);
+            return;
+        }
+        else
+        {
+            NS_FATAL_ERROR("Unexpected return value from Socket::Send ()");
+        }
+    }
+
+    // Release the connection once all its bytes are acknowledged
+    if (socket->GetTxAvailable() < connection.txCapacity)
+    {
+        return;
+    }
+    auto& idle = m_idle[connection.dst];
+    if (std::find(idle.begin(), idle.end(), socket) != idle.end())
+    {
+        return;
+    }
+    if (m_nIdle < m_maxIdle)
+    {
+        NS_LOG_LOGIC("connection " << socket << " to host " << connection.dst << " is idle");
+        idle.push_back(socket);
+        m_nIdle++;
+    }
+    else
+    {
+        NS_LOG_LOGIC("closing connection " << socket << " to host " << connection.dst);
+        RemoveConnection(socket);
+        socket->Close();
+    }
+}
+
+void
+FlowScheduleApplication::RemoveConnection(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+
+    auto it = m_connectionIds.find(PeekPointer(socket));
+    if (it == m_connectionIds.end())
+    {
+        return;
+    }
+    const Connection& connection = m_connections.at(it->second);
+    if (connection.pending > 0)
+    {
+        NS_LOG_WARN("Connection to host " << connection.dst << " closed with "
+                                          << connection.pending << " bytes not sent");
+    }
+    auto idle = m_idle.find(connection.dst);
+    if (idle != m_idle.end())
+    {
+        auto pos = std::find(idle->second.begin(), idle->second.end(), socket);
+        if (pos != idle->second.end())
+        {
+            idle->second.erase(pos);
+            m_nIdle--;
+        }
+    }
+    m_connections.erase(it->second);
+    m_connectionIds.erase(it);
+    socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+    socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket>>(),
+                              MakeNullCallback<void, Ptr<Socket>>());
+}
+
+void
+FlowScheduleApplication::ConnectionSucceeded(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    NS_LOG_LOGIC("FlowScheduleApplication Connection succeeded");
+    Connection* connection = FindConnection(socket);
+    if (connection)
+    {
+        connection->connected = true;
+        SendData(socket);
+    }
+}
+
+void
+FlowScheduleApplication::ConnectionFailed(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    NS_LOG_LOGIC("FlowScheduleApplication, Connection Failed");
+    RemoveConnection(socket);
+}
+
+void
+FlowScheduleApplication::DataSend(Ptr<Socket> socket, uint32_t)
+{
+    NS_LOG_FUNCTION(this);
+    SendData(socket);
+}
+
+void
+FlowScheduleApplication::ConnectionClosed(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    RemoveConnection(socket);
+}
+
+} // Namespace ns3
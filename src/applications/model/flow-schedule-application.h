@@ -0,0 +1,201 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_SCHEDULE_APPLICATION_H
+#define FLOW_SCHEDULE_APPLICATION_H
+
+#include "flow-schedule.h"
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class Socket;
+
+/**
+ * \ingroup applications
+ * \defgroup flowschedule FlowScheduleApplication
+ *
+ * This traffic generator starts the flows of a host given by a shared,
+ * pre-sampled FlowSchedule, instead of an application per flow.
+ */
+
+/**
+ * \ingroup flowschedule
+ *
+ * \brief Start the flows of a host from a FlowSchedule.
+ *
+ * Only the start of the next flow of the host is scheduled at a time.  A
+ * flow sends its bytes as fast as possible on a stream socket connected to
+ * its destination, as a BulkSendApplication with MaxBytes does.
+ *
+ * Once all the bytes of its flows are acknowledged, a connection is kept
+ * idle, up to MaxIdleConnections, and the next flow to the same
+ * destination reuses it rather than opening a new connection.  Otherwise,
+ * the connection is closed.  The destinations must accept the connections,
+ * e.g., with a PacketSink.
+ */
+class FlowScheduleApplication : public Application
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    FlowScheduleApplication();
+
+    ~FlowScheduleApplication() override;
+
+    /**
+     * \brief Set the flows to start.
+     * \param schedule The schedule, shared by the hosts.
+     * \param source The index of the host of this application in the schedule.
+     * \param peers The socket addresses of the hosts, by index in the
+     * schedule, shared by the hosts.
+     */
+    void SetSchedule(Ptr<const FlowSchedule> schedule,
+                     uint32_t source,
+                     std::shared_ptr<const std::vector<Address>> peers);
+
+    /** \returns The number of flows started. */
+    uint64_t GetFlowsStarted() const;
+
+    /** \returns The number of connections opened. */
+    uint64_t GetConnectionsOpened() const;
+
+    /**
+     * TracedCallback signature for the start of a flow.
+     *
+     * \param [in] dst The destination host, as index in the schedule.
+     * \param [in] size The size of the flow in bytes.
+     */
+    typedef void (*FlowTracedCallback)(uint32_t dst, uint64_t size);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    // inherited from Application base class.
+    void StartApplication() override; // Called at time specified by Start
+    void StopApplication() override;  // Called at time specified by Stop
+
+    /** A connection to a destination. */
+    struct Connection
+    {
+        Ptr<Socket> socket;   //!< Socket of the connection
+        uint32_t dst;         //!< Destination host
+        uint64_t pending;     //!< Bytes of the flows not sent yet
+        uint32_t txCapacity;  //!< Available transmit buffer when empty
+        bool connected;       //!< Whether the connection is established
+        Ptr<Packet> unsent{}; //!< Packet to send again
+    };
+
+    /** \brief Schedule the start of the next flow, if any. */
+    void ScheduleNextFlow();
+
+    /** \brief Start the flows due now, and schedule the next one. */
+    void StartFlows();
+
+    /**
+     * \brief Get a connection to a destination, idle or new.
+     * \param dst The destination host.
+     * \returns The socket of the connection.
+     */
+    Ptr<Socket> GetConnection(uint32_t dst);
+
+    /**
+     * \brief Find an open connection.
+     * \param socket The socket of the connection.
+     * \returns The connection, or nullptr if not open.
+     */
+    Connection* FindConnection(Ptr<Socket> socket);
+
+    /**
+     * \brief Send the pending bytes of a connection until the transmit
+     * buffer is full, and release it when all are acknowledged.
+     * \param socket The socket of the connection.
+     */
+    void SendData(Ptr<Socket> socket);
+
+    /**
+     * \brief Forget a connection.
+     * \param socket The socket of the connection.
+     */
+    void RemoveConnection(Ptr<Socket> socket);
+
+    /**
+     * \brief Connection Succeeded (called by Socket through a callback)
+     * \param socket the connected socket
+     */
+    void ConnectionSucceeded(Ptr<Socket> socket);
+    /**
+     * \brief Connection Failed (called by Socket through a callback)
+     * \param socket the connected socket
+     */
+    void ConnectionFailed(Ptr<Socket> socket);
+    /**
+     * \brief Send more data as soon as some has been transmitted or
+     * acknowledged.
+     *
+     * Used in socket's SetSendCallback - params are forced by it.
+     *
+     * \param socket socket to use
+     * \param unused actually unused
+     */
+    void DataSend(Ptr<Socket> socket, uint32_t unused);
+    /**
+     * \brief Connection closed by the peer or on error (called by Socket
+     * through a callback)
+     * \param socket the closed socket
+     */
+    void ConnectionClosed(Ptr<Socket> socket);
+
+    Ptr<const FlowSchedule> m_schedule;                 //!< Shared schedule
+    uint32_t m_source;                                  //!< Index of this host
+    std::shared_ptr<const std::vector<Address>> m_peers; //!< Addresses of the hosts
+    std::size_t m_nextFlow;                             //!< Index of the next flow to start
+    EventId m_startEvent;                               //!< Start of the next flow
+    uint32_t m_sendSize;                                //!< Size of data to send each time
+    uint32_t m_maxIdle;                                 //!< Maximum number of idle connections
+    TypeId m_tid;                                       //!< The type of protocol to use.
+    std::map<uint64_t, Connection> m_connections;       //!< Open connections, in opening order
+    std::unordered_map<const Socket*, uint64_t> m_connectionIds; //!< Open connections, by socket
+    std::unordered_map<uint32_t, std::vector<Ptr<Socket>>> m_idle; //!< Idle connections
+    uint32_t m_nIdle;                                   //!< Number of idle connections
+    uint64_t m_flowsStarted;                            //!< Number of flows started
+    uint64_t m_connectionsOpened;                       //!< Number of connections opened
+
+    /// Traced Callback: sent packets
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+
+    /// Traced Callback: started flows
+    TracedCallback<uint32_t, uint64_t> m_flowStartTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_SCHEDULE_APPLICATION_H */
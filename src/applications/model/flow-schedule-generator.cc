@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-schedule-generator.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowScheduleGenerator");
+
+FlowScheduleGenerator::FlowScheduleGenerator(uint32_t nHosts, DataRate hostRate)
+    : m_nHosts(nHosts),
+      m_hostRate(hostRate)
+{
+    NS_LOG_FUNCTION(this << nHosts << hostRate);
+    NS_ABORT_MSG_IF(nHosts < 2, "At least two hosts are needed");
+    m_size = CreateObject<EmpiricalRandomVariable>();
+    m_size->SetInterpolate(true);
+    m_interArrival = CreateObject<ExponentialRandomVariable>();
+    m_host = CreateObject<UniformRandomVariable>();
+}
+
+void
+FlowScheduleGenerator::LoadSizeCdf(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    std::ifstream in(filename);
+    NS_ABORT_MSG_IF(!in, "Cannot open CDF file " << filename);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        double size;
+        double cdf;
+        if (fields >> size >> cdf)
+        {
+            AddSizeCdf(size, cdf);
+        }
+    }
+}
+
+void
+FlowScheduleGenerator::AddSizeCdf(double size, double cdf)
+{
+    NS_LOG_FUNCTION(this << size << cdf);
+    // the sizes below the first point are the first size, and are
+    // interpolated linearly between the points
+    m_meanSize += m_nPoints == 0 ? size * cdf : (m_lastSize + size) / 2 * (cdf - m_lastCdf);
+    m_size->CDF(size, cdf);
+    m_nPoints++;
+    m_lastSize = size;
+    m_lastCdf = cdf;
+}
+
+double
+FlowScheduleGenerator::GetMeanSize() const
+{
+    return m_meanSize;
+}
+
+int64_t
+FlowScheduleGenerator::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_size->SetStream(stream);
+    m_interArrival->SetStream(stream + 1);
+    m_host->SetStream(stream + 2);
+    return 3;
+}
+
+Time
+FlowScheduleGenerator::NextEvent(Time now, double load, double flowsPerEvent)
+{
+    // events per second such that the flows offer the load requested
+    double rate = load * m_nHosts * m_hostRate.GetBitRate() / 8 / (m_meanSize * flowsPerEvent);
+    return now + Seconds(m_interArrival->GetValue(1 / rate, 0));
+}
+
+uint64_t
+FlowScheduleGenerator::SampleSize()
+{
+    return std::max<uint64_t>(std::llround(m_size->GetValue()), 1);
+}
+
+void
+FlowScheduleGenerator::Poisson(Ptr<FlowSchedule> schedule, double load, Time start, Time stop)
+{
+    NS_LOG_FUNCTION(this << schedule << load << start << stop);
+    NS_ABORT_MSG_IF(m_nPoints == 0 || load <= 0, "No flow size distribution or load");
+    for (Time t = NextEvent(start, load, 1); t <= stop; t = NextEvent(t, load, 1))
+    {
+        uint32_t dst = m_host->GetInteger(0, m_nHosts - 1);
+        uint32_t src;
+        do
+        {
+            src = m_host->GetInteger(0, m_nHosts - 1);
+        } while (src == dst);
+        schedule->Add(t, src, dst, SampleSize());
+    }
+}
+
+void
+FlowScheduleGenerator::Incast(Ptr<FlowSchedule> schedule,
+                              double load,
+                              Time start,
+                              Time stop,
+                              uint32_t fanIn)
+{
+    NS_LOG_FUNCTION(this << schedule << load << start << stop << fanIn);
+    NS_ABORT_MSG_IF(m_nPoints == 0 || load <= 0, "No flow size distribution or load");
+    NS_ABORT_MSG_IF(fanIn == 0 || fanIn >= m_nHosts, "Invalid incast fan-in " << fanIn);
+    std::vector<uint32_t> sources;
+    for (Time t = NextEvent(start, load, fanIn); t <= stop; t = NextEvent(t, load, fanIn))
+    {
+        uint32_t dst = m_host->GetInteger(0, m_nHosts - 1);
+        sources.clear();
+        while (sources.size() < fanIn)
+        {
+            uint32_t src = m_host->GetInteger(0, m_nHosts - 1);
+            if (src != dst && std::find(sources.begin(), sources.end(), src) == sources.end())
+            {
+                sources.push_back(src);
+                schedule->Add(t, src, dst, SampleSize());
+            }
+        }
+    }
+}
+
+void
+FlowScheduleGenerator::AllToAll(Ptr<FlowSchedule> schedule, double load, Time start, Time stop)
+{
+    NS_LOG_FUNCTION(this << schedule << load << start << stop);
+    NS_ABORT_MSG_IF(m_nPoints == 0 || load <= 0, "No flow size distribution or load");
+    double flowsPerEvent = static_cast<double>(m_nHosts) * (m_nHosts - 1);
+    for (Time t = NextEvent(start, load, flowsPerEvent); t <= stop;
+         t = NextEvent(t, load, flowsPerEvent))
+    {
+        for (uint32_t src = 0; src < m_nHosts; src++)
+        {
+            for (uint32_t dst = 0; dst < m_nHosts; dst++)
+            {
+                if (src != dst)
+                {
+                    schedule->Add(t, src, dst, SampleSize());
+                }
+            }
+        }
+    }
+}
+
+} // namespace ns3
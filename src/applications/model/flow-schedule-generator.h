@@ -0,0 +1,135 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_SCHEDULE_GENERATOR_H
+#define FLOW_SCHEDULE_GENERATOR_H
+
+#include "flow-schedule.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup flowschedule
+ * \brief Sample the flows of a FlowSchedule for common traffic patterns.
+ *
+ * The flow sizes follow an empirical distribution, given as a CDF, and the
+ * flows are started by events in a Poisson process whose rate yields the
+ * load requested, as a fraction of the aggregate rate of the hosts:
+ *
+ * - Poisson: each event starts one flow between two random hosts;
+ * - incast: each event starts flows from several random hosts to one;
+ * - all-to-all: each event starts a flow between every pair of hosts.
+ */
+class FlowScheduleGenerator
+{
+  public:
+    /**
+     * \brief Create a generator.
+     * \param nHosts The number of hosts.
+     * \param hostRate The rate of the link of each host.
+     */
+    FlowScheduleGenerator(uint32_t nHosts, DataRate hostRate);
+
+    /**
+     * \brief Read the distribution of the flow sizes from a CDF file.
+     *
+     * Each line of the file has a size in bytes and the probability of a
+     * flow to be at most that size, in increasing order.  The sizes are
+     * interpolated between these points.
+     *
+     * \param filename The name of the file.
+     */
+    void LoadSizeCdf(const std::string& filename);
+
+    /**
+     * \brief Add a point to the distribution of the flow sizes.
+     * \param size A size in bytes.
+     * \param cdf The probability of a flow to be at most this size.
+     */
+    void AddSizeCdf(double size, double cdf);
+
+    /** \returns The mean flow size of the distribution, in bytes. */
+    double GetMeanSize() const;
+
+    /**
+     * \brief Assign fixed random variable stream numbers.
+     * \param stream The first stream index to use.
+     * \returns The number of stream indices assigned.
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * \brief Add flows between random pairs of hosts.
+     * \param schedule The schedule to fill.
+     * \param load The load, as a fraction of the aggregate host rate.
+     * \param start The start of the first event.
+     * \param stop The time after which no event starts.
+     */
+    void Poisson(Ptr<FlowSchedule> schedule, double load, Time start, Time stop);
+
+    /**
+     * \brief Add incast flows.
+     * \param schedule The schedule to fill.
+     * \param load The load, as a fraction of the aggregate host rate.
+     * \param start The start of the first event.
+     * \param stop The time after which no event starts.
+     * \param fanIn The number of sources of each incast.
+     */
+    void Incast(Ptr<FlowSchedule> schedule, double load, Time start, Time stop, uint32_t fanIn);
+
+    /**
+     * \brief Add flows between all the pairs of hosts.
+     * \param schedule The schedule to fill.
+     * \param load The load, as a fraction of the aggregate host rate.
+     * \param start The start of the first event.
+     * \param stop The time after which no event starts.
+     */
+    void AllToAll(Ptr<FlowSchedule> schedule, double load, Time start, Time stop);
+
+  private:
+    /**
+     * \brief Get the time of the next event.
+     * \param now The time of the previous event.
+     * \param load The load, as a fraction of the aggregate host rate.
+     * \param flowsPerEvent The number of flows started by an event.
+     * \returns The time of the next event.
+     */
+    Time NextEvent(Time now, double load, double flowsPerEvent);
+
+    /** \returns A flow size, in bytes. */
+    uint64_t SampleSize();
+
+    uint32_t m_nHosts;                             //!< Number of hosts
+    DataRate m_hostRate;                           //!< Rate of each host
+    Ptr<EmpiricalRandomVariable> m_size;           //!< Flow sizes
+    uint32_t m_nPoints{0};                         //!< Number of points of the CDF
+    double m_lastSize{0};                          //!< Last size of the CDF
+    double m_lastCdf{0};                           //!< Last probability of the CDF
+    double m_meanSize{0};                          //!< Mean flow size
+    Ptr<ExponentialRandomVariable> m_interArrival; //!< Times between events
+    Ptr<UniformRandomVariable> m_host;             //!< Hosts
+};
+
+} // namespace ns3
+
+#endif /* FLOW_SCHEDULE_GENERATOR_H */
@@ -0,0 +1,250 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-schedule.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowSchedule");
+
+namespace
+{
+
+/** Magic of the binary format. */
+const char MAGIC[8] = {'n', 's', '3', 'f', 'l', 'o', 'w', 's'};
+/** Version of the binary format. */
+const uint32_t VERSION = 1;
+/** Size of a flow in the binary format. */
+const std::size_t RECORD_SIZE = 24;
+
+/**
+ * \brief Write a little-endian integer.
+ * \param [out] buffer The buffer.
+ * \param [in] value The integer.
+ * \param [in] size The size of the integer in bytes.
+ * \returns The buffer after the integer.
+ */
+uint8_t*
+WriteLe(uint8_t* buffer, uint64_t value, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; i++)
+    {
+        buffer[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return buffer + size;
+}
+
+/**
+ * \brief Read a little-endian integer.
+ * \param [in,out] buffer The buffer, moved after the integer.
+ * \param [in] size The size of the integer in bytes.
+ * \returns The integer.
+ */
+uint64_t
+ReadLe(const uint8_t*& buffer, std::size_t size)
+{
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        value |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+    }
+    buffer += size;
+    return value;
+}
+
+} // namespace
+
+void
+FlowSchedule::Add(Time start, uint32_t src, uint32_t dst, uint64_t size)
+{
+    NS_LOG_FUNCTION(this << start << src << dst << size);
+    if (src >= m_flows.size())
+    {
+        m_flows.resize(src + 1);
+    }
+    auto& flows = m_flows[src];
+    Flow flow{start.GetTimeStep(), size, dst};
+    if (flows.empty() || flows.back().start <= flow.start)
+    {
+        flows.push_back(flow);
+    }
+    else
+    {
+        // keep the flows with the same start in the order added
+        auto it = std::upper_bound(flows.begin(),
+                                   flows.end(),
+                                   flow.start,
+                                   [](int64_t ts, const Flow& f) { return ts < f.start; });
+        flows.insert(it, flow);
+    }
+    m_nFlows++;
+    m_totalSize += size;
+}
+
+const std::vector<FlowSchedule::Flow>&
+FlowSchedule::GetFlows(uint32_t src) const
+{
+    static const std::vector<Flow> none;
+    return src < m_flows.size() ? m_flows[src] : none;
+}
+
+uint32_t
+FlowSchedule::GetNSources() const
+{
+    return m_flows.size();
+}
+
+uint64_t
+FlowSchedule::GetNFlows() const
+{
+    return m_nFlows;
+}
+
+uint64_t
+FlowSchedule::GetTotalSize() const
+{
+    return m_totalSize;
+}
+
+void
+FlowSchedule::Load(const std::string& filename, uint32_t nHosts)
+{
+    NS_LOG_FUNCTION(this << filename << nHosts);
+    std::ifstream in(filename, std::ios::binary);
+    NS_ABORT_MSG_IF(!in, "Cannot open flow schedule " << filename);
+
+    char magic[sizeof(MAGIC)] = {};
+    in.read(magic, sizeof(magic));
+    if (in.gcount() == sizeof(magic) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0)
+    {
+        uint8_t header[12];
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        NS_ABORT_MSG_IF(in.gcount() != sizeof(header), "Truncated flow schedule " << filename);
+        const uint8_t* p = header;
+        uint32_t version = ReadLe(p, 4);
+        uint64_t count = ReadLe(p, 8);
+        NS_ABORT_MSG_IF(version != VERSION,
+                        "Unsupported flow schedule version " << version << " in " << filename);
+
+        // read the records by chunks
+        std::vector<uint8_t> buffer(RECORD_SIZE * 4096);
+        while (count > 0)
+        {
+            uint64_t n = std::min<uint64_t>(count, buffer.size() / RECORD_SIZE);
+            in.read(reinterpret_cast<char*>(buffer.data()), n * RECORD_SIZE);
+            NS_ABORT_MSG_IF(static_cast<uint64_t>(in.gcount()) != n * RECORD_SIZE,
+                            "Truncated flow schedule " << filename);
+            p = buffer.data();
+            for (uint64_t i = 0; i < n; i++)
+            {
+                auto start = static_cast<int64_t>(ReadLe(p, 8));
+                auto src = static_cast<uint32_t>(ReadLe(p, 4));
+                auto dst = static_cast<uint32_t>(ReadLe(p, 4));
+                uint64_t size = ReadLe(p, 8);
+                NS_ABORT_MSG_IF(src >= nHosts || dst >= nHosts,
+                                "Flow from host " << src << " to host " << dst << " out of the "
+                                                  << nHosts << " hosts in " << filename);
+                Add(NanoSeconds(start), src, dst, size);
+            }
+            count -= n;
+        }
+        return;
+    }
+
+    in.clear();
+    in.seekg(0);
+    std::string line;
+    uint64_t lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        lineNumber++;
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+        {
+            continue;
+        }
+        std::istringstream fields(line);
+        double start;
+        uint32_t src;
+        uint32_t dst;
+        uint64_t size;
+        fields >> start >> src >> dst >> size;
+        NS_ABORT_MSG_IF(fields.fail(),
+                        "Invalid flow at " << filename << ":" << lineNumber << ": " << line);
+        NS_ABORT_MSG_IF(src >= nHosts || dst >= nHosts,
+                        "Flow from host " << src << " to host " << dst << " out of the " << nHosts
+                                          << " hosts at " << filename << ":" << lineNumber);
+        Add(Seconds(start), src, dst, size);
+    }
+}
+
+void
+FlowSchedule::Save(const std::string& filename, bool binary) const
+{
+    NS_LOG_FUNCTION(this << filename << binary);
+    std::ofstream out(filename, binary ? std::ios::binary : std::ios::out);
+    NS_ABORT_MSG_IF(!out, "Cannot write flow schedule " << filename);
+
+    if (!binary)
+    {
+        out.precision(12);
+        for (uint32_t src = 0; src < m_flows.size(); src++)
+        {
+            for (const auto& flow : m_flows[src])
+            {
+                out << TimeStep(flow.start).GetSeconds() << " " << src << " " << flow.dst << " "
+                    << flow.size << "\n";
+            }
+        }
+        return;
+    }
+
+    uint8_t header[sizeof(MAGIC) + 12];
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    WriteLe(WriteLe(header + sizeof(MAGIC), VERSION, 4), m_nFlows, 8);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(RECORD_SIZE * 4096);
+    for (uint32_t src = 0; src < m_flows.size(); src++)
+    {
+        for (const auto& flow : m_flows[src])
+        {
+            uint8_t record[RECORD_SIZE];
+            uint8_t* p = WriteLe(record, TimeStep(flow.start).GetNanoSeconds(), 8);
+            p = WriteLe(p, src, 4);
+            p = WriteLe(p, flow.dst, 4);
+            WriteLe(p, flow.size, 8);
+            buffer.insert(buffer.end(), record, record + RECORD_SIZE);
+            if (buffer.size() == buffer.capacity())
+            {
+                out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+                buffer.clear();
+            }
+        }
+    }
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+}
+
+} // namespace ns3
@@ -0,0 +1,114 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_SCHEDULE_H
+#define FLOW_SCHEDULE_H
+
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup flowschedule
+ * \brief The flows to be started by a set of hosts.
+ *
+ * Each flow is given by its start time, its source and destination hosts,
+ * as indexes in the set of hosts, and its size in bytes.  The flows are
+ * kept by source, sorted by start time, so that the application of each
+ * source only walks its own flows.
+ *
+ * A schedule can be filled directly, e.g., by a FlowScheduleGenerator, or
+ * loaded from a file.  Two file formats are supported:
+ *
+ * - text: one flow per line, as "start src dst size" with the start time
+ *   in seconds; empty lines and lines starting with '#' are ignored;
+ * - binary: the magic "ns3flows", a 32-bit version (1) and a 64-bit count
+ *   of flows, followed by the flows as 24-byte records: a 64-bit start
+ *   time in nanoseconds, the 32-bit source and destination and a 64-bit
+ *   size.  All the integers are little-endian.
+ *
+ * The schedule is read-only once the simulation runs, so that it can be
+ * shared by the applications of all the logical processes.
+ */
+class FlowSchedule : public SimpleRefCount<FlowSchedule>
+{
+  public:
+    /** A flow of a source. */
+    struct Flow
+    {
+        int64_t start; //!< Start time, in time steps
+        uint64_t size; //!< Size in bytes
+        uint32_t dst;  //!< Destination host
+    };
+
+    /**
+     * \brief Add a flow.
+     *
+     * The flows are indexed by source, so the sources should be numbered from 0.
+     *
+     * \param start The start time.
+     * \param src The source host.
+     * \param dst The destination host.
+     * \param size The size in bytes.
+     */
+    void Add(Time start, uint32_t src, uint32_t dst, uint64_t size);
+
+    /**
+     * \param src A source host.
+     * \returns The flows of the source, sorted by start time.
+     */
+    const std::vector<Flow>& GetFlows(uint32_t src) const;
+
+    /** \returns The number of sources, i.e., the highest source plus one. */
+    uint32_t GetNSources() const;
+
+    /** \returns The number of flows. */
+    uint64_t GetNFlows() const;
+
+    /** \returns The total size of the flows in bytes. */
+    uint64_t GetTotalSize() const;
+
+    /**
+     * \brief Add the flows of a file, in either format.
+     *
+     * Aborts on a flow from or to a host out of the set of hosts.
+     *
+     * \param filename The name of the file.
+     * \param nHosts The number of hosts.
+     */
+    void Load(const std::string& filename, uint32_t nHosts);
+
+    /**
+     * \brief Write the flows to a file, sorted by source.
+     * \param filename The name of the file.
+     * \param binary Whether to use the binary format.
+     */
+    void Save(const std::string& filename, bool binary = true) const;
+
+  private:
+    std::vector<std::vector<Flow>> m_flows; //!< Flows by source
+    uint64_t m_nFlows{0};                   //!< Number of flows
+    uint64_t m_totalSize{0};                //!< Total size of the flows
+};
+
+} // namespace ns3
+
+#endif /* FLOW_SCHEDULE_H */
@@ -0,0 +1,296 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/application-container.h"
+#include "ns3/data-rate.h"
+#include "ns3/flow-schedule-application.h"
+#include "ns3/flow-schedule-generator.h"
+#include "ns3/flow-schedule-helper.h"
+#include "ns3/flow-schedule.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that a schedule is kept sorted by source and start time, and is
+ * read back identical from both file formats.
+ */
+class FlowScheduleFileTestCase : public TestCase
+{
+  public:
+    FlowScheduleFileTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Check that two schedules have the same flows.
+     * \param a the first schedule
+     * \param b the second schedule
+     * \param format the name of the file format
+     */
+    void CheckEqual(Ptr<const FlowSchedule> a, Ptr<const FlowSchedule> b, std::string format);
+};
+
+FlowScheduleFileTestCase::FlowScheduleFileTestCase()
+    : TestCase("Check the order and the file formats of a flow schedule")
+{
+}
+
+void
+FlowScheduleFileTestCase::CheckEqual(Ptr<const FlowSchedule> a,
+                                     Ptr<const FlowSchedule> b,
+                                     std::string format)
+{
+    NS_TEST_ASSERT_MSG_EQ(b->GetNSources(), a->GetNSources(), "Sources differ in " << format);
+    NS_TEST_ASSERT_MSG_EQ(b->GetNFlows(), a->GetNFlows(), "Flows differ in " << format);
+    NS_TEST_ASSERT_MSG_EQ(b->GetTotalSize(), a->GetTotalSize(), "Sizes differ in " << format);
+    for (uint32_t src = 0; src < a->GetNSources(); src++)
+    {
+        const auto& fa = a->GetFlows(src);
+        const auto& fb = b->GetFlows(src);
+        NS_TEST_ASSERT_MSG_EQ(fb.size(), fa.size(), "Flows of " << src << " differ in " << format);
+        for (std::size_t i = 0; i < fa.size() && i < fb.size(); i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(fb[i].start, fa[i].start, "Start differs in " << format);
+            NS_TEST_EXPECT_MSG_EQ(fb[i].dst, fa[i].dst, "Destination differs in " << format);
+            NS_TEST_EXPECT_MSG_EQ(fb[i].size, fa[i].size, "Size differs in " << format);
+        }
+    }
+}
+
+void
+FlowScheduleFileTestCase::DoRun()
+{
+    auto schedule = Create<FlowSchedule>();
+    schedule->Add(MilliSeconds(30), 2, 0, 1000);
+    schedule->Add(MilliSeconds(10), 2, 1, 2000);
+    schedule->Add(MicroSeconds(10001), 0, 2, 3000);
+    schedule->Add(MilliSeconds(10), 2, 0, 4000);
+    schedule->Add(Seconds(1234.5), 0, 1, 1ULL << 40);
+
+    NS_TEST_ASSERT_MSG_EQ(schedule->GetNSources(), 3, "Wrong number of sources");
+    NS_TEST_ASSERT_MSG_EQ(schedule->GetNFlows(), 5, "Wrong number of flows");
+    NS_TEST_ASSERT_MSG_EQ(schedule->GetFlows(1).size(), 0, "Host 1 has no flow");
+    NS_TEST_ASSERT_MSG_EQ(schedule->GetFlows(7).size(), 0, "Host 7 has no flow");
+    const auto& flows = schedule->GetFlows(2);
+    NS_TEST_ASSERT_MSG_EQ(flows.size(), 3, "Wrong number of flows of host 2");
+    NS_TEST_EXPECT_MSG_EQ(flows[0].size, 2000, "Flows not sorted by start time");
+    NS_TEST_EXPECT_MSG_EQ(flows[1].size, 4000, "Flows with the same start not in order");
+    NS_TEST_EXPECT_MSG_EQ(flows[2].size, 1000, "Flows not sorted by start time");
+
+    std::string binary = CreateTempDirFilename("flows.bin");
+    schedule->Save(binary);
+    auto fromBinary = Create<FlowSchedule>();
+    fromBinary->Load(binary, 3);
+    CheckEqual(schedule, fromBinary, "binary");
+
+    std::string text = CreateTempDirFilename("flows.txt");
+    schedule->Save(text, false);
+    auto fromText = Create<FlowSchedule>();
+    fromText->Load(text, 3);
+    CheckEqual(schedule, fromText, "text");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that the generated flows offer the load requested.
+ */
+class FlowScheduleGeneratorTestCase : public TestCase
+{
+  public:
+    FlowScheduleGeneratorTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FlowScheduleGeneratorTestCase::FlowScheduleGeneratorTestCase()
+    : TestCase("Check the flows of the generated patterns")
+{
+}
+
+void
+FlowScheduleGeneratorTestCase::DoRun()
+{
+    const uint32_t nHosts = 10;
+    const double load = 0.5;
+    const Time duration = MilliSeconds(100);
+    FlowScheduleGenerator generator(nHosts, DataRate("1Gbps"));
+    generator.AddSizeCdf(1000, 0.5);
+    generator.AddSizeCdf(3000, 1);
+    generator.AssignStreams(1);
+    NS_TEST_ASSERT_MSG_EQ_TOL(generator.GetMeanSize(), 1500, 1e-9, "Wrong mean size");
+
+    // bytes offered by the hosts at the load requested
+    double offered = load * nHosts * 1e9 / 8 * duration.GetSeconds();
+
+    auto poisson = Create<FlowSchedule>();
+    generator.Poisson(poisson, load, Seconds(0), duration);
+    NS_TEST_ASSERT_MSG_EQ_TOL(poisson->GetTotalSize(), offered, offered * 0.05, "Wrong load");
+    for (uint32_t src = 0; src < poisson->GetNSources(); src++)
+    {
+        for (const auto& flow : poisson->GetFlows(src))
+        {
+            NS_TEST_ASSERT_MSG_NE(flow.dst, src, "Flow to itself");
+            NS_TEST_ASSERT_MSG_LT(flow.dst, nHosts, "Wrong destination");
+            NS_TEST_ASSERT_MSG_GT_OR_EQ(flow.size, 1000, "Size out of the distribution");
+            NS_TEST_ASSERT_MSG_LT_OR_EQ(flow.size, 3000, "Size out of the distribution");
+            NS_TEST_ASSERT_MSG_LT_OR_EQ(flow.start, duration.GetTimeStep(), "Flow too late");
+        }
+    }
+
+    auto incast = Create<FlowSchedule>();
+    generator.Incast(incast, load, Seconds(0), duration, 4);
+    NS_TEST_ASSERT_MSG_EQ(incast->GetNFlows() % 4, 0, "Incomplete incast");
+    NS_TEST_ASSERT_MSG_EQ_TOL(incast->GetTotalSize(), offered, offered * 0.1, "Wrong load");
+
+    auto allToAll = Create<FlowSchedule>();
+    generator.AllToAll(allToAll, load, Seconds(0), duration);
+    NS_TEST_ASSERT_MSG_EQ(allToAll->GetNFlows() % (nHosts * (nHosts - 1)), 0, "Missing pairs");
+    NS_TEST_ASSERT_MSG_EQ_TOL(allToAll->GetTotalSize(), offered, offered * 0.2, "Wrong load");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that the applications deliver all the flows of a schedule, and
+ * reuse idle connections unless disabled.
+ */
+class FlowScheduleApplicationTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param maxIdle the maximum number of idle connections of a host
+     */
+    FlowScheduleApplicationTestCase(uint32_t maxIdle);
+
+  private:
+    void DoRun() override;
+    uint32_t m_maxIdle; //!< Maximum number of idle connections
+};
+
+FlowScheduleApplicationTestCase::FlowScheduleApplicationTestCase(uint32_t maxIdle)
+    : TestCase("Check the flows of a schedule with " + std::to_string(maxIdle) +
+               " idle connections"),
+      m_maxIdle(maxIdle)
+{
+}
+
+void
+FlowScheduleApplicationTestCase::DoRun()
+{
+    NodeContainer hosts;
+    hosts.Create(3);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    simpleHelper.SetChannelAttribute("Delay", StringValue("1ms"));
+    NetDeviceContainer devices = simpleHelper.Install(hosts);
+    InternetStackHelper internet;
+    internet.Install(hosts);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    ipv4.Assign(devices);
+
+    auto schedule = Create<FlowSchedule>();
+    // flows after the previous ones completed, to the same host
+    schedule->Add(Seconds(1), 0, 1, 100000);
+    schedule->Add(Seconds(2), 0, 1, 20000);
+    schedule->Add(Seconds(3), 0, 1, 1);
+    // concurrent flows to the same host
+    schedule->Add(Seconds(1), 1, 2, 50000);
+    schedule->Add(Seconds(1), 1, 2, 50000);
+    schedule->Add(Seconds(1.001), 1, 0, 3000);
+    schedule->Add(Seconds(1.5), 2, 0, 70000);
+
+    uint16_t port = 9;
+    FlowScheduleHelper sourceHelper("ns3::TcpSocketFactory", port);
+    sourceHelper.SetAttribute("MaxIdleConnections", UintegerValue(m_maxIdle));
+    ApplicationContainer sourceApps = sourceHelper.Install(hosts, schedule);
+    sourceApps.Start(Seconds(0.0));
+    sourceApps.Stop(Seconds(10.0));
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sinkApps = sinkHelper.Install(hosts);
+    sinkApps.Start(Seconds(0.0));
+    sinkApps.Stop(Seconds(10.0));
+
+    Simulator::Run();
+
+    uint64_t received = 0;
+    for (uint32_t i = 0; i < hosts.GetN(); i++)
+    {
+        received += DynamicCast<PacketSink>(sinkApps.Get(i))->GetTotalRx();
+    }
+    NS_TEST_ASSERT_MSG_EQ(received, schedule->GetTotalSize(), "Not all the flows received");
+    NS_TEST_ASSERT_MSG_EQ(DynamicCast<PacketSink>(sinkApps.Get(2))->GetTotalRx(),
+                          100000,
+                          "Wrong bytes received by host 2");
+
+    std::vector<uint64_t> opened;
+    for (uint32_t i = 0; i < hosts.GetN(); i++)
+    {
+        auto app = DynamicCast<FlowScheduleApplication>(sourceApps.Get(i));
+        NS_TEST_ASSERT_MSG_EQ(app->GetFlowsStarted(),
+                              schedule->GetFlows(i).size(),
+                              "Not all the flows of host " << i << " started");
+        opened.push_back(app->GetConnectionsOpened());
+    }
+    Simulator::Destroy();
+
+    uint64_t expected = m_maxIdle > 0 ? 1 : 3;
+    NS_TEST_EXPECT_MSG_EQ(opened[0], expected, "Wrong connections of host 0");
+    NS_TEST_EXPECT_MSG_EQ(opened[1], 3, "Wrong connections of host 1");
+    NS_TEST_EXPECT_MSG_EQ(opened[2], 1, "Wrong connections of host 2");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief FlowSchedule TestSuite
+ */
+class FlowScheduleTestSuite : public TestSuite
+{
+  public:
+    FlowScheduleTestSuite();
+};
+
+FlowScheduleTestSuite::FlowScheduleTestSuite()
+    : TestSuite("flow-schedule", UNIT)
+{
+    AddTestCase(new FlowScheduleFileTestCase, TestCase::QUICK);
+    AddTestCase(new FlowScheduleGeneratorTestCase, TestCase::QUICK);
+    AddTestCase(new FlowScheduleApplicationTestCase(16), TestCase::QUICK);
+    AddTestCase(new FlowScheduleApplicationTestCase(0), TestCase::QUICK);
+}
+
+static FlowScheduleTestSuite g_flowScheduleTestSuite; //!< Static variable for test initialization
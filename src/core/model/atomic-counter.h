@@ -97,6 +97,118 @@ class AtomicCounter
     std::atomic<uint32_t> m_count;
 };
 
+/**
+ * @brief
+ * A reference counter which is atomic only once shared by several threads.
+ *
+ * The objects counted are expected to be used by a single logical process
+ * at a time, hence the counter is incremented and decremented with plain
+ * loads and stores.  An object is handed over to another logical process
+ * through its mailbox, which orders the accesses of both processes, as long
+ * as the sender keeps no reference to it.  Otherwise, the counter must be
+ * shared before the handover, and is then atomic for the rest of the life of
+ * the object.  The shared state is kept in the highest bit of the counter.
+ */
+class OwnedCounter
+{
+  public:
+    /** Constructor */
+    inline OwnedCounter()
+    {
+        m_count.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Construct a new counter, not shared.
+     *
+     * @param count The initialization count number
+     */
+    inline OwnedCounter(uint32_t count)
+    {
+        m_count.store(count, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read the counter value.
+     *
+     * @return The counter value.
+     */
+    inline operator uint32_t() const
+    {
+        return m_count.load(std::memory_order_acquire) & ~SHARED;
+    }
+
+    /**
+     * @brief Set the counter value, the counter being not shared anymore, as
+     * done when (re)initializing the object counted.
+     *
+     * @param count The counter value to be set
+     * @return The counter value to be set
+     */
+    inline uint32_t operator=(const uint32_t count)
+    {
+        m_count.store(count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Increment the counter by one.
+     *
+     * @return The old counter value
+     */
+    inline uint32_t operator++(int)
+    {
+        uint32_t count = m_count.load(std::memory_order_relaxed);
+        if (count & SHARED)
+        {
+            return m_count.fetch_add(1, std::memory_order_relaxed) & ~SHARED;
+        }
+        m_count.store(count + 1, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @brief Decrement the counter by one.
+     *
+     * @return The old counter value
+     */
+    inline uint32_t operator--(int)
+    {
+        uint32_t count = m_count.load(std::memory_order_relaxed);
+        if (count & SHARED)
+        {
+            return m_count.fetch_sub(1, std::memory_order_release) & ~SHARED;
+        }
+        m_count.store(count - 1, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @brief Make the counter atomic, before the object counted is used by
+     * another thread.
+     */
+    inline void Share()
+    {
+        m_count.fetch_or(SHARED, std::memory_order_release);
+    }
+
+    /**
+     * @brief Whether the counter is atomic.
+     *
+     * @return true if the counter is shared
+     */
+    inline bool IsShared() const
+    {
+        return m_count.load(std::memory_order_relaxed) & SHARED;
+    }
+
+  private:
+    /** The bit of the counter telling whether it is shared. */
+    static constexpr uint32_t SHARED = 0x80000000;
+
+    std::atomic<uint32_t> m_count;
+};
+
 } // namespace ns3
 
 #endif /* ATOMIC_COUNTER_H */
@@ -27,8 +27,11 @@
 #include "ptr.h"
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -279,7 +282,55 @@ class CallbackImpl : public CallbackImplBase
      */
     R operator()(UArgs... uargs) const
     {
-        return m_func(uargs...);
+        if (m_invoke != nullptr)
+        {
+            return m_invoke(m_binding, std::forward<UArgs>(uargs)...);
+        }
+        return m_func(std::forward<UArgs>(uargs)...);
+    }
+
+    /**
+     * Invoke a member function directly on its object when called.
+     *
+     * Callbacks made of a member function and the object to invoke it on
+     * are the most common kind.  For these, the member function pointer and
+     * a raw pointer to the object are stored inline, and calls go through a
+     * single indirect call instead of the nested std::function calls of the
+     * stored function.  The stored function, which must make the same call,
+     * keeps the object alive.  As the stored function passes a smart pointer
+     * to the object by value, the object cannot be destroyed by the call it
+     * is running (e.g., a socket closing itself from a receive callback); if
+     * KeepAlive is true, a reference to the object is held during the call
+     * for the same reason.
+     *
+     * \tparam KeepAlive Whether the object is reference counted and must be
+     *         kept alive during the call.
+     * \tparam MemPtr \deduced The type of the member function pointer.
+     * \tparam Obj \deduced The type of the object.
+     * \param memPtr The member function pointer.
+     * \param obj The object.
+     */
+    template <bool KeepAlive, typename MemPtr, typename Obj>
+    void SetMemberBinding(MemPtr memPtr, Obj* obj)
+    {
+        static_assert(sizeof(MemberBinding<MemPtr, Obj>) <= sizeof(m_binding));
+        new (m_binding) MemberBinding<MemPtr, Obj>{memPtr, obj};
+        m_invoke = &InvokeMember<KeepAlive, MemPtr, Obj>;
+    }
+
+    /**
+     * Check whether a member function binding fits in the inline storage.
+     *
+     * \tparam MemPtr The type of the member function pointer.
+     * \tparam Obj The type of the object.
+     * \return \c true if SetMemberBinding() can be used.
+     */
+    template <typename MemPtr, typename Obj>
+    static constexpr bool CanBindMember()
+    {
+        return sizeof(MemberBinding<MemPtr, Obj>) <= BINDING_SIZE &&
+               alignof(MemberBinding<MemPtr, Obj>) <= alignof(std::max_align_t) &&
+               std::is_invocable_r_v<R, MemPtr, Obj*, UArgs...>;
     }
 
     bool IsEqual(Ptr<const CallbackImplBase> other) const override
@@ -344,11 +395,62 @@ class CallbackImpl : public CallbackImplBase
     }
 
   private:
+    /**
+     * A member function pointer and the object to invoke it on.
+     *
+     * \tparam MemPtr The type of the member function pointer.
+     * \tparam Obj The type of the object.
+     */
+    template <typename MemPtr, typename Obj>
+    struct MemberBinding
+    {
+        MemPtr memPtr; //!< the member function pointer
+        Obj* obj;      //!< the object
+    };
+
+    /**
+     * Invoke the member function binding stored inline.
+     *
+     * \tparam KeepAlive Whether to hold a reference to the object during the call.
+     * \tparam MemPtr The type of the member function pointer.
+     * \tparam Obj The type of the object.
+     * \param binding The inline storage.
+     * \param uargs The arguments to the Callback.
+     * \return Callback value
+     */
+    template <bool KeepAlive, typename MemPtr, typename Obj>
+    static R InvokeMember(const void* binding, UArgs... uargs)
+    {
+        const auto b = std::launder(static_cast<const MemberBinding<MemPtr, Obj>*>(binding));
+        if constexpr (KeepAlive)
+        {
+            Ptr<Obj> obj(b->obj);
+            return std::invoke(b->memPtr, PeekPointer(obj), std::forward<UArgs>(uargs)...);
+        }
+        else if constexpr (std::is_void_v<R>)
+        {
+            std::invoke(b->memPtr, b->obj, std::forward<UArgs>(uargs)...);
+        }
+        else
+        {
+            return std::invoke(b->memPtr, b->obj, std::forward<UArgs>(uargs)...);
+        }
+    }
+
+    /// Size of the inline storage for member function bindings
+    static constexpr std::size_t BINDING_SIZE = 4 * sizeof(void*);
+
     /// Stores the callable object associated with this callback (as a lambda)
     std::function<R(UArgs...)> m_func;
 
     /// Stores the original callable object and the bound arguments, if any
     std::vector<std::shared_ptr<CallbackComponentBase>> m_components;
+
+    /// Invoker of the member function binding, if any
+    R (*m_invoke)(const void*, UArgs...){nullptr};
+
+    /// Inline storage of the member function binding, if any
+    alignas(std::max_align_t) unsigned char m_binding[BINDING_SIZE];
 };
 
 /**
@@ -511,9 +613,45 @@ class Callback : public CallbackBase
                 return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
             },
             components);
+
+        // a member function bound to a plain or smart pointer to its object
+        if constexpr (std::is_member_function_pointer_v<T> && sizeof...(BArgs) == 1)
+        {
+            if constexpr (requires { PeekObject(bargs...); })
+            {
+                using Obj = std::remove_pointer_t<decltype(PeekObject(bargs...))>;
+                if constexpr (CallbackImpl<R, UArgs...>::template CanBindMember<T, Obj>())
+                {
+                    // hold a reference during the call, as the stored function does
+                    constexpr bool keepAlive = (!std::is_pointer_v<BArgs> && ...);
+                    DoPeekImpl()->template SetMemberBinding<keepAlive>(func,
+                                                                       PeekObject(bargs...));
+                }
+            }
+        }
     }
 
   private:
+    /**
+     * Get a raw pointer to the object a member function is bound to.
+     *
+     * \tparam U \deduced The type of the object.
+     * \param obj The pointer to the object.
+     * \return The raw pointer to the object.
+     */
+    template <typename U>
+    static U* PeekObject(U* obj)
+    {
+        return obj;
+    }
+
+    /** \copydoc PeekObject(U*) */
+    template <typename U>
+    static U* PeekObject(const Ptr<U>& obj)
+    {
+        return PeekPointer(obj);
+    }
+
     /**
      * Implementation of the Bind method
      *
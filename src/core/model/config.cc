@@ -23,10 +23,17 @@
 #include "names.h"
 #include "object-ptr-container.h"
 #include "object.h"
+#include "parallel-construction.h"
 #include "pointer.h"
+#include "simulator.h"
 #include "singleton.h"
+#include "uinteger.h"
 
+#include <algorithm>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 
 /**
  * \file
@@ -197,6 +204,9 @@ MatchContainer::DisconnectWithoutContext(std::string name, const CallbackBase& c
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, when the matcher is constructed,
+ * into a list of index ranges.
  */
 class ArrayMatcher
 {
@@ -214,8 +224,24 @@ class ArrayMatcher
      * \returns \c true if the index matches the Config Path.
      */
     bool Matches(std::size_t i) const;
+    /**
+     * Get the sorted list of indexes matching the Config Path, if they are
+     * all smaller than \pname{n}.
+     *
+     * \param [in] n The number of entries in the container.
+     * \param [out] indexes The matching indexes.
+     * \returns \c false if the Config Path may match an index greater than
+     *          or equal to \pname{n}.
+     */
+    bool GetIndexes(std::size_t n, std::vector<std::size_t>* indexes) const;
 
   private:
+    /**
+     * Parse a Config path specification, or one of its alternatives.
+     *
+     * \param [in] element The Config path specification.
+     */
+    void Parse(std::string element);
     /**
      * Convert a string to an \c uint32_t.
      *
@@ -226,75 +252,109 @@ class ArrayMatcher
     bool StringToUint32(std::string str, uint32_t* value) const;
     /** The Config path element. */
     std::string m_element;
+    /** Whether the Config path element matches any index. */
+    bool m_all;
+    /** The inclusive index ranges matching the Config path element. */
+    std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
 
 }; // class ArrayMatcher
 
 ArrayMatcher::ArrayMatcher(std::string element)
-    : m_element(element)
+    : m_element(element),
+      m_all(false)
 {
     NS_LOG_FUNCTION(this << element);
+    Parse(element);
+}
+
+void
+ArrayMatcher::Parse(std::string element)
+{
+    NS_LOG_FUNCTION(this << element);
+    if (element == "*")
+    {
+        m_all = true;
+        return;
+    }
+    std::string::size_type tmp;
+    tmp = element.find('|');
+    if (tmp != std::string::npos)
+    {
+        Parse(element.substr(0, tmp - 0));
+        Parse(element.substr(tmp + 1, element.size() - (tmp + 1)));
+        return;
+    }
+    std::string::size_type leftBracket = element.find('[');
+    std::string::size_type rightBracket = element.find(']');
+    std::string::size_type dash = element.find('-');
+    if (leftBracket == 0 && rightBracket == element.size() - 1 && dash > leftBracket &&
+        dash < rightBracket)
+    {
+        std::string lowerBound = element.substr(leftBracket + 1, dash - (leftBracket + 1));
+        std::string upperBound = element.substr(dash + 1, rightBracket - (dash + 1));
+        uint32_t min;
+        uint32_t max;
+        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && min <= max)
+        {
+            m_ranges.emplace_back(min, max);
+        }
+        return;
+    }
+    uint32_t value;
+    if (StringToUint32(element, &value))
+    {
+        m_ranges.emplace_back(value, value);
+    }
 }
 
 bool
 ArrayMatcher::Matches(std::size_t i) const
 {
     NS_LOG_FUNCTION(this << i);
-    if (m_element == "*")
+    if (m_all)
     {
         NS_LOG_DEBUG("Array " << i << " matches *");
         return true;
     }
-    std::string::size_type tmp;
-    tmp = m_element.find('|');
-    if (tmp != std::string::npos)
+    for (const auto& range : m_ranges)
     {
-        std::string left = m_element.substr(0, tmp - 0);
-        std::string right = m_element.substr(tmp + 1, m_element.size() - (tmp + 1));
-        ArrayMatcher matcher = ArrayMatcher(left);
-        if (matcher.Matches(i))
+        if (i >= range.first && i <= range.second)
         {
-            NS_LOG_DEBUG("Array " << i << " matches " << left);
-            return true;
-        }
-        matcher = ArrayMatcher(right);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << right);
+            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
             return true;
         }
-        NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
+    }
+    NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
+    return false;
+}
+
+bool
+ArrayMatcher::GetIndexes(std::size_t n, std::vector<std::size_t>* indexes) const
+{
+    NS_LOG_FUNCTION(this << n << indexes);
+    indexes->clear();
+    if (m_all)
+    {
         return false;
     }
-    std::string::size_type leftBracket = m_element.find('[');
-    std::string::size_type rightBracket = m_element.find(']');
-    std::string::size_type dash = m_element.find('-');
-    if (leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
-        dash < rightBracket)
+    for (const auto& range : m_ranges)
     {
-        std::string lowerBound = m_element.substr(leftBracket + 1, dash - (leftBracket + 1));
-        std::string upperBound = m_element.substr(dash + 1, rightBracket - (dash + 1));
-        uint32_t min;
-        uint32_t max;
-        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && i >= min &&
-            i <= max)
+        if (range.second >= n)
         {
-            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-            return true;
+            indexes->clear();
+            return false;
         }
-        else
+        for (std::size_t i = range.first; i <= range.second; i++)
         {
-            NS_LOG_DEBUG("Array " << i << " does not " << m_element);
-            return false;
+            indexes->push_back(i);
         }
     }
-    uint32_t value;
-    if (StringToUint32(m_element, &value) && i == value)
+    if (m_ranges.size() > 1)
     {
-        NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-        return true;
+        std::sort(indexes->begin(), indexes->end());
+        indexes->erase(std::unique(indexes->begin(), indexes->end()), indexes->end());
     }
-    NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
-    return false;
+    return true;
 }
 
 bool
@@ -310,6 +370,13 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The Config path is compiled once, when the Resolver is constructed, into
+ * a list of segments, and is then resolved by segment index.  The
+ * attributes matching a segment are cached by TypeId, the container
+ * attributes are accessed by index when the segment only names indexes
+ * within the container, and, when built with NS3_MTP, large containers
+ * such as the NodeList are resolved in parallel.
  */
 class Resolver
 {
@@ -333,23 +400,95 @@ class Resolver
     void Resolve(Ptr<Object> root);
 
   private:
+    /** An object or container attribute matching a Config path segment. */
+    struct AttributeMatch
+    {
+        std::string name;                            //!< The attribute name.
+        bool isPointer;                              //!< Whether the attribute is a pointer.
+        bool isGettable;                             //!< Whether the attribute is gettable.
+        Ptr<const AttributeAccessor> accessor;       //!< The attribute accessor.
+        const ObjectPtrContainerAccessor* container; //!< The container accessor, if any.
+    };
+
+    /** An object found on the Config path, and its index in its container. */
+    typedef std::pair<std::size_t, Ptr<Object>> Item;
+
+    /** One element of the compiled Config path. */
+    struct Segment
+    {
+        std::string item;     //!< The path element.
+        bool isNames;         //!< Whether the element starts the "/Names" namespace.
+        bool isTid;           //!< Whether the element is a "$TypeId" element.
+        bool hasTid;          //!< Whether the "$TypeId" element names a registered TypeId.
+        TypeId tid;           //!< The TypeId of a "$TypeId" element.
+        ArrayMatcher matcher; //!< The element, as an index into a container.
+        /** The attributes matching the element, by instance TypeId uid. */
+        std::unordered_map<uint16_t, std::vector<AttributeMatch>> attributes;
+    };
+
+    /** A Resolver collecting the objects found by a worker thread. */
+    class CollectingResolver;
+
     /** Ensure the Config path starts and ends with a '/'. */
     void Canonicalize();
+    /** Split the Config path into segments. */
+    void Compile();
     /**
      * Parse the next element in the Config path.
      *
-     * \param [in] path The remaining portion of the Config path.
+     * \param [in] segment The index of the next Config path segment.
      * \param [in] root The object corresponding to the current position
      *                  in the Config path.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    void DoResolve(std::size_t segment, Ptr<Object> root);
     /**
      * Parse an index on the Config path.
      *
-     * \param [in] path The remaining Config path.
-     * \param [in,out] vector The resulting list of matching objects.
+     * \param [in] segment The index of the Config path segment.
+     * \param [in] root The object holding the container.
+     * \param [in] attribute The container attribute.
+     */
+    void DoArrayResolve(std::size_t segment, Ptr<Object> root, const AttributeMatch& attribute);
+    /**
+     * Resolve the rest of the Config path from some container entries.
+     *
+     * \param [in] segment The index of the next Config path segment.
+     * \param [in] items The container entries.
+     * \param [in] begin The first entry to resolve.
+     * \param [in] end The entry past the last entry to resolve.
+     */
+    void DoResolveItems(std::size_t segment,
+                        const std::vector<Item>& items,
+                        std::size_t begin,
+                        std::size_t end);
+#ifdef NS3_MTP
+    /**
+     * Get the number of threads resolving a large container in parallel,
+     * which is the MaxThreads of the multithreaded simulator, or 1 when
+     * called from within the simulation.
+     *
+     * \returns The number of threads.
+     */
+    static uint32_t GetResolveThreadCount();
+#endif
+    /**
+     * Get the attributes of a TypeId matching a Config path segment.
+     *
+     * \param [in] segment The Config path segment.
+     * \param [in] tid The instance TypeId of the current object.
+     * \returns The matching attributes.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    const std::vector<AttributeMatch>& GetAttributes(Segment& segment, TypeId tid);
+    /**
+     * Get the value of an attribute.
+     *
+     * \param [in] object The object.
+     * \param [in] attribute The attribute.
+     * \param [out] value The attribute value.
+     */
+    void GetAttributeValue(Ptr<Object> object,
+                           const AttributeMatch& attribute,
+                           AttributeValue& value) const;
     /**
      * Handle one object found on the path.
      *
@@ -370,18 +509,60 @@ class Resolver
      */
     virtual void DoOne(Ptr<Object> object, std::string path) = 0;
 
-    /** Current list of path tokens. */
-    std::vector<std::string> m_workStack;
+    /**
+     * The minimum number of container entries resolved by each thread,
+     * when resolving in parallel.
+     */
+    static constexpr std::size_t PARALLEL_GRAIN = 256;
+
+    /** The Config path, as resolved so far. */
+    std::string m_resolved;
+    /** The compiled Config path. */
+    std::vector<Segment> m_segments;
     /** The Config path. */
     std::string m_path;
+    /** Whether this Resolver runs in a worker thread. */
+    bool m_worker;
 
 }; // class Resolver
 
+/**
+ * \ingroup config-impl
+ * A Resolver resolving part of a container on behalf of another Resolver,
+ * and collecting the objects found, to be handed back in order.
+ */
+class Resolver::CollectingResolver : public Resolver
+{
+  public:
+    /**
+     * Construct from the Resolver to work for.
+     *
+     * \param [in] parent The Resolver to work for.
+     */
+    CollectingResolver(const Resolver& parent)
+        : Resolver(parent)
+    {
+        m_worker = true;
+    }
+
+    void DoOne(Ptr<Object> object, std::string path) override
+    {
+        m_objects.push_back(object);
+        m_contexts.push_back(path);
+    }
+
+    std::vector<Ptr<Object>> m_objects;  //!< The objects found.
+    std::vector<std::string> m_contexts; //!< The Config paths of the objects found.
+};
+
 Resolver::Resolver(std::string path)
-    : m_path(path)
+    : m_resolved("/"),
+      m_path(path),
+      m_worker(false)
 {
     NS_LOG_FUNCTION(this << path);
     Canonicalize();
+    Compile();
 }
 
 Resolver::~Resolver()
@@ -409,25 +590,41 @@ Resolver::Canonicalize()
     }
 }
 
+void
+Resolver::Compile()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::string::size_type start = 1;
+    while (start < m_path.size())
+    {
+        std::string::size_type next = m_path.find('/', start);
+        std::string item = m_path.substr(start, next - start);
+        start = next + 1;
+
+        Segment segment{item, item.compare(0, 5, "Names") == 0, false, false, TypeId(), item, {}};
+        if (item.find('$') == 0)
+        {
+            segment.isTid = true;
+            segment.hasTid = TypeId::LookupByNameFailSafe(item.substr(1), &segment.tid);
+        }
+        m_segments.push_back(std::move(segment));
+    }
+}
+
 void
 Resolver::Resolve(Ptr<Object> root)
 {
     NS_LOG_FUNCTION(this << root);
 
-    DoResolve(m_path, root);
+    DoResolve(0, root);
 }
 
 std::string
 Resolver::GetResolvedPath() const
 {
     NS_LOG_FUNCTION(this);
-
-    std::string fullPath = "/";
-    for (auto i = m_workStack.begin(); i != m_workStack.end(); i++)
-    {
-        fullPath += *i + "/";
-    }
-    return fullPath;
+    return m_resolved;
 }
 
 void
@@ -439,14 +636,77 @@ Resolver::DoResolveOne(Ptr<Object> object)
     DoOne(object, GetResolvedPath());
 }
 
+const std::vector<Resolver::AttributeMatch>&
+Resolver::GetAttributes(Segment& segment, TypeId tid)
+{
+    NS_LOG_FUNCTION(this << segment.item << tid);
+
+    auto [it, inserted] = segment.attributes.try_emplace(tid.GetUid());
+    if (!inserted)
+    {
+        return it->second;
+    }
+    TypeId instanceTid = tid;
+    TypeId nextTid = tid;
+    do
+    {
+        tid = nextTid;
+
+        for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+        {
+            TypeId::AttributeInformation info;
+            info = tid.GetAttribute(i);
+            if (info.name != segment.item && segment.item != "*")
+            {
+                continue;
+            }
+            // only pointers and object vectors lead further down the path.
+            bool isPointer =
+                dynamic_cast<const PointerChecker*>(PeekPointer(info.checker)) != nullptr;
+            bool isContainer =
+                dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker)) !=
+                nullptr;
+            if (!isPointer && !isContainer)
+            {
+                continue;
+            }
+            // the attribute is always got by name, as ObjectBase::GetAttribute would.
+            instanceTid.LookupAttributeByName(info.name, &info);
+            bool isGettable = (info.flags & TypeId::ATTR_GET) && info.accessor->HasGetter();
+            const auto container =
+                dynamic_cast<const ObjectPtrContainerAccessor*>(PeekPointer(info.accessor));
+            it->second.push_back({info.name,
+                                  isPointer,
+                                  isGettable,
+                                  info.accessor,
+                                  isGettable ? container : nullptr});
+        }
+
+        nextTid = tid.GetParent();
+    } while (nextTid != tid);
+
+    return it->second;
+}
+
+void
+Resolver::GetAttributeValue(Ptr<Object> object,
+                            const AttributeMatch& attribute,
+                            AttributeValue& value) const
+{
+    NS_LOG_FUNCTION(this << object << attribute.name << &value);
+    if (!attribute.isGettable || !attribute.accessor->Get(PeekPointer(object), value))
+    {
+        // Let ObjectBase::GetAttribute raise any errors
+        object->GetAttribute(attribute.name, value);
+    }
+}
+
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Resolver::DoResolve(std::size_t segment, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << segment << root);
 
-    if (next == std::string::npos)
+    if (segment == m_segments.size())
     {
         //
         // If root is zero, we're beginning to see if we can use the object name
@@ -462,8 +722,9 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
         }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    Segment& current = m_segments[segment];
+    const std::string& item = current.item;
+    std::string::size_type mark = m_resolved.size();
 
     //
     // If root is zero, we're beginning to see if we can use the object name
@@ -474,12 +735,11 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     //
     if (!root)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
+        if (current.isNames)
         {
-            m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
-            m_workStack.pop_back();
+            m_resolved += item + "/";
+            DoResolve(segment + 1, root);
+            m_resolved.resize(mark);
             return;
         }
     }
@@ -494,9 +754,9 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     if (namedObject)
     {
         NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
-        m_workStack.pop_back();
+        m_resolved += item + "/";
+        DoResolve(segment + 1, namedObject);
+        m_resolved.resize(mark);
         return;
     }
 
@@ -511,85 +771,62 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         return;
     }
-    std::string::size_type dollarPos = item.find('$');
-    if (dollarPos == 0)
+    if (current.isTid)
     {
         // This is a call to GetObject
-        std::string tidString = item.substr(1, item.size() - 1);
-        NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
-        TypeId tid = TypeId::LookupByName(tidString);
+        NS_LOG_DEBUG("GetObject=" << item.substr(1) << " on path=" << GetResolvedPath());
+        // Let TypeId::LookupByName raise any errors
+        TypeId tid = current.hasTid ? current.tid : TypeId::LookupByName(item.substr(1));
         Ptr<Object> object = root->GetObject<Object>(tid);
         if (!object)
         {
-            NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
+            NS_LOG_DEBUG("GetObject (" << item.substr(1)
+                                       << ") failed on path=" << GetResolvedPath());
             return;
         }
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
-        m_workStack.pop_back();
+        m_resolved += item + "/";
+        DoResolve(segment + 1, object);
+        m_resolved.resize(mark);
     }
     else
     {
         // this is a normal attribute.
-        TypeId tid;
-        TypeId nextTid = root->GetInstanceTypeId();
+        const std::vector<AttributeMatch>& attributes =
+            GetAttributes(current, root->GetInstanceTypeId());
         bool foundMatch = false;
 
-        do
+        for (const auto& attribute : attributes)
         {
-            tid = nextTid;
-
-            for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+            if (attribute.isPointer)
             {
-                TypeId::AttributeInformation info;
-                info = tid.GetAttribute(i);
-                if (info.name != item && item != "*")
+                NS_LOG_DEBUG("GetAttribute(ptr)=" << attribute.name
+                                                  << " on path=" << GetResolvedPath());
+                PointerValue pValue;
+                GetAttributeValue(root, attribute, pValue);
+                Ptr<Object> object = pValue.Get<Object>();
+                if (!object)
                 {
+                    NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
+                                                            << GetResolvedPath()
+                                                            << "\""
+                                                               " but is null.");
                     continue;
                 }
-                // attempt to cast to a pointer checker.
-                const auto pChecker =
-                    dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
-                if (pChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name
-                                                      << " on path=" << GetResolvedPath());
-                    PointerValue pValue;
-                    root->GetAttribute(info.name, pValue);
-                    Ptr<Object> object = pValue.Get<Object>();
-                    if (!object)
-                    {
-                        NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
-                                                                << GetResolvedPath()
-                                                                << "\""
-                                                                   " but is null.");
-                        continue;
-                    }
-                    foundMatch = true;
-                    m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
-                    m_workStack.pop_back();
-                }
-                // attempt to cast to an object vector.
-                const auto vectorChecker =
-                    dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
-                if (vectorChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
-                    foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
-                    m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
-                    m_workStack.pop_back();
-                }
-                // this could be anything else and we don't know what to do with it.
-                // So, we just ignore it.
+                foundMatch = true;
+                m_resolved += attribute.name + "/";
+                DoResolve(segment + 1, object);
+                m_resolved.resize(mark);
             }
-
-            nextTid = tid.GetParent();
-        } while (nextTid != tid);
+            else
+            {
+                NS_LOG_DEBUG("GetAttribute(vector)=" << attribute.name
+                                                     << " on path=" << GetResolvedPath());
+                foundMatch = true;
+                m_resolved += attribute.name + "/";
+                DoArrayResolve(segment + 1, root, attribute);
+                m_resolved.resize(mark);
+            }
+        }
 
         if (!foundMatch)
         {
@@ -601,32 +838,143 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::size_t segment, Ptr<Object> root, const AttributeMatch& attribute)
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(!path.empty());
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
+    NS_LOG_FUNCTION(this << segment << root << attribute.name);
+    if (segment == m_segments.size())
+    {
+        return;
+    }
+    const ArrayMatcher& matcher = m_segments[segment].matcher;
+    std::vector<Item> items;
+
+    //
+    // If the path names only indexes within the container, look them up
+    // directly rather than getting the whole container.  This only works
+    // when the indexes are the positions in the container, as for the
+    // ObjectVector attributes; otherwise, fall back to getting the container.
+    //
+    std::size_t n;
+    std::vector<std::size_t> indexes;
+    bool direct = attribute.container && attribute.container->GetN(PeekPointer(root), &n) &&
+                  matcher.GetIndexes(n, &indexes);
+    if (direct)
+    {
+        for (auto i : indexes)
+        {
+            std::size_t index;
+            Ptr<Object> object = attribute.container->Get(PeekPointer(root), i, &index);
+            if (index != i)
+            {
+                break;
+            }
+            items.emplace_back(i, object);
+        }
+        if (items.size() != indexes.size())
+        {
+            items.clear();
+            direct = false;
+        }
+    }
+    if (!direct)
     {
+        ObjectPtrContainerValue container;
+        GetAttributeValue(root, attribute, container);
+        for (auto it = container.Begin(); it != container.End(); ++it)
+        {
+            if (matcher.Matches((*it).first))
+            {
+                items.push_back(*it);
+            }
+        }
+    }
+
+#ifdef NS3_MTP
+    //
+    // Resolve large containers, such as the NodeList, in parallel.  The
+    // objects found are handed to DoOne() in the same order as if they had
+    // been resolved sequentially.
+    //
+    std::size_t nThreads = m_worker ? 1 : items.size() / PARALLEL_GRAIN;
+    if (nThreads > 1)
+    {
+        nThreads = std::min<std::size_t>(nThreads, GetResolveThreadCount());
+    }
+    if (nThreads > 1)
+    {
+        NS_LOG_DEBUG("Resolve " << items.size() << " items with " << nThreads << " threads");
+        std::vector<CollectingResolver> workers(nThreads, CollectingResolver(*this));
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < nThreads; t++)
+        {
+            std::size_t begin = items.size() * t / nThreads;
+            std::size_t end = items.size() * (t + 1) / nThreads;
+            threads.emplace_back([&workers, &items, segment, t, begin, end]() {
+                workers[t].DoResolveItems(segment + 1, items, begin, end);
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        for (const auto& worker : workers)
+        {
+            for (std::size_t i = 0; i < worker.m_objects.size(); i++)
+            {
+                DoOne(worker.m_objects[i], worker.m_contexts[i]);
+            }
+        }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+#endif
+
+    DoResolveItems(segment + 1, items, 0, items.size());
+}
 
-    ArrayMatcher matcher = ArrayMatcher(item);
-    ObjectPtrContainerValue::Iterator it;
-    for (it = container.Begin(); it != container.End(); ++it)
+#ifdef NS3_MTP
+uint32_t
+Resolver::GetResolveThreadCount()
+{
+    //
+    // Never start threads from within the simulation, where the thread may
+    // be running a logical process, or from an item of ParallelConstruction,
+    // which already runs on its own threads.
+    //
+    if (ParallelConstruction::IsActive() || Simulator::GetSystemId() != 0)
     {
-        if (matcher.Matches((*it).first))
+        return 1;
+    }
+
+    // reuse the thread count of the multithreaded simulator
+    TypeId tid;
+    TypeId::AttributeInformation info;
+    if (TypeId::LookupByNameFailSafe("ns3::MultithreadedSimulatorImpl", &tid) &&
+        tid.LookupAttributeByName("MaxThreads", &info))
+    {
+        Ptr<const UintegerValue> maxThreads = DynamicCast<const UintegerValue>(info.initialValue);
+        if (maxThreads)
         {
-            std::ostringstream oss;
-            oss << (*it).first;
-            m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
-            m_workStack.pop_back();
+            return std::max<uint32_t>(maxThreads->Get(), 1);
         }
     }
+    return 1;
+}
+#endif
+
+void
+Resolver::DoResolveItems(std::size_t segment,
+                         const std::vector<Item>& items,
+                         std::size_t begin,
+                         std::size_t end)
+{
+    NS_LOG_FUNCTION(this << segment << &items << begin << end);
+    std::string::size_type mark = m_resolved.size();
+    for (std::size_t i = begin; i < end; i++)
+    {
+        m_resolved += std::to_string(items[i].first) + "/";
+        DoResolve(segment, items[i].second);
+        m_resolved.resize(mark);
+    }
 }
 
 /**
@@ -0,0 +1,185 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "deadline-timer.h"
+
+#include "assert.h"
+#include "log.h"
+#include "simulator.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::DeadlineTimer timer class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("DeadlineTimer");
+
+void
+DeadlineTimer::Event::Schedule(const Time& delay)
+{
+    EventId id = Simulator::Schedule(delay, Ptr<EventImpl>(this));
+    m_pending = true;
+    m_ts = id.GetTs();
+    m_context = id.GetContext();
+    m_uid = id.GetUid();
+}
+
+void
+DeadlineTimer::Event::Notify()
+{
+    m_pending = false;
+    if (!m_armed)
+    {
+        return;
+    }
+    int64_t now = Simulator::Now().GetTimeStep();
+    if (now < m_deadline)
+    {
+        // re-armed since scheduled
+        Schedule(TimeStep(m_deadline - now));
+        return;
+    }
+    m_armed = false;
+    m_fn();
+}
+
+DeadlineTimer::DeadlineTimer()
+    : m_event(nullptr)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+DeadlineTimer&
+DeadlineTimer::operator=(const EventId& event)
+{
+    NS_LOG_FUNCTION(this << event.GetUid());
+    if (m_event)
+    {
+        m_event->m_armed = false;
+    }
+    m_external = event;
+    return *this;
+}
+
+void
+DeadlineTimer::SetFunction(const Callback<void>& fn)
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_event)
+    {
+        m_event = Create<Event>();
+    }
+    m_event->m_fn = fn;
+}
+
+void
+DeadlineTimer::Schedule(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay);
+    NS_ASSERT_MSG(m_event, "The function of the timer is not set");
+    NS_ASSERT(delay.IsPositive());
+    if (m_external.PeekEventImpl())
+    {
+        m_external.Cancel();
+        m_external = EventId();
+    }
+    int64_t deadline = Simulator::Now().GetTimeStep() + delay.GetTimeStep();
+    if (m_event->m_pending && static_cast<int64_t>(m_event->m_ts) > deadline)
+    {
+        // the event scheduled is too late: cancel it and use a new one
+        NS_LOG_LOGIC("Replace the event at " << m_event->m_ts);
+        m_event->Cancel();
+        Ptr<Event> event = Create<Event>();
+        event->m_fn = m_event->m_fn;
+        m_event = event;
+    }
+    m_event->m_deadline = deadline;
+    m_event->m_armed = true;
+    if (!m_event->m_pending)
+    {
+        m_event->Schedule(delay);
+    }
+}
+
+void
+DeadlineTimer::Cancel()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_external.PeekEventImpl())
+    {
+        m_external.Cancel();
+        m_external = EventId();
+    }
+    if (m_event)
+    {
+        m_event->m_armed = false;
+    }
+}
+
+void
+DeadlineTimer::Remove()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_external.PeekEventImpl())
+    {
+        m_external.Remove();
+        m_external = EventId();
+    }
+    if (!m_event)
+    {
+        return;
+    }
+    m_event->m_armed = false;
+    if (m_event->m_pending)
+    {
+        // removing the event cancels it: use a new one from now on
+        Simulator::Remove(EventId(m_event, m_event->m_ts, m_event->m_context, m_event->m_uid));
+        Ptr<Event> event = Create<Event>();
+        event->m_fn = m_event->m_fn;
+        m_event = event;
+    }
+}
+
+bool
+DeadlineTimer::IsRunning() const
+{
+    return (m_event && m_event->m_armed) || (m_external.PeekEventImpl() && m_external.IsRunning());
+}
+
+bool
+DeadlineTimer::IsExpired() const
+{
+    return !IsRunning();
+}
+
+Time
+DeadlineTimer::GetDelayLeft() const
+{
+    if (m_external.PeekEventImpl() && m_external.IsRunning())
+    {
+        return Simulator::GetDelayLeft(m_external);
+    }
+    if (!IsRunning())
+    {
+        return TimeStep(0);
+    }
+    return TimeStep(m_event->m_deadline - Simulator::Now().GetTimeStep());
+}
+
+} // namespace ns3
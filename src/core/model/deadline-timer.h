@@ -0,0 +1,146 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DEADLINE_TIMER_H
+#define DEADLINE_TIMER_H
+
+#include "callback.h"
+#include "event-id.h"
+#include "event-impl.h"
+#include "nstime.h"
+#include "ptr.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::DeadlineTimer timer class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup timer
+ * \brief A timer which can be cancelled and re-armed without scheduling a
+ * new event each time.
+ *
+ * Protocols often cancel a timer and schedule it again right away, e.g.,
+ * the retransmission timer of TCP on every new ACK.  With an EventId, each
+ * cycle allocates an event and leaves the cancelled one in the scheduler
+ * until its time comes.  A DeadlineTimer keeps a single event instead:
+ * Cancel() only disarms it, and Schedule() moves its deadline in place as
+ * long as the deadline is not before the time of the event scheduled.
+ * When the event is invoked before the deadline, it is scheduled again for
+ * the deadline; when it is invoked while the timer is disarmed, it does
+ * nothing.  Only a deadline earlier than the pending event needs a new
+ * event.
+ *
+ * As an EventId, a DeadlineTimer does not cancel its event when destroyed:
+ * the owner of the function must cancel the timer before the function
+ * becomes invalid.  Once cancelled, the function is never called, even if
+ * the event is still scheduled.  Unlike an EventId, a copy is not a handle
+ * on the same timer: a copy shares the pending event only until either of
+ * them schedules an earlier deadline or removes the event.
+ *
+ * For code written against an EventId, an event scheduled elsewhere may be
+ * assigned to a DeadlineTimer: it then stands for the timer, being
+ * cancelled by Cancel() and Remove(), and reported by IsRunning(),
+ * IsExpired() and GetDelayLeft(), until the timer is scheduled again.
+ */
+class DeadlineTimer
+{
+  public:
+    /** Constructor. */
+    DeadlineTimer();
+
+    /**
+     * Stand for an event scheduled elsewhere, as if the timer had been
+     * scheduled with this event.  The timer itself is disarmed.
+     *
+     * \param [in] event The event.
+     * \returns This timer.
+     */
+    DeadlineTimer& operator=(const EventId& event);
+
+    /**
+     * Set the function called when the timer expires, including by the
+     * expiry of a running timer.
+     *
+     * \param [in] fn The function.
+     */
+    void SetFunction(const Callback<void>& fn);
+
+    /**
+     * Arm the timer, whether it is running or not, so that it expires after
+     * the given delay.  The function must be set.
+     *
+     * \param [in] delay The delay.
+     */
+    void Schedule(const Time& delay);
+
+    /**
+     * Disarm the timer, if running.  The event scheduled, if any, is kept
+     * to be re-armed later.
+     */
+    void Cancel();
+
+    /**
+     * Disarm the timer, if running, and remove the event scheduled, if any,
+     * from the event list.
+     */
+    void Remove();
+
+    /** \returns \c true if the timer is armed. */
+    bool IsRunning() const;
+
+    /** \returns \c true if the timer is not armed. */
+    bool IsExpired() const;
+
+    /** \returns The time left until the timer expires, or zero if not armed. */
+    Time GetDelayLeft() const;
+
+  private:
+    /** The event of the timer, re-scheduled until the deadline is reached. */
+    class Event : public EventImpl
+    {
+      public:
+        /**
+         * Schedule the event.
+         *
+         * \param [in] delay The delay.
+         */
+        void Schedule(const Time& delay);
+
+        Callback<void> m_fn;   //!< The function called on expiry.
+        int64_t m_deadline{0}; //!< The time step at which the timer expires.
+        bool m_armed{false};   //!< Whether the timer is armed.
+        bool m_pending{false}; //!< Whether the event is in the event list.
+        uint64_t m_ts{0};      //!< The time step of the event, if pending.
+        uint32_t m_context{0}; //!< The context of the event, if pending.
+        uint32_t m_uid{0};     //!< The uid of the event, if pending.
+
+      private:
+        void Notify() override;
+    };
+
+    /** The event of the timer, or nullptr if no function was set. */
+    Ptr<Event> m_event;
+    /** The event scheduled elsewhere standing for the timer, if any. */
+    EventId m_external;
+};
+
+} // namespace ns3
+
+#endif /* DEADLINE_TIMER_H */
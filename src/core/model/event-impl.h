@@ -42,7 +42,7 @@ namespace ns3
  * are usually created by one of the many Simulator::Schedule
  * methods.
  */
-class EventImpl : public SimpleRefCount<EventImpl>
+class EventImpl : public SimpleRefCount<EventImpl, Empty, DefaultDeleter<EventImpl>, OwnedCounter>
 {
   public:
     /** Default constructor. */
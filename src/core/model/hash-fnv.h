@@ -94,6 +94,29 @@ class Fnv1a : public Implementation
      */
     void clear() override;
 
+    /**
+     * Compute the 32-bit hash of a byte buffer in one shot.
+     *
+     * The result is the same as GetHash32() on a cleared Fnv1a, but no
+     * object or state is involved, so this can be called from any thread
+     * without allocating a Hasher.
+     *
+     * \param [in] buffer pointer to the beginning of the buffer
+     * \param [in] size length of the buffer, in bytes
+     * \return 32-bit hash of the buffer
+     */
+    static uint32_t Hash32(const char* buffer, const size_t size);
+    /**
+     * Compute the 64-bit hash of a byte buffer in one shot.
+     *
+     * The result is the same as GetHash64() on a cleared Fnv1a.
+     *
+     * \param [in] buffer pointer to the beginning of the buffer
+     * \param [in] size length of the buffer, in bytes
+     * \return 64-bit hash of the buffer
+     */
+    static uint64_t Hash64(const char* buffer, const size_t size);
+
   private:
     /**
      * Seed value
@@ -108,6 +131,34 @@ class Fnv1a : public Implementation
 
 }; // class Fnv1a
 
+/*************************************************
+ **  Inline implementations
+ ************************************************/
+
+inline uint32_t
+Fnv1a::Hash32(const char* buffer, const size_t size)
+{
+    uint32_t hash = 0x811c9dc5; // FNV1_32A_INIT
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<uint8_t>(buffer[i]);
+        hash *= 0x01000193; // FNV_32_PRIME
+    }
+    return hash;
+}
+
+inline uint64_t
+Fnv1a::Hash64(const char* buffer, const size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL; // FNV1A_64_INIT
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<uint8_t>(buffer[i]);
+        hash *= 0x100000001b3ULL; // FNV_64_PRIME
+    }
+    return hash;
+}
+
 } // namespace Function
 
 } // namespace Hash
@@ -575,6 +575,29 @@ Murmur3::clear()
     m_size64 = 0;
 }
 
+uint32_t
+Murmur3::Hash32(const char* buffer, const std::size_t size)
+{
+    using namespace Murmur3Implementation;
+
+    uint32_t hash;
+    MurmurHash3_x86_32(buffer, size, (uint32_t)SEED, (void*)&hash);
+    return hash;
+}
+
+uint64_t
+Murmur3::Hash64(const char* buffer, const std::size_t size)
+{
+    using namespace Murmur3Implementation;
+
+    // see GetHash64() for the use of uint32_t
+    uint32_t hash[4];
+    MurmurHash3_x86_128(buffer, size, (uint32_t)SEED, hash);
+    uint64_t result = hash[1];
+    result = (result << 32) | hash[0];
+    return result;
+}
+
 } // namespace Function
 
 } // namespace Hash
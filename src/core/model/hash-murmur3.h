@@ -22,6 +22,8 @@
 
 #include "hash-function.h"
 
+#include <cstring>
+
 /**
  * \file
  * \ingroup hash
@@ -94,7 +96,61 @@ class Murmur3 : public Implementation
      */
     void clear() override;
 
+    /**
+     * Compute the 32-bit hash of a byte buffer in one shot.
+     *
+     * The result is the same as GetHash32() on a cleared Murmur3, but no
+     * object or state is involved, so this can be called from any thread
+     * without allocating a Hasher.
+     *
+     * \param [in] buffer pointer to the beginning of the buffer
+     * \param [in] size length of the buffer, in bytes
+     * \return 32-bit hash of the buffer
+     */
+    static uint32_t Hash32(const char* buffer, const std::size_t size);
+    /**
+     * Compute the 64-bit hash of a byte buffer in one shot.
+     *
+     * The result is the same as GetHash64() on a cleared Murmur3.
+     *
+     * \param [in] buffer pointer to the beginning of the buffer
+     * \param [in] size length of the buffer, in bytes
+     * \return 64-bit hash of the buffer
+     */
+    static uint64_t Hash64(const char* buffer, const std::size_t size);
+    /**
+     * Compute the 32-bit hash of a fixed-size byte buffer, such as a
+     * serialized 5-tuple, in one shot.
+     *
+     * The result is the same as Hash32(buffer, N).  Since the size is known
+     * at compile time, the hash is inlined and fully unrolled, and the
+     * mixing of the 4-byte blocks, which does not depend on the running
+     * hash, is done up front where the compiler can vectorize it.
+     *
+     * \tparam N length of the buffer, in bytes
+     * \param [in] buffer the buffer
+     * \return 32-bit hash of the buffer
+     */
+    template <std::size_t N>
+    static uint32_t Hash32(const uint8_t (&buffer)[N]);
+
   private:
+    /**
+     * Barrel shift (rotate) left on 32 bits.
+     *
+     * \param [in] x The initial value.
+     * \param [in] r The number of bit positions to rotate.
+     * \return The rotated value.
+     */
+    static uint32_t Rotl32(uint32_t x, int r);
+    /**
+     * Mix a 4-byte block before it enters the 32-bit hash.
+     *
+     * \param [in] k The block.
+     * \return The mixed block.
+     */
+    static uint32_t MixBlock32(uint32_t k);
+
     /**
      * Seed value
      *
@@ -120,6 +176,64 @@ class Murmur3 : public Implementation
 
 }; // class Murmur3
 
+/*************************************************
+ **  Inline implementations
+ ************************************************/
+
+inline uint32_t
+Murmur3::Rotl32(uint32_t x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+inline uint32_t
+Murmur3::MixBlock32(uint32_t k)
+{
+    return Rotl32(k * 0xcc9e2d51, 15) * 0x1b873593;
+}
+
+template <std::size_t N>
+uint32_t
+Murmur3::Hash32(const uint8_t (&buffer)[N])
+{
+    constexpr std::size_t nblocks = N / 4;
+
+    // body: mix all the blocks first, then fold them into the hash
+    uint32_t blocks[nblocks + 1];
+    for (std::size_t i = 0; i < nblocks; i++)
+    {
+        std::memcpy(&blocks[i], &buffer[4 * i], 4);
+        blocks[i] = MixBlock32(blocks[i]);
+    }
+    auto h1 = static_cast<uint32_t>(SEED);
+    for (std::size_t i = 0; i < nblocks; i++)
+    {
+        h1 ^= blocks[i];
+        h1 = Rotl32(h1, 13);
+        h1 = h1 * 5 + 0xe6546b64;
+    }
+
+    // tail
+    if constexpr ((N & 3) != 0)
+    {
+        uint32_t k1 = 0;
+        for (std::size_t i = N & 3; i > 0; i--)
+        {
+            k1 = (k1 << 8) | buffer[4 * nblocks + i - 1];
+        }
+        h1 ^= MixBlock32(k1);
+    }
+
+    // finalization
+    h1 ^= static_cast<uint32_t>(N);
+    h1 ^= h1 >> 16;
+    h1 *= 0x85ebca6b;
+    h1 ^= h1 >> 13;
+    h1 *= 0xc2b2ae35;
+    h1 ^= h1 >> 16;
+    return h1;
+}
+
 } // namespace Function
 
 } // namespace Hash
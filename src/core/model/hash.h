@@ -219,6 +219,19 @@ uint32_t Hash32(const std::string s);
  */
 uint64_t Hash64(const std::string s);
 
+/**
+ * \ingroup hash
+ *
+ * Compute 32-bit hash of a fixed-size byte buffer, such as a serialized
+ * 5-tuple, using the default hash function.
+ *
+ * \tparam N Length of the buffer, in bytes.
+ * \param [in] buffer The buffer.
+ * \return 32-bit hash of the buffer, the same as Hash32() of its N bytes.
+ */
+template <std::size_t N>
+uint32_t Hash32(const uint8_t (&buffer)[N]);
+
 } // namespace ns3
 
 /*************************************************
@@ -273,41 +286,32 @@ Hasher& GetStaticHash();
 inline uint32_t
 Hash32(const char* buffer, const std::size_t size)
 {
-#ifdef NS3_MTP
-    return Hasher().GetHash32(buffer, size);
-#else
-    return GetStaticHash().GetHash32(buffer, size);
-#endif
+    return Hash::Function::Murmur3::Hash32(buffer, size);
 }
 
 inline uint64_t
 Hash64(const char* buffer, const std::size_t size)
 {
-#ifdef NS3_MTP
-    return Hasher().GetHash64(buffer, size);
-#else
-    return GetStaticHash().GetHash64(buffer, size);
-#endif
+    return Hash::Function::Murmur3::Hash64(buffer, size);
 }
 
 inline uint32_t
 Hash32(const std::string s)
 {
-#ifdef NS3_MTP
-    return Hasher().GetHash32(s);
-#else
-    return GetStaticHash().GetHash32(s);
-#endif
+    return Hash::Function::Murmur3::Hash32(s.c_str(), s.size());
 }
 
 inline uint64_t
 Hash64(const std::string s)
 {
-#ifdef NS3_MTP
-    return Hasher().GetHash64(s);
-#else
-    return GetStaticHash().GetHash64(s);
-#endif
+    return Hash::Function::Murmur3::Hash64(s.c_str(), s.size());
+}
+
+template <std::size_t N>
+inline uint32_t
+Hash32(const uint8_t (&buffer)[N])
+{
+    return Hash::Function::Murmur3::Hash32(buffer);
 }
 
 } // namespace ns3
@@ -233,6 +233,25 @@ class ObjectPtrContainerAccessor : public AttributeAccessor
     bool HasGetter() const override;
     bool HasSetter() const override;
 
+    /**
+     * Get the number of instances in the container.
+     *
+     * \param [in] object The container object.
+     * \param [out] n The number of instances in the container.
+     * \returns true if the value could be obtained successfully.
+     */
+    bool GetN(const ObjectBase* object, std::size_t* n) const;
+    /**
+     * Get a single instance from the container, without building the
+     * whole ObjectPtrContainerValue.
+     *
+     * \param [in] object The container object.
+     * \param [in] i The position of the instance, smaller than GetN().
+     * \param [out] index The index of the instance.
+     * \returns The instance.
+     */
+    Ptr<Object> Get(const ObjectBase* object, std::size_t i, std::size_t* index) const;
+
   private:
     /**
      * Get the number of instances in the container.
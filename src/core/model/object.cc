@@ -26,6 +26,7 @@
 #include "object-factory.h"
 #include "string.h"
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
 #include <sstream>
@@ -96,11 +97,10 @@ Object::Object()
     : m_tid(Object::GetTypeId()),
       m_disposed(false),
       m_initialized(false),
-      m_aggregates((Aggregates*)std::malloc(sizeof(Aggregates))),
+      m_aggregates(AllocateAggregates(1)),
       m_getObjectCount(0)
 {
     NS_LOG_FUNCTION(this);
-    m_aggregates->n = 1;
     m_aggregates->buffer[0] = this;
 }
 
@@ -118,6 +118,10 @@ Object::~Object()
                          &m_aggregates->buffer[i + 1],
                          sizeof(Object*) * (m_aggregates->n - (i + 1)));
             m_aggregates->n--;
+#ifdef NS3_MTP
+            // the indices of the following Objects changed
+            std::memset(m_aggregates->cache, 0, sizeof(m_aggregates->cache));
+#endif
         }
     }
     // finally, if all objects have been removed from the list,
@@ -133,10 +137,9 @@ Object::Object(const Object& o)
     : m_tid(o.m_tid),
       m_disposed(false),
       m_initialized(false),
-      m_aggregates((Aggregates*)std::malloc(sizeof(Aggregates))),
+      m_aggregates(AllocateAggregates(1)),
       m_getObjectCount(0)
 {
-    m_aggregates->n = 1;
     m_aggregates->buffer[0] = this;
 }
 
@@ -153,6 +156,27 @@ Object::DoGetObject(TypeId tid) const
     NS_LOG_FUNCTION(this << tid);
     NS_ASSERT(CheckLoose());
 
+#ifdef NS3_MTP
+    // The aggregates are not reordered in MTP builds, since other threads may
+    // be iterating over them, so look for a previous lookup of this TypeId in
+    // the cache instead.  An entry is always valid for this list: its indices
+    // only change when an Object is removed, which clears the cache.
+    uint16_t uid = tid.GetUid();
+    uint32_t slot = uid & (AGGREGATES_CACHE_SIZE - 1);
+    for (uint32_t way = 0; way < 2; way++)
+    {
+        uint32_t entry = std::atomic_ref<uint32_t>(m_aggregates->cache[slot ^ way])
+                             .load(std::memory_order_relaxed);
+        uint32_t index = entry & 0xffff;
+        if ((entry >> 16) == uid && index != 0)
+        {
+            return index == AGGREGATES_NOT_FOUND
+                       ? nullptr
+                       : const_cast<Object*>(m_aggregates->buffer[index - 1]);
+        }
+    }
+#endif
+
     uint32_t n = m_aggregates->n;
     TypeId objectTid = Object::GetTypeId();
     for (uint32_t i = 0; i < n; i++)
@@ -176,14 +200,54 @@ Object::DoGetObject(TypeId tid) const
             current->m_getObjectCount++;
             // then, update the sort
             UpdateSortedArray(m_aggregates, i);
+#else
+            if (i + 1 < AGGREGATES_NOT_FOUND)
+            {
+                CacheLookup(uid, i + 1);
+            }
 #endif
             // finally, return the match
             return const_cast<Object*>(current);
         }
     }
+#ifdef NS3_MTP
+    CacheLookup(uid, AGGREGATES_NOT_FOUND);
+#endif
     return nullptr;
 }
 
+Object::Aggregates*
+Object::AllocateAggregates(uint32_t n)
+{
+    auto aggregates = (Aggregates*)std::malloc(sizeof(Aggregates) + (n - 1) * sizeof(Object*));
+    aggregates->n = n;
+#ifdef NS3_MTP
+    std::memset(aggregates->cache, 0, sizeof(aggregates->cache));
+#endif
+    return aggregates;
+}
+
+#ifdef NS3_MTP
+void
+Object::CacheLookup(uint16_t uid, uint32_t index) const
+{
+    // two-way associative: keep the entry of the first slot unless it is
+    // empty or already holds this TypeId
+    uint32_t slot = uid & (AGGREGATES_CACHE_SIZE - 1);
+    std::atomic_ref<uint32_t> first(m_aggregates->cache[slot]);
+    uint32_t entry = first.load(std::memory_order_relaxed);
+    if (entry == 0 || (entry >> 16) == uid)
+    {
+        first.store((uint32_t(uid) << 16) | index, std::memory_order_relaxed);
+    }
+    else
+    {
+        std::atomic_ref<uint32_t>(m_aggregates->cache[slot ^ 1])
+            .store((uint32_t(uid) << 16) | index, std::memory_order_relaxed);
+    }
+}
+#endif
+
 void
 Object::Initialize()
 {
@@ -269,8 +333,7 @@ Object::AggregateObject(Ptr<Object> o)
     Object* other = PeekPointer(o);
     // first create the new aggregate buffer.
     uint32_t total = m_aggregates->n + other->m_aggregates->n;
-    auto aggregates = (Aggregates*)std::malloc(sizeof(Aggregates) + (total - 1) * sizeof(Object*));
-    aggregates->n = total;
+    Aggregates* aggregates = AllocateAggregates(total);
 
     // copy our buffer to the new buffer
     std::memcpy(&aggregates->buffer[0],
@@ -343,10 +343,28 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      * variable sized buffer whose size is indicated by the element
      * \c n
      */
+#ifdef NS3_MTP
+    /** The number of entries of the DoGetObject() lookup cache. */
+    static constexpr uint32_t AGGREGATES_CACHE_SIZE = 16;
+    /** The lookup cache index of a TypeId aggregated to none of the Objects. */
+    static constexpr uint32_t AGGREGATES_NOT_FOUND = 0xffff;
+#endif
+
     struct Aggregates
     {
         /** The number of entries in \c buffer. */
         uint32_t n;
+#ifdef NS3_MTP
+        /**
+         * The results of the previous DoGetObject() lookups, indexed by the
+         * TypeId uid.  Each entry packs the uid in its upper 16 bits and the
+         * index in \c buffer of the matching Object plus one (or
+         * AGGREGATES_NOT_FOUND) in its lower 16 bits; 0 is an empty entry.
+         * The entries are read and written with relaxed atomic operations,
+         * so that the threads of the simulator can share the cache.
+         */
+        uint32_t cache[AGGREGATES_CACHE_SIZE];
+#endif
         /** The array of Objects. */
         Object* buffer[1];
     };
@@ -358,6 +376,24 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      * \return The matching Object, if it is found
      */
     Ptr<Object> DoGetObject(TypeId tid) const;
+    /**
+     * Allocate an empty list of aggregates.
+     *
+     * \param [in] n The number of entries in the list.
+     * \return The list, to be released with std::free().
+     */
+    static Aggregates* AllocateAggregates(uint32_t n);
+#ifdef NS3_MTP
+    /**
+     * Record the result of a DoGetObject() lookup in the cache of the
+     * list of aggregates.
+     *
+     * \param [in] uid The uid of the TypeId looked up.
+     * \param [in] index The index in the list of the matching Object plus
+     *        one, or AGGREGATES_NOT_FOUND.
+     */
+    void CacheLookup(uint16_t uid, uint32_t index) const;
+#endif
     /**
      * Verify that this Object is still live, by checking it's reference count.
      * \return \c true if the reference count is non zero.
@@ -0,0 +1,198 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "parallel-construction.h"
+
+#include "assert.h"
+#include "log.h"
+#include "simulator-impl.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <list>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ParallelConstruction implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ParallelConstruction");
+
+namespace
+{
+
+/** The deferred actions of the item handled by the current thread, if any. */
+thread_local std::list<std::function<void()>>* t_deferred = nullptr;
+
+/** The maximum number of threads used by ParallelConstruction::For(). */
+uint32_t g_maxThreads = 0;
+
+/** The function returning the thread-local state of the simulator. */
+void* (*g_getThreadState)() = nullptr;
+
+/** The function setting the thread-local state of the simulator. */
+void (*g_setThreadState)(void*) = nullptr;
+
+} // unnamed namespace
+
+#ifdef NS3_MTP
+std::atomic<bool> ParallelConstruction::m_running{false};
+#endif
+
+void
+ParallelConstruction::For(uint32_t n, const std::function<void(uint32_t)>& f)
+{
+    NS_LOG_FUNCTION(n);
+    Run(n, nullptr, f);
+}
+
+void
+ParallelConstruction::For(const std::vector<std::vector<uint32_t>>& groups,
+                          const std::function<void(uint32_t)>& f)
+{
+    NS_LOG_FUNCTION(groups.size());
+    uint32_t n = 0;
+    for (const auto& group : groups)
+    {
+        n += group.size();
+    }
+    Run(n, &groups, f);
+}
+
+void
+ParallelConstruction::Run(uint32_t n,
+                          const std::vector<std::vector<uint32_t>>* groups,
+                          const std::function<void(uint32_t)>& f)
+{
+    NS_LOG_FUNCTION(n << groups);
+    std::size_t nTasks = groups ? groups->size() : n;
+    std::size_t nThreads = g_maxThreads ? g_maxThreads : std::thread::hardware_concurrency();
+    nThreads = std::min(nThreads, nTasks);
+
+#ifdef NS3_MTP
+    // run sequentially on a single thread, or within an item of For()
+    if (nThreads <= 1 || IsActive())
+#endif
+    {
+        // in item order, as the deferred actions would be replayed; the
+        // items of each group are thus still handled in order
+        for (uint32_t i = 0; i < n; i++)
+        {
+            f(i);
+        }
+        return;
+    }
+
+#ifdef NS3_MTP
+    NS_LOG_DEBUG("Run " << n << " items on " << nThreads << " threads");
+
+    // make sure the simulator exists before the threads use it
+    Simulator::GetImplementation();
+
+    std::vector<std::list<std::function<void()>>> deferred(n);
+    std::size_t chunk = groups ? 1 : std::max<std::size_t>(1, nTasks / (nThreads * 16));
+    std::atomic<std::size_t> next{0};
+    void* state = g_getThreadState ? g_getThreadState() : nullptr;
+    auto work = [&]() {
+        if (g_setThreadState)
+        {
+            g_setThreadState(state);
+        }
+        for (std::size_t task; (task = next.fetch_add(chunk)) < nTasks;)
+        {
+            for (std::size_t end = std::min(task + chunk, nTasks); task < end; task++)
+            {
+                if (groups)
+                {
+                    for (auto i : (*groups)[task])
+                    {
+                        NS_ASSERT_MSG(i < n, "Item " << i << " out of range");
+                        t_deferred = &deferred[i];
+                        f(i);
+                    }
+                }
+                else
+                {
+                    t_deferred = &deferred[task];
+                    f(task);
+                }
+            }
+        }
+        t_deferred = nullptr;
+    };
+
+    m_running.store(true, std::memory_order_relaxed);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < nThreads; t++)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    m_running.store(false, std::memory_order_relaxed);
+
+    // replay the deferred actions, as if the items had been handled in order
+    for (auto& actions : deferred)
+    {
+        for (auto& action : actions)
+        {
+            action();
+        }
+    }
+#endif
+}
+
+std::function<void()>*
+ParallelConstruction::Defer(std::function<void()> action)
+{
+    if (IsActive())
+    {
+        t_deferred->push_back(std::move(action));
+        return &t_deferred->back();
+    }
+    action();
+    return nullptr;
+}
+
+bool
+ParallelConstruction::IsWorker()
+{
+    return t_deferred != nullptr;
+}
+
+void
+ParallelConstruction::SetMaxThreads(uint32_t n)
+{
+    NS_LOG_FUNCTION(n);
+    g_maxThreads = n;
+}
+
+void
+ParallelConstruction::SetThreadState(void* (*get)(), void (*set)(void*))
+{
+    NS_LOG_FUNCTION(get << set);
+    g_getThreadState = get;
+    g_setThreadState = set;
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARALLEL_CONSTRUCTION_H
+#define PARALLEL_CONSTRUCTION_H
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ParallelConstruction declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup core
+ * \brief Build independent parts of a simulation on several threads, with
+ * the same result as a sequential build.
+ *
+ * For() calls a function for each of a number of items, such as the nodes
+ * on which to install a protocol stack, on several threads when built with
+ * NS3_MTP.  The function may create objects and modify the objects of its
+ * item, but not the objects shared with other items.
+ *
+ * The operations whose result depends on the order in which the items are
+ * handled must be passed to Defer(), which runs them on the calling thread
+ * of For(), item after item and in the order they were deferred, once all
+ * the items are done.  The automatic numbering of random variable streams,
+ * the events scheduled with a context, and the numbering of nodes and
+ * channels do so already.  The simulation built is thus the same as if the
+ * items had been handled sequentially, in order: the objects get the same
+ * identifiers, addresses and random variable streams.
+ *
+ * The objects an action is deferred for must live until For() returns.
+ * The random variable streams of an item cannot be used before For()
+ * returns, and events cannot be scheduled without a context.
+ */
+class ParallelConstruction
+{
+  public:
+    /**
+     * Call a function for each item, on several threads.
+     *
+     * \param [in] n The number of items.
+     * \param [in] f The function, called with the index of each item.
+     */
+    static void For(uint32_t n, const std::function<void(uint32_t)>& f);
+
+    /**
+     * Call a function for each item, on several threads, the items of a
+     * group being handled in order by the same thread.  This allows, e.g.,
+     * the items to be the devices and the groups to be their nodes.
+     *
+     * \param [in] groups The item indexes of each group, in increasing
+     *        order; each item from 0 to the number of items must be in one
+     *        group.
+     * \param [in] f The function, called with the index of each item.
+     */
+    static void For(const std::vector<std::vector<uint32_t>>& groups,
+                    const std::function<void(uint32_t)>& f);
+
+    /**
+     * Run an action now, or, if called from an item of For(), once all the
+     * items are done, in item order.
+     *
+     * \param [in] action The action.
+     * \returns The deferred action, which can be replaced (e.g., if the
+     *          object it applies to is destroyed) until it is run, or
+     *          nullptr if the action was run right away.
+     */
+    static std::function<void()>* Defer(std::function<void()> action);
+
+    /**
+     * \returns true if called from an item of For() running on several
+     *          threads, in which case Defer() defers its actions.
+     */
+    static bool IsActive();
+
+    /**
+     * Set the maximum number of threads used by For().
+     *
+     * \param [in] n The number of threads, or 0 to use as many threads as
+     *        the hardware supports.
+     */
+    static void SetMaxThreads(uint32_t n);
+
+    /**
+     * Set the functions carrying the thread-local state of the simulator
+     * over from the thread calling For() to the threads it starts.
+     *
+     * \param [in] get The function returning the state of the current
+     *        thread.
+     * \param [in] set The function setting the state of the current thread.
+     */
+    static void SetThreadState(void* (*get)(), void (*set)(void*));
+
+  private:
+    /**
+     * Call a function for each item, on several threads.
+     *
+     * \param [in] n The number of items.
+     * \param [in] groups The item indexes of each group, or nullptr to
+     *        handle the items independently.
+     * \param [in] f The function, called with the index of each item.
+     */
+    static void Run(uint32_t n,
+                    const std::vector<std::vector<uint32_t>>* groups,
+                    const std::function<void(uint32_t)>& f);
+
+    /**
+     * \returns true if the current thread handles an item of For().
+     */
+    static bool IsWorker();
+
+#ifdef NS3_MTP
+    /** Whether For() is running items on several threads. */
+    static std::atomic<bool> m_running;
+#endif
+};
+
+inline bool
+ParallelConstruction::IsActive()
+{
+#ifdef NS3_MTP
+    return m_running.load(std::memory_order_relaxed) && IsWorker();
+#else
+    return false;
+#endif
+}
+
+} // namespace ns3
+
+#endif /* PARALLEL_CONSTRUCTION_H */
@@ -29,6 +29,7 @@
 #include "double.h"
 #include "integer.h"
 #include "log.h"
+#include "parallel-construction.h"
 #include "pointer.h"
 #include "rng-seed-manager.h"
 #include "rng-stream.h"
@@ -49,6 +50,67 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("RandomVariableStream");
 
+namespace
+{
+
+/**
+ * \ingroup randomvariable
+ * Fill an array with the values of a distribution obtained by transforming
+ * uniform randoms, and rejecting the values above a bound.
+ *
+ * The uniform randoms are drawn in batches, but the accepted values and the
+ * final state of the stream are the same as when drawing the values one at
+ * a time: each value still needed takes at least one more uniform random,
+ * and the rejected values are squeezed out in order.
+ *
+ * \tparam Transform \deduced The type of the transform.
+ * \param [in] rng The underlying RngStream.
+ * \param [in] antithetic Whether to use antithetic uniform randoms.
+ * \param [in] bound The upper bound on the values, or 0 for no bound.
+ * \param [out] values The random values.
+ * \param [in] n The number of values.
+ * \param [in] transform The transform of a uniform random into a value.
+ */
+template <typename Transform>
+void
+GetBoundedValues(RngStream* rng,
+                 bool antithetic,
+                 double bound,
+                 double* values,
+                 std::size_t n,
+                 Transform transform)
+{
+    std::size_t filled = 0;
+    while (filled < n)
+    {
+        rng->RandU01(values + filled, n - filled);
+        if (antithetic)
+        {
+            for (std::size_t i = filled; i < n; i++)
+            {
+                values[i] = (1 - values[i]);
+            }
+        }
+        for (std::size_t i = filled; i < n; i++)
+        {
+            values[i] = transform(values[i]);
+        }
+        if (bound == 0)
+        {
+            return;
+        }
+        for (std::size_t i = filled; i < n; i++)
+        {
+            if (values[i] <= bound)
+            {
+                values[filled++] = values[i];
+            }
+        }
+    }
+}
+
+} // unnamed namespace
+
 NS_OBJECT_ENSURE_REGISTERED(RandomVariableStream);
 
 TypeId
@@ -77,7 +139,8 @@ RandomVariableStream::GetTypeId()
 }
 
 RandomVariableStream::RandomVariableStream()
-    : m_rng(nullptr)
+    : m_rng(nullptr),
+      m_deferredStream(nullptr)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -85,6 +148,11 @@ RandomVariableStream::RandomVariableStream()
 RandomVariableStream::~RandomVariableStream()
 {
     NS_LOG_FUNCTION(this);
+    if (m_deferredStream)
+    {
+        // the automatic stream number is still used up
+        *m_deferredStream = []() { RngSeedManager::GetNextStreamIndex(); };
+    }
     delete m_rng;
 }
 
@@ -109,6 +177,16 @@ RandomVariableStream::GetInteger()
     return static_cast<uint32_t>(GetValue());
 }
 
+void
+RandomVariableStream::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        values[i] = GetValue();
+    }
+}
+
 void
 RandomVariableStream::SetStream(int64_t stream)
 {
@@ -116,13 +194,24 @@ RandomVariableStream::SetStream(int64_t stream)
     // negative values are not legal.
     NS_ASSERT(stream >= -1);
     delete m_rng;
+    m_rng = nullptr;
+    if (m_deferredStream)
+    {
+        // the automatic stream number is still used up
+        *m_deferredStream = []() { RngSeedManager::GetNextStreamIndex(); };
+        m_deferredStream = nullptr;
+    }
     if (stream == -1)
     {
         // The first 2^63 streams are reserved for automatic stream
-        // number assignment.
-        uint64_t nextStream = RngSeedManager::GetNextStreamIndex();
-        NS_ASSERT(nextStream <= ((1ULL) << 63));
-        m_rng = new RngStream(RngSeedManager::GetSeed(), nextStream, RngSeedManager::GetRun());
+        // number assignment.  They are numbered in construction order,
+        // which ParallelConstruction keeps by deferring the assignment.
+        m_deferredStream = ParallelConstruction::Defer([this]() {
+            m_deferredStream = nullptr;
+            uint64_t nextStream = RngSeedManager::GetNextStreamIndex();
+            NS_ASSERT(nextStream <= ((1ULL) << 63));
+            m_rng = new RngStream(RngSeedManager::GetSeed(), nextStream, RngSeedManager::GetRun());
+        });
     }
     else
     {
@@ -146,6 +235,7 @@ RngStream*
 RandomVariableStream::Peek() const
 {
     NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(m_rng, "Stream not assigned yet (used within ParallelConstruction::For()?)");
     return m_rng;
 }
 
@@ -219,6 +309,29 @@ UniformRandomVariable::GetValue()
     return GetValue(m_min, m_max);
 }
 
+void
+UniformRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    Peek()->RandU01(values, n);
+    double min = m_min;
+    double max = m_max;
+    if (IsAntithetic())
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            values[i] = min + (max - (min + values[i] * (max - min)));
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            values[i] = min + values[i] * (max - min);
+        }
+    }
+}
+
 uint32_t
 UniformRandomVariable::GetInteger()
 {
@@ -455,6 +568,16 @@ ExponentialRandomVariable::GetValue()
     return GetValue(m_mean, m_bound);
 }
 
+void
+ExponentialRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    double mean = m_mean;
+    GetBoundedValues(Peek(), IsAntithetic(), m_bound, values, n, [mean](double v) {
+        return -mean * std::log(v);
+    });
+}
+
 NS_OBJECT_ENSURE_REGISTERED(ParetoRandomVariable);
 
 TypeId
@@ -554,6 +677,17 @@ ParetoRandomVariable::GetValue()
     return GetValue(m_scale, m_shape, m_bound);
 }
 
+void
+ParetoRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    double scale = m_scale;
+    double shape = m_shape;
+    GetBoundedValues(Peek(), IsAntithetic(), m_bound, values, n, [scale, shape](double v) {
+        return (scale * (1.0 / std::pow(v, 1.0 / shape)));
+    });
+}
+
 NS_OBJECT_ENSURE_REGISTERED(WeibullRandomVariable);
 
 TypeId
@@ -776,6 +910,78 @@ NormalRandomVariable::GetValue()
     return GetValue(m_mean, m_variance, m_bound);
 }
 
+void
+NormalRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    double mean = m_mean;
+    double stddev = std::sqrt(m_variance);
+    double bound = m_bound;
+    bool antithetic = IsAntithetic();
+
+    // Pairs of uniform randoms drawn in advance.  Each pair yields at most
+    // two values, so drawing one pair for every two values still needed
+    // never takes more uniform randoms than GetValue() would.
+    static constexpr std::size_t MAX_PAIRS = 32;
+    double uniforms[2 * MAX_PAIRS];
+    std::size_t next = 0;
+    std::size_t pairs = 0;
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (m_nextValid)
+        { // use previously generated
+            m_nextValid = false;
+            double x2 = mean + m_v2 * m_y * stddev;
+            if (std::fabs(x2 - mean) <= bound)
+            {
+                values[i] = x2;
+                continue;
+            }
+        }
+        while (true)
+        { // same Box-Muller transform as GetValue (double, double, double)
+            if (next == pairs)
+            {
+                pairs = std::min(MAX_PAIRS, (n - i + 1) / 2);
+                Peek()->RandU01(uniforms, 2 * pairs);
+                next = 0;
+            }
+            double u1 = uniforms[2 * next];
+            double u2 = uniforms[2 * next + 1];
+            next++;
+            if (antithetic)
+            {
+                u1 = (1 - u1);
+                u2 = (1 - u2);
+            }
+            double v1 = 2 * u1 - 1;
+            double v2 = 2 * u2 - 1;
+            double w = v1 * v1 + v2 * v2;
+            if (w <= 1.0)
+            { // Got good pair
+                double y = std::sqrt((-2 * std::log(w)) / w);
+                double x1 = mean + v1 * y * stddev;
+                if (std::fabs(x1 - mean) <= bound)
+                {
+                    m_nextValid = true;
+                    m_y = y;
+                    m_v2 = v2;
+                    values[i] = x1;
+                    break;
+                }
+                double x2 = mean + v2 * y * stddev;
+                if (std::fabs(x2 - mean) <= bound)
+                {
+                    m_nextValid = false;
+                    values[i] = x2;
+                    break;
+                }
+            }
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(LogNormalRandomVariable);
 
 TypeId
@@ -1586,14 +1792,14 @@ EmpiricalRandomVariable::PreSample(double& value)
     value = r;
     bool valid = false;
     // check extrema
-    if (r <= m_empCdf.begin()->first)
+    if (r <= m_cdfProbabilities.front())
     {
-        value = m_empCdf.begin()->second; // Less than first
+        value = m_cdfValues.front(); // Less than first
         valid = true;
     }
-    else if (r >= m_empCdf.rbegin()->first)
+    else if (r >= m_cdfProbabilities.back())
     {
-        value = m_empCdf.rbegin()->second; // Greater than last
+        value = m_cdfValues.back(); // Greater than last
         valid = true;
     }
     return valid;
@@ -1622,15 +1828,72 @@ EmpiricalRandomVariable::GetValue()
     return value;
 }
 
+void
+EmpiricalRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+
+    if (!m_validated)
+    {
+        Validate();
+    }
+
+    Peek()->RandU01(values, n);
+    bool antithetic = IsAntithetic();
+    double first = m_cdfProbabilities.front();
+    double last = m_cdfProbabilities.back();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double r = values[i];
+        if (antithetic)
+        {
+            r = (1 - r);
+        }
+
+        // same as GetValue ()
+        if (r <= first)
+        {
+            values[i] = m_cdfValues.front();
+        }
+        else if (r >= last)
+        {
+            values[i] = m_cdfValues.back();
+        }
+        else if (m_interpolate)
+        {
+            values[i] = DoInterpolate(r);
+        }
+        else
+        {
+            values[i] = DoSampleCDF(r);
+        }
+    }
+}
+
+std::size_t
+EmpiricalRandomVariable::FindUpperBound(double r) const
+{
+    auto slot = std::min(static_cast<std::size_t>(r * m_guide.size()), m_guide.size() - 1);
+    std::size_t i = m_guide[slot];
+    // r * m_guide.size () may have been rounded up to the next slot
+    while (i > 0 && m_cdfProbabilities[i - 1] > r)
+    {
+        i--;
+    }
+    while (m_cdfProbabilities[i] <= r)
+    {
+        i++;
+    }
+    return i;
+}
+
 double
 EmpiricalRandomVariable::DoSampleCDF(double r)
 {
     NS_LOG_FUNCTION(this << r);
 
     // Find first CDF that is greater than r
-    auto bound = m_empCdf.upper_bound(r);
-
-    return bound->second;
+    return m_cdfValues[FindUpperBound(r)];
 }
 
 double
@@ -1658,19 +1921,14 @@ EmpiricalRandomVariable::DoInterpolate(double r)
     // This code based (loosely) on code by Bruce Mah (Thanks Bruce!)
 
     // search
-    auto upper = m_empCdf.upper_bound(r);
-    auto lower = std::prev(upper, 1);
-
-    if (upper == m_empCdf.begin())
-    {
-        lower = upper;
-    }
+    std::size_t upper = FindUpperBound(r);
+    std::size_t lower = (upper == 0) ? upper : upper - 1;
 
     // Interpolate random value in range [v1..v2) based on [c1 .. r .. c2)
-    double c1 = lower->first;
-    double c2 = upper->first;
-    double v1 = lower->second;
-    double v2 = upper->second;
+    double c1 = m_cdfProbabilities[lower];
+    double c2 = m_cdfProbabilities[upper];
+    double v1 = m_cdfValues[lower];
+    double v2 = m_cdfValues[upper];
 
     double value = (v1 + ((v2 - v1) / (c2 - c1)) * (r - c1));
     return value;
@@ -1691,6 +1949,7 @@ EmpiricalRandomVariable::CDF(double v, double c)
     }
 
     m_empCdf[c] = v;
+    m_validated = false;
 }
 
 void
@@ -1735,6 +1994,30 @@ EmpiricalRandomVariable::Validate()
                        << lastCdfPair->first << ", Value: " << lastCdfPair->second);
     }
 
+    // Flatten the CDF into contiguous arrays, and index them with a guide
+    // table with as many entries as CDF points, so that the expected number
+    // of points visited by FindUpperBound () is constant.
+    m_cdfProbabilities.clear();
+    m_cdfValues.clear();
+    m_cdfProbabilities.reserve(m_empCdf.size());
+    m_cdfValues.reserve(m_empCdf.size());
+    for (const auto& cdfPair : m_empCdf)
+    {
+        m_cdfProbabilities.push_back(cdfPair.first);
+        m_cdfValues.push_back(cdfPair.second);
+    }
+    m_guide.resize(m_empCdf.size());
+    std::size_t i = 0;
+    for (std::size_t j = 0; j < m_guide.size(); j++)
+    {
+        double r = static_cast<double>(j) / m_guide.size();
+        while (i < m_cdfProbabilities.size() - 1 && m_cdfProbabilities[i] <= r)
+        {
+            i++;
+        }
+        m_guide[j] = static_cast<uint32_t>(i);
+    }
+
     m_validated = true;
 }
 
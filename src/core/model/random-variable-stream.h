@@ -30,8 +30,10 @@
 #include "object.h"
 #include "type-id.h"
 
+#include <functional>
 #include <map>
 #include <stdint.h>
+#include <vector>
 
 /**
  * \file
@@ -154,6 +156,20 @@ class RandomVariableStream : public Object
     // The base implementation returns `(uint32_t)GetValue()`
     virtual uint32_t GetInteger();
 
+    /**
+     * \brief Get the next random values drawn from the distribution.
+     *
+     * The values are the same as those of \pname{n} successive calls to
+     * GetValue(), and the stream is left in the same state.  The base
+     * implementation just calls GetValue(); distributions which transform
+     * uniform randoms override it to draw the uniform randoms in a batch
+     * and transform them in a tight loop.
+     *
+     * \param [out] values The random values.
+     * \param [in] n The number of values.
+     */
+    virtual void GetValues(double* values, std::size_t n);
+
   protected:
     /**
      * \brief Get the pointer to the underlying RngStream.
@@ -171,6 +187,12 @@ class RandomVariableStream : public Object
     /** The stream number for the RngStream. */
     int64_t m_stream;
 
+    /**
+     * The assignment of the automatic stream number, while deferred by
+     * ParallelConstruction.
+     */
+    std::function<void()>* m_deferredStream;
+
 }; // class RandomVariableStream
 
 /**
@@ -278,6 +300,9 @@ class UniformRandomVariable : public RandomVariableStream
      */
     double GetValue() override;
 
+    /** \copydoc RandomVariableStream::GetValues() */
+    void GetValues(double* values, std::size_t n) override;
+
     /**
      * \copydoc RandomVariableStream::GetInteger()
      * \note The upper limit is included in the output range, unlike GetValue().
@@ -592,6 +617,7 @@ class ExponentialRandomVariable : public RandomVariableStream
 
     // Inherited
     double GetValue() override;
+    void GetValues(double* values, std::size_t n) override;
     using RandomVariableStream::GetInteger;
 
   private:
@@ -728,6 +754,7 @@ class ParetoRandomVariable : public RandomVariableStream
 
     // Inherited
     double GetValue() override;
+    void GetValues(double* values, std::size_t n) override;
     using RandomVariableStream::GetInteger;
 
   private:
@@ -1017,6 +1044,7 @@ class NormalRandomVariable : public RandomVariableStream
 
     // Inherited
     double GetValue() override;
+    void GetValues(double* values, std::size_t n) override;
     using RandomVariableStream::GetInteger;
 
   private:
@@ -2002,6 +2030,9 @@ class EmpiricalRandomVariable : public RandomVariableStream
     double GetValue() override;
     using RandomVariableStream::GetInteger;
 
+    /** \copydoc RandomVariableStream::GetValues() */
+    void GetValues(double* values, std::size_t n) override;
+
     /**
      * \brief Returns the next value in the empirical distribution using
      * linear interpolation.
@@ -2020,7 +2051,7 @@ class EmpiricalRandomVariable : public RandomVariableStream
 
   private:
     /**
-     * \brief Check that the CDF is valid.
+     * \brief Check that the CDF is valid, and build the sampling tables.
      *
      * A valid CDF has
      *
@@ -2030,6 +2061,18 @@ class EmpiricalRandomVariable : public RandomVariableStream
      * It is a fatal error to fail validation.
      */
     void Validate();
+    /**
+     * \brief Find the first CDF point whose probability is greater than \p r.
+     *
+     * This is \c m_empCdf.upper_bound(r), as an index in the sampling tables.
+     * The guide table gives the first candidate, and the search continues
+     * linearly from there, which takes constant expected time.
+     *
+     * \param [in] r The CDF value, strictly between the first and the last
+     *        CDF points.
+     * \returns The index of the CDF point.
+     */
+    std::size_t FindUpperBound(double r) const;
     /**
      * \brief Do the initial rng draw and check against the extrema.
      *
@@ -2067,6 +2110,15 @@ class EmpiricalRandomVariable : public RandomVariableStream
      * Key: CDF F(x) [0, 1] | Value: domain value (x) [-inf, inf].
      */
     std::map<double, double> m_empCdf;
+    /** The CDF values F(x) of \c m_empCdf, in increasing order, built by Validate(). */
+    std::vector<double> m_cdfProbabilities;
+    /** The domain values x matching \c m_cdfProbabilities, built by Validate(). */
+    std::vector<double> m_cdfValues;
+    /**
+     * The guide table: entry \c j is the index of the first CDF point whose
+     * probability is greater than \c j / m_guide.size(), built by Validate().
+     */
+    std::vector<uint32_t> m_guide;
     /**
      * If \c true GetValue will interpolate,
      * otherwise treat CDF as normal histogram.
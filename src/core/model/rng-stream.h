@@ -18,6 +18,7 @@
 
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
+#include <cstddef>
 #include <stdint.h>
 #include <string>
 
@@ -70,6 +71,16 @@ class RngStream
      * \returns The next random.
      */
     double RandU01();
+    /**
+     * Generate the next \pname{n} random numbers for this stream.
+     *
+     * This returns the same values as \pname{n} calls to RandU01(), but
+     * keeps the state of the generator in registers for the whole batch.
+     *
+     * \param [out] values The random numbers.
+     * \param [in] n The number of random numbers.
+     */
+    void RandU01(double* values, std::size_t n);
 
   private:
     /**
@@ -59,7 +59,7 @@ class Empty
  * virtual.
  *
  *
- * This template takes 3 arguments but only the first argument is
+ * This template takes 4 arguments but only the first argument is
  * mandatory:
  *
  * \tparam T \explicit The typename of the subclass which derives
@@ -74,10 +74,17 @@ class Empty
  *      a public static method named 'Delete'. This method will be called
  *      whenever the SimpleRefCount template detects that no references
  *      to the object it manages exist anymore.
+ * \tparam COUNTER \explicit The typename of the reference counter when
+ *      built with NS3_MTP: ns3::AtomicCounter by default, or
+ *      ns3::OwnedCounter for objects used by a single logical process at
+ *      a time, see ShareReferenceCount().
  *
  * Interesting users of this class include ns3::Object as well as ns3::Packet.
  */
-template <typename T, typename PARENT = Empty, typename DELETER = DefaultDeleter<T>>
+template <typename T,
+          typename PARENT = Empty,
+          typename DELETER = DefaultDeleter<T>,
+          typename COUNTER = AtomicCounter>
 class SimpleRefCount : public PARENT
 {
   public:
@@ -146,6 +153,18 @@ class SimpleRefCount : public PARENT
         return m_count;
     }
 
+#ifdef NS3_MTP
+    /**
+     * Make the reference counting of the object atomic, before it is used
+     * by another logical process.  Only available with an
+     * ns3::OwnedCounter.
+     */
+    inline void ShareReferenceCount() const
+    {
+        m_count.Share();
+    }
+#endif
+
   private:
     /**
      * The reference count.
@@ -155,7 +174,7 @@ class SimpleRefCount : public PARENT
      * change it.
      */
 #ifdef NS3_MTP
-    mutable AtomicCounter m_count;
+    mutable COUNTER m_count;
 #else
     mutable uint32_t m_count;
 #endif
@@ -25,6 +25,7 @@
 #include "log.h"
 #include "map-scheduler.h"
 #include "object-factory.h"
+#include "parallel-construction.h"
 #include "ptr.h"
 #include "scheduler.h"
 #include "simulator-impl.h"
@@ -235,6 +236,13 @@ Simulator::ScheduleNow(const Ptr<EventImpl>& ev)
 void
 Simulator::ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* impl)
 {
+    if (ParallelConstruction::IsActive())
+    {
+        // keep the events in the order of a sequential construction
+        ParallelConstruction::Defer(
+            [context, delay, impl]() { ScheduleWithContext(context, delay, impl); });
+        return;
+    }
 #ifdef ENABLE_DES_METRICS
     DesMetrics::Get()->TraceWithContext(context, Now(), delay);
 #endif
@@ -250,6 +258,8 @@ Simulator::ScheduleDestroy(const Ptr<EventImpl>& ev)
 EventId
 Simulator::DoSchedule(const Time& time, EventImpl* impl)
 {
+    NS_ASSERT_MSG(!ParallelConstruction::IsActive(),
+                  "Events scheduled within ParallelConstruction::For() need a context");
 #ifdef ENABLE_DES_METRICS
     DesMetrics::Get()->Trace(Now(), time);
 #endif
@@ -259,6 +269,8 @@ Simulator::DoSchedule(const Time& time, EventImpl* impl)
 EventId
 Simulator::DoScheduleNow(EventImpl* impl)
 {
+    NS_ASSERT_MSG(!ParallelConstruction::IsActive(),
+                  "Events scheduled within ParallelConstruction::For() need a context");
 #ifdef ENABLE_DES_METRICS
     DesMetrics::Get()->Trace(Now(), Time(0));
 #endif
@@ -268,6 +280,8 @@ Simulator::DoScheduleNow(EventImpl* impl)
 EventId
 Simulator::DoScheduleDestroy(EventImpl* impl)
 {
+    NS_ASSERT_MSG(!ParallelConstruction::IsActive(),
+                  "Events scheduled within ParallelConstruction::For() need a context");
     return GetImpl()->ScheduleDestroy(impl);
 }
 
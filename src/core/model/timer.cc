@@ -36,6 +36,7 @@ NS_LOG_COMPONENT_DEFINE("Timer");
 Timer::Timer()
     : m_flags(CHECK_ON_DESTROY),
       m_delay(FemtoSeconds(0)),
+      m_timer(),
       m_event(),
       m_impl(nullptr)
 {
@@ -45,6 +46,7 @@ Timer::Timer()
 Timer::Timer(DestroyPolicy destroyPolicy)
     : m_flags(destroyPolicy),
       m_delay(FemtoSeconds(0)),
+      m_timer(),
       m_event(),
       m_impl(nullptr)
 {
@@ -56,17 +58,19 @@ Timer::~Timer()
     NS_LOG_FUNCTION(this);
     if (m_flags & CHECK_ON_DESTROY)
     {
-        if (m_event.IsRunning())
+        if (m_timer.IsRunning() || m_event.IsRunning())
         {
             NS_FATAL_ERROR("Event is still running while destroying.");
         }
     }
     else if (m_flags & CANCEL_ON_DESTROY)
     {
+        m_timer.Cancel();
         m_event.Cancel();
     }
     else if (m_flags & REMOVE_ON_DESTROY)
     {
+        m_timer.Remove();
         m_event.Remove();
     }
     delete m_impl;
@@ -93,7 +97,7 @@ Timer::GetDelayLeft() const
     switch (GetState())
     {
     case Timer::RUNNING:
-        return Simulator::GetDelayLeft(m_event);
+        return m_timer.IsRunning() ? m_timer.GetDelayLeft() : Simulator::GetDelayLeft(m_event);
     case Timer::EXPIRED:
         return TimeStep(0);
     case Timer::SUSPENDED:
@@ -108,6 +112,7 @@ void
 Timer::Cancel()
 {
     NS_LOG_FUNCTION(this);
+    m_timer.Cancel();
     m_event.Cancel();
 }
 
@@ -115,6 +120,7 @@ void
 Timer::Remove()
 {
     NS_LOG_FUNCTION(this);
+    m_timer.Remove();
     m_event.Remove();
 }
 
@@ -122,14 +128,14 @@ bool
 Timer::IsExpired() const
 {
     NS_LOG_FUNCTION(this);
-    return !IsSuspended() && m_event.IsExpired();
+    return !IsSuspended() && !m_timer.IsRunning() && m_event.IsExpired();
 }
 
 bool
 Timer::IsRunning() const
 {
     NS_LOG_FUNCTION(this);
-    return !IsSuspended() && m_event.IsRunning();
+    return !IsSuspended() && (m_timer.IsRunning() || m_event.IsRunning());
 }
 
 bool
@@ -170,11 +176,11 @@ Timer::Schedule(Time delay)
 {
     NS_LOG_FUNCTION(this << delay);
     NS_ASSERT(m_impl != nullptr);
-    if (m_event.IsRunning())
+    if (m_timer.IsRunning() || m_event.IsRunning())
     {
         NS_FATAL_ERROR("Event is still running while re-scheduling.");
     }
-    m_event = m_impl->Schedule(delay);
+    m_timer.Schedule(delay);
 }
 
 void
@@ -182,13 +188,15 @@ Timer::Suspend()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(IsRunning());
-    m_delayLeft = Simulator::GetDelayLeft(m_event);
+    m_delayLeft = GetDelayLeft();
     if (m_flags & CANCEL_ON_DESTROY)
     {
+        m_timer.Cancel();
         m_event.Cancel();
     }
     else if (m_flags & REMOVE_ON_DESTROY)
     {
+        m_timer.Remove();
         m_event.Remove();
     }
     m_flags |= TIMER_SUSPENDED;
@@ -199,8 +207,28 @@ Timer::Resume()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(m_flags & TIMER_SUSPENDED);
-    m_event = m_impl->Schedule(m_delayLeft);
+    if (m_timer.IsRunning())
+    {
+        // not disarmed by Suspend()
+        m_event = m_impl->Schedule(m_delayLeft);
+    }
+    else
+    {
+        m_timer.Schedule(m_delayLeft);
+    }
     m_flags &= ~TIMER_SUSPENDED;
 }
 
+void
+Timer::Materialize()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_timer.IsRunning())
+    {
+        Time delayLeft = m_timer.GetDelayLeft();
+        m_timer.Cancel();
+        m_event = m_impl->Schedule(delayLeft);
+    }
+}
+
 } // namespace ns3
@@ -19,6 +19,7 @@
 #ifndef TIMER_H
 #define TIMER_H
 
+#include "deadline-timer.h"
 #include "event-id.h"
 #include "fatal-error.h"
 #include "int-to-type.h"
@@ -68,6 +69,12 @@ class TimerImpl;
  * management policies. These policies are specified at construction time
  * and cannot be changed after.
  *
+ * The expiry is scheduled through a DeadlineTimer, so that a timer which is
+ * cancelled and scheduled again does not schedule a new event each time.
+ * The arguments are still those set when the timer was scheduled: setting
+ * the function or the arguments of a running timer first schedules its
+ * expiry with the previous ones.
+ *
  * \see Watchdog for a simpler interface for a watchdog timer.
  */
 class Timer
@@ -236,6 +243,12 @@ class Timer
     /** Internal bit marking the suspended timer state */
     static constexpr auto TIMER_SUSPENDED{1 << 7};
 
+    /**
+     * Schedule the expiry of the running timer, if any, with the current
+     * function and arguments, before they are changed.
+     */
+    void Materialize();
+
     /**
      * Bitfield for Timer State, DestroyPolicy and InternalSuspended.
      *
@@ -248,7 +261,12 @@ class Timer
     int m_flags;
     /** The delay configured for this Timer. */
     Time m_delay;
-    /** The future event scheduled to expire the timer. */
+    /** The deadline of the timer, re-armed in place. */
+    DeadlineTimer m_timer;
+    /**
+     * The future event scheduled to expire the timer, when its function or
+     * arguments were changed while it was running.
+     */
     EventId m_event;
     /**
      * The timer implementation, which contains the bound callback
@@ -274,16 +292,20 @@ template <typename FN>
 void
 Timer::SetFunction(FN fn)
 {
+    Materialize();
     delete m_impl;
     m_impl = MakeTimerImpl(fn);
+    m_timer.SetFunction(MakeCallback(&TimerImpl::Invoke, m_impl));
 }
 
 template <typename MEM_PTR, typename OBJ_PTR>
 void
 Timer::SetFunction(MEM_PTR memPtr, OBJ_PTR objPtr)
 {
+    Materialize();
     delete m_impl;
     m_impl = MakeTimerImpl(memPtr, objPtr);
+    m_timer.SetFunction(MakeCallback(&TimerImpl::Invoke, m_impl));
 }
 
 template <typename... Ts>
@@ -295,6 +317,7 @@ Timer::SetArguments(Ts... args)
         NS_FATAL_ERROR("You cannot set the arguments of a Timer before setting its function.");
         return;
     }
+    Materialize();
     m_impl->SetArgs(args...);
 }
 
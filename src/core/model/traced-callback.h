@@ -22,7 +22,7 @@
 
 #include "callback.h"
 
-#include <list>
+#include <vector>
 
 /**
  * \file
@@ -86,10 +86,15 @@ class TracedCallback
     void Disconnect(const CallbackBase& callback, std::string path);
     /**
      * \brief Functor which invokes the chain of Callbacks.
+     *
+     * The arguments are taken by reference, so that firing a trace source
+     * with no Callback connected, the most common case, costs no more than
+     * checking that the chain is empty.
+     *
      * \tparam Ts \deduced Types of the functor arguments.
      * \param [in] args The arguments to the functor
      */
-    void operator()(Ts... args) const;
+    void operator()(const Ts&... args) const;
     /**
      * \brief Checks if the Callbacks list is empty.
      * \return true if the Callbacks list is empty.
@@ -111,9 +116,12 @@ class TracedCallback
     /**
      * Container type for holding the chain of Callbacks.
      *
+     * The Callbacks are stored contiguously, since the chain is walked on
+     * every call but rarely modified.
+     *
      * \tparam Ts \deduced Types of the functor arguments.
      */
-    typedef std::list<Callback<void, Ts...>> CallbackList;
+    typedef std::vector<Callback<void, Ts...>> CallbackList;
     /** The chain of Callbacks. */
     CallbackList m_callbackList;
 };
@@ -190,11 +198,17 @@ TracedCallback<Ts...>::Disconnect(const CallbackBase& callback, std::string path
 
 template <typename... Ts>
 void
-TracedCallback<Ts...>::operator()(Ts... args) const
+TracedCallback<Ts...>::operator()(const Ts&... args) const
 {
-    for (auto i = m_callbackList.begin(); i != m_callbackList.end(); i++)
+    if (m_callbackList.empty())
+    {
+        return;
+    }
+    // Index the chain, rather than iterate over it, in case a Callback
+    // connects another one to this TracedCallback.
+    for (std::size_t i = 0; i < m_callbackList.size(); i++)
     {
-        (*i)(args...);
+        m_callbackList[i](args...);
     }
 }
 
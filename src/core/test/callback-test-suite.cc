@@ -16,6 +16,8 @@
  */
 
 #include "ns3/callback.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
 #include "ns3/test.h"
 
 #include <stdint.h>
@@ -991,6 +993,79 @@ NullifyCallbackTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(target1.IsNull(), true, "Nullified Callback reports not IsNull()");
 }
 
+/**
+ * \ingroup callback-tests
+ *
+ * Make sure that an object a member function Callback is bound to with a Ptr
+ * is kept alive while the member function runs, even if it releases the
+ * Callback (e.g., a socket closing itself from its receive callback).
+ */
+class CallbackObjectLifetimeTestCase : public TestCase
+{
+  public:
+    CallbackObjectLifetimeTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Object releasing the only Callback referring to it.
+     */
+    class Target : public SimpleRefCount<Target>
+    {
+      public:
+        /**
+         * Constructor.
+         * \param destroyed set to true when the object is destroyed.
+         */
+        Target(bool* destroyed)
+            : m_destroyed(destroyed)
+        {
+        }
+
+        ~Target()
+        {
+            *m_destroyed = true;
+        }
+
+        /**
+         * Release the Callback and check that the object is still alive.
+         * \return true if the object was still alive after releasing the Callback.
+         */
+        bool Release()
+        {
+            m_callback->Nullify();
+            return !*m_destroyed;
+        }
+
+        Callback<bool>* m_callback{nullptr}; //!< the Callback to release
+
+      private:
+        bool* m_destroyed; //!< set to true when the object is destroyed
+    };
+};
+
+CallbackObjectLifetimeTestCase::CallbackObjectLifetimeTestCase()
+    : TestCase("Check that the object of a member function Callback outlives the call")
+{
+}
+
+void
+CallbackObjectLifetimeTestCase::DoRun()
+{
+    bool destroyed = false;
+    Ptr<Target> target = Create<Target>(&destroyed);
+    Callback<bool> cb = MakeCallback(&Target::Release, target);
+    target->m_callback = &cb;
+    target = nullptr;
+    NS_TEST_ASSERT_MSG_EQ(destroyed, false, "Object destroyed too early");
+
+    // the call releases the last reference to the object
+    bool alive = cb();
+    NS_TEST_ASSERT_MSG_EQ(alive, true, "Object destroyed during the call");
+    NS_TEST_ASSERT_MSG_EQ(destroyed, true, "Object not destroyed after the call");
+}
+
 /**
  * \ingroup callback-tests
  *
@@ -1198,6 +1273,7 @@ CallbackTestSuite::CallbackTestSuite()
     AddTestCase(new CallbackEqualityTestCase, TestCase::QUICK);
     AddTestCase(new NullifyCallbackTestCase, TestCase::QUICK);
     AddTestCase(new MakeCallbackTemplatesTestCase, TestCase::QUICK);
+    AddTestCase(new CallbackObjectLifetimeTestCase, TestCase::QUICK);
 }
 
 static CallbackTestSuite g_gallbackTestSuite; //!< Static variable for test initialization
@@ -864,6 +864,97 @@ SearchAttributesOfParentObjectsTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), 42, "Object Attribute \"X\" not settable in derived class");
 }
 
+/**
+ * \ingroup config-tests
+ * Test the resolution of paths through large object vectors.
+ */
+class LargeObjectVectorConfigTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    LargeObjectVectorConfigTestCase();
+
+    /** Destructor. */
+    ~LargeObjectVectorConfigTestCase() override
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+LargeObjectVectorConfigTestCase::LargeObjectVectorConfigTestCase()
+    : TestCase("Check the matches of paths through large vectors of Object, in order")
+{
+}
+
+void
+LargeObjectVectorConfigTestCase::DoRun()
+{
+    const uint32_t n = 2000;
+
+    //
+    // Create a root namespace object, with a large vector of objects, each
+    // of which points to another object.
+    //
+    Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject>();
+    Config::RegisterRootNamespaceObject(root);
+    std::vector<Ptr<ConfigTestObject>> objects;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject>();
+        Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject>();
+        a->SetNodeB(b);
+        root->AddNodeA(a);
+        objects.push_back(b);
+    }
+
+    Config::MatchContainer matches = Config::LookupMatches("/NodesA/*/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), n, "Unexpected number of matches");
+    for (uint32_t i = 0; i < matches.GetN(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(matches.Get(i), objects[i], "Unexpected match " << i);
+        std::ostringstream oss;
+        oss << "/NodesA/" << i << "/NodeB/";
+        NS_TEST_ASSERT_MSG_EQ(matches.GetMatchedPath(i), oss.str(), "Unexpected context " << i);
+    }
+
+    matches = Config::LookupMatches("/NodesA/1500/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Unexpected number of matches");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(0), objects[1500], "Unexpected match");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetMatchedPath(0),
+                          "/NodesA/1500/NodeB/",
+                          "Unexpected context");
+
+    matches = Config::LookupMatches("/NodesA/1999|[10-12]|11|2000/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 4, "Unexpected number of matches");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(0), objects[10], "Unexpected match");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(1), objects[11], "Unexpected match");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(2), objects[12], "Unexpected match");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(3), objects[1999], "Unexpected match");
+
+    // an out of range alternative, last or first, falls back to a full scan
+    matches = Config::LookupMatches("/NodesA/1999|2000/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Unexpected number of matches");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(0), objects[1999], "Unexpected match");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetMatchedPath(0),
+                          "/NodesA/1999/NodeB/",
+                          "Unexpected context");
+
+    matches = Config::LookupMatches("/NodesA/2000|5/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 1, "Unexpected number of matches");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(0), objects[5], "Unexpected match");
+
+    matches = Config::LookupMatches("/NodesA/[1998-1999]/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 2, "Unexpected number of matches");
+    NS_TEST_ASSERT_MSG_EQ(matches.Get(1), objects[1999], "Unexpected match");
+
+    matches = Config::LookupMatches("/NodesA/2000/NodeB");
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 0, "Unexpected match");
+
+    Config::UnregisterRootNamespaceObject(root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -882,6 +973,7 @@ ConfigTestSuite::ConfigTestSuite()
     AddTestCase(new UnderRootNamespaceConfigTestCase);
     AddTestCase(new ObjectVectorConfigTestCase);
     AddTestCase(new SearchAttributesOfParentObjectsTestCase);
+    AddTestCase(new LargeObjectVectorConfigTestCase);
 }
 
 /**
@@ -20,6 +20,7 @@
 #include "ns3/hash.h"
 #include "ns3/test.h"
 
+#include <cstring>
 #include <iomanip>
 #include <string>
 
@@ -216,6 +217,9 @@ Fnv1aTestCase::DoRun()
 
     hash64Reference = 0x88f6cdbe0a31098dULL;
     Check("FNV1a", hasher.clear().GetHash64(key));
+
+    Check("FNV1a one-shot", Hash::Function::Fnv1a::Hash32(key.c_str(), key.size()));
+    Check("FNV1a one-shot", Hash::Function::Fnv1a::Hash64(key.c_str(), key.size()));
 }
 
 /**
@@ -252,6 +256,23 @@ Murmur3TestCase::DoRun()
 
     hash64Reference = 0xa750412079d53e04ULL;
     Check("murmur3", hasher.clear().GetHash64(key));
+
+    Check("murmur3 one-shot", Hash::Function::Murmur3::Hash32(key.c_str(), key.size()));
+    Check("murmur3 one-shot", Hash::Function::Murmur3::Hash64(key.c_str(), key.size()));
+
+    // fixed-size buffers, including the serialized IPv4 and IPv6 5-tuples
+    uint8_t tuple4[17];
+    uint8_t tuple6[41];
+    uint8_t blocks[16];
+    std::memcpy(tuple4, key.c_str(), sizeof(tuple4));
+    std::memcpy(tuple6, key.c_str(), sizeof(tuple6));
+    std::memcpy(blocks, key.c_str(), sizeof(blocks));
+    hash32Reference = hasher.clear().GetHash32(key.c_str(), sizeof(tuple4));
+    Check("murmur3 fixed-size", Hash32(tuple4));
+    hash32Reference = hasher.clear().GetHash32(key.c_str(), sizeof(tuple6));
+    Check("murmur3 fixed-size", Hash32(tuple6));
+    hash32Reference = hasher.clear().GetHash32(key.c_str(), sizeof(blocks));
+    Check("murmur3 fixed-size", Hash32(blocks));
 }
 
 /**
@@ -462,6 +462,27 @@ AggregateObjectTestCase::DoRun()
 
     baseA = baseB->GetObject<BaseA>();
     NS_TEST_ASSERT_MSG_NE(baseA, nullptr, "Unable to GetObject on released object");
+
+    //
+    // Repeated lookups must keep returning the same Objects, and a failed
+    // lookup must not hide an Object aggregated afterwards.
+    //
+    Ptr<DerivedA> derivedA = CreateObject<DerivedA>();
+    Ptr<DerivedB> derivedB = CreateObject<DerivedB>();
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(derivedA->GetObject<BaseA>(), derivedA, "Unexpected BaseA");
+        NS_TEST_ASSERT_MSG_EQ(derivedA->GetObject<BaseB>(), nullptr, "Unexpected BaseB");
+    }
+    derivedA->AggregateObject(derivedB);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(derivedA->GetObject<BaseB>(), derivedB, "Unexpected BaseB");
+        NS_TEST_ASSERT_MSG_EQ(derivedA->GetObject<Object>(BaseB::GetTypeId()),
+                              derivedB,
+                              "Unexpected BaseB");
+        NS_TEST_ASSERT_MSG_EQ(derivedB->GetObject<DerivedA>(), derivedA, "Unexpected DerivedA");
+    }
 }
 
 /**
@@ -0,0 +1,259 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/parallel-construction.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/rng-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * ParallelConstruction test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup parallel-construction-tests ParallelConstruction test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/** The number of threads used by the tests, whatever the hardware. */
+static const uint32_t N_THREADS = 4;
+
+/**
+ * \ingroup parallel-construction-tests
+ * Check that the deferred actions are run in item order.
+ */
+class ParallelConstructionDeferTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    ParallelConstructionDeferTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ParallelConstructionDeferTestCase::ParallelConstructionDeferTestCase()
+    : TestCase("Check the order of the deferred actions")
+{
+}
+
+void
+ParallelConstructionDeferTestCase::DoRun()
+{
+    ParallelConstruction::SetMaxThreads(N_THREADS);
+
+    const uint32_t n = 1000;
+    std::vector<uint32_t> order;
+    ParallelConstruction::For(n, [&order](uint32_t i) {
+        ParallelConstruction::Defer([&order, i]() { order.push_back(2 * i); });
+        ParallelConstruction::Defer([&order, i]() { order.push_back(2 * i + 1); });
+    });
+    NS_TEST_ASSERT_MSG_EQ(order.size(), 2 * n, "Missing deferred actions");
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(order[i], i, "Deferred action run out of order");
+    }
+
+    // the items of a group are handled in order, but their actions are
+    // still run in item order
+    std::vector<std::vector<uint32_t>> groups{{1, 3}, {0}, {2, 4, 5}};
+    std::vector<uint32_t> handled;
+    order.clear();
+    ParallelConstruction::For(groups, [&](uint32_t i) {
+        if (i == 1 || i == 3)
+        {
+            handled.push_back(i);
+        }
+        ParallelConstruction::Defer([&order, i]() { order.push_back(i); });
+    });
+    NS_TEST_ASSERT_MSG_EQ(handled.size(), 2, "Missing items");
+    NS_TEST_ASSERT_MSG_EQ(handled[0], 1, "Items of a group handled out of order");
+    NS_TEST_ASSERT_MSG_EQ(handled[1], 3, "Items of a group handled out of order");
+    NS_TEST_ASSERT_MSG_EQ(order.size(), 6, "Missing deferred actions");
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(order[i], i, "Deferred action run out of order");
+    }
+
+    // on a single thread, the items are handled in item order, as with a loop
+    ParallelConstruction::SetMaxThreads(1);
+    handled.clear();
+    ParallelConstruction::For(groups, [&handled](uint32_t i) { handled.push_back(i); });
+    NS_TEST_ASSERT_MSG_EQ(handled.size(), 6, "Missing items");
+    for (uint32_t i = 0; i < handled.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(handled[i], i, "Item handled out of order on a single thread");
+    }
+
+    // outside of For(), the actions are run right away
+    bool done = false;
+    NS_TEST_ASSERT_MSG_EQ(ParallelConstruction::Defer([&done]() { done = true; }),
+                          nullptr,
+                          "Action deferred outside of For()");
+    NS_TEST_ASSERT_MSG_EQ(done, true, "Action not run");
+
+    ParallelConstruction::SetMaxThreads(0);
+}
+
+/**
+ * \ingroup parallel-construction-tests
+ * Check that the random variables created in parallel get the streams they
+ * would get if created in order.
+ */
+class ParallelConstructionStreamTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    ParallelConstructionStreamTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ParallelConstructionStreamTestCase::ParallelConstructionStreamTestCase()
+    : TestCase("Check the streams of the random variables created in parallel")
+{
+}
+
+void
+ParallelConstructionStreamTestCase::DoRun()
+{
+    ParallelConstruction::SetMaxThreads(N_THREADS);
+
+    // each item uses two streams, one of them from a variable destroyed
+    // before For() returns
+    const uint32_t n = 500;
+    std::vector<Ptr<UniformRandomVariable>> variables(n);
+    uint64_t first = RngSeedManager::GetNextStreamIndex() + 1;
+    ParallelConstruction::For(n, [&variables](uint32_t i) {
+        CreateObject<UniformRandomVariable>();
+        variables[i] = CreateObject<UniformRandomVariable>();
+    });
+    NS_TEST_ASSERT_MSG_EQ(RngSeedManager::GetNextStreamIndex(),
+                          first + 2 * n,
+                          "Wrong number of streams used");
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        RngStream expected(RngSeedManager::GetSeed(), first + 2 * i + 1, RngSeedManager::GetRun());
+        for (uint32_t j = 0; j < 10; j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(variables[i]->GetValue(),
+                                  expected.RandU01(),
+                                  "Variable " << i << " has the wrong stream");
+        }
+    }
+
+    ParallelConstruction::SetMaxThreads(0);
+}
+
+/**
+ * \ingroup parallel-construction-tests
+ * Check that the events scheduled in parallel run in item order.
+ */
+class ParallelConstructionScheduleTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    ParallelConstructionScheduleTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Record an event.
+     * \param [in] i The item which scheduled the event.
+     */
+    void Record(uint32_t i);
+
+    std::vector<uint32_t> m_order; //!< The items of the events run.
+};
+
+ParallelConstructionScheduleTestCase::ParallelConstructionScheduleTestCase()
+    : TestCase("Check the order of the events scheduled in parallel")
+{
+}
+
+void
+ParallelConstructionScheduleTestCase::Record(uint32_t i)
+{
+    m_order.push_back(i);
+}
+
+void
+ParallelConstructionScheduleTestCase::DoRun()
+{
+    ParallelConstruction::SetMaxThreads(N_THREADS);
+
+    const uint32_t n = 1000;
+    ParallelConstruction::For(n, [this](uint32_t i) {
+        Simulator::ScheduleWithContext(i,
+                                       Seconds(1),
+                                       &ParallelConstructionScheduleTestCase::Record,
+                                       this,
+                                       i);
+    });
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_order.size(), n, "Missing events");
+    for (uint32_t i = 0; i < m_order.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_order[i], i, "Event run out of order");
+    }
+
+    ParallelConstruction::SetMaxThreads(0);
+}
+
+/**
+ * \ingroup parallel-construction-tests
+ * ParallelConstruction test suite.
+ */
+class ParallelConstructionTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    ParallelConstructionTestSuite();
+};
+
+ParallelConstructionTestSuite::ParallelConstructionTestSuite()
+    : TestSuite("parallel-construction")
+{
+    AddTestCase(new ParallelConstructionDeferTestCase);
+    AddTestCase(new ParallelConstructionStreamTestCase);
+    AddTestCase(new ParallelConstructionScheduleTestCase);
+}
+
+/**
+ * \ingroup parallel-construction-tests
+ * ParallelConstructionTestSuite instance variable.
+ */
+static ParallelConstructionTestSuite g_parallelConstructionTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
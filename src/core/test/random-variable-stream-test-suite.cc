@@ -24,6 +24,7 @@
 #include "ns3/double.h"
 #include "ns3/integer.h"
 #include "ns3/log.h"
+#include "ns3/object-factory.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/string.h"
@@ -32,6 +33,8 @@
 #include <cmath>
 #include <ctime>
 #include <fstream>
+#include <map>
+#include <vector>
 #include <gsl/gsl_cdf.h>
 #include <gsl/gsl_histogram.h>
 #include <gsl/gsl_randist.h>
@@ -2566,6 +2569,162 @@ NormalCachingTestCase::DoRun()
     NS_TEST_ASSERT_MSG_GT(v2, 0, "Incorrect value returned, expected > 0");
 }
 
+/**
+ * \ingroup rng-tests
+ * Test case for the batched GetValues() of the random variable streams
+ */
+class GetValuesTestCase : public TestCaseBase
+{
+  public:
+    // Constructor
+    GetValuesTestCase();
+
+  private:
+    // Inherited
+    void DoRun() override;
+
+    /**
+     * Check that GetValues() returns the same values as GetValue().
+     * \param [in] factory The factory of the random variable to check.
+     */
+    void Check(ObjectFactory factory);
+    /**
+     * Check that GetValues() returns the same values as GetValue().
+     * \param [in] batched The random variable to draw batches from.
+     * \param [in] single An identical random variable to draw values one at a time from.
+     */
+    void Check(Ptr<RandomVariableStream> batched, Ptr<RandomVariableStream> single);
+    /**
+     * Create an empirical random variable with an irregular CDF.
+     * \param [in] interpolate Whether to interpolate the CDF.
+     * \param [in] antithetic Whether to generate antithetic values.
+     * \returns The random variable.
+     */
+    Ptr<EmpiricalRandomVariable> CreateEmpirical(bool interpolate, bool antithetic) const;
+};
+
+GetValuesTestCase::GetValuesTestCase()
+    : TestCaseBase("RandomVariableStream batched values")
+{
+}
+
+void
+GetValuesTestCase::Check(ObjectFactory factory)
+{
+    Check(factory.Create<RandomVariableStream>(), factory.Create<RandomVariableStream>());
+}
+
+Ptr<EmpiricalRandomVariable>
+GetValuesTestCase::CreateEmpirical(bool interpolate, bool antithetic) const
+{
+    Ptr<EmpiricalRandomVariable> x = CreateObject<EmpiricalRandomVariable>();
+    x->SetInterpolate(interpolate);
+    x->SetAntithetic(antithetic);
+    // points bunched at both ends, as in flow size distributions
+    for (uint32_t i = 1; i < 100; i++)
+    {
+        double c = i / 100.0;
+        x->CDF(i * i, c * c * c);
+    }
+    x->CDF(1e6, 1.0);
+    return x;
+}
+
+void
+GetValuesTestCase::Check(Ptr<RandomVariableStream> batched, Ptr<RandomVariableStream> single)
+{
+    batched->SetStream(1);
+    single->SetStream(1);
+
+    // batches of all sizes, which must leave the streams in the same state
+    std::vector<double> values;
+    for (std::size_t n = 0; n < 64; n++)
+    {
+        values.resize(n);
+        batched->GetValues(values.data(), n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(values[i],
+                                  single->GetValue(),
+                                  batched->GetInstanceTypeId().GetName()
+                                      << " value " << i << " of batch " << n << " differs");
+        }
+        NS_TEST_ASSERT_MSG_EQ(batched->GetValue(),
+                              single->GetValue(),
+                              batched->GetInstanceTypeId().GetName()
+                                  << " differs after batch " << n);
+    }
+}
+
+void
+GetValuesTestCase::DoRun()
+{
+    NS_LOG_FUNCTION(this);
+    SetTestSuiteSeed();
+
+    for (bool antithetic : {false, true})
+    {
+        ObjectFactory factory("ns3::UniformRandomVariable");
+        factory.Set("Antithetic", BooleanValue(antithetic));
+        factory.Set("Min", DoubleValue(2));
+        factory.Set("Max", DoubleValue(5));
+        Check(factory);
+
+        factory = ObjectFactory("ns3::ExponentialRandomVariable");
+        factory.Set("Antithetic", BooleanValue(antithetic));
+        factory.Set("Mean", DoubleValue(3));
+        Check(factory);
+        factory.Set("Bound", DoubleValue(4));
+        Check(factory);
+
+        factory = ObjectFactory("ns3::ParetoRandomVariable");
+        factory.Set("Antithetic", BooleanValue(antithetic));
+        factory.Set("Shape", DoubleValue(2));
+        Check(factory);
+        factory.Set("Bound", DoubleValue(1.5));
+        Check(factory);
+
+        factory = ObjectFactory("ns3::NormalRandomVariable");
+        factory.Set("Antithetic", BooleanValue(antithetic));
+        factory.Set("Variance", DoubleValue(4));
+        Check(factory);
+        factory.Set("Bound", DoubleValue(1));
+        Check(factory);
+
+        // default implementation
+        factory = ObjectFactory("ns3::WeibullRandomVariable");
+        factory.Set("Antithetic", BooleanValue(antithetic));
+        Check(factory);
+
+        for (bool interpolate : {false, true})
+        {
+            Check(CreateEmpirical(interpolate, antithetic),
+                  CreateEmpirical(interpolate, antithetic));
+        }
+    }
+
+    // The sampling tables of EmpiricalRandomVariable must find the same
+    // CDF points as a search of the CDF.
+    Ptr<EmpiricalRandomVariable> x = CreateEmpirical(false, false);
+    Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable>();
+    x->SetStream(2);
+    u->SetStream(2);
+    std::map<double, double> cdf;
+    for (uint32_t i = 1; i < 100; i++)
+    {
+        double c = i / 100.0;
+        cdf[c * c * c] = i * i;
+    }
+    cdf[1.0] = 1e6;
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        double r = u->GetValue();
+        double expected = (r <= cdf.begin()->first) ? cdf.begin()->second
+                                                    : cdf.upper_bound(r)->second;
+        NS_TEST_ASSERT_MSG_EQ(x->GetValue(), expected, "Wrong CDF point for " << r);
+    }
+}
+
 /**
  * \ingroup rng-tests
  * Test case for bernoulli distribution random variable stream generator
@@ -2924,6 +3083,7 @@ RandomVariableSuite::RandomVariableSuite()
     AddTestCase(new EmpiricalAntitheticTestCase);
     /// Issue #302:  NormalRandomVariable produces stale values
     AddTestCase(new NormalCachingTestCase);
+    AddTestCase(new GetValuesTestCase);
     AddTestCase(new BernoulliTestCase);
     AddTestCase(new BernoulliAntitheticTestCase);
     AddTestCase(new BinomialTestCase);
@@ -16,11 +16,14 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include "ns3/deadline-timer.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 #include "ns3/timer.h"
 
+#include <vector>
+
 /**
  * \file
  * \ingroup timer-tests
@@ -220,6 +223,106 @@ TimerTemplateTestCase::DoTeardown()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup timer-tests
+ *
+ * \brief Check that a DeadlineTimer expires at its last deadline.
+ */
+class DeadlineTimerTestCase : public TestCase
+{
+  public:
+    DeadlineTimerTestCase();
+    void DoRun() override;
+
+    /** Record the expiry of the timer. */
+    void Expire();
+    /**
+     * Re-arm the timer.
+     * \param [in] delay The delay.
+     */
+    void Rearm(Time delay);
+
+    DeadlineTimer m_timer;       //!< The timer.
+    std::vector<Time> m_expired; //!< The times the timer expired.
+};
+
+DeadlineTimerTestCase::DeadlineTimerTestCase()
+    : TestCase("Check the expiry of a re-armed DeadlineTimer")
+{
+}
+
+void
+DeadlineTimerTestCase::Expire()
+{
+    m_expired.push_back(Simulator::Now());
+}
+
+void
+DeadlineTimerTestCase::Rearm(Time delay)
+{
+    m_timer.Schedule(delay);
+}
+
+void
+DeadlineTimerTestCase::DoRun()
+{
+    m_timer.SetFunction(MakeCallback(&DeadlineTimerTestCase::Expire, this));
+    NS_TEST_ASSERT_MSG_EQ(m_timer.IsExpired(), true, "");
+
+    // pushed later 100 times: one event, and one more to reach the deadline
+    m_timer.Schedule(Seconds(1));
+    for (int i = 1; i <= 100; i++)
+    {
+        Simulator::Schedule(MilliSeconds(5 * i), &DeadlineTimerTestCase::Rearm, this, Seconds(1));
+    }
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), 1, "");
+    NS_TEST_ASSERT_MSG_EQ(m_expired[0], Seconds(1.5), "");
+    NS_TEST_ASSERT_MSG_EQ(Simulator::GetEventCount(), 102, "");
+    Simulator::Destroy();
+
+    // moved earlier, then cancelled and re-armed
+    m_expired.clear();
+    m_timer.Schedule(Seconds(10));
+    Simulator::Schedule(Seconds(1), &DeadlineTimerTestCase::Rearm, this, Seconds(1));
+    Simulator::Schedule(Seconds(3), &DeadlineTimer::Schedule, &m_timer, Seconds(5));
+    Simulator::Schedule(Seconds(4), &DeadlineTimer::Cancel, &m_timer);
+    Simulator::Schedule(Seconds(6), &DeadlineTimerTestCase::Rearm, this, Seconds(3));
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), 2, "");
+    NS_TEST_ASSERT_MSG_EQ(m_expired[0], Seconds(2), "");
+    NS_TEST_ASSERT_MSG_EQ(m_expired[1], Seconds(9), "");
+    NS_TEST_ASSERT_MSG_EQ(m_timer.IsRunning(), false, "");
+
+    // removed
+    m_timer.Schedule(Seconds(1));
+    NS_TEST_ASSERT_MSG_EQ(m_timer.GetDelayLeft(), Seconds(1), "");
+    m_timer.Remove();
+    NS_TEST_ASSERT_MSG_EQ(m_timer.IsRunning(), false, "");
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), 2, "");
+
+    // an event scheduled elsewhere stands for the timer until re-armed
+    Time start = Simulator::Now();
+    m_timer.Schedule(Seconds(1));
+    m_timer = Simulator::Schedule(Seconds(2), &DeadlineTimerTestCase::Expire, this);
+    NS_TEST_ASSERT_MSG_EQ(m_timer.IsRunning(), true, "");
+    NS_TEST_ASSERT_MSG_EQ(m_timer.GetDelayLeft(), Seconds(2), "");
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), 3, "");
+    NS_TEST_ASSERT_MSG_EQ(m_expired[2], start + Seconds(2), "");
+    NS_TEST_ASSERT_MSG_EQ(m_timer.IsExpired(), true, "");
+    m_timer = Simulator::Schedule(Seconds(1), &DeadlineTimerTestCase::Expire, this);
+    m_timer.Cancel();
+    NS_TEST_ASSERT_MSG_EQ(m_timer.IsRunning(), false, "");
+    m_timer = Simulator::Schedule(Seconds(1), &DeadlineTimerTestCase::Expire, this);
+    m_timer.Schedule(Seconds(3));
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), 4, "");
+    NS_TEST_ASSERT_MSG_EQ(m_expired[3], start + Seconds(5), "");
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup timer-tests
  *
@@ -233,6 +336,7 @@ class TimerTestSuite : public TestSuite
     {
         AddTestCase(new TimerStateTestCase(), TestCase::QUICK);
         AddTestCase(new TimerTemplateTestCase(), TestCase::QUICK);
+        AddTestCase(new DeadlineTimerTestCase(), TestCase::QUICK);
     }
 };
 
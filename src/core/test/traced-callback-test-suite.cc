@@ -131,6 +131,17 @@ BasicTracedCallbackTestCase::DoRun()
     trace(1, 2);
     NS_TEST_ASSERT_MSG_EQ(m_one, true, "Callback CbOne not called");
     NS_TEST_ASSERT_MSG_EQ(m_two, true, "Callback CbTwo not called");
+    //
+    // A callback may connect another one while the trace is being hit, in
+    // which case the new callback is called too.
+    //
+    TracedCallback<uint8_t, double> chain;
+    chain.ConnectWithoutContext(Callback<void, uint8_t, double>([this, &chain](uint8_t, double) {
+        chain.ConnectWithoutContext(MakeCallback(&BasicTracedCallbackTestCase::CbOne, this));
+    }));
+    m_one = false;
+    chain(1, 2);
+    NS_TEST_ASSERT_MSG_EQ(m_one, true, "Callback CbOne not called");
 }
 
 /**
@@ -0,0 +1,271 @@
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef FLOW_CLASSIFIER_TABLE_H
+#define FLOW_CLASSIFIER_TABLE_H
+
+#include "flow-classifier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/// \ingroup flow-monitor
+/// The flows of a classifier, found by their tuple, which the packets of
+/// known flows are classified with without any lock.
+///
+/// The flows are found in an open-addressing hash table of pointers that
+/// is only ever added to.  New flows are added under a lock, to a new
+/// table twice as large once the current one is half full; the replaced
+/// tables are kept until the flow table is deleted, as other threads may
+/// still be reading them.
+///
+/// Flows mostly carry a single DSCP value: only the packets of the DSCP
+/// value of the first packet are counted without a lock.
+///
+/// \tparam Tuple the flow tuple, with an equal to operator
+/// \tparam Hash the hash function of the tuples
+/// \tparam Dscp the DSCP type
+template <typename Tuple, typename Hash, typename Dscp>
+class FlowClassifierTable
+{
+  public:
+    /// A classified flow
+    struct Flow
+    {
+        Tuple tuple;                          //!< flow tuple
+        FlowId flowId;                        //!< FlowId
+        std::atomic<FlowPacketId> packets{0}; //!< number of packets classified
+        Dscp dscp;                            //!< DSCP value of the first packet
+        std::atomic<uint32_t> dscpPackets{0}; //!< number of packets with that DSCP value
+        std::map<Dscp, uint32_t> otherDscps;  //!< packets with other DSCP values, under the lock
+    };
+
+    FlowClassifierTable();
+
+    /// Count a packet in its flow, adding the flow if not found
+    /// \param tuple the flow tuple
+    /// \param dscp the DSCP value of the packet
+    /// \param newFlowId function returning a new FlowId, called under the lock
+    /// \param out_packetId the identifier of the packet in its flow
+    /// \returns the flow
+    template <typename F>
+    const Flow* Classify(const Tuple& tuple, Dscp dscp, F newFlowId, FlowPacketId* out_packetId);
+
+    /// Find a flow by FlowId
+    /// \param flowId the FlowId
+    /// \returns the flow, or nullptr if not found
+    const Flow* Find(FlowId flowId) const;
+
+    /// Get the number of packets of a flow by DSCP value
+    /// \param flow the flow
+    /// \returns the DSCP values and packet counts, by DSCP value
+    std::vector<std::pair<Dscp, uint32_t>> GetDscpCounts(const Flow* flow) const;
+
+    /// \returns the flows, sorted by tuple
+    std::vector<const Flow*> GetFlows() const;
+
+  private:
+    /// A hash table of flows
+    struct Slots
+    {
+        std::unique_ptr<std::atomic<Flow*>[]> flows; //!< flows, nullptr in the free slots
+        uint32_t mask;                               //!< number of slots minus one
+    };
+
+    /// Find a flow in a hash table
+    /// \param slots the hash table
+    /// \param tuple the flow tuple
+    /// \param hash the hash of the tuple
+    /// \returns the flow, or nullptr if not found
+    static Flow* Lookup(const Slots* slots, const Tuple& tuple, std::size_t hash);
+
+    /// Add a flow to a hash table with a free slot.  Not thread-safe.
+    /// \param slots the hash table
+    /// \param flow the flow
+    static void Insert(Slots* slots, Flow* flow);
+
+    /// Create a hash table, made current.  Not thread-safe.
+    /// \param capacity the number of slots, a power of two
+    void NewSlots(uint32_t capacity);
+
+    std::atomic<Slots*> m_slots;                 //!< current hash table
+    std::vector<std::unique_ptr<Slots>> m_tables; //!< current and replaced hash tables
+    std::vector<std::unique_ptr<Flow>> m_flows;   //!< flows, by FlowId
+    mutable std::mutex m_mutex;                   //!< lock of the additions
+};
+
+template <typename Tuple, typename Hash, typename Dscp>
+FlowClassifierTable<Tuple, Hash, Dscp>::FlowClassifierTable()
+{
+    NewSlots(64);
+}
+
+template <typename Tuple, typename Hash, typename Dscp>
+template <typename F>
+const typename FlowClassifierTable<Tuple, Hash, Dscp>::Flow*
+FlowClassifierTable<Tuple, Hash, Dscp>::Classify(const Tuple& tuple,
+                                                 Dscp dscp,
+                                                 F newFlowId,
+                                                 FlowPacketId* out_packetId)
+{
+    std::size_t hash = Hash()(tuple);
+    Flow* flow = Lookup(m_slots.load(std::memory_order_acquire), tuple, hash);
+    if (flow == nullptr)
+    {
+        // the flow may have been added meanwhile, possibly to a new table
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Slots* slots = m_slots.load(std::memory_order_relaxed);
+        flow = Lookup(slots, tuple, hash);
+        if (flow == nullptr)
+        {
+            flow = m_flows.emplace_back(std::make_unique<Flow>()).get();
+            flow->tuple = tuple;
+            flow->flowId = newFlowId();
+            flow->dscp = dscp;
+            if (m_flows.size() * 2 > slots->mask + 1)
+            {
+                NewSlots((slots->mask + 1) * 2);
+            }
+            else
+            {
+                Insert(slots, flow);
+            }
+        }
+    }
+
+    *out_packetId = flow->packets.fetch_add(1, std::memory_order_relaxed);
+    if (dscp == flow->dscp)
+    {
+        flow->dscpPackets.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        flow->otherDscps[dscp]++;
+    }
+    return flow;
+}
+
+template <typename Tuple, typename Hash, typename Dscp>
+const typename FlowClassifierTable<Tuple, Hash, Dscp>::Flow*
+FlowClassifierTable<Tuple, Hash, Dscp>::Find(FlowId flowId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // the FlowIds are assigned in increasing order
+    auto flow = std::lower_bound(m_flows.begin(),
+                                 m_flows.end(),
+                                 flowId,
+                                 [](const std::unique_ptr<Flow>& f, FlowId id) {
+                                     return f->flowId < id;
+                                 });
+    if (flow == m_flows.end() || (*flow)->flowId != flowId)
+    {
+        return nullptr;
+    }
+    return flow->get();
+}
+
+template <typename Tuple, typename Hash, typename Dscp>
+std::vector<std::pair<Dscp, uint32_t>>
+FlowClassifierTable<Tuple, Hash, Dscp>::GetDscpCounts(const Flow* flow) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<Dscp, uint32_t> counts = flow->otherDscps;
+    uint32_t dscpPackets = flow->dscpPackets.load(std::memory_order_relaxed);
+    if (dscpPackets > 0)
+    {
+        counts[flow->dscp] = dscpPackets;
+    }
+    return std::vector<std::pair<Dscp, uint32_t>>(counts.begin(), counts.end());
+}
+
+template <typename Tuple, typename Hash, typename Dscp>
+std::vector<const typename FlowClassifierTable<Tuple, Hash, Dscp>::Flow*>
+FlowClassifierTable<Tuple, Hash, Dscp>::GetFlows() const
+{
+    std::vector<const Flow*> flows;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& flow : m_flows)
+        {
+            flows.push_back(flow.get());
+        }
+    }
+    std::sort(flows.begin(), flows.end(), [](const Flow* a, const Flow* b) {
+        return a->tuple < b->tuple;
+    });
+    return flows;
+}
+
+template <typename Tuple, typename Hash, typename Dscp>
+typename FlowClassifierTable<Tuple, Hash, Dscp>::Flow*
+FlowClassifierTable<Tuple, Hash, Dscp>::Lookup(const Slots* slots,
+                                               const Tuple& tuple,
+                                               std::size_t hash)
+{
+    // the table is never more than half full, so the probing always ends
+    for (uint32_t i = hash & slots->mask;; i = (i + 1) & slots->mask)
+    {
+        Flow* flow = slots->flows[i].load(std::memory_order_acquire);
+        if (flow == nullptr || flow->tuple == tuple)
+        {
+            return flow;
+        }
+    }
+}
+
+template <typename Tuple, typename Hash, typename Dscp>
+void
+FlowClassifierTable<Tuple, Hash, Dscp>::Insert(Slots* slots, Flow* flow)
+{
+    uint32_t i = Hash()(flow->tuple) & slots->mask;
+    while (slots->flows[i].load(std::memory_order_relaxed) != nullptr)
+    {
+        i = (i + 1) & slots->mask;
+    }
+    // published once complete
+    slots->flows[i].store(flow, std::memory_order_release);
+}
+
+template <typename Tuple, typename Hash, typename Dscp>
+void
+FlowClassifierTable<Tuple, Hash, Dscp>::NewSlots(uint32_t capacity)
+{
+    auto slots = std::make_unique<Slots>();
+    slots->flows = std::make_unique<std::atomic<Flow*>[]>(capacity);
+    slots->mask = capacity - 1;
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        slots->flows[i].store(nullptr, std::memory_order_relaxed);
+    }
+    for (const auto& flow : m_flows)
+    {
+        Insert(slots.get(), flow.get());
+    }
+    m_slots.store(slots.get(), std::memory_order_release);
+    m_tables.push_back(std::move(slots));
+}
+
+} // namespace ns3
+
+#endif /* FLOW_CLASSIFIER_TABLE_H */
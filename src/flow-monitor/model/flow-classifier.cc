@@ -34,7 +34,11 @@ FlowClassifier::~FlowClassifier()
 FlowId
 FlowClassifier::GetNewFlowId()
 {
+#ifdef NS3_MTP
+    return m_lastNewFlowId.fetch_add(1, std::memory_order_relaxed) + 1;
+#else
     return ++m_lastNewFlowId;
+#endif
 }
 
 } // namespace ns3
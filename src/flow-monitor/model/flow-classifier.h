@@ -22,6 +22,7 @@
 
 #include "ns3/simple-ref-count.h"
 
+#include <atomic>
 #include <ostream>
 
 namespace ns3
@@ -53,7 +54,11 @@ typedef uint32_t FlowPacketId;
 class FlowClassifier : public SimpleRefCount<FlowClassifier>
 {
   private:
+#ifdef NS3_MTP
+    std::atomic<FlowId> m_lastNewFlowId; //!< Last known Flow ID
+#else
     FlowId m_lastNewFlowId; //!< Last known Flow ID
+#endif
 
   public:
     FlowClassifier();
@@ -69,7 +74,8 @@ class FlowClassifier : public SimpleRefCount<FlowClassifier>
     virtual void SerializeToXmlStream(std::ostream& os, uint16_t indent) const = 0;
 
   protected:
-    /// Returns a new, unique Flow Identifier
+    /// Returns a new, unique Flow Identifier.  In MTP builds this is
+    /// lock-free and may be called concurrently.
     /// \returns a new FlowId
     FlowId GetNewFlowId();
 
@@ -21,8 +21,10 @@
 
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/node-list.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -35,6 +37,149 @@ NS_LOG_COMPONENT_DEFINE("FlowMonitor");
 
 NS_OBJECT_ENSURE_REGISTERED(FlowMonitor);
 
+/**
+ * Mix the bits of a tracked packet key (the splitmix64 finalizer)
+ *
+ * \param key the key
+ * \returns the hash of the key
+ */
+static inline uint64_t
+TrackedPacketHash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+FlowMonitor::TrackedPacket*
+FlowMonitor::TrackedPacketTable::Find(uint64_t key)
+{
+    if (m_size == 0)
+    {
+        return nullptr;
+    }
+    // the table is never more than half full, so the probing always ends
+    uint32_t mask = m_slots.size() - 1;
+    for (uint32_t i = TrackedPacketHash(key) & mask;; i = (i + 1) & mask)
+    {
+        Slot& slot = m_slots[i];
+        if (!slot.used)
+        {
+            return nullptr;
+        }
+        if (slot.key == key)
+        {
+            return &slot.packet;
+        }
+    }
+}
+
+FlowMonitor::TrackedPacket&
+FlowMonitor::TrackedPacketTable::Insert(uint64_t key)
+{
+    if ((m_size + 1) * 2 > m_slots.size())
+    {
+        Grow();
+    }
+    uint32_t mask = m_slots.size() - 1;
+    for (uint32_t i = TrackedPacketHash(key) & mask;; i = (i + 1) & mask)
+    {
+        Slot& slot = m_slots[i];
+        if (!slot.used)
+        {
+            slot.used = true;
+            slot.key = key;
+            slot.packet = TrackedPacket();
+            m_size++;
+            return slot.packet;
+        }
+        if (slot.key == key)
+        {
+            return slot.packet;
+        }
+    }
+}
+
+void
+FlowMonitor::TrackedPacketTable::Erase(uint64_t key)
+{
+    if (m_size == 0)
+    {
+        return;
+    }
+    uint32_t mask = m_slots.size() - 1;
+    for (uint32_t i = TrackedPacketHash(key) & mask; m_slots[i].used; i = (i + 1) & mask)
+    {
+        if (m_slots[i].key == key)
+        {
+            EraseSlot(i);
+            return;
+        }
+    }
+}
+
+template <typename F>
+void
+FlowMonitor::TrackedPacketTable::EraseIf(F pred)
+{
+    // EraseSlot() only moves slots backwards into the erased one, so the
+    // current index is examined again after an erase instead of skipped
+    for (uint32_t i = 0; i < m_slots.size();)
+    {
+        if (m_slots[i].used && pred(m_slots[i].key, m_slots[i].packet))
+        {
+            EraseSlot(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+void
+FlowMonitor::TrackedPacketTable::Grow()
+{
+    std::vector<Slot> old(std::max<std::size_t>(16, m_slots.size() * 2));
+    old.swap(m_slots);
+    uint32_t mask = m_slots.size() - 1;
+    for (const auto& slot : old)
+    {
+        if (!slot.used)
+        {
+            continue;
+        }
+        uint32_t i = TrackedPacketHash(slot.key) & mask;
+        while (m_slots[i].used)
+        {
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = slot;
+    }
+}
+
+void
+FlowMonitor::TrackedPacketTable::EraseSlot(uint32_t index)
+{
+    uint32_t mask = m_slots.size() - 1;
+    uint32_t hole = index;
+    for (uint32_t j = (hole + 1) & mask; m_slots[j].used; j = (j + 1) & mask)
+    {
+        // a slot may fill the hole only if the hole is not before its home slot
+        uint32_t home = TrackedPacketHash(m_slots[j].key) & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            m_slots[hole] = m_slots[j];
+            hole = j;
+        }
+    }
+    m_slots[hole].used = false;
+    m_size--;
+}
+
 TypeId
 FlowMonitor::GetTypeId()
 {
@@ -94,9 +239,6 @@ FlowMonitor::FlowMonitor()
     : m_enabled(false)
 {
     NS_LOG_FUNCTION(this);
-#ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_relaxed);
-#endif
 }
 
 void
@@ -121,10 +263,21 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow(FlowId flowId)
 {
     NS_LOG_FUNCTION(this);
-    auto iter = m_flowStats.find(flowId);
-    if (iter == m_flowStats.end())
+#ifdef NS3_MTP
+    // each LP only ever touches its own shard, so no lock is needed
+    uint32_t systemId = Simulator::GetSystemId();
+    NS_ABORT_MSG_IF(systemId >= m_flowStatsShards.size(),
+                    "FlowMonitor has no statistics shard for LP " << systemId);
+    FlowStatsShard& shard = m_flowStatsShards[systemId];
+    shard.version++;
+    FlowStatsContainer& flowStats = shard.stats;
+#else
+    FlowStatsContainer& flowStats = m_flowStats;
+#endif
+    auto iter = flowStats.find(flowId);
+    if (iter == flowStats.end())
     {
-        FlowMonitor::FlowStats& ref = m_flowStats[flowId];
+        FlowMonitor::FlowStats& ref = flowStats[flowId];
         ref.delaySum = Seconds(0);
         ref.jitterSum = Seconds(0);
         ref.lastDelay = Seconds(0);
@@ -146,6 +299,34 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
     }
 }
 
+inline uint64_t
+FlowMonitor::TrackedPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (static_cast<uint64_t>(flowId) << 32) | packetId;
+}
+
+inline FlowMonitor::TrackedPacketStripe&
+FlowMonitor::LockStripe(FlowId flowId, FlowPacketId packetId)
+{
+    // consecutive packets of a flow go to consecutive stripes
+    TrackedPacketStripe& stripe =
+        m_trackedPackets[(packetId + flowId * 0x9e3779b1U) & (TRACKED_PACKET_STRIPES - 1)];
+#ifdef NS3_MTP
+    while (stripe.lock.exchange(true, std::memory_order_acquire))
+    {
+    };
+#endif
+    return stripe;
+}
+
+inline void
+FlowMonitor::UnlockStripe(TrackedPacketStripe& stripe)
+{
+#ifdef NS3_MTP
+    stripe.lock.store(false, std::memory_order_release);
+#endif
+}
+
 void
 FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
                            uint32_t flowId,
@@ -160,16 +341,12 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
     }
     Time now = Simulator::Now();
 
-#ifdef NS3_MTP
-    while (m_lock.exchange(true, std::memory_order_acquire))
-    {
-    };
-#endif
-
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
+    TrackedPacketStripe& stripe = LockStripe(flowId, packetId);
+    TrackedPacket& tracked = stripe.packets.Insert(TrackedPacketKey(flowId, packetId));
     tracked.firstSeenTime = now;
     tracked.lastSeenTime = tracked.firstSeenTime;
     tracked.timesForwarded = 0;
+    UnlockStripe(stripe);
     NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
                                                                  << packetId << ").");
 
@@ -183,10 +360,6 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         stats.timeFirstTxPacket = now;
     }
     stats.timeLastTxPacket = now;
-
-#ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_release);
-#endif
 }
 
 void
@@ -202,33 +375,23 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         return;
     }
 
-#ifdef NS3_MTP
-    while (m_lock.exchange(true, std::memory_order_acquire))
-    {
-    };
-#endif
-
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    auto tracked = m_trackedPackets.find(key);
-    if (tracked == m_trackedPackets.end())
+    TrackedPacketStripe& stripe = LockStripe(flowId, packetId);
+    TrackedPacket* tracked = stripe.packets.Find(TrackedPacketKey(flowId, packetId));
+    if (tracked == nullptr)
     {
+        UnlockStripe(stripe);
         NS_LOG_WARN("Received packet forward report (flowId="
                     << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
-#ifdef NS3_MTP
-        m_lock.store(false, std::memory_order_release);
-#endif
         return;
     }
 
-    tracked->second.timesForwarded++;
-    tracked->second.lastSeenTime = Simulator::Now();
+    tracked->timesForwarded++;
+    tracked->lastSeenTime = Simulator::Now();
 
-    Time delay = (Simulator::Now() - tracked->second.firstSeenTime);
-    probe->AddPacketStats(flowId, packetSize, delay);
+    Time delay = (Simulator::Now() - tracked->firstSeenTime);
+    UnlockStripe(stripe);
 
-#ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_release);
-#endif
+    probe->AddPacketStats(flowId, packetSize, delay);
 }
 
 void
@@ -244,25 +407,23 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         return;
     }
 
-#ifdef NS3_MTP
-    while (m_lock.exchange(true, std::memory_order_acquire))
-    {
-    };
-#endif
-
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked == m_trackedPackets.end())
+    uint64_t key = TrackedPacketKey(flowId, packetId);
+    TrackedPacketStripe& stripe = LockStripe(flowId, packetId);
+    TrackedPacket* tracked = stripe.packets.Find(key);
+    if (tracked == nullptr)
     {
+        UnlockStripe(stripe);
         NS_LOG_WARN("Received packet last-tx report (flowId="
                     << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
-#ifdef NS3_MTP
-        m_lock.store(false, std::memory_order_release);
-#endif
         return;
     }
 
     Time now = Simulator::Now();
-    Time delay = (now - tracked->second.firstSeenTime);
+    Time delay = (now - tracked->firstSeenTime);
+    uint32_t timesForwarded = tracked->timesForwarded;
+    stripe.packets.Erase(key); // we don't need to track this packet anymore
+    UnlockStripe(stripe);
+
     probe->AddPacketStats(flowId, packetSize, delay);
 
     FlowStats& stats = GetStatsForFlow(flowId);
@@ -301,16 +462,10 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         }
     }
     stats.timeLastRxPacket = now;
-    stats.timesForwarded += tracked->second.timesForwarded;
+    stats.timesForwarded += timesForwarded;
 
-    NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
-                                                                  << packetId << ").");
-
-    m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
-
-#ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_release);
-#endif
+    NS_LOG_DEBUG("ReportLastTx: removed tracked packet (flowId=" << flowId << ", packetId="
+                                                                 << packetId << ").");
 }
 
 void
@@ -327,12 +482,6 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
         return;
     }
 
-#ifdef NS3_MTP
-    while (m_lock.exchange(true, std::memory_order_acquire))
-    {
-    };
-#endif
-
     probe->AddPacketDropStats(flowId, packetSize, reasonCode);
 
     FlowStats& stats = GetStatsForFlow(flowId);
@@ -347,49 +496,145 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked != m_trackedPackets.end())
-    {
-        // we don't need to track this packet anymore
-        // FIXME: this will not necessarily be true with broadcast/multicast
-        NS_LOG_DEBUG("ReportDrop: removing tracked packet (flowId=" << flowId << ", packetId="
-                                                                    << packetId << ").");
-        m_trackedPackets.erase(tracked);
-    }
-
-#ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_release);
-#endif
+    // we don't need to track this packet anymore
+    // FIXME: this will not necessarily be true with broadcast/multicast
+    NS_LOG_DEBUG("ReportDrop: removing tracked packet (flowId=" << flowId << ", packetId="
+                                                                << packetId << ").");
+    TrackedPacketStripe& stripe = LockStripe(flowId, packetId);
+    stripe.packets.Erase(TrackedPacketKey(flowId, packetId));
+    UnlockStripe(stripe);
 }
 
 const FlowMonitor::FlowStatsContainer&
 FlowMonitor::GetFlowStats() const
 {
+#ifdef NS3_MTP
+    MergeFlowStats();
+#endif
     return m_flowStats;
 }
 
+#ifdef NS3_MTP
+/**
+ * Add the contents of a histogram to another one with the same bin width
+ *
+ * \param total the histogram to add to
+ * \param part the histogram to add
+ */
+static void
+MergeHistogram(Histogram& total, const Histogram& part)
+{
+    for (uint32_t i = 0; i < part.GetNBins(); i++)
+    {
+        uint32_t count = part.GetBinCount(i);
+        if (count > 0)
+        {
+            total.AddBinCount(i, count);
+        }
+    }
+}
+
+void
+FlowMonitor::MergeFlowStats() const
+{
+    NS_LOG_FUNCTION(this);
+    // the merged view is only rebuilt after the shards changed
+    bool changed = m_mergedVersions.size() != m_flowStatsShards.size();
+    m_mergedVersions.resize(m_flowStatsShards.size());
+    for (std::size_t i = 0; i < m_flowStatsShards.size(); i++)
+    {
+        changed |= m_mergedVersions[i] != m_flowStatsShards[i].version;
+        m_mergedVersions[i] = m_flowStatsShards[i].version;
+    }
+    if (!changed)
+    {
+        return;
+    }
+    m_flowStats.clear();
+    for (const auto& shard : m_flowStatsShards)
+    {
+        for (const auto& [flowId, part] : shard.stats)
+        {
+            auto [iter, inserted] = m_flowStats.emplace(flowId, part);
+            if (inserted)
+            {
+                continue;
+            }
+            FlowStats& total = iter->second;
+            if (part.txPackets > 0)
+            {
+                if (total.txPackets == 0 || part.timeFirstTxPacket < total.timeFirstTxPacket)
+                {
+                    total.timeFirstTxPacket = part.timeFirstTxPacket;
+                }
+                if (total.txPackets == 0 || part.timeLastTxPacket > total.timeLastTxPacket)
+                {
+                    total.timeLastTxPacket = part.timeLastTxPacket;
+                }
+            }
+            if (part.rxPackets > 0)
+            {
+                if (total.rxPackets == 0 || part.timeFirstRxPacket < total.timeFirstRxPacket)
+                {
+                    total.timeFirstRxPacket = part.timeFirstRxPacket;
+                }
+                if (total.rxPackets == 0 || part.timeLastRxPacket > total.timeLastRxPacket)
+                {
+                    total.timeLastRxPacket = part.timeLastRxPacket;
+                    total.lastDelay = part.lastDelay;
+                }
+            }
+            total.delaySum += part.delaySum;
+            total.jitterSum += part.jitterSum;
+            total.txBytes += part.txBytes;
+            total.rxBytes += part.rxBytes;
+            total.txPackets += part.txPackets;
+            total.rxPackets += part.rxPackets;
+            total.lostPackets += part.lostPackets;
+            total.timesForwarded += part.timesForwarded;
+            MergeHistogram(total.delayHistogram, part.delayHistogram);
+            MergeHistogram(total.jitterHistogram, part.jitterHistogram);
+            MergeHistogram(total.packetSizeHistogram, part.packetSizeHistogram);
+            MergeHistogram(total.flowInterruptionsHistogram, part.flowInterruptionsHistogram);
+            if (total.packetsDropped.size() < part.packetsDropped.size())
+            {
+                total.packetsDropped.resize(part.packetsDropped.size(), 0);
+                total.bytesDropped.resize(part.bytesDropped.size(), 0);
+            }
+            for (std::size_t reasonCode = 0; reasonCode < part.packetsDropped.size(); reasonCode++)
+            {
+                total.packetsDropped[reasonCode] += part.packetsDropped[reasonCode];
+                total.bytesDropped[reasonCode] += part.bytesDropped[reasonCode];
+            }
+        }
+    }
+}
+#endif
+
 void
 FlowMonitor::CheckForLostPackets(Time maxDelay)
 {
     NS_LOG_FUNCTION(this << maxDelay.As(Time::S));
     Time now = Simulator::Now();
 
-    for (auto iter = m_trackedPackets.begin(); iter != m_trackedPackets.end();)
+    for (auto& stripe : m_trackedPackets)
     {
-        if (now - iter->second.lastSeenTime >= maxDelay)
-        {
-            // packet is considered lost, add it to the loss statistics
-            auto flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
-
-            // we won't track it anymore
-            m_trackedPackets.erase(iter++);
-        }
-        else
+#ifdef NS3_MTP
+        while (stripe.lock.exchange(true, std::memory_order_acquire))
         {
-            iter++;
-        }
+        };
+#endif
+        stripe.packets.EraseIf([this, now, maxDelay](uint64_t key, const TrackedPacket& tracked) {
+            if (now - tracked.lastSeenTime < maxDelay)
+            {
+                return false;
+            }
+            // packet is considered lost, add it to the loss statistics; we
+            // won't track it anymore
+            GetStatsForFlow(key >> 32).lostPackets++;
+            return true;
+        });
+        UnlockStripe(stripe);
     }
 }
 
@@ -457,6 +702,13 @@ FlowMonitor::StartRightNow()
         NS_LOG_DEBUG("FlowMonitor already enabled; returning");
         return;
     }
+#ifdef NS3_MTP
+    // one shard per LP; LPs never outnumber the nodes plus the public LP
+    if (m_flowStatsShards.size() < NodeList::GetNNodes() + 1)
+    {
+        m_flowStatsShards.resize(NodeList::GetNNodes() + 1);
+    }
+#endif
     m_enabled = true;
 }
 
@@ -487,6 +739,9 @@ FlowMonitor::SerializeToXmlStream(std::ostream& os,
 {
     NS_LOG_FUNCTION(this << indent << enableHistograms << enableProbes);
     CheckForLostPackets();
+#ifdef NS3_MTP
+    MergeFlowStats();
+#endif
 
     os << std::string(indent, ' ') << "<FlowMonitor>\n";
     indent += 2;
@@ -585,25 +840,36 @@ FlowMonitor::ResetAllStats()
 {
     NS_LOG_FUNCTION(this);
 
-    for (auto& iter : m_flowStats)
-    {
-        auto& flowStat = iter.second;
-        flowStat.delaySum = Seconds(0);
-        flowStat.jitterSum = Seconds(0);
-        flowStat.lastDelay = Seconds(0);
-        flowStat.txBytes = 0;
-        flowStat.rxBytes = 0;
-        flowStat.txPackets = 0;
-        flowStat.rxPackets = 0;
-        flowStat.lostPackets = 0;
-        flowStat.timesForwarded = 0;
-        flowStat.bytesDropped.clear();
-        flowStat.packetsDropped.clear();
-
-        flowStat.delayHistogram.Clear();
-        flowStat.jitterHistogram.Clear();
-        flowStat.packetSizeHistogram.Clear();
-        flowStat.flowInterruptionsHistogram.Clear();
+    std::vector<FlowStatsContainer*> containers{&m_flowStats};
+#ifdef NS3_MTP
+    for (auto& shard : m_flowStatsShards)
+    {
+        containers.push_back(&shard.stats);
+        shard.version++;
+    }
+#endif
+    for (auto container : containers)
+    {
+        for (auto& iter : *container)
+        {
+            auto& flowStat = iter.second;
+            flowStat.delaySum = Seconds(0);
+            flowStat.jitterSum = Seconds(0);
+            flowStat.lastDelay = Seconds(0);
+            flowStat.txBytes = 0;
+            flowStat.rxBytes = 0;
+            flowStat.txPackets = 0;
+            flowStat.rxPackets = 0;
+            flowStat.lostPackets = 0;
+            flowStat.timesForwarded = 0;
+            flowStat.bytesDropped.clear();
+            flowStat.packetsDropped.clear();
+
+            flowStat.delayHistogram.Clear();
+            flowStat.jitterHistogram.Clear();
+            flowStat.packetSizeHistogram.Clear();
+            flowStat.flowInterruptionsHistogram.Clear();
+        }
     }
 }
 
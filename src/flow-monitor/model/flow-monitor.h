@@ -29,6 +29,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 
+#include <array>
 #include <atomic>
 #include <map>
 #include <vector>
@@ -48,6 +49,12 @@ namespace ns3
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * In MTP builds the flow statistics are kept in one shard per logical
+ * process, so that probes on different LPs never contend for them; the
+ * shards are merged whenever the statistics are read back.  The tracked
+ * packets are spread over a fixed number of independently locked
+ * open-addressing hash tables, since a packet is usually transmitted and
+ * received by nodes on different LPs.
  */
 class FlowMonitor : public Object
 {
@@ -291,14 +298,83 @@ class FlowMonitor : public Object
         uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
     };
 
-    /// FlowId --> FlowStats
-    FlowStatsContainer m_flowStats;
+    /// (FlowId,PacketId) --> TrackedPacket open-addressing hash table, using
+    /// linear probing and backward-shift deletion
+    class TrackedPacketTable
+    {
+      public:
+        /// Find a tracked packet
+        /// \param key the (FlowId,PacketId) key, see TrackedPacketKey()
+        /// \returns the tracked packet, or nullptr if it is not in the table
+        TrackedPacket* Find(uint64_t key);
+        /// Find a tracked packet, adding it to the table if not there yet
+        /// \param key the (FlowId,PacketId) key, see TrackedPacketKey()
+        /// \returns the tracked packet
+        TrackedPacket& Insert(uint64_t key);
+        /// Remove a tracked packet from the table, if present
+        /// \param key the (FlowId,PacketId) key, see TrackedPacketKey()
+        void Erase(uint64_t key);
+        /// Remove all the tracked packets for which a predicate holds
+        /// \param pred predicate called with the key and the tracked packet
+        template <typename F>
+        void EraseIf(F pred);
+
+      private:
+        /// A table slot
+        struct Slot
+        {
+            uint64_t key{0};      //!< (FlowId,PacketId) key
+            TrackedPacket packet; //!< tracked packet data
+            bool used{false};     //!< whether the slot holds a packet
+        };
+
+        /// Double the table capacity and rehash all the slots
+        void Grow();
+        /// Empty a slot, shifting back the slots of its probe sequence
+        /// \param index the slot index
+        void EraseSlot(uint32_t index);
+
+        std::vector<Slot> m_slots; //!< slots, the capacity is a power of two
+        uint32_t m_size{0};        //!< number of used slots
+    };
+
+    /// Number of independently locked tracked packet tables
+#ifdef NS3_MTP
+    static constexpr uint32_t TRACKED_PACKET_STRIPES = 64;
+#else
+    static constexpr uint32_t TRACKED_PACKET_STRIPES = 1;
+#endif
+
+    /// A slice of the tracked packets, with its own lock in MTP builds
+    struct alignas(64) TrackedPacketStripe
+    {
+        TrackedPacketTable packets; //!< tracked packets of this stripe
+#ifdef NS3_MTP
+        std::atomic<bool> lock{false}; //!< lock protecting the packets
+#endif
+    };
+
+    /// FlowId --> FlowStats.  In MTP builds this is only a merged view of
+    /// m_flowStatsShards, rebuilt by MergeFlowStats() when they changed
+    mutable FlowStatsContainer m_flowStats;
+
+#ifdef NS3_MTP
+    /// Flow statistics recorded by the probes of one logical process
+    struct alignas(64) FlowStatsShard
+    {
+        FlowStatsContainer stats; //!< FlowId --> FlowStats
+        uint64_t version{0};      //!< incremented whenever the stats may change
+    };
+
+    std::vector<FlowStatsShard> m_flowStatsShards; //!< flow stats indexed by LP system id
+    /// versions of the shards merged into m_flowStats
+    mutable std::vector<uint64_t> m_mergedVersions;
+#endif
 
     /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
-    TrackedPacketMap m_trackedPackets; //!< Tracked packets
-    Time m_maxPerHopDelay;             //!< Minimum per-hop delay
-    FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
+    std::array<TrackedPacketStripe, TRACKED_PACKET_STRIPES> m_trackedPackets;
+    Time m_maxPerHopDelay;           //!< Minimum per-hop delay
+    FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
     // note: this is needed only for serialization
     std::list<Ptr<FlowClassifier>> m_classifiers; //!< the FlowClassifiers
@@ -311,15 +387,34 @@ class FlowMonitor : public Object
     double m_packetSizeBinWidth;        //!< packet size bin width (for histograms)
     double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
     Time m_flowInterruptionsMinTime;    //!< Flow interruptions minimum time
-#ifdef NS3_MTP
-    std::atomic<bool> m_lock;
-#endif
 
-    /// Get the stats for a given flow
+    /// Get the stats for a given flow, as recorded by the current LP in MTP builds
     /// \param flowId the Flow identification
     /// \returns the stats of the flow
     FlowStats& GetStatsForFlow(FlowId flowId);
 
+    /// Build the tracked packet table key of a packet
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet identification
+    /// \returns the key
+    static uint64_t TrackedPacketKey(FlowId flowId, FlowPacketId packetId);
+
+    /// Find and lock the stripe holding a tracked packet
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet identification
+    /// \returns the locked stripe
+    TrackedPacketStripe& LockStripe(FlowId flowId, FlowPacketId packetId);
+
+    /// Unlock a stripe locked by LockStripe()
+    /// \param stripe the stripe
+    void UnlockStripe(TrackedPacketStripe& stripe);
+
+#ifdef NS3_MTP
+    /// Rebuild m_flowStats from the per-LP shards, if they changed since
+    /// the last merge
+    void MergeFlowStats() const;
+#endif
+
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
 };
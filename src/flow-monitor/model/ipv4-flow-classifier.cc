@@ -91,11 +91,24 @@ operator==(const Ipv4FlowClassifier::FiveTuple& t1, const Ipv4FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
-Ipv4FlowClassifier::Ipv4FlowClassifier()
-{
 #ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_relaxed);
+std::size_t
+Ipv4FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t h = Ipv4AddressHash()(tuple.sourceAddress);
+    h = h * 0x9e3779b97f4a7c15ULL + Ipv4AddressHash()(tuple.destinationAddress);
+    h = h * 0x9e3779b97f4a7c15ULL +
+        ((uint64_t(tuple.protocol) << 32) | (uint64_t(tuple.sourcePort) << 16) |
+         tuple.destinationPort);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
 #endif
+
+Ipv4FlowClassifier::Ipv4FlowClassifier()
+{
 }
 
 bool
@@ -148,11 +161,13 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
     tuple.destinationPort = dstPort;
 
 #ifdef NS3_MTP
-    while (m_lock.exchange(true, std::memory_order_acquire))
-    {
-    };
-#endif
-
+    *out_flowId = m_flowTable
+                      .Classify(tuple,
+                                ipHeader.GetDscp(),
+                                [this]() { return GetNewFlowId(); },
+                                out_packetId)
+                      ->flowId;
+#else
     // try to insert the tuple, but check if it already exists
     auto insert = m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
 
@@ -182,9 +197,6 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
 
     *out_flowId = insert.first->second;
     *out_packetId = m_flowPktIdMap[*out_flowId];
-
-#ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_release);
 #endif
 
     return true;
@@ -193,6 +205,13 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow(FlowId flowId) const
 {
+#ifdef NS3_MTP
+    const auto flow = m_flowTable.Find(flowId);
+    if (flow != nullptr)
+    {
+        return flow->tuple;
+    }
+#else
     for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
     {
         if (iter->second == flowId)
@@ -200,6 +219,7 @@ Ipv4FlowClassifier::FindFlow(FlowId flowId) const
             return iter->first;
         }
     }
+#endif
     NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     FiveTuple retval = {Ipv4Address::GetZero(), Ipv4Address::GetZero(), 0, 0, 0};
     return retval;
@@ -215,6 +235,16 @@ Ipv4FlowClassifier::SortByCount::operator()(std::pair<Ipv4Header::DscpType, uint
 std::vector<std::pair<Ipv4Header::DscpType, uint32_t>>
 Ipv4FlowClassifier::GetDscpCounts(FlowId flowId) const
 {
+#ifdef NS3_MTP
+    const auto flow = m_flowTable.Find(flowId);
+
+    if (flow == nullptr)
+    {
+        NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
+    }
+
+    std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> v = m_flowTable.GetDscpCounts(flow);
+#else
     auto flow = m_flowDscpMap.find(flowId);
 
     if (flow == m_flowDscpMap.end())
@@ -224,6 +254,7 @@ Ipv4FlowClassifier::GetDscpCounts(FlowId flowId) const
 
     std::vector<std::pair<Ipv4Header::DscpType, uint32_t>> v(flow->second.begin(),
                                                              flow->second.end());
+#endif
     std::sort(v.begin(), v.end(), SortByCount());
     return v;
 }
@@ -235,6 +266,30 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     os << "<Ipv4FlowClassifier>\n";
 
     indent += 2;
+#ifdef NS3_MTP
+    for (const auto flow : m_flowTable.GetFlows())
+    {
+        Indent(os, indent);
+        os << "<Flow flowId=\"" << flow->flowId << "\""
+           << " sourceAddress=\"" << flow->tuple.sourceAddress << "\""
+           << " destinationAddress=\"" << flow->tuple.destinationAddress << "\""
+           << " protocol=\"" << int(flow->tuple.protocol) << "\""
+           << " sourcePort=\"" << flow->tuple.sourcePort << "\""
+           << " destinationPort=\"" << flow->tuple.destinationPort << "\">\n";
+
+        indent += 2;
+        for (const auto& [dscp, count] : m_flowTable.GetDscpCounts(flow))
+        {
+            Indent(os, indent);
+            os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(dscp) << "\""
+               << " packets=\"" << std::dec << count << "\" />\n";
+        }
+
+        indent -= 2;
+        Indent(os, indent);
+        os << "</Flow>\n";
+    }
+#else
     for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
     {
         Indent(os, indent);
@@ -262,6 +317,7 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
         Indent(os, indent);
         os << "</Flow>\n";
     }
+#endif
 
     indent -= 2;
     Indent(os, indent);
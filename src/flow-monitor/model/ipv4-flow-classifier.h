@@ -27,6 +27,11 @@
 #include <atomic>
 #include <map>
 #include <stdint.h>
+#include <vector>
+
+#ifdef NS3_MTP
+#include "flow-classifier-table.h"
+#endif
 
 namespace ns3
 {
@@ -94,15 +99,24 @@ class Ipv4FlowClassifier : public FlowClassifier
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
   private:
+#ifdef NS3_MTP
+    /// Hash function of the five-tuples
+    struct FiveTupleHash
+    {
+        /// \param tuple the five-tuple
+        /// \returns the hash of the tuple
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
+    /// Flows, by five-tuple
+    FlowClassifierTable<FiveTuple, FiveTupleHash, Ipv4Header::DscpType> m_flowTable;
+#else
     /// Map to Flows Identifiers to FlowIds
     std::map<FiveTuple, FlowId> m_flowMap;
     /// Map to FlowIds to FlowPacketId
     std::map<FlowId, FlowPacketId> m_flowPktIdMap;
     /// Map FlowIds to (DSCP value, packet count) pairs
     std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>> m_flowDscpMap;
-
-#ifdef NS3_MTP
-    std::atomic<bool> m_lock;
 #endif
 };
 
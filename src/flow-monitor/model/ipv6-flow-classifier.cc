@@ -92,11 +92,24 @@ operator==(const Ipv6FlowClassifier::FiveTuple& t1, const Ipv6FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
-Ipv6FlowClassifier::Ipv6FlowClassifier()
-{
 #ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_relaxed);
+std::size_t
+Ipv6FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t h = Ipv6AddressHash()(tuple.sourceAddress);
+    h = h * 0x9e3779b97f4a7c15ULL + Ipv6AddressHash()(tuple.destinationAddress);
+    h = h * 0x9e3779b97f4a7c15ULL +
+        ((uint64_t(tuple.protocol) << 32) | (uint64_t(tuple.sourcePort) << 16) |
+         tuple.destinationPort);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
 #endif
+
+Ipv6FlowClassifier::Ipv6FlowClassifier()
+{
 }
 
 bool
@@ -149,11 +162,13 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
     tuple.destinationPort = dstPort;
 
 #ifdef NS3_MTP
-    while (m_lock.exchange(true, std::memory_order_acquire))
-    {
-    };
-#endif
-
+    *out_flowId = m_flowTable
+                      .Classify(tuple,
+                                ipHeader.GetDscp(),
+                                [this]() { return GetNewFlowId(); },
+                                out_packetId)
+                      ->flowId;
+#else
     // try to insert the tuple, but check if it already exists
     auto insert = m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
 
@@ -183,9 +198,6 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
 
     *out_flowId = insert.first->second;
     *out_packetId = m_flowPktIdMap[*out_flowId];
-
-#ifdef NS3_MTP
-    m_lock.store(false, std::memory_order_release);
 #endif
 
     return true;
@@ -194,6 +206,13 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow(FlowId flowId) const
 {
+#ifdef NS3_MTP
+    const auto flow = m_flowTable.Find(flowId);
+    if (flow != nullptr)
+    {
+        return flow->tuple;
+    }
+#else
     for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
     {
         if (iter->second == flowId)
@@ -201,6 +220,7 @@ Ipv6FlowClassifier::FindFlow(FlowId flowId) const
             return iter->first;
         }
     }
+#endif
     NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     FiveTuple retval = {Ipv6Address::GetZero(), Ipv6Address::GetZero(), 0, 0, 0};
     return retval;
@@ -216,6 +236,16 @@ Ipv6FlowClassifier::SortByCount::operator()(std::pair<Ipv6Header::DscpType, uint
 std::vector<std::pair<Ipv6Header::DscpType, uint32_t>>
 Ipv6FlowClassifier::GetDscpCounts(FlowId flowId) const
 {
+#ifdef NS3_MTP
+    const auto flow = m_flowTable.Find(flowId);
+
+    if (flow == nullptr)
+    {
+        NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
+    }
+
+    std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> v = m_flowTable.GetDscpCounts(flow);
+#else
     auto flow = m_flowDscpMap.find(flowId);
 
     if (flow == m_flowDscpMap.end())
@@ -225,6 +255,7 @@ Ipv6FlowClassifier::GetDscpCounts(FlowId flowId) const
 
     std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> v(flow->second.begin(),
                                                              flow->second.end());
+#endif
     std::sort(v.begin(), v.end(), SortByCount());
     return v;
 }
@@ -236,6 +267,30 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     os << "<Ipv6FlowClassifier>\n";
 
     indent += 2;
+#ifdef NS3_MTP
+    for (const auto flow : m_flowTable.GetFlows())
+    {
+        Indent(os, indent);
+        os << "<Flow flowId=\"" << flow->flowId << "\""
+           << " sourceAddress=\"" << flow->tuple.sourceAddress << "\""
+           << " destinationAddress=\"" << flow->tuple.destinationAddress << "\""
+           << " protocol=\"" << int(flow->tuple.protocol) << "\""
+           << " sourcePort=\"" << flow->tuple.sourcePort << "\""
+           << " destinationPort=\"" << flow->tuple.destinationPort << "\">\n";
+
+        indent += 2;
+        for (const auto& [dscp, count] : m_flowTable.GetDscpCounts(flow))
+        {
+            Indent(os, indent);
+            os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(dscp) << "\""
+               << " packets=\"" << std::dec << count << "\" />\n";
+        }
+
+        indent -= 2;
+        Indent(os, indent);
+        os << "</Flow>\n";
+    }
+#else
     for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
     {
         Indent(os, indent);
@@ -263,6 +318,7 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
         Indent(os, indent);
         os << "</Flow>\n";
     }
+#endif
 
     indent -= 2;
     Indent(os, indent);
@@ -0,0 +1,538 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv6-flow-classifier.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#ifdef NS3_MTP
+#include "ns3/global-value.h"
+#include "ns3/mtp-interface.h"
+#include "ns3/string.h"
+#endif
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor
+ * \defgroup flow-monitor-test FlowMonitor module tests
+ */
+
+/**
+ * \ingroup flow-monitor-test
+ * \brief Create the payload of a TCP or UDP packet
+ *
+ * \param srcPort the source port
+ * \param dstPort the destination port
+ * \returns the payload, starting with the ports
+ */
+static Ptr<Packet>
+CreatePayload(uint16_t srcPort, uint16_t dstPort)
+{
+    const uint8_t ports[] = {uint8_t(srcPort >> 8),
+                             uint8_t(srcPort),
+                             uint8_t(dstPort >> 8),
+                             uint8_t(dstPort)};
+    return Create<Packet>(ports, sizeof(ports));
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Ipv4FlowClassifier test: FlowIds, packet ids and DSCP counts.
+ */
+class Ipv4FlowClassifierTestCase : public TestCase
+{
+  public:
+    Ipv4FlowClassifierTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv4FlowClassifierTestCase::Ipv4FlowClassifierTestCase()
+    : TestCase("Ipv4FlowClassifier")
+{
+}
+
+void
+Ipv4FlowClassifierTestCase::DoRun()
+{
+    Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier>();
+    Ipv4Header header;
+    header.SetSource(Ipv4Address("10.0.0.1"));
+    header.SetDestination(Ipv4Address("10.0.0.2"));
+    header.SetProtocol(17);
+    header.SetDscp(Ipv4Header::DSCP_AF11);
+
+    FlowId flowId;
+    FlowPacketId packetId;
+    NS_TEST_ASSERT_MSG_EQ(classifier->Classify(header, CreatePayload(1000, 9), &flowId, &packetId),
+                          true,
+                          "UDP packet not classified");
+    NS_TEST_EXPECT_MSG_EQ(flowId, 1, "Wrong FlowId of the first flow");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 0, "Wrong packet id of the first packet");
+
+    classifier->Classify(header, CreatePayload(1000, 9), &flowId, &packetId);
+    NS_TEST_EXPECT_MSG_EQ(flowId, 1, "Wrong FlowId of a known flow");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 1, "Wrong packet id of the second packet");
+
+    classifier->Classify(header, CreatePayload(1001, 9), &flowId, &packetId);
+    NS_TEST_EXPECT_MSG_EQ(flowId, 2, "Wrong FlowId of another source port");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 0, "Wrong packet id of the first packet of a flow");
+
+    header.SetProtocol(6);
+    classifier->Classify(header, CreatePayload(1000, 9), &flowId, &packetId);
+    NS_TEST_EXPECT_MSG_EQ(flowId, 3, "Wrong FlowId of another protocol");
+
+    header.SetProtocol(17);
+    header.SetDscp(Ipv4Header::DSCP_EF);
+    classifier->Classify(header, CreatePayload(1000, 9), &flowId, &packetId);
+    NS_TEST_EXPECT_MSG_EQ(flowId, 1, "The DSCP value changed the FlowId");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 2, "Wrong packet id of the third packet");
+
+    header.SetProtocol(1);
+    NS_TEST_EXPECT_MSG_EQ(classifier->Classify(header, CreatePayload(0, 0), &flowId, &packetId),
+                          false,
+                          "ICMP packet classified");
+    header.SetProtocol(17);
+    NS_TEST_EXPECT_MSG_EQ(classifier->Classify(header, Create<Packet>(3), &flowId, &packetId),
+                          false,
+                          "Packet without ports classified");
+    header.SetFragmentOffset(8);
+    NS_TEST_EXPECT_MSG_EQ(classifier->Classify(header, CreatePayload(1000, 9), &flowId, &packetId),
+                          false,
+                          "Fragment classified");
+
+    Ipv4FlowClassifier::FiveTuple tuple = classifier->FindFlow(2);
+    NS_TEST_EXPECT_MSG_EQ(tuple.sourceAddress, Ipv4Address("10.0.0.1"), "Wrong source address");
+    NS_TEST_EXPECT_MSG_EQ(tuple.destinationAddress,
+                          Ipv4Address("10.0.0.2"),
+                          "Wrong destination address");
+    NS_TEST_EXPECT_MSG_EQ(uint32_t(tuple.protocol), 17, "Wrong protocol");
+    NS_TEST_EXPECT_MSG_EQ(tuple.sourcePort, 1001, "Wrong source port");
+    NS_TEST_EXPECT_MSG_EQ(tuple.destinationPort, 9, "Wrong destination port");
+
+    auto dscpCounts = classifier->GetDscpCounts(1);
+    NS_TEST_ASSERT_MSG_EQ(dscpCounts.size(), 2, "Wrong number of DSCP values");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[0].first, Ipv4Header::DSCP_AF11, "Wrong most used DSCP");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[0].second, 2, "Wrong count of the most used DSCP");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[1].first, Ipv4Header::DSCP_EF, "Wrong least used DSCP");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[1].second, 1, "Wrong count of the least used DSCP");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Ipv6FlowClassifier test: FlowIds, packet ids and DSCP counts.
+ */
+class Ipv6FlowClassifierTestCase : public TestCase
+{
+  public:
+    Ipv6FlowClassifierTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv6FlowClassifierTestCase::Ipv6FlowClassifierTestCase()
+    : TestCase("Ipv6FlowClassifier")
+{
+}
+
+void
+Ipv6FlowClassifierTestCase::DoRun()
+{
+    Ptr<Ipv6FlowClassifier> classifier = Create<Ipv6FlowClassifier>();
+    Ipv6Header header;
+    header.SetSource(Ipv6Address("2001:db8::1"));
+    header.SetDestination(Ipv6Address("2001:db8::2"));
+    header.SetNextHeader(6);
+    header.SetDscp(Ipv6Header::DSCP_AF11);
+
+    FlowId flowId;
+    FlowPacketId packetId;
+    NS_TEST_ASSERT_MSG_EQ(classifier->Classify(header, CreatePayload(1000, 80), &flowId, &packetId),
+                          true,
+                          "TCP packet not classified");
+    NS_TEST_EXPECT_MSG_EQ(flowId, 1, "Wrong FlowId of the first flow");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 0, "Wrong packet id of the first packet");
+
+    header.SetDestination(Ipv6Address("2001:db8::3"));
+    classifier->Classify(header, CreatePayload(1000, 80), &flowId, &packetId);
+    NS_TEST_EXPECT_MSG_EQ(flowId, 2, "Wrong FlowId of another destination");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 0, "Wrong packet id of the first packet of a flow");
+
+    header.SetDestination(Ipv6Address("2001:db8::2"));
+    header.SetDscp(Ipv6Header::DSCP_EF);
+    classifier->Classify(header, CreatePayload(1000, 80), &flowId, &packetId);
+    NS_TEST_EXPECT_MSG_EQ(flowId, 1, "The DSCP value changed the FlowId");
+    NS_TEST_EXPECT_MSG_EQ(packetId, 1, "Wrong packet id of the second packet");
+    classifier->Classify(header, CreatePayload(1000, 80), &flowId, &packetId);
+    NS_TEST_EXPECT_MSG_EQ(packetId, 2, "Wrong packet id of the third packet");
+
+    header.SetNextHeader(58);
+    NS_TEST_EXPECT_MSG_EQ(classifier->Classify(header, CreatePayload(0, 0), &flowId, &packetId),
+                          false,
+                          "ICMPv6 packet classified");
+    header.SetNextHeader(17);
+    header.SetDestination(Ipv6Address("ff02::1"));
+    NS_TEST_EXPECT_MSG_EQ(classifier->Classify(header, CreatePayload(1000, 80), &flowId, &packetId),
+                          false,
+                          "Multicast packet classified");
+
+    Ipv6FlowClassifier::FiveTuple tuple = classifier->FindFlow(2);
+    NS_TEST_EXPECT_MSG_EQ(tuple.sourceAddress, Ipv6Address("2001:db8::1"), "Wrong source address");
+    NS_TEST_EXPECT_MSG_EQ(tuple.destinationAddress,
+                          Ipv6Address("2001:db8::3"),
+                          "Wrong destination address");
+    NS_TEST_EXPECT_MSG_EQ(uint32_t(tuple.protocol), 6, "Wrong protocol");
+    NS_TEST_EXPECT_MSG_EQ(tuple.sourcePort, 1000, "Wrong source port");
+    NS_TEST_EXPECT_MSG_EQ(tuple.destinationPort, 80, "Wrong destination port");
+
+    auto dscpCounts = classifier->GetDscpCounts(1);
+    NS_TEST_ASSERT_MSG_EQ(dscpCounts.size(), 2, "Wrong number of DSCP values");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[0].first, Ipv6Header::DSCP_EF, "Wrong most used DSCP");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[0].second, 2, "Wrong count of the most used DSCP");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[1].first, Ipv6Header::DSCP_AF11, "Wrong least used DSCP");
+    NS_TEST_EXPECT_MSG_EQ(dscpCounts[1].second, 1, "Wrong count of the least used DSCP");
+}
+
+#ifdef NS3_MTP
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Ipv4FlowClassifier test with threads classifying the packets of
+ * the same flows concurrently, more flows than the initial flow table holds.
+ */
+class FlowClassifierThreadsTestCase : public TestCase
+{
+  public:
+    FlowClassifierThreadsTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FlowClassifierThreadsTestCase::FlowClassifierThreadsTestCase()
+    : TestCase("Ipv4FlowClassifier with concurrent threads")
+{
+}
+
+void
+FlowClassifierThreadsTestCase::DoRun()
+{
+    const uint32_t nThreads = 4;
+    const uint32_t nFlows = 500;
+    Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier>();
+    // (FlowId, packet id) of the packet of each flow, by thread
+    std::vector<std::vector<std::pair<FlowId, FlowPacketId>>> results(
+        nThreads,
+        std::vector<std::pair<FlowId, FlowPacketId>>(nFlows));
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < nThreads; t++)
+    {
+        threads.emplace_back([&classifier, &results, t, nFlows]() {
+            Ipv4Header header;
+            header.SetSource(Ipv4Address("10.0.0.1"));
+            header.SetDestination(Ipv4Address("10.0.0.2"));
+            header.SetProtocol(17);
+            // each thread classifies one packet of each flow, in its own
+            // order: the multipliers are prime with the number of flows
+            const uint32_t multipliers[] = {1, 3, 7, 9};
+            for (uint32_t i = 0; i < nFlows; i++)
+            {
+                uint32_t flow = (i * multipliers[t] + t * 97) % nFlows;
+                classifier->Classify(header,
+                                     CreatePayload(10000 + flow, 9),
+                                     &results[t][flow].first,
+                                     &results[t][flow].second);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<bool> flowIdUsed(nFlows + 1, false);
+    for (uint32_t flow = 0; flow < nFlows; flow++)
+    {
+        FlowId flowId = results[0][flow].first;
+        NS_TEST_ASSERT_MSG_EQ((flowId >= 1 && flowId <= nFlows), true, "FlowId out of range");
+        NS_TEST_EXPECT_MSG_EQ(flowIdUsed[flowId], false, "FlowId of two flows");
+        flowIdUsed[flowId] = true;
+        NS_TEST_EXPECT_MSG_EQ(classifier->FindFlow(flowId).sourcePort,
+                              10000 + flow,
+                              "FlowId of another flow");
+
+        std::vector<bool> packetIdUsed(nThreads, false);
+        for (uint32_t t = 0; t < nThreads; t++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(results[t][flow].first, flowId, "FlowIds of a flow differ");
+            FlowPacketId packetId = results[t][flow].second;
+            NS_TEST_ASSERT_MSG_LT(packetId, nThreads, "Packet id out of range");
+            NS_TEST_EXPECT_MSG_EQ(packetIdUsed[packetId], false, "Packet id of two packets");
+            packetIdUsed[packetId] = true;
+        }
+        NS_TEST_EXPECT_MSG_EQ(classifier->GetDscpCounts(flowId)[0].second,
+                              nThreads,
+                              "Wrong packet count");
+    }
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief A probe reporting packets directly to the FlowMonitor
+ */
+class FlowMonitorTestProbe : public FlowProbe
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param monitor the FlowMonitor
+     */
+    FlowMonitorTestProbe(Ptr<FlowMonitor> monitor)
+        : FlowProbe(monitor)
+    {
+    }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief FlowMonitor test with the multithreaded simulator
+ *
+ * The packets of each flow are sent, forwarded and received or dropped in
+ * different logical processes, each recording the statistics in its own
+ * shard.  It checks that the merged statistics are the ones of a
+ * sequential simulation, and that the received and dropped packets are no
+ * longer tracked.
+ */
+class FlowMonitorShardsTestCase : public TestCase
+{
+  public:
+    FlowMonitorShardsTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run a simulation
+     *
+     * \param threads The number of threads, or 0 for the sequential simulator.
+     * \returns The statistics of the flows.
+     */
+    FlowMonitor::FlowStatsContainer RunOnce(uint32_t threads);
+
+    /**
+     * \brief Check that two histograms have the same bins
+     *
+     * \param actual The histogram of the multithreaded simulation.
+     * \param expected The histogram of the sequential simulation.
+     * \param name The name of the histogram.
+     */
+    void CheckHistogram(const Histogram& actual, const Histogram& expected, std::string name);
+};
+
+FlowMonitorShardsTestCase::FlowMonitorShardsTestCase()
+    : TestCase("FlowMonitor statistics of logical processes")
+{
+}
+
+FlowMonitor::FlowStatsContainer
+FlowMonitorShardsTestCase::RunOnce(uint32_t threads)
+{
+    if (threads > 0)
+    {
+        MtpInterface::Enable(threads);
+    }
+
+    // the nodes have no devices, so each one is a logical process
+    const uint32_t nNodes = 4;
+    std::vector<Ptr<Node>> nodes;
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        nodes.push_back(CreateObject<Node>());
+    }
+    Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor>();
+    std::vector<Ptr<FlowProbe>> probes;
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        probes.push_back(Create<FlowMonitorTestProbe>(monitor));
+    }
+    monitor->StartRightNow();
+
+    // the periodic checks of the monitor, every second in the public
+    // logical process, order the phases of the packets
+    for (FlowId flowId = 1; flowId <= 8; flowId++)
+    {
+        uint32_t src = flowId % nNodes;
+        uint32_t forwarder = (flowId + 1) % nNodes;
+        uint32_t dst = (flowId + 2) % nNodes;
+        for (FlowPacketId packetId = 0; packetId < 20; packetId++)
+        {
+            uint32_t size = 100 + 50 * (packetId % 7);
+            Simulator::ScheduleWithContext(src,
+                                           MilliSeconds(10 * packetId + flowId),
+                                           &FlowMonitor::ReportFirstTx,
+                                           monitor,
+                                           probes[src],
+                                           flowId,
+                                           packetId,
+                                           size);
+            if (packetId % 3 != 0)
+            {
+                Simulator::ScheduleWithContext(forwarder,
+                                               Seconds(1) + MilliSeconds(5 * packetId + flowId),
+                                               &FlowMonitor::ReportForwarding,
+                                               monitor,
+                                               probes[forwarder],
+                                               flowId,
+                                               packetId,
+                                               size);
+            }
+            Time rxTime = Seconds(2) + MilliSeconds(7 * packetId + 3 * flowId) +
+                          MicroSeconds(100 * (packetId * packetId % 13));
+            if (packetId % 5 == 4)
+            {
+                Simulator::ScheduleWithContext(dst,
+                                               rxTime,
+                                               &FlowMonitor::ReportDrop,
+                                               monitor,
+                                               probes[dst],
+                                               flowId,
+                                               packetId,
+                                               size,
+                                               packetId % 3);
+            }
+            else if (packetId % 4 != 2)
+            {
+                Simulator::ScheduleWithContext(dst,
+                                               rxTime,
+                                               &FlowMonitor::ReportLastRx,
+                                               monitor,
+                                               probes[dst],
+                                               flowId,
+                                               packetId,
+                                               size);
+            }
+        }
+    }
+    // the packets neither received nor dropped are lost
+    Simulator::Schedule(Seconds(3.5), [monitor]() { monitor->CheckForLostPackets(Seconds(0)); });
+    Simulator::Stop(Seconds(4));
+    Simulator::Run();
+
+    FlowMonitor::FlowStatsContainer stats = monitor->GetFlowStats();
+    Simulator::Destroy();
+    if (threads > 0)
+    {
+        GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    }
+    return stats;
+}
+
+void
+FlowMonitorShardsTestCase::CheckHistogram(const Histogram& actual,
+                                          const Histogram& expected,
+                                          std::string name)
+{
+    NS_TEST_ASSERT_MSG_EQ(actual.GetNBins(), expected.GetNBins(), "Bins of the " << name);
+    for (uint32_t i = 0; i < expected.GetNBins(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(actual.GetBinCount(i),
+                              expected.GetBinCount(i),
+                              "Bin " << i << " of the " << name);
+    }
+}
+
+void
+FlowMonitorShardsTestCase::DoRun()
+{
+    FlowMonitor::FlowStatsContainer expected = RunOnce(0);
+    FlowMonitor::FlowStatsContainer actual = RunOnce(2);
+
+    NS_TEST_ASSERT_MSG_EQ(expected.size(), 8, "Wrong number of flows");
+    NS_TEST_ASSERT_MSG_EQ(actual.size(), expected.size(), "Different flows");
+    for (const auto& [flowId, e] : expected)
+    {
+        // per flow: 4 packets dropped, 4 never received, 12 received
+        NS_TEST_EXPECT_MSG_EQ(e.txPackets, 20, "Wrong transmitted packets, flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(e.rxPackets, 12, "Wrong received packets, flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(e.lostPackets, 8, "Wrong lost packets, flow " << flowId);
+
+        auto iter = actual.find(flowId);
+        NS_TEST_ASSERT_MSG_EQ((iter != actual.end()), true, "Missing flow " << flowId);
+        const FlowMonitor::FlowStats& a = iter->second;
+        NS_TEST_EXPECT_MSG_EQ(a.timeFirstTxPacket, e.timeFirstTxPacket, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.timeFirstRxPacket, e.timeFirstRxPacket, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.timeLastTxPacket, e.timeLastTxPacket, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.timeLastRxPacket, e.timeLastRxPacket, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.delaySum, e.delaySum, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.jitterSum, e.jitterSum, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.lastDelay, e.lastDelay, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.txBytes, e.txBytes, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.rxBytes, e.rxBytes, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.txPackets, e.txPackets, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.rxPackets, e.rxPackets, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.lostPackets, e.lostPackets, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ(a.timesForwarded, e.timesForwarded, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ((a.packetsDropped == e.packetsDropped), true, "Flow " << flowId);
+        NS_TEST_EXPECT_MSG_EQ((a.bytesDropped == e.bytesDropped), true, "Flow " << flowId);
+        CheckHistogram(a.delayHistogram, e.delayHistogram, "delay histogram");
+        CheckHistogram(a.jitterHistogram, e.jitterHistogram, "jitter histogram");
+        CheckHistogram(a.packetSizeHistogram, e.packetSizeHistogram, "packet size histogram");
+        CheckHistogram(a.flowInterruptionsHistogram,
+                       e.flowInterruptionsHistogram,
+                       "flow interruptions histogram");
+    }
+}
+#endif
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief FlowMonitor TestSuite
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+  public:
+    FlowMonitorTestSuite();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite()
+    : TestSuite("flow-monitor", UNIT)
+{
+    AddTestCase(new Ipv4FlowClassifierTestCase, TestCase::QUICK);
+    AddTestCase(new Ipv6FlowClassifierTestCase, TestCase::QUICK);
+#ifdef NS3_MTP
+    AddTestCase(new FlowClassifierThreadsTestCase, TestCase::QUICK);
+    AddTestCase(new FlowMonitorShardsTestCase, TestCase::QUICK);
+#endif
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite; //!< Static variable for test initialization
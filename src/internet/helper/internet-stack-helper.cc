@@ -44,6 +44,7 @@
 #include "ns3/node.h"
 #include "ns3/object.h"
 #include "ns3/packet-socket-factory.h"
+#include "ns3/parallel-construction.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 #include "ns3/traffic-control-layer.h"
@@ -273,6 +274,12 @@ InternetStackHelper::Install(NodeContainer c) const
     }
 }
 
+void
+InternetStackHelper::InstallParallel(NodeContainer c) const
+{
+    ParallelConstruction::For(c.GetN(), [this, &c](uint32_t i) { Install(c.Get(i)); });
+}
+
 void
 InternetStackHelper::InstallAll() const
 {
@@ -170,6 +170,17 @@ class InternetStackHelper : public PcapHelperForIpv4,
      */
     void Install(NodeContainer c) const;
 
+    /**
+     * For each node in the input container, aggregate implementations of the
+     * ns3::Ipv4, ns3::Ipv6, ns3::Udp, and, ns3::Tcp classes, like Install(),
+     * the nodes being handled in parallel.
+     *
+     * \param c NodeContainer that holds the set of nodes on which to install the
+     * new stacks.
+     * \see ParallelConstruction
+     */
+    void InstallParallel(NodeContainer c) const;
+
     /**
      * Aggregate IPv4, IPv6, UDP, and TCP stacks to all nodes in the simulation
      */
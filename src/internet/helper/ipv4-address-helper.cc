@@ -25,11 +25,14 @@
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
+#include "ns3/parallel-construction.h"
 #include "ns3/ptr.h"
 #include "ns3/simulator.h"
 #include "ns3/traffic-control-helper.h"
 #include "ns3/traffic-control-layer.h"
 
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -135,56 +138,96 @@ Ipv4AddressHelper::Assign(const NetDeviceContainer& c)
     Ipv4InterfaceContainer retval;
     for (uint32_t i = 0; i < c.GetN(); ++i)
     {
-        Ptr<NetDevice> device = c.Get(i);
-
-        Ptr<Node> node = device->GetNode();
-        NS_ASSERT_MSG(node,
-                      "Ipv4AddressHelper::Assign(): NetDevice is not not associated "
-                      "with any node -> fail");
-
-        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-        NS_ASSERT_MSG(ipv4,
-                      "Ipv4AddressHelper::Assign(): NetDevice is associated"
-                      " with a node without IPv4 stack installed -> fail "
-                      "(maybe need to use InternetStackHelper?)");
+        auto [ipv4, interface] = AssignAddress(c.Get(i), NewAddress());
+        retval.Add(ipv4, interface);
+    }
+    return retval;
+}
 
-        int32_t interface = ipv4->GetInterfaceForDevice(device);
-        if (interface == -1)
+Ipv4InterfaceContainer
+Ipv4AddressHelper::AssignParallel(const NetDeviceContainer& c)
+{
+    NS_LOG_FUNCTION_NOARGS();
+    // allocate the addresses in order, and group the devices by node so that
+    // the interfaces of a node are added in order
+    std::vector<Ipv4Address> addresses;
+    addresses.reserve(c.GetN());
+    std::vector<std::vector<uint32_t>> groups;
+    std::unordered_map<Ptr<Node>, std::size_t> groupOfNode;
+    for (uint32_t i = 0; i < c.GetN(); ++i)
+    {
+        addresses.push_back(NewAddress());
+        auto [it, added] = groupOfNode.emplace(c.Get(i)->GetNode(), groups.size());
+        if (added)
         {
-            interface = ipv4->AddInterface(device);
+            groups.emplace_back();
         }
-        NS_ASSERT_MSG(interface >= 0,
-                      "Ipv4AddressHelper::Assign(): "
-                      "Interface index not found");
-
-        Ipv4InterfaceAddress ipv4Addr = Ipv4InterfaceAddress(NewAddress(), m_mask);
-        ipv4->AddAddress(interface, ipv4Addr);
-        ipv4->SetMetric(interface, 1);
-        ipv4->SetUp(interface);
+        groups[it->second].push_back(i);
+    }
+
+    std::vector<std::pair<Ptr<Ipv4>, uint32_t>> interfaces(c.GetN());
+    ParallelConstruction::For(groups, [&](uint32_t i) {
+        interfaces[i] = AssignAddress(c.Get(i), addresses[i]);
+    });
+
+    Ipv4InterfaceContainer retval;
+    for (const auto& [ipv4, interface] : interfaces)
+    {
         retval.Add(ipv4, interface);
+    }
+    return retval;
+}
 
-        // Install the default traffic control configuration if the traffic
-        // control layer has been aggregated, if this is not
-        // a loopback interface, and there is no queue disc installed already
-        Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
-        if (tc && !DynamicCast<LoopbackNetDevice>(device) && !tc->GetRootQueueDiscOnDevice(device))
+std::pair<Ptr<Ipv4>, uint32_t>
+Ipv4AddressHelper::AssignAddress(Ptr<NetDevice> device, Ipv4Address address) const
+{
+    NS_LOG_FUNCTION(this << device << address);
+    Ptr<Node> node = device->GetNode();
+    NS_ASSERT_MSG(node,
+                  "Ipv4AddressHelper::Assign(): NetDevice is not not associated "
+                  "with any node -> fail");
+
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    NS_ASSERT_MSG(ipv4,
+                  "Ipv4AddressHelper::Assign(): NetDevice is associated"
+                  " with a node without IPv4 stack installed -> fail "
+                  "(maybe need to use InternetStackHelper?)");
+
+    int32_t interface = ipv4->GetInterfaceForDevice(device);
+    if (interface == -1)
+    {
+        interface = ipv4->AddInterface(device);
+    }
+    NS_ASSERT_MSG(interface >= 0,
+                  "Ipv4AddressHelper::Assign(): "
+                  "Interface index not found");
+
+    Ipv4InterfaceAddress ipv4Addr = Ipv4InterfaceAddress(address, m_mask);
+    ipv4->AddAddress(interface, ipv4Addr);
+    ipv4->SetMetric(interface, 1);
+    ipv4->SetUp(interface);
+
+    // Install the default traffic control configuration if the traffic
+    // control layer has been aggregated, if this is not
+    // a loopback interface, and there is no queue disc installed already
+    Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+    if (tc && !DynamicCast<LoopbackNetDevice>(device) && !tc->GetRootQueueDiscOnDevice(device))
+    {
+        Ptr<NetDeviceQueueInterface> ndqi = device->GetObject<NetDeviceQueueInterface>();
+        // It is useless to install a queue disc if the device has no
+        // NetDeviceQueueInterface attached: the device queue is never
+        // stopped and every packet enqueued in the queue disc is
+        // immediately dequeued, hence there will never be backlog
+        if (ndqi)
         {
-            Ptr<NetDeviceQueueInterface> ndqi = device->GetObject<NetDeviceQueueInterface>();
-            // It is useless to install a queue disc if the device has no
-            // NetDeviceQueueInterface attached: the device queue is never
-            // stopped and every packet enqueued in the queue disc is
-            // immediately dequeued, hence there will never be backlog
-            if (ndqi)
-            {
-                std::size_t nTxQueues = ndqi->GetNTxQueues();
-                NS_LOG_LOGIC("Installing default traffic control configuration ("
-                             << nTxQueues << " device queue(s))");
-                TrafficControlHelper tcHelper = TrafficControlHelper::Default(nTxQueues);
-                tcHelper.Install(device);
-            }
+            std::size_t nTxQueues = ndqi->GetNTxQueues();
+            NS_LOG_LOGIC("Installing default traffic control configuration ("
+                         << nTxQueues << " device queue(s))");
+            TrafficControlHelper tcHelper = TrafficControlHelper::Default(nTxQueues);
+            tcHelper.Install(device);
         }
     }
-    return retval;
+    return {ipv4, interface};
 }
 
 const uint32_t N_BITS = 32; //!< number of bits in a IPv4 address
@@ -178,7 +178,32 @@ class Ipv4AddressHelper
      */
     Ipv4InterfaceContainer Assign(const NetDeviceContainer& c);
 
+    /**
+     * @brief Assign IP addresses to the net devices specified in the container,
+     * like Assign(), the nodes being configured in parallel.
+     *
+     * The addresses are allocated in the order of the net devices, and the
+     * net devices of a node are configured in that order, so that the result
+     * is the same as with Assign().
+     *
+     * @param c The NetDeviceContainer holding the collection of net devices we
+     * are asked to assign Ipv4 addresses to.
+     *
+     * @returns A container holding the added NetDevices
+     * @see ParallelConstruction
+     */
+    Ipv4InterfaceContainer AssignParallel(const NetDeviceContainer& c);
+
   private:
+    /**
+     * \brief Assign an IP address to a net device.
+     * \param device the net device
+     * \param address the address
+     * \returns the Ipv4 object of the node and the index of the interface
+     */
+    std::pair<Ptr<Ipv4>, uint32_t> AssignAddress(Ptr<NetDevice> device,
+                                                 Ipv4Address address) const;
+
     /**
      * \brief Returns the number of address bits (hostpart) for a given netmask
      * \param maskbits the netmask
@@ -58,20 +58,24 @@ operator<<(std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream&
 operator<<(std::ostream& os, const CandidateQueue& q)
 {
-    const CandidateQueue::CandidateList_t& list = q.m_candidates;
+    CandidateQueue::CandidateList_t list = q.m_candidates;
+    std::sort(list.begin(), list.end(), &CandidateQueue::EntryBefore);
 
     os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
     for (auto iter = list.begin(); iter != list.end(); iter++)
     {
-        os << "<" << (*iter)->GetVertexId() << ", " << (*iter)->GetDistanceFromRoot() << ", "
-           << (*iter)->GetVertexType() << ">" << std::endl;
+        os << "<" << iter->vertex->GetVertexId() << ", " << iter->vertex->GetDistanceFromRoot()
+           << ", " << iter->vertex->GetVertexType() << ">" << std::endl;
     }
     os << "*** CandidateQueue End ***";
     return os;
 }
 
 CandidateQueue::CandidateQueue()
-    : m_candidates()
+    : m_candidates(),
+      m_slots(),
+      m_vertexIds(),
+      m_sequence(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -99,11 +103,11 @@ CandidateQueue::Push(SPFVertex* vNew)
 {
     NS_LOG_FUNCTION(this << vNew);
 
-    auto i = std::upper_bound(m_candidates.begin(),
-                              m_candidates.end(),
-                              vNew,
-                              &CandidateQueue::CompareSPFVertex);
-    m_candidates.insert(i, vNew);
+    m_candidates.push_back(MakeEntry(vNew));
+    m_vertexIds.emplace(vNew->GetVertexId(), vNew);
+    uint32_t slot = m_candidates.size() - 1;
+    m_slots[vNew] = slot;
+    SiftUp(slot);
 }
 
 SPFVertex*
@@ -115,8 +119,25 @@ CandidateQueue::Pop()
         return nullptr;
     }
 
-    SPFVertex* v = m_candidates.front();
-    m_candidates.pop_front();
+    SPFVertex* v = m_candidates.front().vertex;
+    m_slots.erase(v);
+    auto range = m_vertexIds.equal_range(v->GetVertexId());
+    for (auto i = range.first; i != range.second; i++)
+    {
+        if (i->second == v)
+        {
+            m_vertexIds.erase(i);
+            break;
+        }
+    }
+
+    CandidateEntry last = m_candidates.back();
+    m_candidates.pop_back();
+    if (!m_candidates.empty())
+    {
+        Place(0, last);
+        SiftDown(0);
+    }
     return v;
 }
 
@@ -129,7 +150,7 @@ CandidateQueue::Top() const
         return nullptr;
     }
 
-    return m_candidates.front();
+    return m_candidates.front().vertex;
 }
 
 bool
@@ -150,18 +171,22 @@ SPFVertex*
 CandidateQueue::Find(const Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this);
-    auto i = m_candidates.begin();
-
-    for (; i != m_candidates.end(); i++)
+    //
+    // Vertex IDs are unique during an SPF calculation; should several queued
+    // vertices share an ID anyway, return the one that would be popped first.
+    //
+    const CandidateEntry* found = nullptr;
+    auto range = m_vertexIds.equal_range(addr);
+    for (auto i = range.first; i != range.second; i++)
     {
-        SPFVertex* v = *i;
-        if (v->GetVertexId() == addr)
+        const CandidateEntry& entry = m_candidates[m_slots.at(i->second)];
+        if (found == nullptr || EntryBefore(entry, *found))
         {
-            return v;
+            found = &entry;
         }
     }
 
-    return nullptr;
+    return found ? found->vertex : nullptr;
 }
 
 void
@@ -169,11 +194,116 @@ CandidateQueue::Reorder()
 {
     NS_LOG_FUNCTION(this);
 
-    m_candidates.sort(&CandidateQueue::CompareSPFVertex);
+    //
+    // Stable-sort the current queue order by the updated distances, then
+    // renumber the entries so that the heap reproduces that order.
+    //
+    std::sort(m_candidates.begin(), m_candidates.end(), &CandidateQueue::EntryBefore);
+    std::stable_sort(m_candidates.begin(),
+                     m_candidates.end(),
+                     [](const CandidateEntry& a, const CandidateEntry& b) {
+                         return CompareSPFVertex(a.vertex, b.vertex);
+                     });
+    for (uint32_t slot = 0; slot < m_candidates.size(); slot++)
+    {
+        m_candidates[slot].distance = m_candidates[slot].vertex->GetDistanceFromRoot();
+        m_candidates[slot].sequence = slot;
+        m_slots[m_candidates[slot].vertex] = slot;
+    }
+    m_sequence = m_candidates.size();
+
     NS_LOG_LOGIC("After reordering the CandidateQueue");
     NS_LOG_LOGIC(*this);
 }
 
+void
+CandidateQueue::Reorder(SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << v);
+
+    auto i = m_slots.find(v);
+    NS_ASSERT_MSG(i != m_slots.end(), "Vertex is not in the CandidateQueue");
+    uint32_t slot = i->second;
+    NS_ASSERT(v->GetDistanceFromRoot() <= m_candidates[slot].distance);
+    Place(slot, MakeEntry(v));
+    SiftUp(slot);
+}
+
+CandidateQueue::CandidateEntry
+CandidateQueue::MakeEntry(SPFVertex* v)
+{
+    CandidateEntry entry;
+    entry.vertex = v;
+    entry.distance = v->GetDistanceFromRoot();
+    entry.rank = v->GetVertexType() == SPFVertex::VertexNetwork ? 0 : 1;
+    entry.sequence = m_sequence++;
+    return entry;
+}
+
+void
+CandidateQueue::Place(uint32_t slot, const CandidateEntry& entry)
+{
+    m_candidates[slot] = entry;
+    m_slots[entry.vertex] = slot;
+}
+
+void
+CandidateQueue::SiftUp(uint32_t slot)
+{
+    CandidateEntry entry = m_candidates[slot];
+    while (slot > 0)
+    {
+        uint32_t parent = (slot - 1) / 2;
+        if (!EntryBefore(entry, m_candidates[parent]))
+        {
+            break;
+        }
+        Place(slot, m_candidates[parent]);
+        slot = parent;
+    }
+    Place(slot, entry);
+}
+
+void
+CandidateQueue::SiftDown(uint32_t slot)
+{
+    CandidateEntry entry = m_candidates[slot];
+    uint32_t size = m_candidates.size();
+    for (;;)
+    {
+        uint32_t child = 2 * slot + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && EntryBefore(m_candidates[child + 1], m_candidates[child]))
+        {
+            child++;
+        }
+        if (!EntryBefore(m_candidates[child], entry))
+        {
+            break;
+        }
+        Place(slot, m_candidates[child]);
+        slot = child;
+    }
+    Place(slot, entry);
+}
+
+bool
+CandidateQueue::EntryBefore(const CandidateEntry& a, const CandidateEntry& b)
+{
+    if (a.distance != b.distance)
+    {
+        return a.distance < b.distance;
+    }
+    if (a.rank != b.rank)
+    {
+        return a.rank < b.rank;
+    }
+    return a.sequence < b.sequence;
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
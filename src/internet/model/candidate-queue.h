@@ -22,8 +22,9 @@
 
 #include "ns3/ipv4-address.h"
 
-#include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -47,7 +48,9 @@ class SPFVertex;
  * Although a STL priority_queue almost does what we want, the requirement
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple
- * enhanced priority queue.
+ * enhanced priority queue.  It is an indexed binary heap, so Push (), Pop ()
+ * and Reorder (SPFVertex*) are logarithmic and Find () is constant time;
+ * vertices of equal priority are still popped in insertion order.
  */
 class CandidateQueue
 {
@@ -159,6 +162,19 @@ class CandidateQueue
      */
     void Reorder();
 
+    /**
+     * @brief Restores the priority order after the distance of a single vertex
+     * in the queue has been lowered.
+     *
+     * This is the logarithmic-time counterpart of Reorder () used by the SPF
+     * relaxation step.  The vertex is ordered after any vertex already queued
+     * with the same priority, exactly as a full Reorder () would do.
+     *
+     * @see SPFVertex
+     * @param v The queued vertex whose m_distanceFromRoot has been lowered.
+     */
+    void Reorder(SPFVertex* v);
+
   private:
     /**
      * \brief return true if v1 < v2
@@ -173,8 +189,61 @@ class CandidateQueue
      */
     static bool CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2);
 
-    typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-    CandidateList_t m_candidates;                  //!< SPFVertex candidates
+    /**
+     * \brief An entry of the binary heap backing the queue.
+     *
+     * The distance is cached at insertion time, and the sequence number keeps
+     * vertices of equal priority in insertion order, as the original sorted
+     * list did.
+     */
+    struct CandidateEntry
+    {
+        SPFVertex* vertex; //!< the queued vertex
+        uint32_t distance; //!< the distance from root the vertex was queued with
+        uint8_t rank;      //!< 0 for network vertices, 1 otherwise
+        uint64_t sequence; //!< insertion sequence number, used to break ties
+    };
+
+    /**
+     * \brief return true if entry a should be popped before entry b
+     * \param a first operand
+     * \param b second operand
+     * \return True if a has a higher priority than b
+     */
+    static bool EntryBefore(const CandidateEntry& a, const CandidateEntry& b);
+
+    /**
+     * \brief Build a heap entry for a vertex
+     * \param v the vertex
+     * \return the entry, holding a fresh sequence number
+     */
+    CandidateEntry MakeEntry(SPFVertex* v);
+
+    /**
+     * \brief Move the entry at the given heap slot towards the top
+     * \param slot the heap slot
+     */
+    void SiftUp(uint32_t slot);
+
+    /**
+     * \brief Move the entry at the given heap slot towards the bottom
+     * \param slot the heap slot
+     */
+    void SiftDown(uint32_t slot);
+
+    /**
+     * \brief Store an entry into a heap slot and update the slot index
+     * \param slot the heap slot
+     * \param entry the entry
+     */
+    void Place(uint32_t slot, const CandidateEntry& entry);
+
+    typedef std::vector<CandidateEntry> CandidateList_t; //!< container of heap entries
+    CandidateList_t m_candidates;                         //!< SPFVertex candidates, as a heap
+    std::unordered_map<const SPFVertex*, uint32_t> m_slots; //!< heap slot of each vertex
+    std::unordered_multimap<Ipv4Address, SPFVertex*, Ipv4AddressHash>
+        m_vertexIds;     //!< queued vertices, by vertex ID
+    uint64_t m_sequence; //!< next insertion sequence number
 
     /**
      * \brief Stream insertion operator.
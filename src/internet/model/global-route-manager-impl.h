@@ -24,13 +24,16 @@
 #include "global-router-interface.h"
 
 #include "ns3/ipv4-address.h"
+#include "ns3/node.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <queue>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -672,13 +675,33 @@ class GlobalRouteManagerLSDB
      */
     uint32_t GetNumExtLSAs() const;
 
+    /**
+     * @brief Get the number of (non-external) Link State Advertisements.
+     *
+     * The LSAs are stored in a flat array; GetLSAIndex () maps each of them
+     * to a slot in [0, GetNumLSAs ()), so that per-calculation state can be
+     * kept in plain arrays rather than in the shared LSAs.
+     *
+     * @returns the number of Link State Advertisements.
+     */
+    uint32_t GetNumLSAs() const;
+
+    /**
+     * @brief Get the slot of a Link State Advertisement in the database.
+     *
+     * @see GetNumLSAs
+     * @param lsa A Link State Advertisement stored in this database.
+     * @returns The slot of the LSA, in [0, GetNumLSAs ()).
+     */
+    uint32_t GetLSAIndex(const GlobalRoutingLSA* lsa) const;
+
   private:
-    typedef std::map<Ipv4Address, GlobalRoutingLSA*>
-        LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
-    typedef std::pair<Ipv4Address, GlobalRoutingLSA*>
-        LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
+    typedef std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>
+        LSDBIndex_t; //!< container of IPv4 addresses / slots in the database
 
-    LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+    std::vector<GlobalRoutingLSA*> m_database; //!< database of Link State Advertisements
+    LSDBIndex_t m_index;                       //!< slots of the LSAs, by link state ID
+    LSDBIndex_t m_linkDataIndex; //!< slots of the LSAs, by transit network link data
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
 };
@@ -738,8 +761,74 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
+    /**
+     * @brief Construct a worker that runs SPF calculations on the Link State
+     * DataBase of another Global Route Manager.
+     *
+     * Each worker keeps its own SPF tree and per-LSA status, so that several
+     * workers can compute the routes of different roots concurrently.  The
+     * LSDB is shared read-only and is not freed by the worker.
+     *
+     * @param owner the Global Route Manager owning the LSDB
+     */
+    GlobalRouteManagerImpl(const GlobalRouteManagerImpl* owner);
+
+    /**
+     * @brief Compute the routes of a batch of routers.
+     *
+     * Roots are claimed one at a time from a shared counter, so that several
+     * workers running this method concurrently balance the load among them.
+     *
+     * @param roots the router IDs of the roots to compute the routes for
+     * @param next the shared index of the next root to be claimed
+     */
+    void SPFCalculateBatch(const std::vector<Ipv4Address>& roots, std::atomic<uint32_t>& next);
+
+    /**
+     * @brief Get the number of threads used to run the SPF calculations.
+     *
+     * In multithreaded builds this is the maximum number of threads of the
+     * multithreaded simulator, which may be set through
+     * Config::SetDefault or MtpInterface::Enable before populating the routing
+     * tables; otherwise the calculations run on the calling thread only.
+     *
+     * @returns the number of threads.
+     */
+    static uint32_t GetSPFThreadCount();
+
+    /**
+     * @brief Map the router IDs of all the nodes having a GlobalRouter
+     * interface to the nodes.
+     *
+     * This lets the route installation find the node at the root of the SPF
+     * tree without walking the node list.
+     */
+    void BuildRouterMap();
+
+    /**
+     * @brief Get the SPF status of an LSA in the current calculation.
+     * @param lsa the LSA
+     * @returns the status
+     */
+    GlobalRoutingLSA::SPFStatus GetLSAStatus(const GlobalRoutingLSA* lsa) const;
+
+    /**
+     * @brief Set the SPF status of an LSA in the current calculation.
+     * @param lsa the LSA
+     * @param status the new status
+     */
+    void SetLSAStatus(const GlobalRoutingLSA* lsa, GlobalRoutingLSA::SPFStatus status);
+
+    typedef std::unordered_map<Ipv4Address, Ptr<Node>, Ipv4AddressHash>
+        RouterMap_t; //!< container of router IDs / nodes
+
     SPFVertex* m_spfroot;           //!< the root node
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    bool m_ownsLsdb;                //!< whether the LSDB is freed by this object
+    RouterMap_t m_routers;          //!< the nodes, by router ID
+    Ptr<Node> m_spfrootNode;        //!< the node at the root of the current calculation
+    std::vector<GlobalRoutingLSA::SPFStatus>
+        m_lsaStatus; //!< SPF status of the LSAs in the current calculation, by LSDB slot
 
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
@@ -31,6 +31,7 @@
 #include "ns3/net-device.h"
 #include "ns3/node-list.h"
 #include "ns3/node.h"
+#include "ns3/parallel-construction.h"
 
 #include <vector>
 
@@ -508,7 +509,9 @@ GlobalRouter::GlobalRouter()
     : m_LSAs()
 {
     NS_LOG_FUNCTION(this);
-    m_routerId.Set(GlobalRouteManager::AllocateRouterId());
+    // router ids are allocated in construction order
+    ParallelConstruction::Defer(
+        [this]() { m_routerId.Set(GlobalRouteManager::AllocateRouterId()); });
 }
 
 GlobalRouter::~GlobalRouter()
@@ -24,6 +24,8 @@
 
 #include "ns3/log.h"
 
+#include <bit>
+
 namespace ns3
 {
 
@@ -52,24 +54,21 @@ bool
 Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_ports.find(port) != m_ports.end();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto it = m_local.find(LocalKey(addr, port));
+    if (it == m_local.end())
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        return false;
+    }
+    for (auto i = it->second.begin(); i != it->second.end(); i++)
+    {
+        if ((*i)->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -88,7 +87,7 @@ Ipv4EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -104,7 +103,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -127,7 +126,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -140,19 +139,35 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // only the end points connected to the same peer from the same port,
+    // or, if not connected, those bound to the same port, may be duplicates
+    const EndPoints* candidates = nullptr;
+    if (peerAddress != Ipv4Address::GetAny() && peerPort != 0)
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        auto it = m_connected.find(ConnectionKey(localPort, peerAddress, peerPort));
+        candidates = it != m_connected.end() ? &it->second : nullptr;
+    }
+    else
+    {
+        auto it = m_unconnected.find(localPort);
+        candidates = it != m_unconnected.end() ? &it->second : nullptr;
+    }
+    if (candidates)
+    {
+        for (auto i = candidates->begin(); i != candidates->end(); i++)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if ((*i)->GetLocalAddress() == localAddress && (*i)->GetPeerPort() == peerPort &&
+                (*i)->GetPeerAddress() == peerAddress &&
+                ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -163,15 +178,20 @@ void
 Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this << endPoint);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    if (endPoint->m_demux != this)
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        return;
     }
+    Unindex(endPoint);
+    endPoint->m_demux = nullptr;
+    auto port = m_ports.find(endPoint->GetLocalPort());
+    if (--port->second == 0)
+    {
+        m_ports.erase(port);
+        MarkEphemeralPort(endPoint->GetLocalPort(), false);
+    }
+    m_endPoints.erase(endPoint->m_demuxPosition);
+    delete endPoint;
 }
 
 /*
@@ -211,131 +231,153 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
     EndPoints retval4; // Exact match on all 4
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // only the end points not connected to a peer, and those connected to
+    // the source of the packet, may match
+    const EndPoints* candidates[2] = {nullptr, nullptr};
+    auto unconnected = m_unconnected.find(dport);
+    if (unconnected != m_unconnected.end())
     {
-        Ipv4EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
-        {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
-        }
-
-        if (endP->GetLocalPort() != dport)
+        candidates[0] = &unconnected->second;
+    }
+    auto connected = m_connected.find(ConnectionKey(dport, saddr, sport));
+    if (connected != m_connected.end())
+    {
+        candidates[1] = &connected->second;
+    }
+    for (const EndPoints* endPoints : candidates)
+    {
+        if (!endPoints)
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
             continue;
         }
-        if (endP->GetBoundNetDevice())
+        for (auto i = endPoints->begin(); i != endPoints->end(); i++)
         {
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            Ipv4EndPoint* endP = *i;
+
+            NS_LOG_DEBUG("Looking at endpoint dport="
+                         << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                         << " sport=" << endP->GetPeerPort()
+                         << " saddr=" << endP->GetPeerAddress());
+
+            if (!endP->IsRxEnabled())
             {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
+                NS_LOG_LOGIC("Skipping endpoint " << &endP
+                                                  << " because endpoint can not receive packets");
                 continue;
             }
-        }
 
-        bool localAddressMatchesExact = false;
-        bool localAddressIsAny = false;
-        bool localAddressIsSubnetAny = false;
+            if (endP->GetLocalPort() != dport)
+            {
+                NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
+                                                  << endP->GetLocalPort()
+                                                  << " does not match packet dport " << dport);
+                continue;
+            }
+            if (endP->GetBoundNetDevice())
+            {
+                if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+                {
+                    NS_LOG_LOGIC("Skipping endpoint "
+                                 << &endP << " because endpoint is bound to specific device and"
+                                 << endP->GetBoundNetDevice() << " does not match packet device "
+                                 << incomingInterface->GetDevice());
+                    continue;
+                }
+            }
 
-        // We have 3 cases:
-        // 1) Exact local / destination address match
-        // 2) Local endpoint bound to Any -> matches anything
-        // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
-        // x.y.z.255 in a /24 net) and direct destination match.
+            bool localAddressMatchesExact = false;
+            bool localAddressIsAny = false;
+            bool localAddressIsSubnetAny = false;
 
-        if (endP->GetLocalAddress() == daddr)
-        {
-            // Case 1:
-            localAddressMatchesExact = true;
-        }
-        else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
-        {
-            // Case 2:
-            localAddressIsAny = true;
-        }
-        else
-        {
-            // Case 3:
-            for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
-            {
-                Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
+            // We have 3 cases:
+            // 1) Exact local / destination address match
+            // 2) Local endpoint bound to Any -> matches anything
+            // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
+            // x.y.z.255 in a /24 net) and direct destination match.
 
-                Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
-                if (endP->GetLocalAddress() == addrNetpart)
+            if (endP->GetLocalAddress() == daddr)
+            {
+                // Case 1:
+                localAddressMatchesExact = true;
+            }
+            else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
+            {
+                // Case 2:
+                localAddressIsAny = true;
+            }
+            else
+            {
+                // Case 3:
+                for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
                 {
-                    NS_LOG_LOGIC("Endpoint is SubnetDirectedAny "
-                                 << endP->GetLocalAddress() << "/"
-                                 << addr.GetMask().GetPrefixLength());
+                    Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
 
-                    Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
-                    if (addrNetpart == daddrNetPart)
+                    Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
+                    if (endP->GetLocalAddress() == addrNetpart)
                     {
-                        localAddressIsSubnetAny = true;
+                        NS_LOG_LOGIC("Endpoint is SubnetDirectedAny "
+                                     << endP->GetLocalAddress() << "/"
+                                     << addr.GetMask().GetPrefixLength());
+
+                        Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
+                        if (addrNetpart == daddrNetPart)
+                        {
+                            localAddressIsSubnetAny = true;
+                        }
                     }
                 }
+
+                // if no match here, keep looking
+                if (!localAddressIsSubnetAny)
+                {
+                    continue;
+                }
             }
 
-            // if no match here, keep looking
-            if (!localAddressIsSubnetAny)
+            bool remotePortMatchesExact = endP->GetPeerPort() == sport;
+            bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
+            bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
+            bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
+
+            // If remote does not match either with exact or wildcard,
+            // skip this one
+            if (!(remotePortMatchesExact || remotePortMatchesWildCard))
+            {
+                continue;
+            }
+            if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
             {
                 continue;
             }
-        }
-
-        bool remotePortMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
-
-        // If remote does not match either with exact or wildcard,
-        // skip this one
-        if (!(remotePortMatchesExact || remotePortMatchesWildCard))
-        {
-            continue;
-        }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-            continue;
-        }
 
-        bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
+            bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
 
-        if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All 4 match - this is the case of an open TCP connection, for example.
-            NS_LOG_LOGIC("Found an endpoint for case 4, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval4.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All but local address - no idea what this case could be.
-            NS_LOG_LOGIC("Found an endpoint for case 3, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
-        { // Only local port and local address matches exactly - Not yet opened connection
-            NS_LOG_LOGIC("Found an endpoint for case 2, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesWildCard &&
-            remotePortMatchesWildCard)
-        { // Only local port matches exactly - Endpoint open to "any" connection
-            NS_LOG_LOGIC("Found an endpoint for case 1, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval1.push_back(endP);
+            if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
+            { // All 4 match - this is the case of an open TCP connection, for example.
+                NS_LOG_LOGIC("Found an endpoint for case 4, adding "
+                             << endP->GetLocalAddress() << ":" << endP->GetLocalPort());
+                retval4.push_back(endP);
+            }
+            if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
+            { // All but local address - no idea what this case could be.
+                NS_LOG_LOGIC("Found an endpoint for case 3, adding "
+                             << endP->GetLocalAddress() << ":" << endP->GetLocalPort());
+                retval3.push_back(endP);
+            }
+            if (localAddressMatchesExact && remoteAddressMatchesWildCard &&
+                remotePortMatchesWildCard)
+            { // Only local port and local address matches exactly - Not yet opened connection
+                NS_LOG_LOGIC("Found an endpoint for case 2, adding "
+                             << endP->GetLocalAddress() << ":" << endP->GetLocalPort());
+                retval2.push_back(endP);
+            }
+            if (localAddressMatchesWildCard && remoteAddressMatchesWildCard &&
+                remotePortMatchesWildCard)
+            { // Only local port matches exactly - Endpoint open to "any" connection
+                NS_LOG_LOGIC("Found an endpoint for case 1, adding "
+                             << endP->GetLocalAddress() << ":" << endP->GetLocalPort());
+                retval1.push_back(endP);
+            }
         }
     }
 
@@ -409,24 +451,146 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
 uint16_t
 Ipv4EndPointDemux::AllocateEphemeralPort()
 {
-    // Similar to counting up logic in netinet/in_pcb.c
+    // Similar to counting up logic in netinet/in_pcb.c, the ports in use
+    // being skipped a word of the bitmap at a time
     NS_LOG_FUNCTION(this);
-    uint16_t port = m_ephemeral;
-    int count = m_portLast - m_portFirst;
-    do
+    uint32_t nPorts = m_portLast - m_portFirst + 1;
+    uint32_t nWords = (nPorts + 63) / 64;
+    if (m_ephemeralPorts.empty())
     {
-        if (count-- < 0)
+        // the bits past the last port are set, as if in use
+        m_ephemeralPorts.assign(nWords, 0);
+        for (uint32_t bit = nPorts; bit < nWords * 64; bit++)
+        {
+            m_ephemeralPorts[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+        for (const auto& [port, count] : m_ports)
         {
-            return 0;
+            MarkEphemeralPort(port, true);
         }
-        ++port;
-        if (port < m_portFirst || port > m_portLast)
+    }
+    uint32_t bit = 0;
+    if (m_ephemeral >= m_portFirst && m_ephemeral < m_portLast)
+    {
+        bit = m_ephemeral + 1 - m_portFirst;
+    }
+    // the word of the first port is looked at twice, to wrap around
+    for (uint32_t i = 0; i <= nWords; i++)
+    {
+        uint64_t free = ~m_ephemeralPorts[bit / 64] >> (bit % 64);
+        if (free != 0)
         {
-            port = m_portFirst;
+            m_ephemeral = m_portFirst + bit + std::countr_zero(free);
+            return m_ephemeral;
         }
-    } while (LookupPortLocal(port));
-    m_ephemeral = port;
-    return port;
+        bit = (bit / 64 + 1) % nWords * 64;
+    }
+    return 0;
+}
+
+void
+Ipv4EndPointDemux::MarkEphemeralPort(uint16_t port, bool inUse)
+{
+    NS_LOG_FUNCTION(this << port << inUse);
+    if (m_ephemeralPorts.empty() || port < m_portFirst || port > m_portLast)
+    {
+        return;
+    }
+    uint32_t bit = port - m_portFirst;
+    if (inUse)
+    {
+        m_ephemeralPorts[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    else
+    {
+        m_ephemeralPorts[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+    }
+}
+
+void
+Ipv4EndPointDemux::Insert(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    endPoint->m_demuxPosition = m_endPoints.insert(m_endPoints.end(), endPoint);
+    endPoint->m_demux = this;
+    Index(endPoint);
+    if (m_ports[endPoint->GetLocalPort()]++ == 0)
+    {
+        MarkEphemeralPort(endPoint->GetLocalPort(), true);
+    }
+}
+
+void
+Ipv4EndPointDemux::Index(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    uint16_t port = endPoint->GetLocalPort();
+    EndPoints& local = m_local[LocalKey(endPoint->GetLocalAddress(), port)];
+    endPoint->m_localPosition = local.insert(local.end(), endPoint);
+    EndPoints& peer =
+        IsConnected(endPoint)
+            ? m_connected[ConnectionKey(port, endPoint->GetPeerAddress(), endPoint->GetPeerPort())]
+            : m_unconnected[port];
+    endPoint->m_peerPosition = peer.insert(peer.end(), endPoint);
+}
+
+/**
+ * Remove an end point from one of the indexes of Ipv4EndPointDemux.
+ *
+ * \tparam M \deduced The index type.
+ * \tparam K \deduced The key type.
+ * \param [in,out] index The index.
+ * \param [in] key The key of the end point.
+ * \param [in] position The position of the end point in the index.
+ */
+template <typename M, typename K>
+static void
+RemoveFromIndex(M& index, const K& key, Ipv4EndPointDemux::EndPointsI position)
+{
+    auto it = index.find(key);
+    NS_ASSERT(it != index.end());
+    it->second.erase(position);
+    if (it->second.empty())
+    {
+        index.erase(it);
+    }
+}
+
+void
+Ipv4EndPointDemux::Unindex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    uint16_t port = endPoint->GetLocalPort();
+    RemoveFromIndex(m_local,
+                    LocalKey(endPoint->GetLocalAddress(), port),
+                    endPoint->m_localPosition);
+    if (IsConnected(endPoint))
+    {
+        uint64_t key = ConnectionKey(port, endPoint->GetPeerAddress(), endPoint->GetPeerPort());
+        RemoveFromIndex(m_connected, key, endPoint->m_peerPosition);
+    }
+    else
+    {
+        RemoveFromIndex(m_unconnected, port, endPoint->m_peerPosition);
+    }
+}
+
+uint64_t
+Ipv4EndPointDemux::LocalKey(Ipv4Address address, uint16_t port)
+{
+    return (uint64_t(address.Get()) << 16) | port;
+}
+
+uint64_t
+Ipv4EndPointDemux::ConnectionKey(uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort)
+{
+    return (uint64_t(peerAddress.Get()) << 32) | (uint64_t(peerPort) << 16) | localPort;
+}
+
+bool
+Ipv4EndPointDemux::IsConnected(const Ipv4EndPoint* endPoint)
+{
+    return endPoint->GetPeerAddress() != Ipv4Address::GetAny() && endPoint->GetPeerPort() != 0;
 }
 
 } // namespace ns3
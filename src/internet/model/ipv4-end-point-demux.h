@@ -26,6 +26,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -42,6 +44,11 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are also indexed by local address and port, and, when
+ * connected to a peer, by local port and peer address and port, so that
+ * a lookup only looks at the endpoints which may match, whatever the number
+ * of connections.  The ephemeral ports in use are kept in a bitmap.
  */
 
 class Ipv4EndPointDemux
@@ -171,12 +178,66 @@ class Ipv4EndPointDemux
     void DeAllocate(Ipv4EndPoint* endPoint);
 
   private:
+    friend class Ipv4EndPoint;
+
     /**
      * \brief Allocate an ephemeral port.
      * \returns the ephemeral port
      */
     uint16_t AllocateEphemeralPort();
 
+    /**
+     * \brief Add an end point to the list and the indexes.
+     * \param endPoint the end point
+     */
+    void Insert(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Add an end point to the indexes on its addresses.
+     *
+     * Called by the end point after its addresses changed.
+     *
+     * \param endPoint the end point
+     */
+    void Index(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the indexes on its addresses.
+     *
+     * Called by the end point before its addresses change.
+     *
+     * \param endPoint the end point
+     */
+    void Unindex(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Mark a port in use or free in the bitmap of the ephemeral ports.
+     * \param port the port
+     * \param inUse whether the port is in use
+     */
+    void MarkEphemeralPort(uint16_t port, bool inUse);
+
+    /**
+     * \param address the local address
+     * \param port the local port
+     * \returns the key of the end points bound to the address and port
+     */
+    static uint64_t LocalKey(Ipv4Address address, uint16_t port);
+
+    /**
+     * \param localPort the local port
+     * \param peerAddress the peer address
+     * \param peerPort the peer port
+     * \returns the key of the end points connected to the peer from the local port
+     */
+    static uint64_t ConnectionKey(uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+    /**
+     * \param endPoint an end point
+     * \returns true if the end point is connected to a peer address and port
+     */
+    static bool IsConnected(const Ipv4EndPoint* endPoint);
+
     /**
      * \brief The ephemeral port.
      */
@@ -196,6 +257,33 @@ class Ipv4EndPointDemux
      * \brief A list of IPv4 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The end points by local address and port.
+     */
+    std::unordered_map<uint64_t, EndPoints> m_local;
+
+    /**
+     * \brief The end points connected to a peer, by local port and peer
+     * address and port.
+     */
+    std::unordered_map<uint64_t, EndPoints> m_connected;
+
+    /**
+     * \brief The end points not connected to a peer, by local port.
+     */
+    std::unordered_map<uint16_t, EndPoints> m_unconnected;
+
+    /**
+     * \brief The number of end points by local port.
+     */
+    std::unordered_map<uint16_t, uint32_t> m_ports;
+
+    /**
+     * \brief The bitmap of the ephemeral ports in use, allocated on the
+     * first allocation of an ephemeral port.
+     */
+    std::vector<uint64_t> m_ephemeralPorts;
 };
 
 } // namespace ns3
@@ -31,6 +31,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -71,7 +72,8 @@ Ipv4GlobalRouting::GetTypeId()
 
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_respondToInterfaceEvents(false),
+      m_indexValid(false)
 {
     NS_LOG_FUNCTION(this);
 
@@ -90,6 +92,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
     m_hostRoutes.push_back(route);
+    InvalidateIndex();
 }
 
 void
@@ -99,6 +102,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
     m_hostRoutes.push_back(route);
+    InvalidateIndex();
 }
 
 void
@@ -111,6 +115,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_networkRoutes.push_back(route);
+    InvalidateIndex();
 }
 
 void
@@ -120,6 +125,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     m_networkRoutes.push_back(route);
+    InvalidateIndex();
 }
 
 void
@@ -132,81 +138,181 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_ASexternalRoutes.push_back(route);
+    InvalidateIndex();
 }
 
-Ptr<Ipv4Route>
-Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, uint32_t flowHash, Ptr<NetDevice> oif)
+void
+Ipv4GlobalRouting::InvalidateIndex()
 {
-    NS_LOG_FUNCTION(this << dest << oif);
-    NS_LOG_LOGIC("Looking for route for destination " << dest);
-    Ptr<Ipv4Route> rtentry = nullptr;
-    // store all available routes that bring packets to their destination
-    typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
-    RouteVec_t allRoutes;
+    m_indexValid = false;
+}
 
-    NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
-    for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+void
+Ipv4GlobalRouting::BuildIndex()
+{
+    NS_LOG_FUNCTION(this);
+    m_ecmpRoutes.clear();
+    m_hostIndex.clear();
+
+    // Host routes to the same destination form one group, in table order
+    std::unordered_map<uint32_t, std::vector<Ipv4RoutingTableEntry*>> hosts;
+    std::vector<uint32_t> hostOrder;
+    for (auto route : m_hostRoutes)
     {
-        NS_ASSERT((*i)->IsHost());
-        if ((*i)->GetDest() == dest)
+        NS_ASSERT(route->IsHost());
+        auto& group = hosts[route->GetDest().Get()];
+        if (group.empty())
         {
-            if (oif)
-            {
-                if (oif != m_ipv4->GetNetDevice((*i)->GetInterface()))
-                {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
-                    continue;
-                }
-            }
-            allRoutes.push_back(*i);
-            NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << *i);
+            hostOrder.push_back(route->GetDest().Get());
         }
+        group.push_back(route);
     }
-    if (allRoutes.empty()) // if no host route is found
+    m_hostIndex.reserve(hostOrder.size());
+    for (auto dest : hostOrder)
     {
-        NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
-        for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+        const auto& group = hosts[dest];
+        m_hostIndex[dest] = {static_cast<uint32_t>(m_ecmpRoutes.size()),
+                             static_cast<uint32_t>(group.size())};
+        m_ecmpRoutes.insert(m_ecmpRoutes.end(), group.begin(), group.end());
+    }
+
+    BuildPrefixTables(m_networkRoutes, m_networkIndex);
+    BuildPrefixTables(m_ASexternalRoutes, m_ASexternalIndex);
+    m_indexValid = true;
+    NS_LOG_LOGIC("Indexed " << m_hostIndex.size() << " hosts, " << m_networkIndex.size()
+                            << " network masks, " << m_ASexternalIndex.size()
+                            << " external masks");
+}
+
+void
+Ipv4GlobalRouting::BuildPrefixTables(const std::list<Ipv4RoutingTableEntry*>& routes,
+                                     PrefixTables_t& tables)
+{
+    NS_LOG_FUNCTION(this);
+    tables.clear();
+
+    // Bucket the table positions of the routes by mask and masked network
+    std::vector<Ipv4RoutingTableEntry*> byPosition(routes.begin(), routes.end());
+    std::vector<std::pair<Ipv4Mask, std::unordered_map<uint32_t, std::vector<uint32_t>>>> buckets;
+    for (uint32_t pos = 0; pos < byPosition.size(); pos++)
+    {
+        Ipv4Mask mask = byPosition[pos]->GetDestNetworkMask();
+        auto bucket = std::find_if(buckets.begin(), buckets.end(), [mask](const auto& b) {
+            return b.first == mask;
+        });
+        if (bucket == buckets.end())
         {
-            Ipv4Mask mask = (*j)->GetDestNetworkMask();
-            Ipv4Address entry = (*j)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+            buckets.emplace_back(mask, std::unordered_map<uint32_t, std::vector<uint32_t>>());
+            bucket = buckets.end() - 1;
+        }
+        bucket->second[byPosition[pos]->GetDestNetwork().Get() & mask.Get()].push_back(pos);
+    }
+    std::stable_sort(buckets.begin(), buckets.end(), [](const auto& a, const auto& b) {
+        return a.first.GetPrefixLength() > b.first.GetPrefixLength();
+    });
+
+    // A destination matching a prefix also matches every shorter prefix
+    // containing it; the list walk collects all of them in table order
+    tables.resize(buckets.size());
+    std::vector<uint32_t> positions;
+    for (std::size_t i = 0; i < buckets.size(); i++)
+    {
+        tables[i].mask = buckets[i].first;
+        tables[i].groups.reserve(buckets[i].second.size());
+        for (const auto& prefix : buckets[i].second)
+        {
+            positions = prefix.second;
+            for (std::size_t j = i + 1; j < buckets.size(); j++)
             {
-                if (oif)
+                auto outer = buckets[j].second.find(prefix.first & buckets[j].first.Get());
+                if (outer != buckets[j].second.end())
                 {
-                    if (oif != m_ipv4->GetNetDevice((*j)->GetInterface()))
-                    {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
-                    }
+                    positions.insert(positions.end(), outer->second.begin(), outer->second.end());
                 }
-                allRoutes.push_back(*j);
-                NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << *j);
+            }
+            std::sort(positions.begin(), positions.end());
+            tables[i].groups[prefix.first] = {static_cast<uint32_t>(m_ecmpRoutes.size()),
+                                              static_cast<uint32_t>(positions.size())};
+            for (auto pos : positions)
+            {
+                m_ecmpRoutes.push_back(byPosition[pos]);
             }
         }
     }
-    if (allRoutes.empty()) // consider external if no host/network found
+}
+
+const Ipv4GlobalRouting::EcmpGroup*
+Ipv4GlobalRouting::FindPrefix(const PrefixTables_t& tables, Ipv4Address dest)
+{
+    for (const auto& table : tables)
+    {
+        auto group = table.groups.find(dest.Get() & table.mask.Get());
+        if (group != table.groups.end())
+        {
+            return &group->second;
+        }
+    }
+    return nullptr;
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, uint32_t flowHash, Ptr<NetDevice> oif)
+{
+    NS_LOG_FUNCTION(this << dest << oif);
+    NS_LOG_LOGIC("Looking for route for destination " << dest);
+    if (!m_indexValid)
     {
-        for (auto k = m_ASexternalRoutes.begin(); k != m_ASexternalRoutes.end(); k++)
+        BuildIndex();
+    }
+
+    // the available routes that bring packets to their destination: a
+    // precomputed ECMP group, or its members on the requested interface
+    Ipv4RoutingTableEntry* const* allRoutes = nullptr;
+    uint32_t nRoutes = 0;
+    std::vector<Ipv4RoutingTableEntry*> oifRoutes;
+    auto useGroup = [&](const EcmpGroup* group, bool firstOnly) {
+        if (!group)
+        {
+            return;
+        }
+        Ipv4RoutingTableEntry* const* routes = m_ecmpRoutes.data() + group->offset;
+        if (!oif)
+        {
+            allRoutes = routes;
+            nRoutes = firstOnly ? 1 : group->size;
+            return;
+        }
+        for (uint32_t i = 0; i < group->size; i++)
         {
-            Ipv4Mask mask = (*k)->GetDestNetworkMask();
-            Ipv4Address entry = (*k)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+            if (oif != m_ipv4->GetNetDevice(routes[i]->GetInterface()))
+            {
+                NS_LOG_LOGIC("Not on requested interface, skipping");
+                continue;
+            }
+            oifRoutes.push_back(routes[i]);
+            if (firstOnly)
             {
-                NS_LOG_LOGIC("Found external route" << *k);
-                if (oif)
-                {
-                    if (oif != m_ipv4->GetNetDevice((*k)->GetInterface()))
-                    {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
-                    }
-                }
-                allRoutes.push_back(*k);
                 break;
             }
         }
+        allRoutes = oifRoutes.data();
+        nRoutes = oifRoutes.size();
+    };
+
+    auto hostGroup = m_hostIndex.find(dest.Get());
+    useGroup(hostGroup != m_hostIndex.end() ? &hostGroup->second : nullptr, false);
+    NS_LOG_LOGIC("Found " << nRoutes << " global host routes");
+    if (nRoutes == 0) // if no host route is found
+    {
+        useGroup(FindPrefix(m_networkIndex, dest), false);
+        NS_LOG_LOGIC("Found " << nRoutes << " global network routes");
+    }
+    if (nRoutes == 0) // consider external if no host/network found
+    {
+        useGroup(FindPrefix(m_ASexternalIndex, dest), true);
+        NS_LOG_LOGIC("Found " << nRoutes << " external routes");
     }
-    if (!allRoutes.empty()) // if route(s) is found
+    if (nRoutes > 0) // if route(s) is found
     {
         // pick up one of the routes uniformly at random if random
         // ECMP routing is enabled, or always select the first route
@@ -214,19 +320,19 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, uint32_t flowHash, Ptr<NetDevi
         uint32_t selectIndex;
         if (m_flowEcmpRouting)
         {
-            selectIndex = flowHash % allRoutes.size();
+            selectIndex = flowHash % nRoutes;
         }
         else if (m_randomEcmpRouting)
         {
-            selectIndex = m_rand->GetInteger(0, allRoutes.size() - 1);
+            selectIndex = m_rand->GetInteger(0, nRoutes - 1);
         }
         else
         {
             selectIndex = 0;
         }
-        Ipv4RoutingTableEntry* route = allRoutes.at(selectIndex);
+        Ipv4RoutingTableEntry* route = allRoutes[selectIndex];
         // create a Ipv4Route object from the selected routing table entry
-        rtentry = Create<Ipv4Route>();
+        Ptr<Ipv4Route> rtentry = Create<Ipv4Route>();
         rtentry->SetDestination(route->GetDest());
         /// \todo handle multi-address case
         rtentry->SetSource(m_ipv4->GetAddress(route->GetInterface(), 0).GetLocal());
@@ -310,6 +416,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
                 delete *i;
                 m_hostRoutes.erase(i);
+                InvalidateIndex();
                 NS_LOG_LOGIC("Done removing host route "
                              << index << "; host route remaining size = " << m_hostRoutes.size());
                 return;
@@ -326,6 +433,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
             delete *j;
             m_networkRoutes.erase(j);
+            InvalidateIndex();
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -341,6 +449,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_ASexternalRoutes.size());
             delete *k;
             m_ASexternalRoutes.erase(k);
+            InvalidateIndex();
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -375,6 +484,11 @@ Ipv4GlobalRouting::DoDispose()
     {
         delete (*l);
     }
+    InvalidateIndex();
+    m_ecmpRoutes.clear();
+    m_hostIndex.clear();
+    m_networkIndex.clear();
+    m_ASexternalIndex.clear();
 
     Ipv4RoutingProtocol::DoDispose();
 }
@@ -29,6 +29,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -66,6 +68,16 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * Lookups do not walk the route lists.  The first lookup after the routes
+ * have changed builds a forwarding index: host routes are hashed by
+ * destination address, and network and AS-external routes are hashed by
+ * masked network in one table per mask, longest mask first.  Every indexed
+ * destination refers to a precomputed ECMP group holding, in table order,
+ * all the routes that the list walk would have collected for it, so the
+ * route selection (first route, RandomEcmpRouting or FlowEcmpRouting) is
+ * unchanged.  Routing table entries returned by GetRoute () must not be
+ * modified in place.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -269,6 +281,56 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
     typedef std::list<Ipv4RoutingTableEntry*>::iterator ASExternalRoutesI;
 
+    /// A run of equal-cost routes stored contiguously in m_ecmpRoutes
+    struct EcmpGroup
+    {
+        uint32_t offset; //!< index of the first route of the group
+        uint32_t size;   //!< number of routes in the group
+    };
+
+    /// ECMP groups indexed by host address or masked network address
+    typedef std::unordered_map<uint32_t, EcmpGroup> EcmpGroups_t;
+
+    /// The ECMP groups of all the indexed prefixes sharing one mask
+    struct PrefixTable
+    {
+        Ipv4Mask mask;       //!< mask shared by the prefixes of this table
+        EcmpGroups_t groups; //!< groups indexed by masked network address
+    };
+
+    /// Prefix tables, longest mask first
+    typedef std::vector<PrefixTable> PrefixTables_t;
+
+    /**
+     * \brief Mark the forwarding index as stale after a route change.
+     */
+    void InvalidateIndex();
+
+    /**
+     * \brief Rebuild the forwarding index from the route lists.
+     */
+    void BuildIndex();
+
+    /**
+     * \brief Build the prefix tables indexing a list of network routes.
+     *
+     * The group of each prefix holds every route of the list whose network
+     * contains that prefix, in list order.
+     *
+     * \param routes the routes to index
+     * \param tables the tables to fill, longest mask first
+     */
+    void BuildPrefixTables(const std::list<Ipv4RoutingTableEntry*>& routes,
+                           PrefixTables_t& tables);
+
+    /**
+     * \brief Find the ECMP group of the longest indexed prefix matching an address.
+     * \param tables the prefix tables to search
+     * \param dest destination address
+     * \return the group, or nullptr if no prefix matches
+     */
+    static const EcmpGroup* FindPrefix(const PrefixTables_t& tables, Ipv4Address dest);
+
     /**
      * \brief Lookup in the forwarding table for destination.
      * \param dest destination address
@@ -284,6 +346,12 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    bool m_indexValid;                                //!< forwarding index is up to date
+    std::vector<Ipv4RoutingTableEntry*> m_ecmpRoutes; //!< routes of all the ECMP groups
+    EcmpGroups_t m_hostIndex;                         //!< host route groups by destination
+    PrefixTables_t m_networkIndex;                    //!< network route groups by prefix
+    PrefixTables_t m_ASexternalIndex;                 //!< external route groups by prefix
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -671,11 +671,16 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
     }
 
     NS_ASSERT_MSG(m_routingProtocol, "Need a routing protocol object to process packets");
+    // unless the trace sinks were given the copy, it is ours: let IpForward
+    // take it over during the routing
+    const Packet* rxPacket = m_rxPacket;
+    m_rxPacket = m_rxTrace.IsEmpty() ? PeekPointer(packet) : nullptr;
     if (!m_routingProtocol->RouteInput(packet, ipHeader, device, m_ucb, m_mcb, m_lcb, m_ecb))
     {
         NS_LOG_WARN("No route found for forwarding packet.  Drop.");
         m_dropTrace(ipHeader, packet, DROP_NO_ROUTE, this, interface);
     }
+    m_rxPacket = rxPacket;
 }
 
 Ptr<Icmpv4L4Protocol>
@@ -1071,7 +1076,17 @@ Ipv4L3Protocol::IpForward(Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv
     NS_LOG_LOGIC("Forwarding logic for node: " << m_node->GetId());
     // Forwarding
     Ipv4Header ipHeader = header;
-    Ptr<Packet> packet = p->Copy();
+    Ptr<Packet> packet;
+    if (PeekPointer(p) == m_rxPacket)
+    {
+        // the packet being received: forward it in place, only once
+        packet = ConstCast<Packet>(p);
+        m_rxPacket = nullptr;
+    }
+    else
+    {
+        packet = p->Copy();
+    }
     int32_t interface = GetInterfaceForDevice(rtentry->GetOutputDevice());
     ipHeader.SetTtl(ipHeader.GetTtl() - 1);
     if (ipHeader.GetTtl() == 0)
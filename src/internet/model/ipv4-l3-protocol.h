@@ -639,6 +639,14 @@ class Ipv4L3Protocol : public Ipv4
     Time m_purge;       //!< time between purging expired duplicate entries
     EventId m_cleanDpd; //!< event to cleanup expired duplicate entries
 
+    /**
+     * The copy of the packet made by Receive while it is routed, which nobody
+     * else refers to, or nullptr.  IpForward forwards it without copying it
+     * again.  The copy is not taken over if it was passed to the Rx trace
+     * sinks, which may have kept it.
+     */
+    const Packet* m_rxPacket{nullptr};
+
     Ipv4RoutingProtocol::UnicastForwardCallback m_ucb;   ///< Unicast forward callback
     Ipv4RoutingProtocol::MulticastForwardCallback m_mcb; ///< Multicast forward callback
     Ipv4RoutingProtocol::LocalDeliverCallback m_lcb;     ///< Local delivery callback
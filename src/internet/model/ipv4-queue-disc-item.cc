@@ -163,7 +163,7 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
 
     // Linux calculates jhash2 (jenkins hash), we calculate murmur3 because it is
     // already available in ns-3
-    uint32_t hash = Hash32((char*)buf, 17);
+    uint32_t hash = Hash32(buf);
 
     NS_LOG_DEBUG("Hash value " << hash);
 
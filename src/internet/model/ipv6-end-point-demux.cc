@@ -23,6 +23,8 @@
 
 #include "ns3/log.h"
 
+#include <bit>
+
 namespace ns3
 {
 
@@ -51,24 +53,21 @@ bool
 Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_ports.find(port) != m_ports.end();
 }
 
 bool
 Ipv6EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto it = m_local.find(Key{addr, port, 0});
+    if (it == m_local.end())
+    {
+        return false;
+    }
+    for (auto i = it->second.begin(); i != it->second.end(); i++)
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        if ((*i)->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -87,7 +86,7 @@ Ipv6EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(Ipv6Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -103,7 +102,7 @@ Ipv6EndPointDemux::Allocate(Ipv6Address address)
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -126,7 +125,7 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv6Address address,
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -139,19 +138,35 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // only the end points connected to the same peer from the same port,
+    // or, if not connected, those bound to the same port, may be duplicates
+    const EndPoints* candidates = nullptr;
+    if (peerAddress != Ipv6Address::GetAny() && peerPort != 0)
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        auto it = m_connected.find(Key{peerAddress, localPort, peerPort});
+        candidates = it != m_connected.end() ? &it->second : nullptr;
+    }
+    else
+    {
+        auto it = m_unconnected.find(localPort);
+        candidates = it != m_unconnected.end() ? &it->second : nullptr;
+    }
+    if (candidates)
+    {
+        for (auto i = candidates->begin(); i != candidates->end(); i++)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if ((*i)->GetLocalAddress() == localAddress && (*i)->GetPeerPort() == peerPort &&
+                (*i)->GetPeerAddress() == peerAddress &&
+                ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv6EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -162,15 +177,20 @@ void
 Ipv6EndPointDemux::DeAllocate(Ipv6EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    if (endPoint->m_demux != this)
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        return;
+    }
+    Unindex(endPoint);
+    endPoint->m_demux = nullptr;
+    auto port = m_ports.find(endPoint->GetLocalPort());
+    if (--port->second == 0)
+    {
+        m_ports.erase(port);
+        MarkEphemeralPort(endPoint->GetLocalPort(), false);
     }
+    m_endPoints.erase(endPoint->m_demuxPosition);
+    delete endPoint;
 }
 
 /*
@@ -193,92 +213,113 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
     EndPoints retval4; /* Exact match on all 4 */
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // only the end points not connected to a peer, and those connected to
+    // the source of the packet, may match
+    const EndPoints* candidates[2] = {nullptr, nullptr};
+    auto unconnected = m_unconnected.find(dport);
+    if (unconnected != m_unconnected.end())
     {
-        Ipv6EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
+        candidates[0] = &unconnected->second;
+    }
+    auto connected = m_connected.find(Key{saddr, dport, sport});
+    if (connected != m_connected.end())
+    {
+        candidates[1] = &connected->second;
+    }
+    for (const EndPoints* endPoints : candidates)
+    {
+        if (!endPoints)
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
             continue;
         }
-
-        if (endP->GetLocalPort() != dport)
+        for (auto i = endPoints->begin(); i != endPoints->end(); i++)
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
-            continue;
-        }
+            Ipv6EndPoint* endP = *i;
 
-        if (endP->GetBoundNetDevice())
-        {
-            if (!incomingInterface)
+            NS_LOG_DEBUG("Looking at endpoint dport="
+                         << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                         << " sport=" << endP->GetPeerPort()
+                         << " saddr=" << endP->GetPeerAddress());
+
+            if (!endP->IsRxEnabled())
             {
+                NS_LOG_LOGIC("Skipping endpoint " << &endP
+                                                  << " because endpoint can not receive packets");
                 continue;
             }
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+
+            if (endP->GetLocalPort() != dport)
             {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
+                NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
+                                                  << endP->GetLocalPort()
+                                                  << " does not match packet dport " << dport);
                 continue;
             }
-        }
 
-        /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-        NS_LOG_DEBUG("dest addr " << daddr);
+            if (endP->GetBoundNetDevice())
+            {
+                if (!incomingInterface)
+                {
+                    continue;
+                }
+                if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+                {
+                    NS_LOG_LOGIC("Skipping endpoint "
+                                 << &endP << " because endpoint is bound to specific device and"
+                                 << endP->GetBoundNetDevice() << " does not match packet device "
+                                 << incomingInterface->GetDevice());
+                    continue;
+                }
+            }
 
-        bool localAddressMatchesWildCard = endP->GetLocalAddress() == Ipv6Address::GetAny();
-        bool localAddressMatchesExact = endP->GetLocalAddress() == daddr;
-        bool localAddressMatchesAllRouters =
-            endP->GetLocalAddress() == Ipv6Address::GetAllRoutersMulticast();
+            /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
+            NS_LOG_DEBUG("dest addr " << daddr);
 
-        /* if no match here, keep looking */
-        if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        {
-            continue;
-        }
-        bool remotePeerMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePeerMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv6Address::GetAny();
-
-        /* If remote does not match either with exact or wildcard,i
-           skip this one */
-        if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        {
-            continue;
-        }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-            continue;
-        }
+            bool localAddressMatchesWildCard = endP->GetLocalAddress() == Ipv6Address::GetAny();
+            bool localAddressMatchesExact = endP->GetLocalAddress() == daddr;
+            bool localAddressMatchesAllRouters =
+                endP->GetLocalAddress() == Ipv6Address::GetAllRoutersMulticast();
 
-        /* Now figure out which return list to add this one to */
-        if (localAddressMatchesWildCard && remotePeerMatchesWildCard &&
-            remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-            retval1.push_back(endP);
-        }
-        if ((localAddressMatchesExact || (localAddressMatchesAllRouters)) &&
-            remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All but local address */
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
-        { /* All 4 match */
-            retval4.push_back(endP);
+            /* if no match here, keep looking */
+            if (!(localAddressMatchesExact || localAddressMatchesWildCard))
+            {
+                continue;
+            }
+            bool remotePeerMatchesExact = endP->GetPeerPort() == sport;
+            bool remotePeerMatchesWildCard = endP->GetPeerPort() == 0;
+            bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
+            bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv6Address::GetAny();
+
+            /* If remote does not match either with exact or wildcard,i
+               skip this one */
+            if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
+            {
+                continue;
+            }
+            if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
+            {
+                continue;
+            }
+
+            /* Now figure out which return list to add this one to */
+            if (localAddressMatchesWildCard && remotePeerMatchesWildCard &&
+                remoteAddressMatchesWildCard)
+            { /* Only local port matches exactly */
+                retval1.push_back(endP);
+            }
+            if ((localAddressMatchesExact || (localAddressMatchesAllRouters)) &&
+                remotePeerMatchesWildCard && remoteAddressMatchesWildCard)
+            { /* Only local port and local address matches exactly */
+                retval2.push_back(endP);
+            }
+            if (localAddressMatchesWildCard && remotePeerMatchesExact && remoteAddressMatchesExact)
+            { /* All but local address */
+                retval3.push_back(endP);
+            }
+            if (localAddressMatchesExact && remotePeerMatchesExact && remoteAddressMatchesExact)
+            { /* All 4 match */
+                retval4.push_back(endP);
+            }
         }
     }
 
@@ -351,23 +392,144 @@ Ipv6EndPointDemux::SimpleLookup(Ipv6Address dst, uint16_t dport, Ipv6Address src
 uint16_t
 Ipv6EndPointDemux::AllocateEphemeralPort()
 {
+    // the ports in use are skipped a word of the bitmap at a time
     NS_LOG_FUNCTION(this);
-    uint16_t port = m_ephemeral;
-    int count = m_portLast - m_portFirst;
-    do
+    uint32_t nPorts = m_portLast - m_portFirst + 1;
+    uint32_t nWords = (nPorts + 63) / 64;
+    if (m_ephemeralPorts.empty())
     {
-        if (count-- < 0)
+        // the bits past the last port are set, as if in use
+        m_ephemeralPorts.assign(nWords, 0);
+        for (uint32_t bit = nPorts; bit < nWords * 64; bit++)
         {
-            return 0;
+            m_ephemeralPorts[bit / 64] |= uint64_t(1) << (bit % 64);
         }
-        ++port;
-        if (port < m_portFirst || port > m_portLast)
+        for (const auto& [port, count] : m_ports)
         {
-            port = m_portFirst;
+            MarkEphemeralPort(port, true);
         }
-    } while (LookupPortLocal(port));
-    m_ephemeral = port;
-    return port;
+    }
+    uint32_t bit = 0;
+    if (m_ephemeral >= m_portFirst && m_ephemeral < m_portLast)
+    {
+        bit = m_ephemeral + 1 - m_portFirst;
+    }
+    // the word of the first port is looked at twice, to wrap around
+    for (uint32_t i = 0; i <= nWords; i++)
+    {
+        uint64_t free = ~m_ephemeralPorts[bit / 64] >> (bit % 64);
+        if (free != 0)
+        {
+            m_ephemeral = m_portFirst + bit + std::countr_zero(free);
+            return m_ephemeral;
+        }
+        bit = (bit / 64 + 1) % nWords * 64;
+    }
+    return 0;
+}
+
+void
+Ipv6EndPointDemux::MarkEphemeralPort(uint16_t port, bool inUse)
+{
+    NS_LOG_FUNCTION(this << port << inUse);
+    if (m_ephemeralPorts.empty() || port < m_portFirst || port > m_portLast)
+    {
+        return;
+    }
+    uint32_t bit = port - m_portFirst;
+    if (inUse)
+    {
+        m_ephemeralPorts[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    else
+    {
+        m_ephemeralPorts[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+    }
+}
+
+void
+Ipv6EndPointDemux::Insert(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    endPoint->m_demuxPosition = m_endPoints.insert(m_endPoints.end(), endPoint);
+    endPoint->m_demux = this;
+    Index(endPoint);
+    if (m_ports[endPoint->GetLocalPort()]++ == 0)
+    {
+        MarkEphemeralPort(endPoint->GetLocalPort(), true);
+    }
+}
+
+void
+Ipv6EndPointDemux::Index(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    uint16_t port = endPoint->GetLocalPort();
+    EndPoints& local = m_local[Key{endPoint->GetLocalAddress(), port, 0}];
+    endPoint->m_localPosition = local.insert(local.end(), endPoint);
+    EndPoints& peer =
+        IsConnected(endPoint)
+            ? m_connected[Key{endPoint->GetPeerAddress(), port, endPoint->GetPeerPort()}]
+            : m_unconnected[port];
+    endPoint->m_peerPosition = peer.insert(peer.end(), endPoint);
+}
+
+/**
+ * Remove an end point from one of the indexes of Ipv6EndPointDemux.
+ *
+ * \tparam M \deduced The index type.
+ * \tparam K \deduced The key type.
+ * \param [in,out] index The index.
+ * \param [in] key The key of the end point.
+ * \param [in] position The position of the end point in the index.
+ */
+template <typename M, typename K>
+static void
+RemoveFromIndex(M& index, const K& key, Ipv6EndPointDemux::EndPointsI position)
+{
+    auto it = index.find(key);
+    NS_ASSERT(it != index.end());
+    it->second.erase(position);
+    if (it->second.empty())
+    {
+        index.erase(it);
+    }
+}
+
+void
+Ipv6EndPointDemux::Unindex(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    uint16_t port = endPoint->GetLocalPort();
+    RemoveFromIndex(m_local, Key{endPoint->GetLocalAddress(), port, 0}, endPoint->m_localPosition);
+    if (IsConnected(endPoint))
+    {
+        RemoveFromIndex(m_connected,
+                        Key{endPoint->GetPeerAddress(), port, endPoint->GetPeerPort()},
+                        endPoint->m_peerPosition);
+    }
+    else
+    {
+        RemoveFromIndex(m_unconnected, port, endPoint->m_peerPosition);
+    }
+}
+
+bool
+Ipv6EndPointDemux::IsConnected(const Ipv6EndPoint* endPoint)
+{
+    return endPoint->GetPeerAddress() != Ipv6Address::GetAny() && endPoint->GetPeerPort() != 0;
+}
+
+bool
+Ipv6EndPointDemux::Key::operator==(const Key& other) const
+{
+    return localPort == other.localPort && peerPort == other.peerPort && address == other.address;
+}
+
+std::size_t
+Ipv6EndPointDemux::KeyHash::operator()(const Key& key) const
+{
+    return Ipv6AddressHash()(key.address) ^ ((uint32_t(key.localPort) << 16) | key.peerPort);
 }
 
 Ipv6EndPointDemux::EndPoints
@@ -26,6 +26,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -36,6 +38,11 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points are indexed by local address and port, and, when
+ * connected to a peer, by local port and peer address and port, so that
+ * a lookup only looks at the end points which may match, whatever the
+ * number of connections.  The ephemeral ports in use are kept in a bitmap.
  */
 class Ipv6EndPointDemux
 {
@@ -161,12 +168,80 @@ class Ipv6EndPointDemux
     EndPoints GetEndPoints() const;
 
   private:
+    friend class Ipv6EndPoint;
+
+    /**
+     * \brief The key of the end points bound to a local address and port, or
+     * connected to a peer address and port from a local port.
+     */
+    struct Key
+    {
+        Ipv6Address address; //!< The local address, or the peer address.
+        uint16_t localPort;  //!< The local port.
+        uint16_t peerPort;   //!< The peer port, or 0 for a local address.
+
+        /**
+         * \param other another key
+         * \return true if the keys are equal
+         */
+        bool operator==(const Key& other) const;
+    };
+
+    /**
+     * \brief Hash function class for the keys of the end points.
+     */
+    struct KeyHash
+    {
+        /**
+         * \param key the key
+         * \return the hash of the key
+         */
+        std::size_t operator()(const Key& key) const;
+    };
+
     /**
      * \brief Allocate a ephemeral port.
      * \return a port
      */
     uint16_t AllocateEphemeralPort();
 
+    /**
+     * \brief Add an end point to the list and the indexes.
+     * \param endPoint the end point
+     */
+    void Insert(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Add an end point to the indexes on its addresses.
+     *
+     * Called by the end point after its addresses changed.
+     *
+     * \param endPoint the end point
+     */
+    void Index(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the indexes on its addresses.
+     *
+     * Called by the end point before its addresses change.
+     *
+     * \param endPoint the end point
+     */
+    void Unindex(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Mark a port in use or free in the bitmap of the ephemeral ports.
+     * \param port the port
+     * \param inUse whether the port is in use
+     */
+    void MarkEphemeralPort(uint16_t port, bool inUse);
+
+    /**
+     * \param endPoint an end point
+     * \return true if the end point is connected to a peer address and port
+     */
+    static bool IsConnected(const Ipv6EndPoint* endPoint);
+
     /**
      * \brief The ephemeral port.
      */
@@ -186,6 +261,33 @@ class Ipv6EndPointDemux
      * \brief A list of IPv6 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The end points by local address and port.
+     */
+    std::unordered_map<Key, EndPoints, KeyHash> m_local;
+
+    /**
+     * \brief The end points connected to a peer, by local port and peer
+     * address and port.
+     */
+    std::unordered_map<Key, EndPoints, KeyHash> m_connected;
+
+    /**
+     * \brief The end points not connected to a peer, by local port.
+     */
+    std::unordered_map<uint16_t, EndPoints> m_unconnected;
+
+    /**
+     * \brief The number of end points by local port.
+     */
+    std::unordered_map<uint16_t, uint32_t> m_ports;
+
+    /**
+     * \brief The bitmap of the ephemeral ports in use, allocated on the
+     * first allocation of an ephemeral port.
+     */
+    std::vector<uint64_t> m_ephemeralPorts;
 };
 
 } /* namespace ns3 */
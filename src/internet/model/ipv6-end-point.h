@@ -27,12 +27,14 @@
 #include "ns3/ipv6-address.h"
 #include "ns3/net-device.h"
 
+#include <list>
 #include <stdint.h>
 
 namespace ns3
 {
 
 class Header;
+class Ipv6EndPointDemux;
 class Packet;
 
 /**
@@ -239,6 +241,30 @@ class Ipv6EndPoint
      * \brief true if the endpoint can receive packets.
      */
     bool m_rxEnabled;
+
+    friend class Ipv6EndPointDemux;
+
+    /**
+     * \brief The demux indexing the endpoint on its addresses (if any).
+     */
+    Ipv6EndPointDemux* m_demux;
+
+    /**
+     * \brief The position of the endpoint in the list of the demux.
+     */
+    std::list<Ipv6EndPoint*>::iterator m_demuxPosition;
+
+    /**
+     * \brief The position of the endpoint in the demux index on its local
+     * address and port.
+     */
+    std::list<Ipv6EndPoint*>::iterator m_localPosition;
+
+    /**
+     * \brief The position of the endpoint in the demux index on its peer,
+     * or on its local port when not connected.
+     */
+    std::list<Ipv6EndPoint*>::iterator m_peerPosition;
 };
 
 } /* namespace ns3 */
@@ -162,7 +162,7 @@ Ipv6QueueDiscItem::Hash(uint32_t perturbation) const
 
     // Linux calculates jhash2 (jenkins hash), we calculate murmur3 because it is
     // already available in ns-3
-    uint32_t hash = Hash32((char*)buf, 41);
+    uint32_t hash = Hash32(buf);
 
     NS_LOG_DEBUG("Found Ipv6 packet; hash of the five tuple " << hash);
 
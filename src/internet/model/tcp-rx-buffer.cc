@@ -121,6 +121,10 @@ TcpRxBuffer::MaxRxSequence() const
     { // No data allowed beyond Rx window allowed
         return m_data.begin()->first + SequenceNumber32(m_maxBuffer);
     }
+    else if (!m_intervals.empty() && m_nextRxSeq > m_intervals.begin()->first)
+    {
+        return m_intervals.begin()->first + SequenceNumber32(m_maxBuffer);
+    }
     return m_nextRxSeq + SequenceNumber32(m_maxBuffer);
 }
 
@@ -143,6 +147,20 @@ TcpRxBuffer::Finished()
     return (m_gotFin && m_finSeq < m_nextRxSeq);
 }
 
+bool
+TcpRxBuffer::IsVirtualPayload() const
+{
+    return m_virtualPayload;
+}
+
+void
+TcpRxBuffer::SetVirtualPayload(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
+    NS_ASSERT_MSG(m_size == 0, "Cannot change the payload of a buffer holding data");
+    m_virtualPayload = enabled;
+}
+
 bool
 TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
 {
@@ -154,6 +172,11 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     NS_LOG_LOGIC("Add pkt " << p << " len=" << pktSize << " seq=" << headSeq
                             << ", when NextRxSeq=" << m_nextRxSeq << ", buffsize=" << m_size);
 
+    if (m_virtualPayload)
+    {
+        return AddVirtual(headSeq, tailSeq);
+    }
+
     // Trim packet to fit Rx window specification
     if (headSeq < m_nextRxSeq)
     {
@@ -243,6 +266,89 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     return true;
 }
 
+bool
+TcpRxBuffer::AddVirtual(SequenceNumber32 headSeq, SequenceNumber32 tailSeq)
+{
+    NS_LOG_FUNCTION(this << headSeq << tailSeq);
+
+    // Trim the block to fit Rx window specification
+    if (headSeq < m_nextRxSeq)
+    {
+        headSeq = m_nextRxSeq;
+    }
+    if (!m_intervals.empty())
+    {
+        SequenceNumber32 maxSeq = m_intervals.begin()->first + SequenceNumber32(m_maxBuffer);
+        if (maxSeq < tailSeq)
+        {
+            tailSeq = maxSeq;
+        }
+        if (tailSeq < headSeq)
+        {
+            headSeq = tailSeq;
+        }
+    }
+    if (headSeq >= tailSeq)
+    {
+        NS_LOG_LOGIC("Nothing to buffer");
+        return false;
+    }
+
+    // Merge the block with the intervals it overlaps or touches. As for
+    // packets, the block reported is trimmed by the intervals overlapping its
+    // ends, while the ones embedded in it are replaced.
+    SequenceNumber32 start = headSeq;
+    SequenceNumber32 end = tailSeq;
+    uint32_t buffered = 0; // bytes of the merged intervals
+    auto i = m_intervals.upper_bound(headSeq);
+    if (i != m_intervals.begin() && std::prev(i)->second >= headSeq)
+    {
+        --i;
+    }
+    while (i != m_intervals.end() && i->first <= tailSeq)
+    {
+        if (i->first <= headSeq)
+        { // Incoming head is overlapped
+            start = i->first;
+            headSeq = std::max(headSeq, i->second);
+        }
+        if (i->second >= tailSeq)
+        { // Incoming tail is overlapped
+            end = i->second;
+            tailSeq = std::min(tailSeq, i->first);
+        }
+        buffered += static_cast<uint32_t>(i->second - i->first);
+        i = m_intervals.erase(i);
+    }
+    m_intervals[start] = end;
+    if (headSeq >= tailSeq)
+    {
+        NS_LOG_LOGIC("Nothing to buffer");
+        return false; // Nothing new: the intervals merged are unchanged
+    }
+
+    if (headSeq > m_nextRxSeq)
+    {
+        // Generate a new SACK block
+        UpdateSackList(headSeq, tailSeq);
+    }
+
+    // Update variables
+    m_size += static_cast<uint32_t>(end - start) - buffered; // Occupancy
+    if (start <= m_nextRxSeq && m_nextRxSeq < end)
+    {
+        m_availBytes += static_cast<uint32_t>(end - m_nextRxSeq);
+        m_nextRxSeq = end;
+        ClearSackList(m_nextRxSeq);
+    }
+    NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
+    if (m_gotFin && m_nextRxSeq == m_finSeq)
+    { // Account for the FIN packet
+        ++m_nextRxSeq;
+    }
+    return true;
+}
+
 uint32_t
 TcpRxBuffer::GetSackListSize() const
 {
@@ -387,6 +493,22 @@ TcpRxBuffer::Extract(uint32_t maxSize)
     {
         return nullptr; // No contiguous block to return
     }
+    if (m_virtualPayload)
+    {
+        auto i = m_intervals.begin();
+        NS_ASSERT(i != m_intervals.end() && i->first + extractSize <= m_nextRxSeq);
+        SequenceNumber32 end = i->second;
+        SequenceNumber32 start = i->first + SequenceNumber32(extractSize);
+        m_intervals.erase(i);
+        if (start < end)
+        {
+            m_intervals.emplace(start, end);
+        }
+        m_size -= extractSize;
+        m_availBytes -= extractSize;
+        NS_LOG_LOGIC("Extracted " << extractSize << " bytes, bufsize=" << m_size);
+        return Create<Packet>(extractSize);
+    }
     NS_ASSERT(!m_data.empty());            // At least we have something to extract
     Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
     BufIterator i;
@@ -71,6 +71,14 @@ class Packet;
  *
  * \see GetSackList
  * \see UpdateSackList
+ *
+ * Virtual payload
+ * ---------------
+ *
+ * When the bytes received are never read, e.g., by a sink counting them, the
+ * buffer can represent them by their sequence numbers only (see
+ * SetVirtualPayload). It then stores the intervals of sequence numbers
+ * received instead of the packets, and Extract returns zero-filled packets.
  */
 class TcpRxBuffer : public Object
 {
@@ -186,6 +194,22 @@ class TcpRxBuffer : public Object
         return m_gotFin;
     }
 
+    /**
+     * \brief check whether the data is represented by its sequence numbers only
+     * \return true if the payload is virtual
+     */
+    bool IsVirtualPayload() const;
+
+    /**
+     * \brief tell rx-buffer whether the data is represented by its sequence
+     * numbers only
+     *
+     * It can be changed only while the buffer is empty.
+     *
+     * \param enabled whether the payload is virtual
+     */
+    void SetVirtualPayload(bool enabled);
+
   private:
     /**
      * \brief Update the sack list, with the block seq starting at the beginning
@@ -220,6 +244,17 @@ class TcpRxBuffer : public Object
      */
     void ClearSackList(const SequenceNumber32& seq);
 
+    /**
+     * \brief Insert a block of virtual data into the buffer
+     *
+     * Same as Add, for the virtual payload.
+     *
+     * \param headSeq sequence number of the first byte
+     * \param tailSeq sequence number after the last byte
+     * \return True when success, false otherwise.
+     */
+    bool AddVirtual(SequenceNumber32 headSeq, SequenceNumber32 tailSeq);
+
     TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
     /// container for data stored in the buffer
@@ -232,6 +267,10 @@ class TcpRxBuffer : public Object
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
     std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+
+    bool m_virtualPayload{false}; //!< Indicates if the data is represented by its sequence only
+    /// Disjoint intervals of data buffered, from first to last sequence, with a virtual payload
+    std::map<SequenceNumber32, SequenceNumber32> m_intervals;
 };
 
 } // namespace ns3
@@ -116,6 +116,13 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_sackEnabled),
                           MakeBooleanChecker())
+            .AddAttribute("VirtualPayload",
+                          "Represent the application data by its size only: the bytes "
+                          "sent are zero-filled, and the bytes received are not stored",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketBase::SetVirtualPayload,
+                                              &TcpSocketBase::IsVirtualPayload),
+                          MakeBooleanChecker())
             .AddAttribute("Timestamp",
                           "Enable or disable Timestamp option",
                           BooleanValue(true),
@@ -277,6 +284,8 @@ TcpSocketBase::TcpSocketBase()
 
     m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
     m_pacingTimer.SetFunction(&TcpSocketBase::NotifyPacingPerformed, this);
+    m_retxEvent.SetFunction(MakeCallback(&TcpSocketBase::RetxTimerExpired, this));
+    m_delAckEvent.SetFunction(MakeCallback(&TcpSocketBase::DelAckTimeout, this));
 
     m_tcb->m_sendEmptyPacketCallback = MakeCallback(&TcpSocketBase::SendEmptyPacket, this);
 
@@ -399,6 +408,8 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
 
     m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
     m_pacingTimer.SetFunction(&TcpSocketBase::NotifyPacingPerformed, this);
+    m_retxEvent.SetFunction(MakeCallback(&TcpSocketBase::RetxTimerExpired, this));
+    m_delAckEvent.SetFunction(MakeCallback(&TcpSocketBase::DelAckTimeout, this));
 
     if (sock.m_congestionControl)
     {
@@ -1414,7 +1425,7 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
         NS_LOG_LOGIC(this << " Enter zerowindow persist state");
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         NS_LOG_LOGIC("Schedule persist timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
@@ -2708,7 +2719,7 @@ TcpSocketBase::Destroy()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2724,7 +2735,7 @@ TcpSocketBase::Destroy6()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2858,7 +2869,8 @@ TcpSocketBase::SendEmptyPacket(uint8_t flags)
         NS_LOG_LOGIC("Schedule retransmission timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
                      << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+        m_retxFlags = flags;
+        m_retxEvent.Schedule(m_rto);
     }
 }
 
@@ -3212,7 +3224,8 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
         NS_LOG_LOGIC(this << " SendDataPacket Schedule ReTxTimeout at time "
                           << Simulator::Now().GetSeconds() << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxFlags = 0;
+        m_retxEvent.Schedule(m_rto);
     }
 
     m_txTrace(p, header, this);
@@ -3609,11 +3622,10 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
         else if (m_delAckEvent.IsExpired())
         {
             m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
-            m_delAckEvent =
-                Simulator::Schedule(m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
+            m_delAckEvent.Schedule(m_delAckTimeout);
             NS_LOG_LOGIC(
                 this << " scheduled delayed ACK at "
-                     << (Simulator::Now() + Simulator::GetDelayLeft(m_delAckEvent)).GetSeconds());
+                     << (Simulator::Now() + m_delAckEvent.GetDelayLeft()).GetSeconds());
         }
     }
 }
@@ -3689,7 +3701,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         // On receiving a "New" ack we restart retransmission timer .. RFC 6298
         // RFC 6298, clause 2.4
@@ -3699,7 +3711,8 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
         NS_LOG_LOGIC(this << " Schedule ReTxTimeout at time " << Simulator::Now().GetSeconds()
                           << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxFlags = 0;
+        m_retxEvent.Schedule(m_rto);
     }
 
     // Note the highest ACK and tell app to send more
@@ -3718,12 +3731,24 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // No retransmit timer if no data to retransmit
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
     }
 }
 
 // Retransmit timeout
+void
+TcpSocketBase::RetxTimerExpired()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_retxFlags)
+    {
+        SendEmptyPacket(m_retxFlags);
+        return;
+    }
+    ReTxTimeout();
+}
+
 void
 TcpSocketBase::ReTxTimeout()
 {
@@ -4443,6 +4468,20 @@ TcpSocketBase::GetClockGranularity() const
     return m_clockGranularity;
 }
 
+void
+TcpSocketBase::SetVirtualPayload(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
+    m_txBuffer->SetVirtualPayload(enabled);
+    m_tcb->m_rxBuffer->SetVirtualPayload(enabled);
+}
+
+bool
+TcpSocketBase::IsVirtualPayload() const
+{
+    return m_txBuffer->IsVirtualPayload();
+}
+
 Ptr<TcpTxBuffer>
 TcpSocketBase::GetTxBuffer() const
 {
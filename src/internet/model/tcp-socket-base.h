@@ -26,6 +26,7 @@
 #include "tcp-socket.h"
 
 #include "ns3/data-rate.h"
+#include "ns3/deadline-timer.h"
 #include "ns3/node.h"
 #include "ns3/sequence-number.h"
 #include "ns3/timer.h"
@@ -295,6 +296,25 @@ class TcpSocketBase : public TcpSocket
      */
     Time GetClockGranularity() const;
 
+    /**
+     * \brief Set whether the application data is represented by its size only
+     *
+     * With a virtual payload, the Tx buffer does not copy the packets sent by
+     * the application, and the Rx buffer keeps the sequence numbers received
+     * instead of the packets: segments and packets received carry zero-filled
+     * payloads. It suits applications which never read the bytes, such as
+     * bulk transfers towards a PacketSink.
+     *
+     * \param enabled Whether the payload is virtual
+     */
+    void SetVirtualPayload(bool enabled);
+
+    /**
+     * \brief Get whether the application data is represented by its size only
+     * \return true if the payload is virtual
+     */
+    bool IsVirtualPayload() const;
+
     /**
      * \brief Get a pointer to the Tx buffer
      * \return a pointer to the tx buffer
@@ -1098,6 +1118,12 @@ class TcpSocketBase : public TcpSocket
      */
     virtual void ReTxTimeout();
 
+    /**
+     * \brief The retransmission timer expired: resend the SYN/FIN segment
+     * guarded by the timer, if any, or else handle the RTO
+     */
+    void RetxTimerExpired();
+
     /**
      * \brief Action upon delay ACK timeout, i.e. send an ACK
      */
@@ -1276,11 +1302,12 @@ class TcpSocketBase : public TcpSocket
 
   protected:
     // Counters and events
-    EventId m_retxEvent{};     //!< Retransmission event
-    EventId m_lastAckEvent{};  //!< Last ACK timeout event
-    EventId m_delAckEvent{};   //!< Delayed ACK timeout event
-    EventId m_persistEvent{};  //!< Persist event: Send 1 byte to probe for a non-zero Rx window
-    EventId m_timewaitEvent{}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
+    DeadlineTimer m_retxEvent{};   //!< Retransmission timer
+    uint8_t m_retxFlags{0};        //!< Flags of the SYN/FIN resent on retransmission timeout, or 0
+    EventId m_lastAckEvent{};      //!< Last ACK timeout event
+    DeadlineTimer m_delAckEvent{}; //!< Delayed ACK timer
+    EventId m_persistEvent{};      //!< Persist event: Send 1 byte to probe for a non-zero Rx window
+    EventId m_timewaitEvent{};     //!< TIME_WAIT expiration event: Move this socket to CLOSED state
 
     // ACK management
     uint32_t m_dupAckCount{0};    //!< Dupack counter
@@ -61,7 +61,10 @@ TcpTxBuffer::TcpTxBuffer(uint32_t n)
     : m_maxBuffer(32768),
       m_size(0),
       m_sentSize(0),
-      m_firstByteSeq(n)
+      m_firstByteSeq(n),
+      m_lostCursor(n),
+      m_lostEnd(n),
+      m_nextSegCursor(n)
 {
     m_rWndCallback = MakeNullCallback<uint32_t>();
 }
@@ -125,6 +128,18 @@ TcpTxBuffer::SetSackEnabled(bool enabled)
     m_sackEnabled = enabled;
 }
 
+bool
+TcpTxBuffer::IsVirtualPayload() const
+{
+    return m_virtualPayload;
+}
+
+void
+TcpTxBuffer::SetVirtualPayload(bool enabled)
+{
+    m_virtualPayload = enabled;
+}
+
 uint32_t
 TcpTxBuffer::Available() const
 {
@@ -174,7 +189,10 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
 
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.empty());
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
+    m_hasHighestSack = false;
+    m_lostEnd = seq;
+    ResetCursors();
 }
 
 bool
@@ -185,10 +203,20 @@ TcpTxBuffer::Add(Ptr<Packet> p)
                                   << m_firstByteSeq << ", availSize=" << Available());
     if (p->GetSize() <= Available())
     {
-        if (p->GetSize() > 0)
+        if (p->GetSize() > 0 && m_virtualPayload && !m_appList.empty())
+        {
+            // Nothing to copy: just enlarge the data not transmitted yet
+            TcpTxItem* item = m_appList.back();
+            item->m_packet = Create<Packet>(item->m_packet->GetSize() + p->GetSize());
+            m_size += p->GetSize();
+
+            NS_LOG_LOGIC("Updated size=" << m_size << ", lastSeq="
+                                         << m_firstByteSeq + SequenceNumber32(m_size));
+        }
+        else if (p->GetSize() > 0)
         {
             auto item = new TcpTxItem();
-            item->m_packet = p->Copy();
+            item->m_packet = m_virtualPayload ? Create<Packet>(p->GetSize()) : p->Copy();
             m_appList.insert(m_appList.end(), item);
             m_size += p->GetSize();
 
@@ -309,37 +337,33 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
+    auto it = FindSentItem(seq);
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    if (it != m_sentList.end() && (*it)->m_startSeq == seq)
     {
-        if ((*it)->m_startSeq == seq)
+        auto next = it;
+        next++;
+        if (next != m_sentList.end())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
             }
             else
             {
+                // Next is sacked... better to retransmit only the first segment
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, (*it)->m_packet->GetSize());
         }
     }
 
@@ -376,14 +400,73 @@ TcpTxBuffer::FindHighestSacked() const
     return ret;
 }
 
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    auto it = std::upper_bound(m_sentList.begin(),
+                               m_sentList.end(),
+                               seq,
+                               [](const SequenceNumber32& s, const TcpTxItem* item) {
+                                   return s < item->m_startSeq;
+                               });
+    if (it == m_sentList.begin())
+    {
+        return m_sentList.end();
+    }
+    --it;
+    if (seq < (*it)->m_startSeq + (*it)->m_packet->GetSize())
+    {
+        return it;
+    }
+    return m_sentList.end();
+}
+
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindSentItemFrom(const SequenceNumber32& seq) const
+{
+    return std::lower_bound(m_sentList.begin(),
+                            m_sentList.end(),
+                            seq,
+                            [](const TcpTxItem* item, const SequenceNumber32& s) {
+                                return item->m_startSeq < s;
+                            });
+}
+
+void
+TcpTxBuffer::MarkLost(TcpTxItem* item)
+{
+    NS_ASSERT(!item->m_lost);
+    item->m_lost = true;
+    m_lostOut += item->m_packet->GetSize();
+    if (m_lostEnd < item->m_startSeq + item->m_packet->GetSize())
+    {
+        m_lostEnd = item->m_startSeq + item->m_packet->GetSize();
+    }
+}
+
+void
+TcpTxBuffer::ResetCursors()
+{
+    m_lostCursor = m_firstByteSeq;
+    m_nextSegCursor = m_firstByteSeq;
+}
+
 void
 TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
 {
     NS_ASSERT(t1 != nullptr && t2 != nullptr);
     NS_LOG_FUNCTION(this << *t2 << size);
 
-    t1->m_packet = t2->m_packet->CreateFragment(0, size);
-    t2->m_packet->RemoveAtStart(size);
+    if (m_virtualPayload)
+    {
+        t1->m_packet = Create<Packet>(size);
+        t2->m_packet = Create<Packet>(t2->m_packet->GetSize() - size);
+    }
+    else
+    {
+        t1->m_packet = t2->m_packet->CreateFragment(0, size);
+        t2->m_packet->RemoveAtStart(size);
+    }
 
     t1->m_startSeq = t2->m_startSeq;
     t1->m_sacked = t2->m_sacked;
@@ -438,11 +521,22 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     auto it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+    if (&list == &m_sentList)
+    {
+        // The sent items know their start: skip the ones before seq
+        auto found = FindSentItem(seq);
+        if (found != m_sentList.end())
+        {
+            it += found - m_sentList.begin();
+            beginOfCurrentPacket = (*it)->m_startSeq;
+        }
+    }
+
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(&list != &m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -599,6 +693,7 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
     // be updated in MarkTransmittedSegment.
     if (t1->m_retrans != t2->m_retrans)
     {
+        m_nextSegCursor = m_firstByteSeq;
         if (t1->m_retrans)
         {
             auto self = const_cast<TcpTxBuffer*>(this);
@@ -619,7 +714,14 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
         t1->m_lastSent = t2->m_lastSent;
     }
 
-    t1->m_packet->AddAtEnd(t2->m_packet);
+    if (m_virtualPayload)
+    {
+        t1->m_packet = Create<Packet>(t1->m_packet->GetSize() + t2->m_packet->GetSize());
+    }
+    else
+    {
+        t1->m_packet->AddAtEnd(t2->m_packet);
+    }
 
     NS_LOG_INFO("Situation after the merge: " << *t1);
 }
@@ -650,16 +752,14 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    auto it = FindSentItem(ack - 1);
+    if (it == m_sentList.end())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    TcpTxItem* item = *it;
+    Ptr<Packet> p = item->m_packet;
+    return item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans;
 }
 
 void
@@ -724,7 +824,9 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             pktSize -= offset;
             NS_LOG_INFO(*item);
             // PacketTags are preserved when fragmenting
-            item->m_packet = item->m_packet->CreateFragment(offset, pktSize);
+            item->m_packet = m_virtualPayload
+                                 ? Create<Packet>(pktSize)
+                                 : item->m_packet->CreateFragment(offset, pktSize);
             item->m_startSeq += offset;
             m_size -= offset;
             m_sentSize -= offset;
@@ -765,11 +867,17 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
                                               << " this is the result: " << *this);
     }
 
-    if (m_highestSack.second <= m_firstByteSeq)
+    if (m_highestSack <= m_firstByteSeq)
     {
-        m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_highestSack = SequenceNumber32(0);
+        m_hasHighestSack = false;
     }
 
+    // Keep the cursors inside the window, where their comparison is valid
+    m_lostCursor = std::max(m_lostCursor, m_firstByteSeq.Get());
+    m_lostEnd = std::max(m_lostEnd, m_firstByteSeq.Get());
+    m_nextSegCursor = std::max(m_nextSegCursor, m_firstByteSeq.Get());
+
     NS_LOG_DEBUG("Discarded up to " << seq << " lost: " << m_lostOut << " retrans: " << m_retrans
                                     << " sacked: " << m_sackedOut);
     NS_LOG_LOGIC("Buffer status after discarding data " << *this);
@@ -788,17 +896,18 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
+        // Items starting before the block cannot be mapped over it
+        auto item_it = FindSentItemFrom((*option_it).first);
+
         while (item_it != m_sentList.end())
         {
+            SequenceNumber32 beginOfCurrentPacket = (*item_it)->m_startSeq;
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
 
             // Check the boundary of this packet ... only mark as sacked if
@@ -828,16 +937,16 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                     m_sackedOut += (*item_it)->m_packet->GetSize();
                     bytesSacked += (*item_it)->m_packet->GetSize();
 
-                    if (m_highestSack.first == m_sentList.end() ||
-                        m_highestSack.second <= beginOfCurrentPacket + pktSize)
+                    if (!m_hasHighestSack || m_highestSack <= beginOfCurrentPacket + pktSize)
                     {
-                        m_highestSack = std::make_pair(item_it, beginOfCurrentPacket);
+                        m_highestSack = beginOfCurrentPacket;
+                        m_hasHighestSack = true;
                     }
 
                     NS_LOG_INFO("Received block "
                                 << *option_it << ", checking sentList for block " << *(*item_it)
                                 << ", found in the sackboard, sacking, current highSack: "
-                                << m_highestSack.second);
+                                << m_highestSack);
 
                     if (!sackedCb.IsNull())
                     {
@@ -853,14 +962,13 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                 break;
             }
 
-            beginOfCurrentPacket += pktSize;
             ++item_it;
         }
     }
 
     if (bytesSacked > 0)
     {
-        NS_ASSERT_MSG(m_highestSack.first != m_sentList.end(), "Buffer status: " << *this);
+        NS_ASSERT_MSG(m_hasHighestSack, "Buffer status: " << *this);
         UpdateLostCount();
     }
 
@@ -877,19 +985,16 @@ TcpTxBuffer::UpdateLostCount()
 {
     NS_LOG_FUNCTION(this);
     uint32_t sacked = 0;
-    SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
-    if (m_highestSack.first == m_sentList.end())
-    {
-        NS_LOG_INFO("Status before the update: " << *this
-                                                 << ", will start from the latest sent item");
-    }
-    else
-    {
-        NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
-                                                 << *(*m_highestSack.first));
-    }
+    auto highestSack = FindSentItem(m_highestSack);
+    NS_ASSERT(highestSack != m_sentList.end());
+    NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
+                                             << *(*highestSack));
+
+    // Start of the item from which the threshold is reached: all the items
+    // before it are sacked or lost at the end of the walk
+    SequenceNumber32 lostCursor = m_lostCursor;
 
-    for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+    for (auto it = highestSack; it != m_sentList.begin(); --it)
     {
         TcpTxItem* item = *it;
         if (item->m_sacked)
@@ -899,13 +1004,20 @@ TcpTxBuffer::UpdateLostCount()
 
         if (sacked >= m_dupAckThresh)
         {
+            if (item->m_startSeq < m_lostCursor)
+            {
+                // Marked by a previous walk, as are the items before
+                break;
+            }
+            if (item->m_sacked && lostCursor < item->m_startSeq)
+            {
+                lostCursor = item->m_startSeq;
+            }
             if (!item->m_sacked && !item->m_lost)
             {
-                item->m_lost = true;
-                m_lostOut += item->m_packet->GetSize();
+                MarkLost(item);
             }
         }
-        beginOfCurrentPacket -= item->m_packet->GetSize();
     }
 
     if (sacked >= m_dupAckThresh)
@@ -913,9 +1025,9 @@ TcpTxBuffer::UpdateLostCount()
         TcpTxItem* item = *m_sentList.begin();
         if (!item->m_lost)
         {
-            item->m_lost = true;
-            m_lostOut += item->m_packet->GetSize();
+            MarkLost(item);
         }
+        m_lostCursor = lostCursor;
     }
     NS_LOG_INFO("Status after the update: " << *this);
     ConsistencyCheck();
@@ -926,29 +1038,24 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
     NS_LOG_FUNCTION(this << seq);
 
-    if (seq >= m_highestSack.second)
+    if (seq >= m_highestSack)
     {
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    auto it = FindSentItem(seq);
+    if (it != m_sentList.end())
     {
-        // Search for the right iterator before calling IsLost()
-        if ((*it)->m_startSeq <= seq && seq < (*it)->m_startSeq + (*it)->m_packet->GetSize())
+        if ((*it)->m_lost)
         {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
+            NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+            return true;
+        }
 
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
+        if ((*it)->m_sacked)
+        {
+            NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
+            return false;
         }
     }
 
@@ -976,15 +1083,26 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
     TcpTxItem* item;
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+    bool isCandidateFound = false;
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // The items before m_nextSegCursor are retransmitted or sacked, and the
+    // items after m_lostEnd are not lost: only the ones in between are walked,
+    // unless rule 3 requires to go further
+    for (auto it = FindSentItemFrom(m_nextSegCursor); it != m_sentList.end(); ++it)
     {
         item = *it;
+        SequenceNumber32 beginOfCurrentPkt = item->m_startSeq;
+        SequenceNumber32 endOfCurrentPkt = beginOfCurrentPkt + item->m_packet->GetSize();
 
         // Condition 1.a , 1.b , and 1.c
         if (!item->m_retrans && !item->m_sacked)
         {
+            if (!isCandidateFound)
+            {
+                isCandidateFound = true;
+                m_nextSegCursor = beginOfCurrentPkt;
+            }
+
             if (item->m_lost)
             {
                 NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
@@ -992,16 +1110,22 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
                 *seqHigh = *seq + m_segmentSize;
                 return true;
             }
-            else if (seqPerRule3.GetValue() == 0 && isRecovery)
+            else if (!isSeqPerRule3Valid && isRecovery)
             {
                 NS_LOG_INFO("Saving for rule 3 the seq " << beginOfCurrentPkt);
                 isSeqPerRule3Valid = true;
                 seqPerRule3 = beginOfCurrentPkt;
             }
         }
+        else if (!isCandidateFound)
+        {
+            m_nextSegCursor = endOfCurrentPkt;
+        }
 
-        // Nothing found, iterate
-        beginOfCurrentPkt += item->m_packet->GetSize();
+        if (endOfCurrentPkt >= m_lostEnd && (isSeqPerRule3Valid || !isRecovery))
+        {
+            break;
+        }
     }
 
     /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1184,7 +1308,7 @@ TcpTxBuffer::IsLostRFC(const SequenceNumber32& seq, const PacketList::const_iter
             }
         }
 
-        if (beginOfCurrentPacket >= m_highestSack.second)
+        if (beginOfCurrentPacket >= m_highestSack)
         {
             if (item->m_lost && !item->m_retrans)
             {
@@ -1197,11 +1321,8 @@ TcpTxBuffer::IsLostRFC(const SequenceNumber32& seq, const PacketList::const_iter
 
         beginOfCurrentPacket += current->GetSize();
     }
-    if (it == m_highestSack.first)
-    {
-        NS_LOG_INFO("seq=" << seq << " is not lost because there are no sacked segment ahead "
-                           << m_highestSack.second);
-    }
+    NS_LOG_INFO("seq=" << seq << " is not lost because there are no sacked segment ahead "
+                       << m_highestSack);
     return false;
 }
 
@@ -1216,7 +1337,9 @@ TcpTxBuffer::ResetRenoSack()
         (*it)->m_sacked = false;
     }
 
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
+    m_hasHighestSack = false;
+    ResetCursors();
 }
 
 void
@@ -1245,7 +1368,9 @@ TcpTxBuffer::ResetSentList()
     m_lostOut = 0;
     m_retrans = 0;
     m_sackedOut = 0;
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
+    m_hasHighestSack = false;
+    ResetCursors();
 }
 
 void
@@ -1263,6 +1388,7 @@ TcpTxBuffer::ResetLastSegmentSent()
             m_retrans -= item->m_packet->GetSize();
         }
         m_appList.insert(m_appList.begin(), item);
+        m_nextSegCursor = std::min(m_nextSegCursor, item->m_startSeq);
     }
     ConsistencyCheck();
 }
@@ -1277,7 +1403,8 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
     {
         m_sackedOut = 0;
         m_lostOut = m_sentSize;
-        m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_highestSack = SequenceNumber32(0);
+        m_hasHighestSack = false;
     }
     else
     {
@@ -1309,6 +1436,9 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         (*it)->m_retrans = false;
     }
 
+    m_lostEnd = m_firstByteSeq + m_sentSize;
+    ResetCursors();
+
     NS_LOG_INFO("Set sent list lost, status: " << *this);
     NS_ASSERT_MSG(m_sentSize >= m_sackedOut + m_lostOut, *this);
     ConsistencyCheck();
@@ -1341,6 +1471,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
     {
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        m_nextSegCursor = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1367,9 +1498,9 @@ TcpTxBuffer::MarkHeadAsLost()
 
         if (!m_sentList.front()->m_lost)
         {
-            m_sentList.front()->m_lost = true;
-            m_lostOut += m_sentList.front()->m_packet->GetSize();
+            MarkLost(m_sentList.front());
         }
+        m_nextSegCursor = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1404,7 +1535,8 @@ TcpTxBuffer::AddRenoSack()
     {
         (*it)->m_sacked = true;
         m_sackedOut += (*it)->m_packet->GetSize();
-        m_highestSack = std::make_pair(it, (*it)->m_startSeq);
+        m_highestSack = (*it)->m_startSeq;
+        m_hasHighestSack = true;
         NS_LOG_INFO("Added a Reno SACK, status: " << *this);
     }
     else
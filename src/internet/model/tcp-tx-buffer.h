@@ -25,6 +25,7 @@
 #include "tcp-tx-item.h"
 
 #include "ns3/object.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/sequence-number.h"
 #include "ns3/traced-value.h"
 
@@ -180,6 +181,24 @@ class TcpTxBuffer : public Object
      */
     void SetSackEnabled(bool enabled);
 
+    /**
+     * \brief check whether the data is represented by its size only
+     * \return true if the payload is virtual
+     */
+    bool IsVirtualPayload() const;
+
+    /**
+     * \brief tell tx-buffer whether the data is represented by its size only
+     *
+     * With a virtual payload, the packets added are not copied: the buffer
+     * holds zero-filled packets of the same size, which are resized instead
+     * of being fragmented or concatenated. The tags of the packets added are
+     * therefore not sent.
+     *
+     * \param enabled whether the payload is virtual
+     */
+    void SetVirtualPayload(bool enabled);
+
     /**
      * \brief Returns the available capacity of this buffer
      * \returns available capacity in this Tx window
@@ -411,7 +430,7 @@ class TcpTxBuffer : public Object
   private:
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
 
-    typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+    typedef RingBuffer<TcpTxItem*> PacketList; //!< container for data stored in the buffer
 
     /**
      * \brief Update the lost count
@@ -428,8 +447,9 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
+     * and updates the lost count. The walk starts from the highest sacked item
+     * and stops, once the threshold is reached, at m_lostCursor, below which
+     * a previous walk already marked all the items.
      *
      */
     void UpdateLostCount();
@@ -596,6 +616,35 @@ class TcpTxBuffer : public Object
      */
     void ConsistencyCheck() const;
 
+    /**
+     * \brief Find the sent item containing a sequence
+     *
+     * The items of the sent list are contiguous and sorted by starting
+     * sequence, so that the item is found by a binary search.
+     *
+     * \param seq Sequence
+     * \return an iterator to the item containing seq, or the end of m_sentList
+     */
+    PacketList::const_iterator FindSentItem(const SequenceNumber32& seq) const;
+
+    /**
+     * \brief Find the first sent item starting at or after a sequence
+     * \param seq Sequence
+     * \return an iterator to the item, or the end of m_sentList
+     */
+    PacketList::const_iterator FindSentItemFrom(const SequenceNumber32& seq) const;
+
+    /**
+     * \brief Mark a sent item as lost, updating the lost count
+     * \param item Item not marked as lost
+     */
+    void MarkLost(TcpTxItem* item);
+
+    /**
+     * \brief Forget the cursors, after flags have been removed from sent items
+     */
+    void ResetCursors();
+
     /**
      * \brief Find the highest SACK byte
      * \return a pair with the highest byte and an iterator inside m_sentList
@@ -611,16 +660,24 @@ class TcpTxBuffer : public Object
 
     TracedValue<SequenceNumber32>
         m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
-    std::pair<PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
+    SequenceNumber32 m_highestSack{0}; //!< Start of the highest sacked item, or 0
+    bool m_hasHighestSack{false};      //!< Indicates if an item is sacked
+
+    // Cursors over the sent list, which spare walking it from the head: each
+    // one only moves back when flags are removed from items, see ResetCursors
+    SequenceNumber32 m_lostCursor;            //!< Items starting before are sacked or lost
+    SequenceNumber32 m_lostEnd;               //!< Items ending after are not lost
+    mutable SequenceNumber32 m_nextSegCursor; //!< Items starting before are retrans or sacked
 
     uint32_t m_lostOut{0};   //!< Number of lost bytes
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
     uint32_t m_retrans{0};   //!< Number of retransmitted bytes
 
-    uint32_t m_dupAckThresh{0}; //!< Duplicate Ack threshold from TcpSocketBase
-    uint32_t m_segmentSize{0};  //!< Segment size from TcpSocketBase
-    bool m_renoSack{false};     //!< Indicates if AddRenoSack was called
-    bool m_sackEnabled{true};   //!< Indicates if SACK is enabled on this connection
+    uint32_t m_dupAckThresh{0};   //!< Duplicate Ack threshold from TcpSocketBase
+    uint32_t m_segmentSize{0};    //!< Segment size from TcpSocketBase
+    bool m_renoSack{false};       //!< Indicates if AddRenoSack was called
+    bool m_sackEnabled{true};     //!< Indicates if SACK is enabled on this connection
+    bool m_virtualPayload{false}; //!< Indicates if the data is represented by its size only
 
     static Callback<void, TcpTxItem*> m_nullCb; //!< Null callback for an item
 };
@@ -0,0 +1,289 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <set>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that the endpoints are found by their new addresses after
+ * SetPeer() and SetLocalAddress(), and no longer by their old ones.
+ *
+ * \tparam Demux The demux type, Ipv4EndPointDemux or Ipv6EndPointDemux.
+ * \tparam Address The address type, Ipv4Address or Ipv6Address.
+ * \tparam Interface The interface type, Ipv4Interface or Ipv6Interface.
+ */
+template <typename Demux, typename Address, typename Interface>
+class EndPointDemuxReindexTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] name The test name.
+     * \param [in] local The local address.
+     * \param [in] peer1 The address of a peer.
+     * \param [in] peer2 The address of another peer.
+     */
+    EndPointDemuxReindexTestCase(std::string name, Address local, Address peer1, Address peer2);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Look up the endpoint receiving a packet sent to the local address.
+     *
+     * \param [in] demux The demux.
+     * \param [in] peer The source address of the packet.
+     * \param [in] peerPort The source port of the packet.
+     * \returns The endpoint found, or nullptr.
+     */
+    typename Demux::EndPoints::value_type Lookup(Demux& demux, Address peer, uint16_t peerPort);
+
+    Address m_local;        //!< The local address.
+    Address m_peer1;        //!< The address of a peer.
+    Address m_peer2;        //!< The address of another peer.
+    Ptr<Interface> m_iface; //!< The interface the packets are received from.
+};
+
+template <typename Demux, typename Address, typename Interface>
+EndPointDemuxReindexTestCase<Demux, Address, Interface>::EndPointDemuxReindexTestCase(
+    std::string name,
+    Address local,
+    Address peer1,
+    Address peer2)
+    : TestCase(name),
+      m_local(local),
+      m_peer1(peer1),
+      m_peer2(peer2)
+{
+}
+
+template <typename Demux, typename Address, typename Interface>
+typename Demux::EndPoints::value_type
+EndPointDemuxReindexTestCase<Demux, Address, Interface>::Lookup(Demux& demux,
+                                                                Address peer,
+                                                                uint16_t peerPort)
+{
+    auto endPoints = demux.Lookup(m_local, 80, peer, peerPort, m_iface);
+    return endPoints.empty() ? nullptr : endPoints.front();
+}
+
+template <typename Demux, typename Address, typename Interface>
+void
+EndPointDemuxReindexTestCase<Demux, Address, Interface>::DoRun()
+{
+    m_iface = CreateObject<Interface>();
+    Demux demux;
+
+    auto listening = demux.Allocate(nullptr, m_local, 80);
+    NS_TEST_ASSERT_MSG_NE(listening, nullptr, "Cannot bind to port 80");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer1, 1234), listening, "Not found by local address");
+
+    auto connected = demux.Allocate(nullptr, m_local, 80, m_peer1, 1234);
+    NS_TEST_ASSERT_MSG_NE(connected, nullptr, "Cannot connect from port 80");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer1, 1234), connected, "Not found by peer");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, m_local, 80, m_peer1, 1234),
+                          nullptr,
+                          "Duplicated connection allowed");
+
+    // the connection moves to another peer
+    connected->SetPeer(m_peer2, 1234);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer1, 1234), listening, "Found by the old peer");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer2, 1234), connected, "Not found by the new peer");
+    auto other = demux.Allocate(nullptr, m_local, 80, m_peer1, 1234);
+    NS_TEST_ASSERT_MSG_NE(other, nullptr, "Connection to the old peer refused");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer1, 1234), other, "Not found by peer");
+    demux.DeAllocate(other);
+
+    // an ephemeral endpoint is bound to the local address
+    auto ephemeral = demux.Allocate();
+    NS_TEST_ASSERT_MSG_NE(ephemeral, nullptr, "Cannot allocate an ephemeral port");
+    uint16_t port = ephemeral->GetLocalPort();
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupLocal(nullptr, Address::GetAny(), port),
+                          true,
+                          "Not found by the wildcard address");
+    ephemeral->SetLocalAddress(m_local);
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupLocal(nullptr, Address::GetAny(), port),
+                          false,
+                          "Found by the old address");
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupLocal(nullptr, m_local, port),
+                          true,
+                          "Not found by the new address");
+
+    // the connection closes
+    demux.DeAllocate(connected);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer2, 1234), listening, "Found after closing");
+    demux.DeAllocate(listening);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer2, 1234), nullptr, "Found after closing");
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(80), false, "Port 80 still in use");
+}
+
+template <typename Demux, typename Address, typename Interface>
+void
+EndPointDemuxReindexTestCase<Demux, Address, Interface>::DoTeardown()
+{
+    m_iface = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the ephemeral port allocation through the bitmap of the
+ * ports in use: the ports are allocated counting up, skipping those in use,
+ * and wrapping around, until all the ephemeral ports are in use.
+ *
+ * \tparam Demux The demux type, Ipv4EndPointDemux or Ipv6EndPointDemux.
+ */
+template <typename Demux>
+class EndPointDemuxEphemeralTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] name The test name.
+     */
+    EndPointDemuxEphemeralTestCase(std::string name);
+
+  private:
+    void DoRun() override;
+};
+
+template <typename Demux>
+EndPointDemuxEphemeralTestCase<Demux>::EndPointDemuxEphemeralTestCase(std::string name)
+    : TestCase(name)
+{
+}
+
+template <typename Demux>
+void
+EndPointDemuxEphemeralTestCase<Demux>::DoRun()
+{
+    const uint16_t first = 49152;
+    const uint16_t last = 65535;
+    Demux demux;
+
+    // a port bound before the bitmap is allocated is skipped
+    auto bound = demux.Allocate(nullptr, first + 3);
+    NS_TEST_ASSERT_MSG_NE(bound, nullptr, "Cannot bind to an ephemeral port");
+    auto a1 = demux.Allocate();
+    auto a2 = demux.Allocate();
+    auto a3 = demux.Allocate();
+    NS_TEST_ASSERT_MSG_NE(a3, nullptr, "Cannot allocate an ephemeral port");
+    NS_TEST_EXPECT_MSG_EQ(a1->GetLocalPort(), first + 1, "Unexpected port");
+    NS_TEST_EXPECT_MSG_EQ(a2->GetLocalPort(), first + 2, "Unexpected port");
+    NS_TEST_EXPECT_MSG_EQ(a3->GetLocalPort(), first + 4, "Port in use allocated");
+
+    // a freed port is not allocated again until the ports wrap around
+    demux.DeAllocate(a2);
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(first + 2), false, "Freed port still in use");
+    auto a4 = demux.Allocate();
+    NS_TEST_EXPECT_MSG_EQ(a4->GetLocalPort(), first + 5, "Freed port allocated again");
+
+    // the ports in use are skipped a word of the bitmap at a time
+    auto b1 = demux.Allocate(nullptr, first + 6);
+    auto b2 = demux.Allocate(nullptr, first + 300);
+    NS_TEST_ASSERT_MSG_NE(b2, nullptr, "Cannot bind to an ephemeral port");
+    std::set<uint16_t> ports;
+    typename Demux::EndPoints::value_type freed = nullptr;
+    for (uint32_t i = 0;; i++)
+    {
+        auto endPoint = demux.Allocate();
+        if (!endPoint)
+        {
+            break;
+        }
+        uint16_t port = endPoint->GetLocalPort();
+        NS_TEST_ASSERT_MSG_EQ(ports.insert(port).second,
+                              true,
+                              "Port " << port << " allocated twice");
+        if (i == 0)
+        {
+            NS_TEST_EXPECT_MSG_EQ(port, first + 7, "Unexpected port");
+        }
+        if (port == 50000)
+        {
+            freed = endPoint;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(ports.size(), last - first + 1 - 6, "Unexpected number of ports");
+    NS_TEST_EXPECT_MSG_EQ(ports.count(first), 1, "The ports did not wrap around");
+    NS_TEST_EXPECT_MSG_EQ(ports.count(first + 2), 1, "The freed port was not allocated");
+    NS_TEST_EXPECT_MSG_EQ(ports.count(first + 300), 0, "Port in use allocated");
+
+    // once all the ports are in use, only a freed port may be allocated
+    NS_TEST_ASSERT_MSG_NE(freed, nullptr, "Port 50000 not allocated");
+    demux.DeAllocate(freed);
+    auto again = demux.Allocate();
+    NS_TEST_ASSERT_MSG_NE(again, nullptr, "Cannot allocate the freed port");
+    NS_TEST_EXPECT_MSG_EQ(again->GetLocalPort(), 50000, "Unexpected port");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(), nullptr, "Port allocated twice");
+
+    demux.DeAllocate(b1);
+    demux.DeAllocate(bound);
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(first + 3), false, "Freed port still in use");
+    auto b3 = demux.Allocate();
+    NS_TEST_ASSERT_MSG_NE(b3, nullptr, "Cannot allocate a freed port");
+    NS_TEST_EXPECT_MSG_EQ(b3->GetLocalPort(), first + 3, "Unexpected port");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate()->GetLocalPort(), first + 6, "Unexpected port");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4EndPointDemux and Ipv6EndPointDemux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    EndPointDemuxTestSuite()
+        : TestSuite("end-point-demux", UNIT)
+    {
+        AddTestCase(new EndPointDemuxReindexTestCase<Ipv4EndPointDemux, Ipv4Address, Ipv4Interface>(
+                        "Re-index the IPv4 endpoints on SetPeer and SetLocalAddress",
+                        Ipv4Address("10.0.0.1"),
+                        Ipv4Address("10.0.0.2"),
+                        Ipv4Address("10.0.0.3")),
+                    TestCase::QUICK);
+        AddTestCase(new EndPointDemuxReindexTestCase<Ipv6EndPointDemux, Ipv6Address, Ipv6Interface>(
+                        "Re-index the IPv6 endpoints on SetPeer and SetLocalAddress",
+                        Ipv6Address("2001:db8::1"),
+                        Ipv6Address("2001:db8::2"),
+                        Ipv6Address("2001:db8::3")),
+                    TestCase::QUICK);
+        AddTestCase(new EndPointDemuxEphemeralTestCase<Ipv4EndPointDemux>(
+                        "Allocate the IPv4 ephemeral ports"),
+                    TestCase::QUICK);
+        AddTestCase(new EndPointDemuxEphemeralTestCase<Ipv6EndPointDemux>(
+                        "Allocate the IPv6 ephemeral ports"),
+                    TestCase::QUICK);
+    }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
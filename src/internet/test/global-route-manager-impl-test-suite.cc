@@ -27,6 +27,7 @@
 #include "ns3/test.h"
 
 #include <cstdlib> // for rand()
+#include <vector>
 
 using namespace ns3;
 
@@ -65,13 +66,41 @@ GlobalRouteManagerImplTestCase::DoRun()
         candidate.Push(v);
     }
 
+    uint32_t lastDistance = 0;
     for (int i = 0; i < 100; ++i)
     {
         SPFVertex* v = candidate.Pop();
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(v->GetDistanceFromRoot(),
+                                    lastDistance,
+                                    "CandidateQueue popped vertices out of order");
+        lastDistance = v->GetDistanceFromRoot();
         delete v;
         v = nullptr;
     }
 
+    // Lowering the distance of a queued vertex moves it behind the vertices
+    // already queued with the same distance, as a full reorder does
+    std::vector<SPFVertex*> vertices;
+    for (int i = 0; i < 4; ++i)
+    {
+        auto v = new SPFVertex;
+        v->SetDistanceFromRoot(i < 3 ? 1 : 2);
+        vertices.push_back(v);
+        candidate.Push(v);
+    }
+    vertices[3]->SetDistanceFromRoot(1);
+    candidate.Reorder(vertices[3]);
+    vertices[1]->SetDistanceFromRoot(0);
+    candidate.Reorder();
+    NS_TEST_ASSERT_MSG_EQ(candidate.Pop(), vertices[1], "Unexpected CandidateQueue order");
+    NS_TEST_ASSERT_MSG_EQ(candidate.Pop(), vertices[0], "Unexpected CandidateQueue order");
+    NS_TEST_ASSERT_MSG_EQ(candidate.Pop(), vertices[2], "Unexpected CandidateQueue order");
+    NS_TEST_ASSERT_MSG_EQ(candidate.Pop(), vertices[3], "Unexpected CandidateQueue order");
+    for (auto v : vertices)
+    {
+        delete v;
+    }
+
     // Build fake link state database; four routers (0-3), 3 point-to-point
     // links
     //
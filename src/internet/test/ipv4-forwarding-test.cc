@@ -49,7 +49,8 @@ using namespace ns3;
  */
 class Ipv4ForwardingTest : public TestCase
 {
-    Ptr<Packet> m_receivedPacket; //!< Received packet
+    Ptr<Packet> m_receivedPacket;     //!< Received packet
+    Ptr<const Packet> m_tracedPacket; //!< Packet received by the forwarding node, as traced
 
     /**
      * \brief Send data.
@@ -73,6 +74,14 @@ class Ipv4ForwardingTest : public TestCase
      * \param socket The receiving socket.
      */
     void ReceivePkt(Ptr<Socket> socket);
+
+    /**
+     * \brief Keep the packet received by the forwarding node.
+     * \param packet The packet.
+     * \param ipv4 The IPv4 protocol.
+     * \param interface The interface index.
+     */
+    void TraceRx(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
 };
 
 Ipv4ForwardingTest::Ipv4ForwardingTest()
@@ -91,6 +100,12 @@ Ipv4ForwardingTest::ReceivePkt(Ptr<Socket> socket)
                           "Received packet size is not equal to Rx buffer size");
 }
 
+void
+Ipv4ForwardingTest::TraceRx(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    m_tracedPacket = packet;
+}
+
 void
 Ipv4ForwardingTest::DoSendData(Ptr<Socket> socket, std::string to)
 {
@@ -216,7 +231,18 @@ Ipv4ForwardingTest::DoRun()
     m_receivedPacket->RemoveAllByteTags();
     m_receivedPacket = nullptr;
 
+    // a packet kept by a trace sink is not forwarded in place
     Ptr<Ipv4> ipv4 = fwNode->GetObject<Ipv4>();
+    ipv4->TraceConnectWithoutContext("Rx", MakeCallback(&Ipv4ForwardingTest::TraceRx, this));
+    SendData(txSocket, "10.0.0.2");
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPacket->GetSize(), 123, "IPv4 Forwarding with Rx trace");
+    NS_TEST_EXPECT_MSG_EQ(m_tracedPacket->GetSize(), 123 + 8, "Traced packet forwarded");
+    ipv4->TraceDisconnectWithoutContext("Rx", MakeCallback(&Ipv4ForwardingTest::TraceRx, this));
+    m_tracedPacket = nullptr;
+
+    m_receivedPacket->RemoveAllByteTags();
+    m_receivedPacket = nullptr;
+
     ipv4->SetAttribute("IpForward", BooleanValue(false));
     SendData(txSocket, "10.0.0.2");
     NS_TEST_EXPECT_MSG_EQ(m_receivedPacket->GetSize(), 0, "IPv4 Forwarding off");
@@ -1311,6 +1311,97 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting forwarding lookup test
+ *
+ * Checks host, overlapping network and external routes, output interface
+ * filtering, and that route changes are seen by later lookups.
+ */
+class Ipv4GlobalRoutingLookupTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Look up a destination and return the selected gateway.
+     * \param dest The destination address.
+     * \param oif The requested output device, if any.
+     * \returns The gateway of the route, or 255.255.255.255 if none is found.
+     */
+    Ipv4Address Lookup(std::string dest, Ptr<NetDevice> oif = nullptr);
+
+    Ptr<Ipv4GlobalRouting> m_routing; //!< Routing protocol under test
+};
+
+Ipv4GlobalRoutingLookupTestCase::Ipv4GlobalRoutingLookupTestCase()
+    : TestCase("Global routing forwarding lookups")
+{
+}
+
+Ipv4Address
+Ipv4GlobalRoutingLookupTestCase::Lookup(std::string dest, Ptr<NetDevice> oif)
+{
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address(dest.c_str()));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = m_routing->RouteOutput(Create<Packet>(), header, oif, sockerr);
+    return route ? route->GetGateway() : Ipv4Address::GetBroadcast();
+}
+
+void
+Ipv4GlobalRoutingLookupTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(Ipv4GlobalRoutingHelper());
+    internet.Install(node);
+
+    SimpleNetDeviceHelper devHelper;
+    NetDeviceContainer devices = devHelper.Install(node);
+    devices.Add(devHelper.Install(node));
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    ipv4.Assign(devices.Get(0));
+    ipv4.SetBase("10.1.2.0", "255.255.255.0");
+    ipv4.Assign(devices.Get(1));
+
+    m_routing = node->GetObject<Ipv4>()->GetRoutingProtocol()->GetObject<Ipv4GlobalRouting>();
+    NS_TEST_ASSERT_MSG_NE(m_routing, nullptr, "Error-- no Ipv4GlobalRouting object");
+
+    m_routing->AddASExternalRouteTo("0.0.0.0", "0.0.0.0", "10.1.1.9", 1);
+    m_routing->AddASExternalRouteTo("0.0.0.0", "0.0.0.0", "10.1.2.9", 2);
+    m_routing->AddNetworkRouteTo("10.2.0.0", "255.255.0.0", "10.1.1.2", 1);
+    m_routing->AddNetworkRouteTo("10.2.1.0", "255.255.255.0", "10.1.2.2", 2);
+    m_routing->AddHostRouteTo("10.2.1.5", "10.1.1.5", 1);
+
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.2.1.5"), Ipv4Address("10.1.1.5"), "Host route not used");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.2.1.5", devices.Get(1)),
+                          Ipv4Address("10.1.2.2"),
+                          "Output interface not honored");
+    // Every matching network route is an equal-cost candidate, in table order
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.2.1.6"), Ipv4Address("10.1.1.2"), "Wrong network route");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.2.2.6"), Ipv4Address("10.1.1.2"), "Wrong network route");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.3.0.1"), Ipv4Address("10.1.1.9"), "Wrong external route");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.3.0.1", devices.Get(1)),
+                          Ipv4Address("10.1.2.9"),
+                          "Output interface not honored");
+
+    // Removing the /16 route leaves the /24 and the external routes
+    m_routing->RemoveRoute(1);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.2.1.6"), Ipv4Address("10.1.2.2"), "Stale network route");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.2.2.6"), Ipv4Address("10.1.1.9"), "Stale network route");
+    m_routing->AddHostRouteTo("10.2.2.6", "10.1.2.6", 2);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.2.2.6"), Ipv4Address("10.1.2.6"), "Stale host route");
+
+    m_routing = nullptr;
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1333,6 +1424,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingLookupTestCase, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
@@ -42,6 +42,11 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * \brief Test that a virtual payload is buffered as the packets are.
+     */
+    void TestVirtualPayload();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -53,6 +58,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestVirtualPayload();
 }
 
 void
@@ -288,6 +294,57 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestVirtualPayload()
+{
+    TcpRxBuffer rxBuf;
+    TcpRxBuffer virtualRxBuf;
+    virtualRxBuf.SetVirtualPayload(true);
+    rxBuf.SetMaxBufferSize(2000);
+    virtualRxBuf.SetMaxBufferSize(2000);
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+    virtualRxBuf.SetNextRxSequence(SequenceNumber32(1));
+
+    // Segments in order, out of order, overlapping, duplicated, and beyond
+    // the window; a segment of size 0 stands for reading some data
+    const std::vector<std::pair<uint32_t, uint32_t>> segments = {
+        {1, 100},   {501, 100},  {401, 100},  {101, 100},  {451, 300},  {1101, 100},
+        {901, 400}, {301, 50},   {201, 200},  {0, 0},      {1601, 900}, {2001, 1000},
+        {351, 800}, {1501, 100}, {0, 0},      {2501, 500}, {1, 3000},
+    };
+    for (const auto& [seq, size] : segments)
+    {
+        if (size == 0)
+        {
+            Ptr<Packet> p = rxBuf.Extract(700);
+            Ptr<Packet> virtualP = virtualRxBuf.Extract(700);
+            NS_TEST_ASSERT_MSG_EQ((p ? p->GetSize() : 0),
+                                  (virtualP ? virtualP->GetSize() : 0),
+                                  "Extracted a different amount of data");
+            continue;
+        }
+        TcpHeader h;
+        h.SetSequenceNumber(SequenceNumber32(seq));
+        NS_TEST_ASSERT_MSG_EQ(virtualRxBuf.Add(Create<Packet>(size), h),
+                              rxBuf.Add(Create<Packet>(size), h),
+                              "Added a segment differently");
+        NS_TEST_ASSERT_MSG_EQ(virtualRxBuf.NextRxSequence(),
+                              rxBuf.NextRxSequence(),
+                              "Sequence number differs");
+        NS_TEST_ASSERT_MSG_EQ(virtualRxBuf.MaxRxSequence(),
+                              rxBuf.MaxRxSequence(),
+                              "Maximum sequence number differs");
+        NS_TEST_ASSERT_MSG_EQ(virtualRxBuf.Size(), rxBuf.Size(), "Size differs");
+        NS_TEST_ASSERT_MSG_EQ(virtualRxBuf.Available(), rxBuf.Available(), "Available differs");
+        NS_TEST_ASSERT_MSG_EQ((virtualRxBuf.GetSackList() == rxBuf.GetSackList()),
+                              true,
+                              "SACK list differs");
+    }
+    Ptr<Packet> p = virtualRxBuf.Extract(10000);
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), rxBuf.Extract(10000)->GetSize(), "Extracted size differs");
+    NS_TEST_ASSERT_MSG_EQ(virtualRxBuf.Size(), 0, "Data left in the buffer");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
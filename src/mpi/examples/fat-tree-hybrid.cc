@@ -211,6 +211,7 @@ bool flow = true;
 uint32_t port = 443;
 string socket = "ns3::TcpSocketFactory";
 string tcp = "ns3::TcpDctcp";
+bool virt = false;
 
 // application layer options
 uint32_t size = 1448;
@@ -256,6 +257,7 @@ Initialize(int argc, char* argv[])
     cmd.AddValue("port", "Port number of server applications", conf::port);
     cmd.AddValue("socket", "Socket protocol", conf::socket);
     cmd.AddValue("tcp", "TCP protocol", conf::tcp);
+    cmd.AddValue("virtual", "Represent TCP payloads by their size only", conf::virt);
     cmd.AddValue("size", "Application packet size", conf::size);
     cmd.AddValue("cdf", "Traffic CDF file location", conf::cdf);
     cmd.AddValue("load", "Traffic load relative to bisection bandwidth", conf::load);
@@ -296,6 +298,7 @@ Initialize(int argc, char* argv[])
     // transport layer settings
     Config::SetDefault("ns3::TcpL4Protocol::SocketType", StringValue(conf::tcp));
     Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(conf::size));
+    Config::SetDefault("ns3::TcpSocketBase::VirtualPayload", BooleanValue(conf::virt));
     Config::SetDefault("ns3::TcpSocket::ConnTimeout",
                        TimeValue(conf::tcp == "ns3::TcpDctcp" ? MilliSeconds(10) : Seconds(3)));
     Config::SetDefault("ns3::TcpSocket::SndBufSize", UintegerValue(1073725440));
@@ -170,6 +170,8 @@ HybridSimulatorImpl::ScheduleNow(EventImpl* event)
 EventId
 HybridSimulatorImpl::ScheduleDestroy(EventImpl* event)
 {
+    // the destroy events are shared by all the logical processes
+    event->ShareReferenceCount();
     EventId id(Ptr<EventImpl>(event, false),
                GetMaximumSimulationTime().GetTimeStep(),
                0xffffffff,
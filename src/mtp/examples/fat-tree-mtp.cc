@@ -208,6 +208,7 @@ bool flow = true;
 uint32_t port = 443;
 string socket = "ns3::TcpSocketFactory";
 string tcp = "ns3::TcpDctcp";
+bool virt = false;
 
 // application layer options
 uint32_t size = 1448;
@@ -215,6 +216,7 @@ string cdf = "src/mtp/examples/web-search.txt";
 double load = 0.3;
 double incast = 0;
 string victim = "0";
+string schedule = "";
 
 // simulation options
 string seed = "";
@@ -248,11 +250,13 @@ Initialize(int argc, char* argv[])
     cmd.AddValue("port", "Port number of server applications", conf::port);
     cmd.AddValue("socket", "Socket protocol", conf::socket);
     cmd.AddValue("tcp", "TCP protocol", conf::tcp);
+    cmd.AddValue("virtual", "Represent TCP payloads by their size only", conf::virt);
     cmd.AddValue("size", "Application packet size", conf::size);
     cmd.AddValue("cdf", "Traffic CDF file location", conf::cdf);
     cmd.AddValue("load", "Traffic load relative to bisection bandwidth", conf::load);
     cmd.AddValue("incast", "Incast traffic ratio", conf::incast);
     cmd.AddValue("victim", "Incast traffic victim list", conf::victim);
+    cmd.AddValue("schedule", "Flow schedule file, instead of generated traffic", conf::schedule);
 
     // parse simulation options
     cmd.AddValue("seed", "The seed of the random number generator", conf::seed);
@@ -286,6 +290,7 @@ Initialize(int argc, char* argv[])
     // transport layer settings
     Config::SetDefault("ns3::TcpL4Protocol::SocketType", StringValue(conf::tcp));
     Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(conf::size));
+    Config::SetDefault("ns3::TcpSocketBase::VirtualPayload", BooleanValue(conf::virt));
     Config::SetDefault("ns3::TcpSocket::ConnTimeout",
                        TimeValue(conf::tcp == "ns3::TcpDctcp" ? MilliSeconds(10) : Seconds(3)));
     Config::SetDefault("ns3::TcpSocket::SndBufSize", UintegerValue(1073725440));
@@ -301,6 +306,7 @@ Initialize(int argc, char* argv[])
 
     // application layer settings
     Config::SetDefault("ns3::BulkSendApplication::SendSize", UintegerValue(UINT32_MAX));
+    Config::SetDefault("ns3::FlowScheduleApplication::SendSize", UintegerValue(UINT32_MAX));
     Config::SetDefault("ns3::OnOffApplication::DataRate", StringValue(conf::bandwidth));
     Config::SetDefault("ns3::OnOffApplication::PacketSize", UintegerValue(conf::size));
     Config::SetDefault("ns3::OnOffApplication::OnTime",
@@ -333,7 +339,7 @@ SetupRouting()
         internet.SetRoutingHelper(Ipv4GlobalRoutingHelper());
     }
     internet.SetIpv6StackInstall(false);
-    internet.InstallAll();
+    internet.InstallParallel(NodeContainer::GetGlobal());
     LOG("\n- Setup the topology...");
 }
 
@@ -362,6 +368,26 @@ InstallTraffic(map<uint32_t, Ptr<Node>>& hosts,
         server.Install(p.second).Start(Seconds(0));
     }
 
+    // pre-sampled traffic (client applications)
+    if (!conf::schedule.empty())
+    {
+        LOG("\n- Loading traffic...");
+        auto schedule = Create<FlowSchedule>();
+        schedule->Load(conf::schedule, hosts.size());
+        NodeContainer clients;
+        vector<Address> peers;
+        for (auto& p : hosts)
+        {
+            clients.Add(p.second);
+            peers.emplace_back(InetSocketAddress(addrs[p.second], conf::port));
+        }
+        FlowScheduleHelper client(conf::socket, conf::port);
+        client.Install(clients, schedule, peers).Start(Seconds(0));
+        LOG("  Total flow count = " << schedule->GetNFlows());
+        LOG("  Total flow size = " << schedule->GetTotalSize() / 1e6 << "MB");
+        return;
+    }
+
     // calculate traffic
     LOG("\n- Generating traffic...");
     double bandwidth = bisection * DataRate(conf::bandwidth).GetBitRate() * 2;
@@ -553,35 +579,36 @@ main(int argc, char* argv[])
     PointToPointHelper p2p;
     red.SetRootQueueDisc("ns3::RedQueueDisc");
 
+    // list the links, which are then built in parallel: the two ends of
+    // each link, and the subnets with their number of links
+    NodeContainer ends[2];
+    vector<pair<string, uint32_t>> subnets;
+
     // connect edge switches to hosts
     for (uint32_t i = 0; i < nPod; i++)
     {
         for (uint32_t j = 0; j < nEdge; j++)
         {
-            string subnet = "10." + to_string(i) + "." + to_string(j) + ".0";
-            addr.SetBase(subnet.c_str(), "255.255.255.0");
+            subnets.emplace_back("10." + to_string(i) + "." + to_string(j) + ".0", nHost);
+            ends[0].Add(host[i][j]);
             for (uint32_t k = 0; k < nHost; k++)
             {
-                Ptr<Node> node = host[i][j].Get(k);
-                NetDeviceContainer ndc = p2p.Install(NodeContainer(node, edge[i].Get(j)));
-                red.Install(ndc.Get(1));
-                addrs[node] = addr.Assign(ndc).GetAddress(0);
+                ends[1].Add(edge[i].Get(j));
             }
         }
     }
+    uint32_t nHostLinks = ends[0].GetN();
 
     // connect aggregate switches to edge switches
     for (uint32_t i = 0; i < nPod; i++)
     {
         for (uint32_t j = 0; j < nAgg; j++)
         {
-            string subnet = "10." + to_string(i) + "." + to_string(j + nEdge) + ".0";
-            addr.SetBase(subnet.c_str(), "255.255.255.0");
+            subnets.emplace_back("10." + to_string(i) + "." + to_string(j + nEdge) + ".0", nEdge);
             for (uint32_t k = 0; k < nEdge; k++)
             {
-                NetDeviceContainer ndc = p2p.Install(agg[i].Get(j), edge[i].Get(k));
-                red.Install(ndc);
-                addr.Assign(ndc);
+                ends[0].Add(agg[i].Get(j));
+                ends[1].Add(edge[i].Get(k));
             }
         }
     }
@@ -591,17 +618,46 @@ main(int argc, char* argv[])
     {
         for (uint32_t j = 0; j < nPod; j++)
         {
-            string subnet = "10." + to_string(i + nPod) + "." + to_string(j) + ".0";
-            addr.SetBase(subnet.c_str(), "255.255.255.0");
+            subnets.emplace_back("10." + to_string(i + nPod) + "." + to_string(j) + ".0", nCore);
             for (uint32_t k = 0; k < nCore; k++)
             {
-                NetDeviceContainer ndc = p2p.Install(core[i].Get(k), agg[j].Get(i));
-                red.Install(ndc);
-                addr.Assign(ndc);
+                ends[0].Add(core[i].Get(k));
+                ends[1].Add(agg[j].Get(i));
             }
         }
     }
 
+    // the devices of a link are in turn, the hosts being the first ends;
+    // the queue discs of the switches only are set, the hosts keeping the
+    // default ones
+    NetDeviceContainer devices = p2p.InstallParallel(ends[0], ends[1]);
+    NetDeviceContainer switchDevices;
+    for (uint32_t i = 0; i < devices.GetN(); i++)
+    {
+        if (i >= nHostLinks * 2 || i % 2 == 1)
+        {
+            switchDevices.Add(devices.Get(i));
+        }
+    }
+    red.InstallParallel(switchDevices);
+
+    uint32_t link = 0;
+    for (const auto& [subnet, nLinks] : subnets)
+    {
+        addr.SetBase(subnet.c_str(), "255.255.255.0");
+        NetDeviceContainer ndc;
+        for (uint32_t k = 0; k < nLinks * 2; k++)
+        {
+            ndc.Add(devices.Get(link * 2 + k));
+        }
+        Ipv4InterfaceContainer ifc = addr.AssignParallel(ndc);
+        for (uint32_t k = 0; k < nLinks && link + k < nHostLinks; k++)
+        {
+            addrs[ends[0].Get(link + k)] = ifc.GetAddress(k * 2);
+        }
+        link += nLinks;
+    }
+
     InstallTraffic(hosts, addrs, nGroup * nCore * nPod / 2.0);
     StartSimulation();
 
@@ -28,6 +28,7 @@
 #include "ns3/assert.h"
 #include "ns3/config.h"
 #include "ns3/log.h"
+#include "ns3/parallel-construction.h"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
 
@@ -120,6 +121,10 @@ MtpInterface::Enable(const uint32_t threadCount, const uint32_t systemCount)
     // so that we can access the currently assigned LP of each thread
     pthread_key_create(&g_key, nullptr);
     pthread_setspecific(g_key, &g_systems[0]);
+
+    // let the threads building the topology in parallel see the LP as well
+    ParallelConstruction::SetThreadState([]() { return pthread_getspecific(g_key); },
+                                         [](void* lp) { pthread_setspecific(g_key, lp); });
 }
 
 void
@@ -155,6 +160,10 @@ MtpInterface::EnableNew(const uint32_t newSystemCount)
     // so that we can access the currently assigned LP of each thread
     pthread_key_create(&g_key, nullptr);
     pthread_setspecific(g_key, &g_systems[0]);
+
+    // let the threads building the topology in parallel see the LP as well
+    ParallelConstruction::SetThreadState([]() { return pthread_getspecific(g_key); },
+                                         [](void* lp) { pthread_setspecific(g_key, lp); });
 }
 
 void
@@ -171,6 +180,7 @@ MtpInterface::Disable()
     g_systemCount = 0;
     g_sortFunc = nullptr;
     g_globalFinished = false;
+    ParallelConstruction::SetThreadState(nullptr, nullptr);
     delete[] g_systems;
     delete[] g_threads;
     delete[] g_sortedSystemIndices;
@@ -151,6 +151,8 @@ MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
 EventId
 MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
 {
+    // the destroy events are shared by all the logical processes
+    event->ShareReferenceCount();
     EventId id(Ptr<EventImpl>(event, false),
                GetMaximumSimulationTime().GetTimeStep(),
                0xffffffff,
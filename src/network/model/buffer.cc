@@ -297,6 +297,18 @@ Buffer::~Buffer()
     }
 }
 
+#ifdef NS3_MTP
+void
+Buffer::Share(bool all) const
+{
+    NS_LOG_FUNCTION(this << all);
+    if (all || m_data->m_count > 1)
+    {
+        m_data->m_count.Share();
+    }
+}
+#endif
+
 uint32_t
 Buffer::GetInternalSize() const
 {
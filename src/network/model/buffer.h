@@ -647,6 +647,17 @@ class Buffer
     Buffer(uint32_t dataSize, bool initialize);
     ~Buffer();
 
+#ifdef NS3_MTP
+    /**
+     * Make the reference counting of the buffer data atomic, before the
+     * buffer is used by another logical process.
+     *
+     * \param all Whether to share the data even if referenced by this buffer
+     *        only, as done when the buffer itself is shared.
+     */
+    void Share(bool all) const;
+#endif
+
   private:
     /**
      * This data structure is variable-sized through its last member whose size
@@ -669,7 +680,7 @@ class Buffer
          * Each buffer which references an instance holds a count.
          */
 #ifdef NS3_MTP
-        AtomicCounter m_count;
+        OwnedCounter m_count;
 #else
         uint32_t m_count;
 #endif
@@ -48,7 +48,7 @@ struct ByteTagListData
 {
     uint32_t size;   //!< size of the data
 #ifdef NS3_MTP
-    AtomicCounter count;
+    OwnedCounter count;
 #else
     uint32_t count;  //!< use counter (for smart deallocation)
 #endif
@@ -208,6 +208,18 @@ ByteTagList::~ByteTagList()
     m_used = 0;
 }
 
+#ifdef NS3_MTP
+void
+ByteTagList::Share(bool all) const
+{
+    NS_LOG_FUNCTION(this << all);
+    if (m_data != nullptr && (all || m_data->count > 1))
+    {
+        m_data->count.Share();
+    }
+}
+#endif
+
 TagBuffer
 ByteTagList::Add(TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
 {
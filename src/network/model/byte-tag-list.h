@@ -176,6 +176,17 @@ class ByteTagList
     ByteTagList& operator=(const ByteTagList& o);
     ~ByteTagList();
 
+#ifdef NS3_MTP
+    /**
+     * Make the reference counting of the tags atomic, before the list is
+     * used by another logical process.
+     *
+     * \param all Whether to share the tags even if referenced by this list
+     *        only.
+     */
+    void Share(bool all) const;
+#endif
+
     /**
      * \param tid the typeid of the tag added
      * \param bufferSize the size of the tag when its serialization will
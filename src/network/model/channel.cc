@@ -21,6 +21,7 @@
 #include "net-device.h"
 
 #include "ns3/log.h"
+#include "ns3/parallel-construction.h"
 #include "ns3/uinteger.h"
 
 namespace ns3
@@ -49,7 +50,9 @@ Channel::Channel()
     : m_id(0)
 {
     NS_LOG_FUNCTION(this);
-    m_id = ChannelList::Add(this);
+    // channels are numbered in construction order, which
+    // ParallelConstruction keeps by deferring the registration
+    ParallelConstruction::Defer([this]() { m_id = ChannelList::Add(this); });
 }
 
 Channel::~Channel()
@@ -30,6 +30,7 @@
 #include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/object-vector.h"
+#include "ns3/parallel-construction.h"
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
 
@@ -105,7 +106,9 @@ void
 Node::Construct()
 {
     NS_LOG_FUNCTION(this);
-    m_id = NodeList::Add(this);
+    // nodes are numbered in construction order, which
+    // ParallelConstruction keeps by deferring the registration
+    ParallelConstruction::Defer([this]() { m_id = NodeList::Add(this); });
 }
 
 Node::~Node()
@@ -565,6 +565,18 @@ PacketMetadata::ReadItems(uint16_t current,
     return buffer - &m_data->m_data[current];
 }
 
+#ifdef NS3_MTP
+void
+PacketMetadata::Share(bool all) const
+{
+    NS_LOG_FUNCTION(this << all);
+    if (all || m_data->m_count > 1)
+    {
+        m_data->m_count.Share();
+    }
+}
+#endif
+
 PacketMetadata::Data*
 PacketMetadata::Create(uint32_t size)
 {
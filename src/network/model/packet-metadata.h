@@ -190,6 +190,17 @@ class PacketMetadata
     inline PacketMetadata& operator=(const PacketMetadata& o);
     inline ~PacketMetadata();
 
+#ifdef NS3_MTP
+    /**
+     * Make the reference counting of the metadata atomic, before the
+     * metadata is used by another logical process.
+     *
+     * \param all Whether to share the data even if referenced by this
+     *        metadata only.
+     */
+    void Share(bool all) const;
+#endif
+
     // Delete default constructor to avoid misuse
     PacketMetadata() = delete;
 
@@ -428,7 +439,7 @@ class PacketMetadata
     {
         /** number of references to this struct Data instance. */
 #ifdef NS3_MTP
-        AtomicCounter m_count;
+        OwnedCounter m_count;
 #else
         uint32_t m_count;
 #endif
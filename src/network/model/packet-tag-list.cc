@@ -303,6 +303,24 @@ PacketTagList::Head() const
     return m_next;
 }
 
+#ifdef NS3_MTP
+void
+PacketTagList::Share(bool all) const
+{
+    NS_LOG_FUNCTION(this << all);
+    // the tags up to the first merge are linked from this list only, the
+    // others may be reached from other lists as well
+    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    {
+        all = all || cur->count > 1;
+        if (all)
+        {
+            cur->count.Share();
+        }
+    }
+}
+#endif
+
 uint32_t
 PacketTagList::GetSerializedSize() const
 {
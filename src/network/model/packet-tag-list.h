@@ -144,7 +144,7 @@ class PacketTagList
     {
         TagData* next;   //!< Pointer to next in list
 #ifdef NS3_MTP
-        AtomicCounter count;
+        OwnedCounter count;
 #else
         uint32_t count;  //!< Number of incoming links
 #endif
@@ -183,6 +183,17 @@ class PacketTagList
      */
     inline ~PacketTagList();
 
+#ifdef NS3_MTP
+    /**
+     * Make the reference counting of the tags atomic, before the list is
+     * used by another logical process.
+     *
+     * \param all Whether to share the tags even if linked from this list
+     *        only.
+     */
+    void Share(bool all) const;
+#endif
+
     /**
      * Add a tag to the head of this branch.
      *
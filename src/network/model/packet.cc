@@ -31,6 +31,7 @@ namespace ns3
 NS_LOG_COMPONENT_DEFINE("Packet");
 
 uint32_t Packet::m_globalUid = 0;
+bool Packet::m_lazyHeadersEnabled = false;
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -136,6 +137,23 @@ Packet::Copy() const
     return Ptr<Packet>(new Packet(*this), false);
 }
 
+void
+Packet::Share() const
+{
+#ifdef NS3_MTP
+    NS_LOG_FUNCTION(this);
+    bool all = GetReferenceCount() > 1;
+    if (all)
+    {
+        ShareReferenceCount();
+    }
+    m_buffer.Share(all);
+    m_byteTagList.Share(all);
+    m_packetTagList.Share(all);
+    m_metadata.Share(all);
+#endif
+}
+
 Packet::Packet()
     : m_buffer(),
       m_byteTagList(),
@@ -156,8 +174,14 @@ Packet::Packet(const Packet& o)
     : m_buffer(o.m_buffer),
       m_byteTagList(o.m_byteTagList),
       m_packetTagList(o.m_packetTagList),
-      m_metadata(o.m_metadata)
+      m_metadata(o.m_metadata),
+      m_nLazyHeaders(o.m_nLazyHeaders),
+      m_lazySize(o.m_lazySize)
 {
+    for (uint8_t i = 0; i < m_nLazyHeaders; i++)
+    {
+        m_lazyHeaders[i] = o.m_lazyHeaders[i];
+    }
     o.m_nixVector ? m_nixVector = o.m_nixVector->Copy() : m_nixVector = nullptr;
 }
 
@@ -173,6 +197,12 @@ Packet::operator=(const Packet& o)
     m_packetTagList = o.m_packetTagList;
     m_metadata = o.m_metadata;
     o.m_nixVector ? m_nixVector = o.m_nixVector->Copy() : m_nixVector = nullptr;
+    for (uint8_t i = 0; i < MAX_LAZY_HEADERS; i++)
+    {
+        m_lazyHeaders[i] = o.m_lazyHeaders[i];
+    }
+    m_nLazyHeaders = o.m_nLazyHeaders;
+    m_lazySize = o.m_lazySize;
     return *this;
 }
 
@@ -238,6 +268,7 @@ Ptr<Packet>
 Packet::CreateFragment(uint32_t start, uint32_t length) const
 {
     NS_LOG_FUNCTION(this << start << length);
+    Materialize();
     Buffer buffer = m_buffer.CreateFragment(start, length);
     ByteTagList byteTagList = m_byteTagList;
     byteTagList.Adjust(-start);
@@ -269,6 +300,7 @@ Packet::AddHeader(const Header& header)
 {
     uint32_t size = header.GetSerializedSize();
     NS_LOG_FUNCTION(this << header.GetInstanceTypeId().GetName() << size);
+    Materialize();
     m_buffer.AddAtStart(size);
     m_byteTagList.Adjust(size);
     m_byteTagList.AddAtStart(size);
@@ -276,9 +308,57 @@ Packet::AddHeader(const Header& header)
     m_metadata.AddHeader(header, size);
 }
 
+void
+Packet::PushLazyHeader(Ptr<LazyHeader> header)
+{
+    uint32_t size = header->m_size;
+    NS_LOG_FUNCTION(this << header->Get().GetInstanceTypeId().GetName() << size);
+    if (m_nLazyHeaders == MAX_LAZY_HEADERS)
+    {
+        Materialize();
+    }
+    m_byteTagList.Adjust(size);
+    m_byteTagList.AddAtStart(size);
+    m_metadata.AddHeader(header->Get(), size);
+    m_lazyHeaders[m_nLazyHeaders++] = header;
+    m_lazySize += size;
+}
+
+uint32_t
+Packet::PopLazyHeader()
+{
+    Ptr<LazyHeader> header = m_lazyHeaders[--m_nLazyHeaders];
+    m_lazyHeaders[m_nLazyHeaders] = nullptr;
+    uint32_t size = header->m_size;
+    NS_LOG_FUNCTION(this << header->Get().GetInstanceTypeId().GetName() << size);
+    m_lazySize -= size;
+    m_byteTagList.Adjust(-size);
+    m_metadata.RemoveHeader(header->Get(), size);
+    return size;
+}
+
+void
+Packet::Materialize() const
+{
+    if (m_nLazyHeaders == 0)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this << +m_nLazyHeaders);
+    for (uint8_t i = 0; i < m_nLazyHeaders; i++)
+    {
+        m_buffer.AddAtStart(m_lazyHeaders[i]->m_size);
+        m_lazyHeaders[i]->Get().Serialize(m_buffer.Begin());
+        m_lazyHeaders[i] = nullptr;
+    }
+    m_nLazyHeaders = 0;
+    m_lazySize = 0;
+}
+
 uint32_t
 Packet::RemoveHeader(Header& header, uint32_t size)
 {
+    Materialize();
     Buffer::Iterator end;
     end = m_buffer.Begin();
     end.Next(size);
@@ -293,6 +373,7 @@ Packet::RemoveHeader(Header& header, uint32_t size)
 uint32_t
 Packet::RemoveHeader(Header& header)
 {
+    Materialize();
     uint32_t deserialized = header.Deserialize(m_buffer.Begin());
     NS_LOG_FUNCTION(this << header.GetInstanceTypeId().GetName() << deserialized);
     m_buffer.RemoveAtStart(deserialized);
@@ -304,6 +385,7 @@ Packet::RemoveHeader(Header& header)
 uint32_t
 Packet::PeekHeader(Header& header) const
 {
+    Materialize();
     uint32_t deserialized = header.Deserialize(m_buffer.Begin());
     NS_LOG_FUNCTION(this << header.GetInstanceTypeId().GetName() << deserialized);
     return deserialized;
@@ -312,6 +394,7 @@ Packet::PeekHeader(Header& header) const
 uint32_t
 Packet::PeekHeader(Header& header, uint32_t size) const
 {
+    Materialize();
     Buffer::Iterator end;
     end = m_buffer.Begin();
     end.Next(size);
@@ -335,6 +418,10 @@ Packet::AddTrailer(const Trailer& trailer)
 uint32_t
 Packet::RemoveTrailer(Trailer& trailer)
 {
+    if (m_buffer.GetSize() < trailer.GetSerializedSize())
+    {
+        Materialize();
+    }
     uint32_t deserialized = trailer.Deserialize(m_buffer.End());
     NS_LOG_FUNCTION(this << trailer.GetInstanceTypeId().GetName() << deserialized);
     m_buffer.RemoveAtEnd(deserialized);
@@ -345,6 +432,10 @@ Packet::RemoveTrailer(Trailer& trailer)
 uint32_t
 Packet::PeekTrailer(Trailer& trailer)
 {
+    if (m_buffer.GetSize() < trailer.GetSerializedSize())
+    {
+        Materialize();
+    }
     uint32_t deserialized = trailer.Deserialize(m_buffer.End());
     NS_LOG_FUNCTION(this << trailer.GetInstanceTypeId().GetName() << deserialized);
     return deserialized;
@@ -359,6 +450,7 @@ Packet::AddAtEnd(Ptr<const Packet> packet)
     copy.AddAtStart(0);
     copy.Adjust(GetSize());
     m_byteTagList.Add(copy);
+    packet->Materialize();
     m_buffer.AddAtEnd(packet->m_buffer);
     m_metadata.AddAtEnd(packet->m_metadata);
 }
@@ -376,6 +468,10 @@ void
 Packet::RemoveAtEnd(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
+    if (m_buffer.GetSize() < size)
+    {
+        Materialize();
+    }
     m_buffer.RemoveAtEnd(size);
     m_metadata.RemoveAtEnd(size);
 }
@@ -384,6 +480,7 @@ void
 Packet::RemoveAtStart(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
+    Materialize();
     m_buffer.RemoveAtStart(size);
     m_byteTagList.Adjust(-size);
     m_metadata.RemoveAtStart(size);
@@ -399,12 +496,14 @@ Packet::RemoveAllByteTags()
 uint32_t
 Packet::CopyData(uint8_t* buffer, uint32_t size) const
 {
+    Materialize();
     return m_buffer.CopyData(buffer, size);
 }
 
 void
 Packet::CopyData(std::ostream* os, uint32_t size) const
 {
+    Materialize();
     return m_buffer.CopyData(os, size);
 }
 
@@ -455,6 +554,7 @@ Packet::ToString() const
 void
 Packet::Print(std::ostream& os) const
 {
+    Materialize();
     PacketMetadata::ItemIterator i = m_metadata.BeginItem(m_buffer);
     while (i.HasNext())
     {
@@ -589,6 +689,7 @@ Packet::Print(std::ostream& os) const
 PacketMetadata::ItemIterator
 Packet::BeginItem() const
 {
+    Materialize();
     return m_metadata.BeginItem(m_buffer);
 }
 
@@ -606,9 +707,24 @@ Packet::EnableChecking()
     PacketMetadata::EnableChecking();
 }
 
+void
+Packet::EnableLazyHeaders()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    m_lazyHeadersEnabled = true;
+}
+
+void
+Packet::DisableLazyHeaders()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    m_lazyHeadersEnabled = false;
+}
+
 uint32_t
 Packet::GetSerializedSize() const
 {
+    Materialize();
     uint32_t size = 0;
 
     if (m_nixVector)
@@ -662,6 +778,7 @@ Packet::GetSerializedSize() const
 uint32_t
 Packet::Serialize(uint8_t* buffer, uint32_t maxSize) const
 {
+    Materialize();
     auto p = reinterpret_cast<uint32_t*>(buffer);
     uint32_t size = 0;
 
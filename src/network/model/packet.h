@@ -34,6 +34,8 @@
 #include "ns3/ptr.h"
 
 #include <stdint.h>
+#include <type_traits>
+#include <typeinfo>
 
 namespace ns3
 {
@@ -224,6 +226,9 @@ class PacketTagIterator
  * qos class id set by an application and processed by a lower-level MAC
  * layer.
  *
+ * - Optionally, the headers added to a packet can be kept as typed objects
+ * rather than serialized right away, see Packet::EnableLazyHeaders.
+ *
  * Implementing a new type of Header or Trailer for a new protocol is
  * pretty easy and is a matter of creating a subclass of the ns3::Header
  * or of the ns3::Trailer base class, and implementing the methods
@@ -235,7 +240,7 @@ class PacketTagIterator
  * The performance aspects copy-on-write semantics of the
  * Packet API are discussed in \ref packetperf
  */
-class Packet : public SimpleRefCount<Packet>
+class Packet : public SimpleRefCount<Packet, Empty, DefaultDeleter<Packet>, OwnedCounter>
 {
   public:
     /**
@@ -362,6 +367,42 @@ class Packet : public SimpleRefCount<Packet>
      * \returns the number of bytes read from the packet.
      */
     uint32_t PeekHeader(Header& header, uint32_t size) const;
+    /**
+     * \brief Add header to this packet.
+     *
+     * Same as AddHeader(const Header&), except that, if lazy headers are
+     * enabled, a copy of the header is kept on top of the packet rather than
+     * serialized in the buffer.
+     *
+     * \tparam T \deduced The type of the header.
+     * \param header a reference to the header to add to this packet.
+     */
+    template <typename T>
+    void AddHeader(const T& header);
+    /**
+     * \brief Remove the header from the internal buffer.
+     *
+     * Same as RemoveHeader(Header&), except that a lazy header of the same
+     * type on top of the packet is copied rather than deserialized.
+     *
+     * \tparam T \deduced The type of the header.
+     * \param header a reference to the header to remove from the internal buffer.
+     * \returns the number of bytes removed from the packet.
+     */
+    template <typename T>
+    uint32_t RemoveHeader(T& header);
+    /**
+     * \brief Read but does _not_ remove the header from the internal buffer.
+     *
+     * Same as PeekHeader(Header&), except that a lazy header of the same
+     * type on top of the packet is copied rather than deserialized.
+     *
+     * \tparam T \deduced The type of the header.
+     * \param header a reference to the header to read from the internal buffer.
+     * \returns the number of bytes read from the packet.
+     */
+    template <typename T>
+    uint32_t PeekHeader(T& header) const;
     /**
      * \brief Add trailer to this packet.
      *
@@ -459,6 +500,21 @@ class Packet : public SimpleRefCount<Packet>
      */
     Ptr<Packet> Copy() const;
 
+    /**
+     * \brief Prepare the packet to be used by another logical process.
+     *
+     * When built with NS3_MTP, the packets and their internal buffers are
+     * reference counted without atomic operations, as long as they are used
+     * by a single logical process.  A packet handed over to another logical
+     * process, e.g., by a channel, must be shared first: the buffers it
+     * shares with other packets, or the packet itself if it is still
+     * referenced elsewhere, are then reference counted atomically.  A packet
+     * which is not, such as a fresh copy, is handed over at no cost.
+     *
+     * Does nothing when not built with NS3_MTP.
+     */
+    void Share() const;
+
     /**
      * \brief Returns the packet's Uid.
      *
@@ -537,6 +593,29 @@ class Packet : public SimpleRefCount<Packet>
      */
     static void EnableChecking();
 
+    /**
+     * \brief Enable lazy headers.
+     *
+     * The headers added to a packet are then kept, up to a few of them, as
+     * typed objects on top of the packet buffer, rather than serialized in
+     * it.  Removing or peeking a header of the same type as the top one
+     * copies it instead of deserializing it, which saves the serialization
+     * and deserialization of the headers at each hop of forwarding-heavy
+     * simulations.  The headers are serialized in the buffer once their
+     * bytes are needed (e.g., to copy the packet data, for pcap traces,
+     * fragmentation or distributed simulations) or a header of another type
+     * is read.
+     *
+     * Since they are copied, the headers removed from a packet keep the
+     * fields which are not serialized (e.g., the state of their checksum)
+     * of the headers added to it.
+     */
+    static void EnableLazyHeaders();
+    /**
+     * \brief Disable lazy headers, for the headers added from now on.
+     */
+    static void DisableLazyHeaders();
+
     /**
      * \brief Returns number of bytes required for packet
      * serialization.
@@ -787,7 +866,95 @@ class Packet : public SimpleRefCount<Packet>
      */
     uint32_t Deserialize(const uint8_t* buffer, uint32_t size);
 
-    Buffer m_buffer;               //!< the packet buffer (it's actual contents)
+    /**
+     * \brief A header kept on top of a packet, not serialized yet.
+     *
+     * The lazy headers are not modified once added, hence they are shared
+     * by the copies of a packet.
+     */
+    class LazyHeader : public SimpleRefCount<LazyHeader>
+    {
+      public:
+        /**
+         * \brief Constructor
+         * \param size the serialized size of the header
+         */
+        LazyHeader(uint32_t size)
+            : m_size(size)
+        {
+        }
+
+        /** \brief Destructor */
+        virtual ~LazyHeader() = default;
+
+        /**
+         * \returns the header
+         */
+        virtual const Header& Get() const = 0;
+
+        uint32_t m_size; //!< the serialized size of the header
+    };
+
+    /**
+     * \brief A lazy header of a given type.
+     * \tparam T the type of the header
+     */
+    template <typename T>
+    class LazyHeaderOf : public LazyHeader
+    {
+      public:
+        /**
+         * \brief Constructor
+         * \param header the header
+         * \param size the serialized size of the header
+         */
+        LazyHeaderOf(const T& header, uint32_t size)
+            : LazyHeader(size),
+              m_header(header)
+        {
+        }
+
+        const Header& Get() const override
+        {
+            return m_header;
+        }
+
+        T m_header; //!< the header
+    };
+
+    /**
+     * \brief Add a lazy header on top of the packet.
+     * \param header the lazy header
+     */
+    void PushLazyHeader(Ptr<LazyHeader> header);
+
+    /**
+     * \brief Remove the lazy header on top of the packet.
+     * \returns the serialized size of the header
+     */
+    uint32_t PopLazyHeader();
+
+    /**
+     * \brief Get the lazy header on top of the packet, if of the given type.
+     * \tparam T the type of the header
+     * \returns the header, or nullptr if the top header is not a lazy
+     *          header of this type
+     */
+    template <typename T>
+    const T* PeekLazyHeader() const;
+
+    /**
+     * \brief Serialize the lazy headers in the packet buffer.
+     *
+     * This does not change the content of the packet, hence is allowed on
+     * a const packet.
+     */
+    void Materialize() const;
+
+    /** The maximum number of lazy headers of a packet. */
+    static constexpr uint8_t MAX_LAZY_HEADERS = 4;
+
+    mutable Buffer m_buffer;       //!< the packet buffer (it's actual contents)
     ByteTagList m_byteTagList;     //!< the ByteTag list
     PacketTagList m_packetTagList; //!< the packet's Tag list
     PacketMetadata m_metadata;     //!< the packet's metadata
@@ -795,7 +962,13 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-    static uint32_t m_globalUid; //!< Global counter of packets Uid
+    /// the lazy headers, from the innermost one, on top of the buffer
+    mutable Ptr<LazyHeader> m_lazyHeaders[MAX_LAZY_HEADERS];
+    mutable uint8_t m_nLazyHeaders{0}; //!< the number of lazy headers
+    mutable uint32_t m_lazySize{0};    //!< the serialized size of the lazy headers
+
+    static uint32_t m_globalUid;      //!< Global counter of packets Uid
+    static bool m_lazyHeadersEnabled; //!< whether headers are added lazily
 };
 
 /**
@@ -860,7 +1033,72 @@ namespace ns3
 uint32_t
 Packet::GetSize() const
 {
-    return m_buffer.GetSize();
+    return m_buffer.GetSize() + m_lazySize;
+}
+
+template <typename T>
+void
+Packet::AddHeader(const T& header)
+{
+    if constexpr (std::is_copy_constructible_v<T> && !std::is_abstract_v<T>)
+    {
+        if (m_lazyHeadersEnabled && typeid(header) == typeid(T))
+        {
+            // through Header, which some headers override privately
+            uint32_t size = static_cast<const Header&>(header).GetSerializedSize();
+            PushLazyHeader(Ptr<LazyHeader>(new LazyHeaderOf<T>(header, size), false));
+            return;
+        }
+    }
+    AddHeader(static_cast<const Header&>(header));
+}
+
+template <typename T>
+const T*
+Packet::PeekLazyHeader() const
+{
+    if (m_nLazyHeaders == 0)
+    {
+        return nullptr;
+    }
+    const LazyHeader* top = PeekPointer(m_lazyHeaders[m_nLazyHeaders - 1]);
+    if (typeid(*top) != typeid(LazyHeaderOf<T>))
+    {
+        return nullptr;
+    }
+    return &static_cast<const LazyHeaderOf<T>*>(top)->m_header;
+}
+
+template <typename T>
+uint32_t
+Packet::RemoveHeader(T& header)
+{
+    if constexpr (std::is_copy_assignable_v<T> && !std::is_abstract_v<T>)
+    {
+        const T* lazy = PeekLazyHeader<T>();
+        if (lazy && typeid(header) == typeid(T))
+        {
+            header = *lazy;
+            return PopLazyHeader();
+        }
+    }
+    return RemoveHeader(static_cast<Header&>(header));
+}
+
+template <typename T>
+uint32_t
+Packet::PeekHeader(T& header) const
+{
+    if constexpr (std::is_copy_assignable_v<T> && !std::is_abstract_v<T>)
+    {
+        const T* lazy = PeekLazyHeader<T>();
+        if (lazy && typeid(header) == typeid(T))
+        {
+            header = *lazy;
+            return m_lazyHeaders[m_nLazyHeaders - 1]->m_size;
+        }
+    }
+    return PeekHeader(static_cast<Header&>(header));
 }
 
 } // namespace ns3
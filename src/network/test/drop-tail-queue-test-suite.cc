@@ -16,9 +16,12 @@
  */
 
 #include "ns3/drop-tail-queue.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <deque>
+
 using namespace ns3;
 
 /**
@@ -87,6 +90,86 @@ DropTailQueueTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(packet, nullptr, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingBuffer unit tests, against std::deque.
+ */
+class RingBufferTestCase : public TestCase
+{
+  public:
+    RingBufferTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Check that the ring buffer has the elements of the reference.
+     * \param ring the ring buffer
+     * \param ref the reference
+     */
+    void Check(const RingBuffer<uint32_t>& ring, const std::deque<uint32_t>& ref);
+};
+
+RingBufferTestCase::RingBufferTestCase()
+    : TestCase("Check the ring buffer container")
+{
+}
+
+void
+RingBufferTestCase::Check(const RingBuffer<uint32_t>& ring, const std::deque<uint32_t>& ref)
+{
+    NS_TEST_ASSERT_MSG_EQ(ring.size(), ref.size(), "Wrong size");
+    auto it = ring.begin();
+    for (auto value : ref)
+    {
+        NS_TEST_ASSERT_MSG_EQ(*it, value, "Wrong element");
+        it++;
+    }
+    NS_TEST_ASSERT_MSG_EQ((it == ring.end()), true, "Wrong end");
+}
+
+void
+RingBufferTestCase::DoRun()
+{
+    RingBuffer<uint32_t> ring;
+    std::deque<uint32_t> ref;
+
+    // wrap around the array without growing it
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        ring.insert(ring.end(), i);
+        ref.push_back(i);
+        if (ring.size() > 5)
+        {
+            ring.erase(ring.begin());
+            ref.pop_front();
+        }
+    }
+    Check(ring, ref);
+    NS_TEST_EXPECT_MSG_EQ(ring.capacity(), 8, "Array grown");
+
+    // insert and erase everywhere, growing the array
+    uint32_t value = 1000;
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        std::size_t pos = (i * 7) % (ring.size() + 1);
+        auto it = ring.insert(ring.begin() + pos, value);
+        NS_TEST_EXPECT_MSG_EQ(*it, value, "Wrong iterator returned");
+        ref.insert(ref.begin() + pos, value++);
+        if (i % 3 == 0)
+        {
+            pos = (i * 5) % ring.size();
+            ring.erase(ring.begin() + pos);
+            ref.erase(ref.begin() + pos);
+        }
+        Check(ring, ref);
+    }
+
+    ring.clear();
+    NS_TEST_EXPECT_MSG_EQ(ring.empty(), true, "Container not cleared");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -100,6 +183,7 @@ class DropTailQueueTestSuite : public TestSuite
         : TestSuite("drop-tail-queue", UNIT)
     {
         AddTestCase(new DropTailQueueTestCase(), TestCase::QUICK);
+        AddTestCase(new RingBufferTestCase(), TestCase::QUICK);
     }
 };
 
@@ -26,6 +26,11 @@
 #include <iostream>
 #include <limits> // std:numeric_limits
 #include <string>
+#include <vector>
+
+#ifdef NS3_MTP
+#include <thread>
+#endif
 
 using namespace ns3;
 
@@ -958,6 +963,150 @@ PacketTest::DoRun()
     }
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Lazy headers unit tests.
+ */
+class LazyHeaderTest : public TestCase
+{
+  public:
+    LazyHeaderTest();
+    void DoRun() override;
+
+  private:
+    /**
+     * Checks that two packets have the same bytes
+     * \param p The packet
+     * \param ref The reference packet
+     * \param msg Message
+     */
+    void CheckData(Ptr<const Packet> p, Ptr<const Packet> ref, const char* msg);
+};
+
+LazyHeaderTest::LazyHeaderTest()
+    : TestCase("Lazy headers")
+{
+}
+
+void
+LazyHeaderTest::CheckData(Ptr<const Packet> p, Ptr<const Packet> ref, const char* msg)
+{
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), ref->GetSize(), msg);
+    std::vector<uint8_t> data(p->GetSize());
+    std::vector<uint8_t> refData(ref->GetSize());
+    p->CopyData(data.data(), data.size());
+    ref->CopyData(refData.data(), refData.size());
+    NS_TEST_EXPECT_MSG_EQ((data == refData), true, msg);
+}
+
+void
+LazyHeaderTest::DoRun()
+{
+    Ptr<Packet> eager = Create<Packet>(10);
+    eager->AddByteTag(ATestTag<1>());
+    eager->AddHeader(ATestHeader<2>());
+    eager->AddHeader(ATestHeader<3>());
+
+    Packet::EnableLazyHeaders();
+    Ptr<Packet> lazy = Create<Packet>(10);
+    lazy->AddByteTag(ATestTag<1>());
+    lazy->AddHeader(ATestHeader<2>());
+    lazy->AddHeader(ATestHeader<3>());
+    Packet::DisableLazyHeaders();
+    NS_TEST_EXPECT_MSG_EQ(lazy->GetSize(), 15, "Lazy headers not counted");
+
+    // the byte tags follow the bytes of the lazy headers
+    ByteTagIterator i = lazy->GetByteTagIterator();
+    NS_TEST_ASSERT_MSG_EQ(i.HasNext(), true, "Missing byte tag");
+    ByteTagIterator::Item item = i.Next();
+    NS_TEST_EXPECT_MSG_EQ(item.GetStart(), 5, "Byte tag not moved");
+    NS_TEST_EXPECT_MSG_EQ(item.GetEnd(), 15, "Byte tag not moved");
+
+    // headers of the same type are copied, the copies being left untouched
+    Ptr<Packet> copy = lazy->Copy();
+    ATestHeader<3> h3;
+    NS_TEST_EXPECT_MSG_EQ(copy->PeekHeader(h3), 3, "Wrong header size");
+    NS_TEST_EXPECT_MSG_EQ(copy->RemoveHeader(h3), 3, "Wrong header size");
+    NS_TEST_EXPECT_MSG_EQ(h3.m_error, false, "Wrong header");
+    NS_TEST_EXPECT_MSG_EQ(copy->GetSize(), 12, "Header not removed");
+    NS_TEST_EXPECT_MSG_EQ(lazy->GetSize(), 15, "Header removed from the original packet");
+
+    // other headers are deserialized from the bytes
+    ATestHeader<2> h2;
+    Header& header = h2;
+    NS_TEST_EXPECT_MSG_EQ(copy->RemoveHeader(header), 2, "Wrong header size");
+    NS_TEST_EXPECT_MSG_EQ(h2.m_error, false, "Wrong header bytes");
+    NS_TEST_EXPECT_MSG_EQ(copy->GetSize(), 10, "Header not removed");
+
+    // the bytes are those of the serialized headers
+    CheckData(lazy->CreateFragment(1, 8), eager->CreateFragment(1, 8), "Wrong fragment");
+    Ptr<Packet> concat = Create<Packet>(1);
+    concat->AddAtEnd(lazy);
+    Ptr<Packet> concatRef = Create<Packet>(1);
+    concatRef->AddAtEnd(eager);
+    CheckData(concat, concatRef, "Wrong concatenation");
+    CheckData(lazy, eager, "Wrong data");
+    NS_TEST_EXPECT_MSG_EQ(lazy->RemoveHeader(h3), 3, "Wrong header size");
+    NS_TEST_EXPECT_MSG_EQ(h3.m_error, false, "Wrong header bytes");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Shared packets unit tests.
+ */
+class PacketShareTest : public TestCase
+{
+  public:
+    PacketShareTest();
+    void DoRun() override;
+};
+
+PacketShareTest::PacketShareTest()
+    : TestCase("Packets shared by several threads")
+{
+}
+
+void
+PacketShareTest::DoRun()
+{
+    Ptr<Packet> p = Create<Packet>(10);
+    p->AddByteTag(ATestTag<1>());
+    p->AddPacketTag(ATestTag<2>());
+    p->AddHeader(ATestHeader<3>());
+    Ptr<Packet> copy = p->Copy();
+    copy->Share();
+    NS_TEST_EXPECT_MSG_EQ(copy->GetSize(), 13, "Packet changed when shared");
+
+#ifdef NS3_MTP
+    // the copies made by each thread reference the same buffers
+    const uint32_t n = 100000;
+    auto work = [&copy, n]() {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            Ptr<Packet> c = copy->Copy();
+            ATestHeader<3> h;
+            c->RemoveHeader(h);
+        }
+    };
+    std::thread thread(work);
+    work();
+    thread.join();
+    NS_TEST_EXPECT_MSG_EQ(copy->GetReferenceCount(), 1, "Wrong reference count");
+#endif
+
+    ATestHeader<3> h;
+    NS_TEST_EXPECT_MSG_EQ(copy->RemoveHeader(h), 3, "Wrong header size");
+    NS_TEST_EXPECT_MSG_EQ(h.m_error, false, "Wrong header bytes");
+    ATestTag<2> tag;
+    NS_TEST_EXPECT_MSG_EQ(copy->PeekPacketTag(tag), true, "Missing packet tag");
+    NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 13, "Original packet changed");
+    NS_TEST_EXPECT_MSG_EQ(p->GetReferenceCount(), 1, "Wrong reference count");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1284,6 +1433,8 @@ PacketTestSuite::PacketTestSuite()
     : TestSuite("packet", UNIT)
 {
     AddTestCase(new PacketTest, TestCase::QUICK);
+    AddTestCase(new LazyHeaderTest, TestCase::QUICK);
+    AddTestCase(new PacketShareTest, TestCase::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::QUICK);
 }
 
@@ -18,6 +18,7 @@
 #include "ns3/log.h"
 #include "ns3/pcap-file.h"
 #include "ns3/test.h"
+#include "ns3/trace-writer.h"
 
 #include <cstdio>
 #include <cstdlib>
@@ -1375,6 +1376,73 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that pcap files written through the
+ * TraceWriter are identical to the ones written directly.
+ */
+class TraceWriterTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param perLpFiles whether the TraceWriter uses per-LP files
+     */
+    TraceWriterTestCase(bool perLpFiles);
+
+  private:
+    void DoRun() override;
+
+    bool m_perLpFiles; //!< whether the TraceWriter uses per-LP files
+};
+
+TraceWriterTestCase::TraceWriterTestCase(bool perLpFiles)
+    : TestCase(std::string("Check that PcapFile writes through the TraceWriter") +
+               (perLpFiles ? " with per-LP files" : "")),
+      m_perLpFiles(perLpFiles)
+{
+}
+
+void
+TraceWriterTestCase::DoRun()
+{
+    std::string direct = CreateTempDirFilename("direct.pcap");
+    std::string async = CreateTempDirFilename("async.pcap");
+    PcapFile f;
+
+    f.Open(direct, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Open (" << direct << ") returns error");
+    f.Init(1, N_PACKET_BYTES);
+    for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+        const PacketEntry& p = knownPackets[i];
+        f.Write(p.tsSec, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+    }
+    f.Close();
+
+    TraceWriter::Enable(m_perLpFiles);
+    f.Open(async, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Open (" << async << ") returns error");
+    f.Init(1, N_PACKET_BYTES);
+    for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+        const PacketEntry& p = knownPackets[i];
+        f.Write(p.tsSec, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+        NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Write must not fail");
+    }
+    f.Close();
+    TraceWriter::Disable();
+
+    uint32_t sec(0);
+    uint32_t usec(0);
+    uint32_t packets(0);
+    bool diff = PcapFile::Diff(direct, async, sec, usec, packets);
+    NS_TEST_EXPECT_MSG_EQ(diff, false, "Files written with and without the TraceWriter differ");
+    NS_TEST_EXPECT_MSG_EQ(packets, N_KNOWN_PACKETS, "Unexpected number of packets");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1398,6 +1466,8 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new TraceWriterTestCase(false), TestCase::QUICK);
+    AddTestCase(new TraceWriterTestCase(true), TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
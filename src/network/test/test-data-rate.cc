@@ -22,6 +22,8 @@
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -269,6 +271,98 @@ DataRateTestCase2::DoRun()
     MultiplicationDoubleTest("6Gb/s", 1.0 / 7.0, "857142857.14b/s");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test the transmission times precomputed by TxTimeCalculator
+ *
+ */
+class DataRateTestCase3 : public DataRateTestCase
+{
+  public:
+    DataRateTestCase3();
+    /**
+     * Checks that the transmission times at a rate are the same as those
+     * calculated by DataRate
+     * \param rate the data rate
+     */
+    void TxTimeTest(DataRate rate);
+
+  private:
+    void DoRun() override;
+};
+
+DataRateTestCase3::DataRateTestCase3()
+    : DataRateTestCase("Test the precomputed transmission times")
+{
+}
+
+void
+DataRateTestCase3::TxTimeTest(DataRate rate)
+{
+    TxTimeCalculator calculator(rate);
+    CheckDataRateEqual(calculator.GetDataRate(), rate, "TxTimeCalculator returned wrong rate");
+
+    std::vector<uint32_t> sizes;
+    for (uint32_t size = 0; size <= 9000; size++)
+    {
+        sizes.push_back(size);
+    }
+    for (uint32_t size : {65535U, 1U << 20, (1U << 29) - 1, 1U << 29, UINT32_MAX})
+    {
+        sizes.push_back(size);
+    }
+    uint32_t random = 12345;
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        random = random * 1664525 + 1013904223;
+        sizes.push_back(random);
+        sizes.push_back(random >> 12);
+    }
+
+    uint32_t errors = 0;
+    for (uint32_t size : sizes)
+    {
+        if (calculator.CalculateBytesTxTime(size) != rate.CalculateBytesTxTime(size))
+        {
+            NS_TEST_EXPECT_MSG_EQ(calculator.CalculateBytesTxTime(size),
+                                  rate.CalculateBytesTxTime(size),
+                                  "Wrong transmission time of " << size << " bytes at " << rate);
+            errors++;
+        }
+        if (calculator.GetBitsTxTimeSteps(size) != rate.CalculateBitsTxTime(size).GetTimeStep())
+        {
+            NS_TEST_EXPECT_MSG_EQ(calculator.CalculateBitsTxTime(size),
+                                  rate.CalculateBitsTxTime(size),
+                                  "Wrong transmission time of " << size << " bits at " << rate);
+            errors++;
+        }
+        if (errors > 10)
+        {
+            break;
+        }
+    }
+}
+
+void
+DataRateTestCase3::DoRun()
+{
+    TxTimeTest(DataRate("1b/s"));
+    TxTimeTest(DataRate("3b/s"));
+    TxTimeTest(DataRate("32768b/s"));
+    TxTimeTest(DataRate("56kbps"));
+    TxTimeTest(DataRate("5Mbps"));
+    TxTimeTest(DataRate("8Kib/s"));
+    TxTimeTest(DataRate("1Gbps"));
+    TxTimeTest(DataRate("10Gbps"));
+    TxTimeTest(DataRate("100Gbps"));
+    TxTimeTest(DataRate("400Gbps"));
+    TxTimeTest(DataRate("6Gb/s") * (1.0 / 7.0));
+    TxTimeTest(DataRate(999999937));
+    TxTimeTest(DataRate(uint64_t(1) << 62));
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -286,6 +380,7 @@ DataRateTestSuite::DataRateTestSuite()
 {
     AddTestCase(new DataRateTestCase1(), TestCase::QUICK);
     AddTestCase(new DataRateTestCase2(), TestCase::QUICK);
+    AddTestCase(new DataRateTestCase3(), TestCase::QUICK);
 }
 
 static DataRateTestSuite sDataRateTestSuite; //!< Static variable for test initialization
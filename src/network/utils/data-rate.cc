@@ -23,6 +23,8 @@
 #include "ns3/log.h"
 #include "ns3/nstime.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -308,6 +310,74 @@ DataRate::GetBitRate() const
     return m_bps;
 }
 
+TxTimeCalculator::TxTimeCalculator()
+    : TxTimeCalculator(DataRate())
+{
+}
+
+TxTimeCalculator::TxTimeCalculator(DataRate rate)
+{
+    SetDataRate(rate);
+}
+
+void
+TxTimeCalculator::SetDataRate(DataRate rate)
+{
+    NS_LOG_FUNCTION(this << rate);
+    m_rate = rate;
+    m_unit = Time::GetResolution();
+    m_fast = false;
+    m_perBitHi = 0;
+    m_perBitLo = 0;
+    m_maxBits = 0;
+#ifdef INT64X64_USE_128
+    // Seconds() multiplies by an integer number of steps per second only
+    // if the resolution is at most a second
+    uint64_t bps = rate.GetBitRate();
+    if (bps > 0 && bps <= static_cast<uint64_t>(INT64_MAX) && m_unit >= Time::S)
+    {
+        auto stepsPerSecond = static_cast<uint64_t>(Seconds(1).GetTimeStep());
+        uint128_t perBit = (static_cast<uint128_t>(stepsPerSecond) << 64) / bps;
+        // the rounded product must not overflow
+        uint128_t maxBits = (~uint128_t(0) >> 1) / perBit;
+        m_perBitHi = static_cast<uint64_t>(perBit >> 64);
+        m_perBitLo = static_cast<uint64_t>(perBit);
+        m_maxBits = static_cast<uint32_t>(std::min<uint128_t>(maxBits, UINT32_MAX));
+        m_fast = true;
+    }
+#endif
+}
+
+DataRate
+TxTimeCalculator::GetDataRate() const
+{
+    return m_rate;
+}
+
+int64_t
+TxTimeCalculator::GetBitsTxTimeSteps(uint32_t bits) const
+{
+#ifdef INT64X64_USE_128
+    if (m_fast && bits <= m_maxBits && Time::GetResolution() == m_unit)
+    {
+        // CalculateBitsTxTime rounds q * steps, with q = bits / bps in 64.64
+        // truncated.  The truncations of q and of the reciprocal keep both
+        // products under the exact one by less than the steps per second
+        // and the bits, both below 2^50.  So the roundings only differ near
+        // a boundary, which is left to the exact calculation.
+        const uint64_t margin = uint64_t(1) << 50;
+        uint128_t perBit = (static_cast<uint128_t>(m_perBitHi) << 64) | m_perBitLo;
+        uint128_t product = perBit * bits + (uint128_t(1) << 63);
+        auto fraction = static_cast<uint64_t>(product);
+        if (fraction >= margin && fraction <= ~margin)
+        {
+            return static_cast<int64_t>(product >> 64);
+        }
+    }
+#endif
+    return m_rate.CalculateBitsTxTime(bits).GetTimeStep();
+}
+
 DataRate::DataRate(std::string rate)
 {
     NS_LOG_FUNCTION(this << rate);
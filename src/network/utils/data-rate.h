@@ -314,6 +314,95 @@ double operator*(const DataRate& lhs, const Time& rhs);
  */
 double operator*(const Time& lhs, const DataRate& rhs);
 
+/**
+ * \ingroup datarate
+ * \brief Transmission times at a data rate, precomputed for the hot paths
+ *
+ * DataRate::CalculateBytesTxTime divides and multiplies int64x64_t values
+ * for each packet.  This class precomputes, when the rate is set, the time
+ * steps per bit as a 64.64 fixed-point reciprocal of the rate, so that a
+ * transmission time costs a multiplication.  The result is the same time
+ * step as DataRate::CalculateBytesTxTime: when the product falls too close
+ * to a rounding boundary, or when the rate or the time resolution are out
+ * of the range of the fixed-point value, the time is calculated by the
+ * DataRate instead.
+ *
+ * A device keeps one, updated when its data rate is set:
+ * \code
+ *   m_txTime.SetDataRate(bps);
+ *   ...
+ *   Time txTime = m_txTime.CalculateBytesTxTime(p->GetSize());
+ * \endcode
+ */
+class TxTimeCalculator
+{
+  public:
+    TxTimeCalculator();
+    /**
+     * \brief Precompute the transmission times at a data rate
+     * \param rate the data rate
+     */
+    explicit TxTimeCalculator(DataRate rate);
+
+    /**
+     * \brief Precompute the transmission times at a data rate
+     * \param rate the data rate
+     */
+    void SetDataRate(DataRate rate);
+
+    /**
+     * \return the data rate
+     */
+    DataRate GetDataRate() const;
+
+    /**
+     * \brief Calculate transmission time in time steps
+     * \param bits The number of bits (not bytes) for which to calculate
+     * \return The transmission time for the number of bits specified, in
+     * time steps of the current resolution
+     */
+    int64_t GetBitsTxTimeSteps(uint32_t bits) const;
+
+    /**
+     * \brief Calculate transmission time in time steps
+     * \param bytes The number of bytes (not bits) for which to calculate
+     * \return The transmission time for the number of bytes specified, in
+     * time steps of the current resolution
+     */
+    int64_t GetBytesTxTimeSteps(uint32_t bytes) const
+    {
+        return GetBitsTxTimeSteps(bytes * 8);
+    }
+
+    /**
+     * \brief Calculate transmission time
+     * \param bits The number of bits (not bytes) for which to calculate
+     * \return The transmission time for the number of bits specified
+     */
+    Time CalculateBitsTxTime(uint32_t bits) const
+    {
+        return TimeStep(GetBitsTxTimeSteps(bits));
+    }
+
+    /**
+     * \brief Calculate transmission time
+     * \param bytes The number of bytes (not bits) for which to calculate
+     * \return The transmission time for the number of bytes specified
+     */
+    Time CalculateBytesTxTime(uint32_t bytes) const
+    {
+        return TimeStep(GetBytesTxTimeSteps(bytes));
+    }
+
+  private:
+    DataRate m_rate;     //!< The data rate
+    Time::Unit m_unit;   //!< The time resolution of the fixed-point values
+    bool m_fast;         //!< Whether the fixed-point values are usable
+    uint64_t m_perBitHi; //!< Integer part of the time steps per bit
+    uint64_t m_perBitLo; //!< Fractional part of the time steps per bit, in 2^-64
+    uint32_t m_maxBits;  //!< Largest number of bits for the fixed-point values
+};
+
 namespace TracedValueCallback
 {
 
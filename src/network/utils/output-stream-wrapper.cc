@@ -17,6 +17,8 @@
 
 #include "output-stream-wrapper.h"
 
+#include "trace-writer.h"
+
 #include "ns3/abort.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/log.h"
@@ -39,11 +41,13 @@ OutputStreamWrapper::OutputStreamWrapper(std::string filename, std::ios::openmod
     NS_ABORT_MSG_UNLESS(os->is_open(),
                         "AsciiTraceHelper::CreateFileStream():  "
                             << "Unable to Open " << filename << " for mode " << filemode);
+    m_traceStream = TraceWriter::Register(m_ostream, filename);
 }
 
 OutputStreamWrapper::OutputStreamWrapper(std::ostream* os)
     : m_ostream(os),
-      m_destroyable(false)
+      m_destroyable(false),
+      m_traceStream(0)
 {
     NS_LOG_FUNCTION(this << os);
     FatalImpl::RegisterStream(m_ostream);
@@ -53,6 +57,7 @@ OutputStreamWrapper::OutputStreamWrapper(std::ostream* os)
 OutputStreamWrapper::~OutputStreamWrapper()
 {
     NS_LOG_FUNCTION(this);
+    TraceWriter::Unregister(m_traceStream);
     FatalImpl::UnregisterStream(m_ostream);
     if (m_destroyable)
     {
@@ -65,6 +70,16 @@ std::ostream*
 OutputStreamWrapper::GetStream()
 {
     NS_LOG_FUNCTION(this);
+    if (m_traceStream != 0)
+    {
+        std::ostream* os = TraceWriter::GetStream(m_traceStream);
+        if (os != nullptr)
+        {
+            return os;
+        }
+        // the TraceWriter was disabled, write the stream directly from now on
+        m_traceStream = 0;
+    }
     return m_ostream;
 }
 
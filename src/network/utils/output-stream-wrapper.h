@@ -64,6 +64,10 @@ namespace ns3
  *   }
  * \endverbatim
  *
+ * If the TraceWriter is enabled when a wrapper is created from a file name,
+ * GetStream() returns a stream owned by the current logical process, and
+ * each flushed line (e.g., ended with std::endl) is written to the file
+ * asynchronously by the TraceWriter.
  *
  * This class uses a basic ns-3 reference counting base class but is not
  * an ns3::Object with attributes, TypeId, or aggregation.
@@ -96,6 +100,7 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
   private:
     std::ostream* m_ostream; //!< The output stream
     bool m_destroyable;      //!< Can be destroyed
+    uint32_t m_traceStream;  //!< TraceWriter stream, 0 if the stream is written directly
 };
 
 } // namespace ns3
@@ -19,6 +19,8 @@
 
 #include "pcap-file.h"
 
+#include "trace-writer.h"
+
 #include "ns3/assert.h"
 #include "ns3/buffer.h"
 #include "ns3/build-profile.h"
@@ -54,7 +56,8 @@ const uint16_t VERSION_MINOR = 4; /**< Minor version of supported pcap file form
 PcapFile::PcapFile()
     : m_file(),
       m_swapMode(false),
-      m_nanosecMode(false)
+      m_nanosecMode(false),
+      m_traceStream(0)
 {
     NS_LOG_FUNCTION(this);
     FatalImpl::RegisterStream(&m_file);
@@ -92,6 +95,8 @@ void
 PcapFile::Close()
 {
     NS_LOG_FUNCTION(this);
+    TraceWriter::Unregister(m_traceStream);
+    m_traceStream = 0;
     m_file.close();
 }
 
@@ -407,6 +412,12 @@ PcapFile::Init(uint32_t dataLinkType,
     m_swapMode = swapMode || bigEndian;
 
     WriteFileHeader();
+
+    //
+    // The packet records may be written asynchronously from now on.
+    //
+    TraceWriter::Unregister(m_traceStream);
+    m_traceStream = TraceWriter::Register(&m_file, m_filename);
 }
 
 uint32_t
@@ -440,11 +451,62 @@ PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     return inclLen;
 }
 
+uint8_t*
+PcapFile::ReserveRecord(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t& inclLen)
+{
+    NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen);
+    if (m_traceStream == 0)
+    {
+        return nullptr;
+    }
+
+    inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+    int64_t timestamp = int64_t(tsSec) * 1000000000 + (m_nanosecMode ? tsUsec : tsUsec * 1000);
+    uint8_t* record = TraceWriter::Reserve(m_traceStream,
+                                           timestamp,
+                                           sizeof(PcapRecordHeader) + inclLen);
+    if (record == nullptr)
+    {
+        // the TraceWriter was disabled, write the file directly from now on
+        m_traceStream = 0;
+        return nullptr;
+    }
+
+    PcapRecordHeader header;
+    header.m_tsSec = tsSec;
+    header.m_tsUsec = tsUsec;
+    header.m_inclLen = inclLen;
+    header.m_origLen = totalLen;
+
+    if (m_swapMode)
+    {
+        Swap(&header, &header);
+    }
+
+    //
+    // Copy the fields individually, as the file layout has no padding.
+    //
+    std::memcpy(record, &header.m_tsSec, sizeof(header.m_tsSec));
+    std::memcpy(record + 4, &header.m_tsUsec, sizeof(header.m_tsUsec));
+    std::memcpy(record + 8, &header.m_inclLen, sizeof(header.m_inclLen));
+    std::memcpy(record + 12, &header.m_origLen, sizeof(header.m_origLen));
+    return record + 16;
+}
+
 void
 PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const uint8_t* const data, uint32_t totalLen)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &data << totalLen);
-    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalLen);
+    uint32_t inclLen;
+    uint8_t* record = ReserveRecord(tsSec, tsUsec, totalLen, inclLen);
+    if (record != nullptr)
+    {
+        std::memcpy(record, data, inclLen);
+        TraceWriter::Commit();
+        return;
+    }
+
+    inclLen = WritePacketHeader(tsSec, tsUsec, totalLen);
     m_file.write((const char*)data, inclLen);
     NS_BUILD_DEBUG(m_file.flush());
 }
@@ -453,7 +515,16 @@ void
 PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << p);
-    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize());
+    uint32_t inclLen;
+    uint8_t* record = ReserveRecord(tsSec, tsUsec, p->GetSize(), inclLen);
+    if (record != nullptr)
+    {
+        p->CopyData(record, inclLen);
+        TraceWriter::Commit();
+        return;
+    }
+
+    inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize());
     p->CopyData(&m_file, inclLen);
     NS_BUILD_DEBUG(m_file.flush());
 }
@@ -464,11 +535,23 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const Header& header, Ptr<const
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &header << p);
     uint32_t headerSize = header.GetSerializedSize();
     uint32_t totalSize = headerSize + p->GetSize();
-    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalSize);
 
     Buffer headerBuffer;
     headerBuffer.AddAtStart(headerSize);
     header.Serialize(headerBuffer.Begin());
+
+    uint32_t inclLen;
+    uint8_t* record = ReserveRecord(tsSec, tsUsec, totalSize, inclLen);
+    if (record != nullptr)
+    {
+        uint32_t toCopy = std::min(headerSize, inclLen);
+        headerBuffer.CopyData(record, toCopy);
+        p->CopyData(record + toCopy, inclLen - toCopy);
+        TraceWriter::Commit();
+        return;
+    }
+
+    inclLen = WritePacketHeader(tsSec, tsUsec, totalSize);
     uint32_t toCopy = std::min(headerSize, inclLen);
     headerBuffer.CopyData(&m_file, toCopy);
     inclLen -= toCopy;
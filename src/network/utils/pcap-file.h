@@ -368,6 +368,21 @@ class PcapFile
      */
     uint32_t WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
 
+    /**
+     * \brief Reserve a packet record in the TraceWriter, if the file is
+     * written by it, and fill in the record header.
+     *
+     * The record must be completed with TraceWriter::Commit().
+     *
+     * \param tsSec Time stamp (seconds part)
+     * \param tsUsec Time stamp (microseconds part)
+     * \param totalLen Total packet length
+     * \param inclLen Number of bytes of packet data to copy in the record
+     * \returns the packet data of the record, or nullptr if the file is
+     * written directly
+     */
+    uint8_t* ReserveRecord(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t& inclLen);
+
     /**
      * \brief Read and verify a Pcap file header
      */
@@ -378,6 +393,7 @@ class PcapFile
     PcapFileHeader m_fileHeader; //!< file header
     bool m_swapMode;             //!< swap mode
     bool m_nanosecMode;          //!< nanosecond timestamp mode
+    uint32_t m_traceStream;      //!< TraceWriter stream, 0 if the file is written directly
 };
 
 } // namespace ns3
@@ -0,0 +1,516 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "ns3/assert.h"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup queue
+ * ns3::RingBuffer declaration and implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup queue
+ *
+ * \brief A sequence container storing its elements in a circular array.
+ *
+ * The elements are stored contiguously, modulo the capacity of the array,
+ * which doubles whenever the container is full and is kept otherwise, so
+ * that a queue which reached its maximum size no longer allocates memory.
+ * Inserting or erasing an element at either end takes constant time; in
+ * the middle, the elements between the position and the nearest end are
+ * moved.  As for std::deque, an insertion or an erasure invalidates the
+ * iterators; the iterator returned by insert() and erase() is valid.
+ *
+ * This is the default container of ns3::Queue, see queue-fwd.h.
+ *
+ * \tparam T \explicit The type of the elements, which must be default
+ *         constructible; the slots of the array not in use hold a default
+ *         constructed element, e.g., a null pointer.
+ */
+template <typename T>
+class RingBuffer
+{
+  private:
+    /**
+     * Random access iterator over the elements of the container.
+     *
+     * \tparam IsConst \explicit Whether the elements are read-only.
+     */
+    template <bool IsConst>
+    class IteratorBase
+    {
+      public:
+        /// The container type.
+        using Ring = std::conditional_t<IsConst, const RingBuffer, RingBuffer>;
+        /// Iterator category.
+        using iterator_category = std::random_access_iterator_tag;
+        /// Element type.
+        using value_type = T;
+        /// Difference type.
+        using difference_type = std::ptrdiff_t;
+        /// Pointer type.
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        /// Reference type.
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        IteratorBase() = default;
+
+        /**
+         * Constructor.
+         *
+         * \param ring the container
+         * \param index the index of the element, from the front
+         */
+        IteratorBase(Ring* ring, std::size_t index)
+            : m_ring(ring),
+              m_index(index)
+        {
+        }
+
+        /**
+         * Conversion from an iterator to a const iterator.
+         *
+         * \tparam C \deduced Whether the iterator converted is const.
+         * \param o the iterator
+         */
+        template <bool C, typename = std::enable_if_t<IsConst && !C>>
+        IteratorBase(const IteratorBase<C>& o)
+            : m_ring(o.m_ring),
+              m_index(o.m_index)
+        {
+        }
+
+        /** \return the element */
+        reference operator*() const
+        {
+            return m_ring->Slot(m_index);
+        }
+
+        /** \return a pointer to the element */
+        pointer operator->() const
+        {
+            return &m_ring->Slot(m_index);
+        }
+
+        /**
+         * \param n the offset
+         * \return the element at the given offset
+         */
+        reference operator[](difference_type n) const
+        {
+            return m_ring->Slot(m_index + n);
+        }
+
+        /** \return the incremented iterator */
+        IteratorBase& operator++()
+        {
+            m_index++;
+            return *this;
+        }
+
+        /** \return the iterator before incrementing */
+        IteratorBase operator++(int)
+        {
+            IteratorBase it = *this;
+            m_index++;
+            return it;
+        }
+
+        /** \return the decremented iterator */
+        IteratorBase& operator--()
+        {
+            m_index--;
+            return *this;
+        }
+
+        /** \return the iterator before decrementing */
+        IteratorBase operator--(int)
+        {
+            IteratorBase it = *this;
+            m_index--;
+            return it;
+        }
+
+        /**
+         * \param n the offset
+         * \return the iterator
+         */
+        IteratorBase& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        /**
+         * \param n the offset
+         * \return the iterator
+         */
+        IteratorBase& operator-=(difference_type n)
+        {
+            m_index -= n;
+            return *this;
+        }
+
+        /**
+         * \param n the offset
+         * \return the iterator at the given offset
+         */
+        IteratorBase operator+(difference_type n) const
+        {
+            return IteratorBase(m_ring, m_index + n);
+        }
+
+        /**
+         * \param n the offset
+         * \return the iterator at the given offset
+         */
+        IteratorBase operator-(difference_type n) const
+        {
+            return IteratorBase(m_ring, m_index - n);
+        }
+
+        /**
+         * \param o another iterator over the same container
+         * \return the distance between the iterators
+         */
+        difference_type operator-(const IteratorBase& o) const
+        {
+            return static_cast<difference_type>(m_index) - static_cast<difference_type>(o.m_index);
+        }
+
+        /**
+         * \param o another iterator
+         * \return true if both iterators point to the same element
+         */
+        bool operator==(const IteratorBase& o) const
+        {
+            return m_index == o.m_index && m_ring == o.m_ring;
+        }
+
+        /**
+         * \param o another iterator
+         * \return true if the iterators point to different elements
+         */
+        bool operator!=(const IteratorBase& o) const
+        {
+            return !(*this == o);
+        }
+
+        /**
+         * \param o another iterator over the same container
+         * \return true if this iterator is before the other one
+         */
+        bool operator<(const IteratorBase& o) const
+        {
+            return m_index < o.m_index;
+        }
+
+      private:
+        friend class RingBuffer;
+        template <bool>
+        friend class IteratorBase;
+
+        Ring* m_ring{nullptr};  //!< the container
+        std::size_t m_index{0}; //!< the index of the element, from the front
+    };
+
+  public:
+    /// Element type.
+    using value_type = T;
+    /// Size type.
+    using size_type = std::size_t;
+    /// Iterator.
+    using iterator = IteratorBase<false>;
+    /// Const iterator.
+    using const_iterator = IteratorBase<true>;
+
+    /** \return an iterator to the first element */
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    /** \return an iterator past the last element */
+    iterator end()
+    {
+        return iterator(this, m_size);
+    }
+
+    /** \return a const iterator to the first element */
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /** \return a const iterator past the last element */
+    const_iterator end() const
+    {
+        return const_iterator(this, m_size);
+    }
+
+    /** \return the number of elements */
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    /** \return true if the container has no element */
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /** \return the number of elements which can be stored without allocating memory */
+    size_type capacity() const
+    {
+        return m_slots.size();
+    }
+
+    /**
+     * Make room for a number of elements.
+     *
+     * \param n the number of elements
+     */
+    void reserve(size_type n)
+    {
+        if (n > m_slots.size())
+        {
+            Grow(n);
+        }
+    }
+
+    /** \return the first element */
+    T& front()
+    {
+        NS_ASSERT(m_size > 0);
+        return m_slots[m_head];
+    }
+
+    /** \return the first element */
+    const T& front() const
+    {
+        NS_ASSERT(m_size > 0);
+        return m_slots[m_head];
+    }
+
+    /** \return the last element */
+    T& back()
+    {
+        NS_ASSERT(m_size > 0);
+        return Slot(m_size - 1);
+    }
+
+    /** \return the last element */
+    const T& back() const
+    {
+        NS_ASSERT(m_size > 0);
+        return Slot(m_size - 1);
+    }
+
+    /**
+     * Append an element.
+     *
+     * \param value the element
+     */
+    void push_back(T value)
+    {
+        if (m_size == m_slots.size())
+        {
+            Grow(m_size + 1);
+        }
+        Slot(m_size) = std::move(value);
+        m_size++;
+    }
+
+    /**
+     * Prepend an element.
+     *
+     * \param value the element
+     */
+    void push_front(T value)
+    {
+        if (m_size == m_slots.size())
+        {
+            Grow(m_size + 1);
+        }
+        m_head = (m_head + m_mask) & m_mask;
+        m_slots[m_head] = std::move(value);
+        m_size++;
+    }
+
+    /** Remove the first element. */
+    void pop_front()
+    {
+        NS_ASSERT(m_size > 0);
+        m_slots[m_head] = T();
+        m_head = (m_head + 1) & m_mask;
+        m_size--;
+    }
+
+    /** Remove the last element. */
+    void pop_back()
+    {
+        NS_ASSERT(m_size > 0);
+        m_size--;
+        Slot(m_size) = T();
+    }
+
+    /**
+     * Insert an element.
+     *
+     * \param pos the position before which the element is inserted
+     * \param value the element
+     * \return an iterator to the element inserted
+     */
+    iterator insert(const_iterator pos, T value)
+    {
+        NS_ASSERT(pos.m_ring == this && pos.m_index <= m_size);
+        std::size_t index = pos.m_index;
+        if (index == m_size)
+        {
+            push_back(std::move(value));
+        }
+        else if (index == 0)
+        {
+            push_front(std::move(value));
+        }
+        else if (index < m_size / 2)
+        {
+            // move the elements before the position one slot to the front
+            push_front(T());
+            for (std::size_t i = 0; i < index; i++)
+            {
+                Slot(i) = std::move(Slot(i + 1));
+            }
+            Slot(index) = std::move(value);
+        }
+        else
+        {
+            // move the elements after the position one slot to the back
+            push_back(T());
+            for (std::size_t i = m_size - 1; i > index; i--)
+            {
+                Slot(i) = std::move(Slot(i - 1));
+            }
+            Slot(index) = std::move(value);
+        }
+        return iterator(this, index);
+    }
+
+    /**
+     * Erase an element.
+     *
+     * \param pos the position of the element
+     * \return an iterator to the element which followed the one erased
+     */
+    iterator erase(const_iterator pos)
+    {
+        NS_ASSERT(pos.m_ring == this && pos.m_index < m_size);
+        std::size_t index = pos.m_index;
+        if (index < m_size / 2)
+        {
+            // move the elements before the position one slot to the back
+            for (std::size_t i = index; i > 0; i--)
+            {
+                Slot(i) = std::move(Slot(i - 1));
+            }
+            pop_front();
+        }
+        else
+        {
+            // move the elements after the position one slot to the front
+            for (std::size_t i = index; i + 1 < m_size; i++)
+            {
+                Slot(i) = std::move(Slot(i + 1));
+            }
+            pop_back();
+        }
+        return iterator(this, index);
+    }
+
+    /** Remove all the elements, keeping the capacity. */
+    void clear()
+    {
+        while (m_size > 0)
+        {
+            pop_back();
+        }
+        m_head = 0;
+    }
+
+  private:
+    /**
+     * \param index the index of an element, from the front
+     * \return the slot of the element
+     */
+    T& Slot(std::size_t index)
+    {
+        return m_slots[(m_head + index) & m_mask];
+    }
+
+    /**
+     * \param index the index of an element, from the front
+     * \return the slot of the element
+     */
+    const T& Slot(std::size_t index) const
+    {
+        return m_slots[(m_head + index) & m_mask];
+    }
+
+    /**
+     * Reallocate the array, with the smallest power of 2 capacity fitting
+     * the given number of elements, the elements being moved to the front.
+     *
+     * \param n the number of elements
+     */
+    void Grow(std::size_t n)
+    {
+        std::size_t capacity = m_slots.empty() ? 8 : m_slots.size();
+        while (capacity < n)
+        {
+            capacity *= 2;
+        }
+        std::vector<T> slots(capacity);
+        for (std::size_t i = 0; i < m_size; i++)
+        {
+            slots[i] = std::move(Slot(i));
+        }
+        m_slots.swap(slots);
+        m_head = 0;
+        m_mask = capacity - 1;
+    }
+
+    std::vector<T> m_slots; //!< the circular array, whose size is a power of 2
+    std::size_t m_head{0};  //!< the slot of the first element
+    std::size_t m_size{0};  //!< the number of elements
+    std::size_t m_mask{0};  //!< the size of the array minus one
+};
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_H */
@@ -0,0 +1,777 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "trace-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TraceWriter");
+
+namespace
+{
+
+/// Size of the per-LP record buffers
+constexpr std::size_t CHUNK_SIZE = 256 * 1024;
+
+/// Amount of data gathered for a file before it is written out
+constexpr std::size_t WRITE_SIZE = 1024 * 1024;
+
+/// Header of a record in a record buffer
+struct RecordHeader
+{
+    int64_t timestamp; //!< record timestamp, in nanoseconds
+    uint32_t stream;   //!< stream identifier
+    uint32_t size;     //!< record size, not including the header and padding
+};
+
+/**
+ * \param size a record size
+ * \returns the space taken by the record in a buffer, keeping the headers aligned
+ */
+inline std::size_t
+RecordSpace(uint32_t size)
+{
+    return sizeof(RecordHeader) + ((size + 7) & ~std::size_t(7));
+}
+
+/// A buffer of records produced by one LP
+struct Chunk
+{
+    Chunk* next{nullptr};                 //!< next chunk in the I/O queue
+    uint32_t lp{0};                       //!< LP that produced the records
+    std::promise<void>* flushed{nullptr}; //!< if not null, a flush marker to fulfill
+    std::size_t used{0};                  //!< bytes used
+    std::size_t capacity{0};              //!< bytes available
+    std::unique_ptr<uint8_t[]> data;      //!< the records
+};
+
+/// Text stream queueing one record per flush
+class TraceStreamBuf : public std::streambuf
+{
+  public:
+    /**
+     * Constructor
+     * \param stream the stream identifier
+     */
+    TraceStreamBuf(uint32_t stream)
+        : m_stream(stream)
+    {
+    }
+
+    /**
+     * Take the text not flushed yet
+     * \param text the text
+     * \param timestamp the time the text started to be written
+     */
+    void TakePending(std::string& text, int64_t& timestamp)
+    {
+        text.swap(m_pending);
+        m_pending.clear();
+        timestamp = m_timestamp;
+    }
+
+  protected:
+    int sync() override
+    {
+        if (!m_pending.empty())
+        {
+            TraceWriter::Write(m_stream, m_timestamp, m_pending.data(), m_pending.size());
+            m_pending.clear();
+        }
+        return 0;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            Stamp();
+            m_pending.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        Stamp();
+        m_pending.append(s, n);
+        return n;
+    }
+
+  private:
+    /// Stamp the pending text with the current time, if it is empty
+    void Stamp()
+    {
+        if (m_pending.empty())
+        {
+            m_timestamp = Simulator::Now().GetNanoSeconds();
+        }
+    }
+
+    uint32_t m_stream;      //!< stream identifier
+    std::string m_pending;  //!< text not flushed yet
+    int64_t m_timestamp{0}; //!< time the pending text started to be written
+};
+
+/// A per-LP text stream, see TraceWriter::GetStream()
+struct TraceStreamProxy
+{
+    /**
+     * Constructor
+     * \param stream the stream identifier
+     */
+    TraceStreamProxy(uint32_t stream)
+        : buf(stream),
+          os(&buf)
+    {
+    }
+
+    TraceStreamBuf buf; //!< the stream buffer
+    std::ostream os;    //!< the stream
+};
+
+/// The record buffer and text streams of one LP
+struct Producer
+{
+    uint32_t lp{0};                                                //!< the LP
+    std::atomic<bool> lock{false};                                 //!< producer lock
+    Chunk* current{nullptr};                                       //!< buffer being filled
+    std::map<uint32_t, std::unique_ptr<TraceStreamProxy>> streams; //!< text streams
+};
+
+/// A temporary file holding the records of one LP
+struct LpFile
+{
+    std::string name;    //!< file name
+    std::ofstream file;  //!< the file
+    std::string staging; //!< data not written yet
+};
+
+/// A stream written by the I/O thread
+struct StreamState
+{
+    std::ostream* os{nullptr};                           //!< the stream
+    std::string filename;                                //!< the file behind the stream
+    bool perLp{false};                                   //!< whether to use per-LP files
+    std::string staging;                                 //!< data not written yet
+    std::map<uint32_t, std::unique_ptr<LpFile>> lpFiles; //!< per-LP files
+};
+
+/// State shared by the producers and the I/O thread
+struct TraceWriterState
+{
+    ~TraceWriterState()
+    {
+        // records still buffered at exit are lost unless Disable() was called
+        if (ioThread.joinable())
+        {
+            stop.store(true, std::memory_order_release);
+            wakeup.notify_one();
+            ioThread.join();
+        }
+    }
+
+    std::atomic<bool> enabled{false};    //!< whether the writer is enabled
+    bool perLpFiles{false};              //!< whether new streams use per-LP files
+    std::atomic<uint64_t> generation{0}; //!< incremented when the producers are deleted
+    std::atomic<Chunk*> queue{nullptr};  //!< lock-free LIFO of chunks to write
+    std::atomic<bool> stop{false};       //!< tells the I/O thread to exit
+    std::thread ioThread;                //!< the I/O thread
+    std::mutex wakeupMutex;              //!< mutex of wakeup
+    std::condition_variable wakeup;      //!< wakes up the I/O thread
+
+    std::mutex producersMutex;                               //!< protects producers
+    std::map<uint32_t, std::unique_ptr<Producer>> producers; //!< producers by LP
+
+    std::mutex streamsMutex;                                  //!< protects streams
+    std::map<uint32_t, std::unique_ptr<StreamState>> streams; //!< streams by identifier
+    uint32_t lastStream{0};                                   //!< last stream identifier
+};
+
+/// \returns the TraceWriter state
+TraceWriterState&
+State()
+{
+    static TraceWriterState state;
+    return state;
+}
+
+/// Producer that reserved a record and has not committed it yet
+thread_local Producer* t_reserved = nullptr;
+
+/**
+ * Lock a producer
+ * \param producer the producer
+ */
+inline void
+LockProducer(Producer* producer)
+{
+    while (producer->lock.exchange(true, std::memory_order_acquire))
+    {
+    };
+}
+
+/**
+ * Unlock a producer
+ * \param producer the producer
+ */
+inline void
+UnlockProducer(Producer* producer)
+{
+    producer->lock.store(false, std::memory_order_release);
+}
+
+/// \returns the producer of the current LP
+Producer*
+GetProducer()
+{
+    TraceWriterState& state = State();
+    uint32_t lp = Simulator::GetSystemId();
+    thread_local uint64_t cachedGeneration = 0;
+    thread_local std::vector<Producer*> cache;
+
+    uint64_t generation = state.generation.load(std::memory_order_acquire);
+    if (cachedGeneration != generation)
+    {
+        cache.clear();
+        cachedGeneration = generation;
+    }
+    if (lp < cache.size() && cache[lp] != nullptr)
+    {
+        return cache[lp];
+    }
+
+    std::lock_guard<std::mutex> guard(state.producersMutex);
+    auto& producer = state.producers[lp];
+    if (!producer)
+    {
+        producer = std::make_unique<Producer>();
+        producer->lp = lp;
+    }
+    if (lp >= cache.size())
+    {
+        cache.resize(lp + 1, nullptr);
+    }
+    cache[lp] = producer.get();
+    return producer.get();
+}
+
+/**
+ * Hand a chunk to the I/O thread
+ * \param chunk the chunk
+ */
+void
+PushChunk(Chunk* chunk)
+{
+    TraceWriterState& state = State();
+    Chunk* head = state.queue.load(std::memory_order_relaxed);
+    do
+    {
+        chunk->next = head;
+    } while (!state.queue.compare_exchange_weak(head,
+                                                chunk,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
+    state.wakeup.notify_one();
+}
+
+/**
+ * Append a record to the buffer of a locked producer
+ * \param producer the producer
+ * \param stream the stream identifier
+ * \param timestamp the record timestamp
+ * \param size the record size
+ * \returns the record data
+ */
+uint8_t*
+AppendRecord(Producer* producer, uint32_t stream, int64_t timestamp, uint32_t size)
+{
+    std::size_t space = RecordSpace(size);
+    Chunk* chunk = producer->current;
+    if (chunk != nullptr && chunk->used + space > chunk->capacity)
+    {
+        PushChunk(chunk);
+        chunk = nullptr;
+    }
+    if (chunk == nullptr)
+    {
+        chunk = new Chunk;
+        chunk->lp = producer->lp;
+        chunk->capacity = std::max(CHUNK_SIZE, space);
+        chunk->data.reset(new uint8_t[chunk->capacity]);
+        producer->current = chunk;
+    }
+    auto header = reinterpret_cast<RecordHeader*>(chunk->data.get() + chunk->used);
+    header->timestamp = timestamp;
+    header->stream = stream;
+    header->size = size;
+    chunk->used += space;
+    return reinterpret_cast<uint8_t*>(header + 1);
+}
+
+/**
+ * Write out the staged data of a per-LP file
+ * \param lpFile the per-LP file
+ */
+void
+WriteLpFile(LpFile& lpFile)
+{
+    lpFile.file.write(lpFile.staging.data(), lpFile.staging.size());
+    lpFile.staging.clear();
+}
+
+/**
+ * Add a record to a stream, writing it out if enough data is staged
+ * \param stream the stream
+ * \param lp the LP that produced the record
+ * \param header the record header
+ */
+void
+StageRecord(StreamState& stream, uint32_t lp, const RecordHeader* header)
+{
+    auto data = reinterpret_cast<const char*>(header + 1);
+    if (!stream.perLp)
+    {
+        stream.staging.append(data, header->size);
+        if (stream.staging.size() >= WRITE_SIZE)
+        {
+            stream.os->write(stream.staging.data(), stream.staging.size());
+            stream.staging.clear();
+        }
+        return;
+    }
+
+    auto& lpFile = stream.lpFiles[lp];
+    if (!lpFile)
+    {
+        lpFile = std::make_unique<LpFile>();
+        std::ostringstream name;
+        name << stream.filename << ".lp" << lp << ".tmp";
+        lpFile->name = name.str();
+        lpFile->file.open(lpFile->name, std::ios::out | std::ios::trunc | std::ios::binary);
+        NS_ABORT_MSG_UNLESS(lpFile->file.is_open(), "Unable to open " << lpFile->name);
+    }
+    lpFile->staging.append(reinterpret_cast<const char*>(&header->timestamp),
+                           sizeof(header->timestamp));
+    lpFile->staging.append(reinterpret_cast<const char*>(&header->size), sizeof(header->size));
+    lpFile->staging.append(data, header->size);
+    if (lpFile->staging.size() >= WRITE_SIZE)
+    {
+        WriteLpFile(*lpFile);
+    }
+}
+
+/**
+ * Write out all the staged data and flush the streams.  Called with the
+ * streams mutex held.
+ */
+void
+FlushStreams()
+{
+    for (auto& [id, stream] : State().streams)
+    {
+        for (auto& [lp, lpFile] : stream->lpFiles)
+        {
+            WriteLpFile(*lpFile);
+            lpFile->file.flush();
+        }
+        stream->os->write(stream->staging.data(), stream->staging.size());
+        stream->staging.clear();
+        stream->os->flush();
+    }
+}
+
+/**
+ * Write the records of the per-LP files of a stream to the stream, in
+ * timestamp order, and delete the files.  Called with the streams mutex held
+ * and the stream flushed.
+ * \param stream the stream
+ */
+void
+MergeLpFiles(StreamState& stream)
+{
+    /// A per-LP file being merged
+    struct Source
+    {
+        std::ifstream file;   //!< the file
+        int64_t timestamp{0}; //!< timestamp of the next record
+        uint32_t size{0};     //!< size of the next record
+        uint32_t lp{0};       //!< the LP
+    };
+
+    std::vector<std::unique_ptr<Source>> sources;
+    auto readHeader = [](Source& source) {
+        source.file.read(reinterpret_cast<char*>(&source.timestamp), sizeof(source.timestamp));
+        source.file.read(reinterpret_cast<char*>(&source.size), sizeof(source.size));
+        return source.file.good();
+    };
+    // the LP breaks ties, so that the merge is deterministic
+    auto later = [&sources](std::size_t a, std::size_t b) {
+        return sources[a]->timestamp > sources[b]->timestamp ||
+               (sources[a]->timestamp == sources[b]->timestamp && sources[a]->lp > sources[b]->lp);
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> next(later);
+
+    for (auto& [lp, lpFile] : stream.lpFiles)
+    {
+        lpFile->file.close();
+        auto source = std::make_unique<Source>();
+        source->file.open(lpFile->name, std::ios::in | std::ios::binary);
+        source->lp = lp;
+        sources.push_back(std::move(source));
+        if (readHeader(*sources.back()))
+        {
+            next.push(sources.size() - 1);
+        }
+    }
+
+    std::vector<char> record;
+    while (!next.empty())
+    {
+        std::size_t index = next.top();
+        next.pop();
+        Source& source = *sources[index];
+        record.resize(source.size);
+        source.file.read(record.data(), source.size);
+        stream.staging.append(record.data(), source.size);
+        if (stream.staging.size() >= WRITE_SIZE)
+        {
+            stream.os->write(stream.staging.data(), stream.staging.size());
+            stream.staging.clear();
+        }
+        if (readHeader(source))
+        {
+            next.push(index);
+        }
+    }
+    stream.os->write(stream.staging.data(), stream.staging.size());
+    stream.staging.clear();
+    stream.os->flush();
+
+    for (auto& [lp, lpFile] : stream.lpFiles)
+    {
+        std::remove(lpFile->name.c_str());
+    }
+    stream.lpFiles.clear();
+}
+
+/**
+ * Write the records of a chunk to their streams
+ * \param chunk the chunk
+ */
+void
+ProcessChunk(Chunk* chunk)
+{
+    TraceWriterState& state = State();
+    std::lock_guard<std::mutex> guard(state.streamsMutex);
+    if (chunk->flushed != nullptr)
+    {
+        FlushStreams();
+        chunk->flushed->set_value();
+        return;
+    }
+    for (std::size_t offset = 0; offset < chunk->used;)
+    {
+        auto header = reinterpret_cast<const RecordHeader*>(chunk->data.get() + offset);
+        auto stream = state.streams.find(header->stream);
+        if (stream != state.streams.end())
+        {
+            StageRecord(*stream->second, chunk->lp, header);
+        }
+        offset += RecordSpace(header->size);
+    }
+}
+
+/// Body of the I/O thread
+void
+IoThread()
+{
+    TraceWriterState& state = State();
+    while (true)
+    {
+        Chunk* batch = state.queue.exchange(nullptr, std::memory_order_acquire);
+        if (batch == nullptr)
+        {
+            if (state.stop.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            // a notification may be missed, the timeout bounds the latency
+            std::unique_lock<std::mutex> lock(state.wakeupMutex);
+            state.wakeup.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        // the queue is a LIFO: reverse it to write the chunks in push order
+        Chunk* fifo = nullptr;
+        while (batch != nullptr)
+        {
+            Chunk* next = batch->next;
+            batch->next = fifo;
+            fifo = batch;
+            batch = next;
+        }
+        while (fifo != nullptr)
+        {
+            Chunk* next = fifo->next;
+            ProcessChunk(fifo);
+            delete fifo;
+            fifo = next;
+        }
+    }
+}
+
+/**
+ * Take the text streams of a stream, or of all the streams, away from the
+ * producers, queueing the text they have not flushed yet.
+ * \param stream the stream identifier, or 0 for all the streams
+ */
+void
+DetachTextStreams(uint32_t stream)
+{
+    TraceWriterState& state = State();
+    std::lock_guard<std::mutex> guard(state.producersMutex);
+    for (auto& [lp, producer] : state.producers)
+    {
+        LockProducer(producer.get());
+        for (auto iter = producer->streams.begin(); iter != producer->streams.end();)
+        {
+            if (stream != 0 && iter->first != stream)
+            {
+                iter++;
+                continue;
+            }
+            std::string text;
+            int64_t timestamp;
+            iter->second->buf.TakePending(text, timestamp);
+            if (!text.empty())
+            {
+                uint8_t* data = AppendRecord(producer.get(), iter->first, timestamp, text.size());
+                std::memcpy(data, text.data(), text.size());
+            }
+            iter = producer->streams.erase(iter);
+        }
+        UnlockProducer(producer.get());
+    }
+}
+
+} // namespace
+
+void
+TraceWriter::Enable(bool perLpFiles)
+{
+    NS_LOG_FUNCTION(perLpFiles);
+    TraceWriterState& state = State();
+    if (state.enabled.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    state.perLpFiles = perLpFiles;
+    state.stop.store(false, std::memory_order_relaxed);
+    state.ioThread = std::thread(&IoThread);
+    state.enabled.store(true, std::memory_order_release);
+}
+
+void
+TraceWriter::Disable()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    TraceWriterState& state = State();
+    if (!state.enabled.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    DetachTextStreams(0);
+    Flush();
+    state.enabled.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> guard(state.streamsMutex);
+        for (auto& [id, stream] : state.streams)
+        {
+            if (stream->perLp)
+            {
+                MergeLpFiles(*stream);
+            }
+        }
+        state.streams.clear();
+    }
+
+    state.stop.store(true, std::memory_order_release);
+    state.wakeup.notify_one();
+    state.ioThread.join();
+
+    std::lock_guard<std::mutex> guard(state.producersMutex);
+    state.producers.clear();
+    state.generation.fetch_add(1, std::memory_order_release);
+}
+
+bool
+TraceWriter::IsEnabled()
+{
+    return State().enabled.load(std::memory_order_acquire);
+}
+
+void
+TraceWriter::Flush()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    TraceWriterState& state = State();
+    if (!state.enabled.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(state.producersMutex);
+        for (auto& [lp, producer] : state.producers)
+        {
+            LockProducer(producer.get());
+            if (producer->current != nullptr)
+            {
+                PushChunk(producer->current);
+                producer->current = nullptr;
+            }
+            UnlockProducer(producer.get());
+        }
+    }
+
+    // the marker is written after every chunk pushed before it
+    std::promise<void> flushed;
+    auto marker = new Chunk;
+    marker->flushed = &flushed;
+    PushChunk(marker);
+    flushed.get_future().wait();
+}
+
+uint32_t
+TraceWriter::Register(std::ostream* os, const std::string& filename)
+{
+    NS_LOG_FUNCTION(os << filename);
+    TraceWriterState& state = State();
+    if (!state.enabled.load(std::memory_order_acquire))
+    {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(state.streamsMutex);
+    auto stream = std::make_unique<StreamState>();
+    stream->os = os;
+    stream->filename = filename;
+    stream->perLp = state.perLpFiles && !filename.empty();
+    uint32_t id = ++state.lastStream;
+    state.streams[id] = std::move(stream);
+    return id;
+}
+
+void
+TraceWriter::Unregister(uint32_t stream)
+{
+    NS_LOG_FUNCTION(stream);
+    TraceWriterState& state = State();
+    if (stream == 0 || !state.enabled.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    DetachTextStreams(stream);
+    Flush();
+
+    std::lock_guard<std::mutex> guard(state.streamsMutex);
+    auto iter = state.streams.find(stream);
+    if (iter == state.streams.end())
+    {
+        return;
+    }
+    if (iter->second->perLp)
+    {
+        MergeLpFiles(*iter->second);
+    }
+    state.streams.erase(iter);
+}
+
+bool
+TraceWriter::Write(uint32_t stream, int64_t timestamp, const void* data, uint32_t size)
+{
+    uint8_t* record = Reserve(stream, timestamp, size);
+    if (record == nullptr)
+    {
+        return false;
+    }
+    std::memcpy(record, data, size);
+    Commit();
+    return true;
+}
+
+uint8_t*
+TraceWriter::Reserve(uint32_t stream, int64_t timestamp, uint32_t size)
+{
+    if (stream == 0 || !State().enabled.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    Producer* producer = GetProducer();
+    LockProducer(producer);
+    t_reserved = producer;
+    return AppendRecord(producer, stream, timestamp, size);
+}
+
+void
+TraceWriter::Commit()
+{
+    NS_ASSERT_MSG(t_reserved != nullptr, "TraceWriter::Commit() without Reserve()");
+    UnlockProducer(t_reserved);
+    t_reserved = nullptr;
+}
+
+std::ostream*
+TraceWriter::GetStream(uint32_t stream)
+{
+    if (stream == 0 || !State().enabled.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    Producer* producer = GetProducer();
+    LockProducer(producer);
+    auto& proxy = producer->streams[stream];
+    if (!proxy)
+    {
+        proxy = std::make_unique<TraceStreamProxy>(stream);
+    }
+    std::ostream* os = &proxy->os;
+    UnlockProducer(producer);
+    return os;
+}
+
+} // namespace ns3
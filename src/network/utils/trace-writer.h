@@ -0,0 +1,150 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_WRITER_H
+#define TRACE_WRITER_H
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ * \brief Asynchronous, buffered writer for trace files
+ *
+ * When the TraceWriter is enabled, the PcapFile and OutputStreamWrapper
+ * objects created afterwards hand their records to it instead of writing
+ * them to their stream on the simulation thread.  Records are appended to a
+ * buffer owned by the logical process that produced them (see
+ * Simulator::GetSystemId()), so that producers never contend with each
+ * other.  Full buffers are passed through a lock-free queue to a dedicated
+ * I/O thread, which writes them out in large sequential writes.
+ *
+ * The records of one LP always reach a stream in the order they were
+ * produced, and the records of different LPs sharing a stream are
+ * interleaved in buffer-sized batches.  When enabled with per-LP files,
+ * the records of each LP are instead written to a temporary file next to
+ * the trace file, and the temporary files are merged by timestamp into the
+ * trace file when it is closed, so that a single trace shared by nodes on
+ * different LPs comes out in time order.
+ *
+ * Records are only guaranteed to be written once their stream is closed,
+ * or after Flush() or Disable() returns.  Flush(), Disable() and closing a
+ * stream must not be done while other LPs are producing records.
+ */
+class TraceWriter
+{
+  public:
+    /**
+     * Start the I/O thread and redirect the trace files opened from now on
+     * to it.
+     *
+     * Without per-LP files, the records of different LPs sharing a file are
+     * written in buffer-sized batches, in the order the buffers fill up, so
+     * that such a file is neither in time order nor reproducible; only the
+     * files written by a single LP come out in order.
+     *
+     * \param perLpFiles whether to write the records of each LP to its own
+     *        temporary file, merged by timestamp when the trace is closed
+     */
+    static void Enable(bool perLpFiles = false);
+
+    /**
+     * Write out all the pending records, close the temporary per-LP files and
+     * stop the I/O thread.  Streams still open are written synchronously from
+     * then on.
+     */
+    static void Disable();
+
+    /**
+     * \returns true if the TraceWriter is enabled
+     */
+    static bool IsEnabled();
+
+    /**
+     * Write out all the records produced so far and flush the streams.
+     */
+    static void Flush();
+
+    /**
+     * Register a stream to be written by the I/O thread.  The stream must
+     * not be written directly until it is unregistered.
+     *
+     * \param os the stream
+     * \param filename the name of the file behind the stream, used to name
+     *        the temporary per-LP files; if empty, the stream does not use
+     *        per-LP files
+     * \returns the stream identifier, or 0 if the TraceWriter is not enabled
+     */
+    static uint32_t Register(std::ostream* os, const std::string& filename = "");
+
+    /**
+     * Write out the pending records of a stream, merging its per-LP files,
+     * and return the stream to its owner.
+     *
+     * \param stream the stream identifier
+     */
+    static void Unregister(uint32_t stream);
+
+    /**
+     * Queue a record for a stream.
+     *
+     * \param stream the stream identifier
+     * \param timestamp the record timestamp, in nanoseconds, used to merge
+     *        per-LP files
+     * \param data the record data
+     * \param size the record size
+     * \returns false if the stream is not written by the TraceWriter, in
+     *          which case the caller must write the record itself
+     */
+    static bool Write(uint32_t stream, int64_t timestamp, const void* data, uint32_t size);
+
+    /**
+     * Reserve space for a record in the buffer of the current LP, to be
+     * filled in place.  Must be followed by Commit() before the next
+     * TraceWriter call from this thread.
+     *
+     * \param stream the stream identifier
+     * \param timestamp the record timestamp, in nanoseconds
+     * \param size the record size
+     * \returns the record data, or nullptr if the stream is not written by
+     *          the TraceWriter
+     */
+    static uint8_t* Reserve(uint32_t stream, int64_t timestamp, uint32_t size);
+
+    /**
+     * Complete the record reserved by Reserve().
+     */
+    static void Commit();
+
+    /**
+     * Get a text stream that queues one record for the stream every time
+     * it is flushed (e.g., by std::endl).  The record is stamped with the
+     * time its text started to be written.  The returned stream belongs to
+     * the current LP and must not be kept across events.
+     *
+     * \param stream the stream identifier
+     * \returns the text stream, or nullptr if the stream is not written by
+     *          the TraceWriter
+     */
+    static std::ostream* GetStream(uint32_t stream);
+};
+
+} // namespace ns3
+
+#endif /* TRACE_WRITER_H */
@@ -25,13 +25,20 @@
 #include "nix-vector-routing.h"
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
 #include "ns3/loopback-net-device.h"
 #include "ns3/names.h"
+#include "ns3/uinteger.h"
 
 #include <iomanip>
 #include <queue>
+#include <thread>
+
+#ifdef NS3_MTP
+#include "ns3/mtp-interface.h"
+#endif
 
 namespace ns3
 {
@@ -62,6 +69,38 @@ bool NixVectorRouting<T>::g_isCacheDirty = false;
 template <typename T>
 uint32_t NixVectorRouting<T>::g_epoch = 1;
 
+#ifdef NS3_MTP
+template <typename T>
+std::atomic<uint32_t> NixVectorRouting<T>::g_pathEpoch(1);
+
+template <typename T>
+std::atomic<bool> NixVectorRouting<T>::g_pathTreesRetiring(false);
+
+template <typename T>
+bool NixVectorRouting<T>::g_pathTreesReclaiming = false;
+
+template <typename T>
+std::atomic<bool> NixVectorRouting<T>::g_pathTreesResizing(false);
+
+template <typename T>
+std::atomic<uint32_t> NixVectorRouting<T>::g_nInstances(0);
+#else
+template <typename T>
+uint32_t NixVectorRouting<T>::g_pathEpoch = 1;
+
+template <typename T>
+uint32_t NixVectorRouting<T>::g_nInstances = 0;
+#endif
+
+template <typename T>
+bool NixVectorRouting<T>::g_pathCachePrecomputing = false;
+
+template <typename T>
+std::vector<typename NixVectorRouting<T>::PathTreeSlot> NixVectorRouting<T>::g_pathTrees;
+
+template <typename T>
+std::vector<const typename NixVectorRouting<T>::PathTree*> NixVectorRouting<T>::g_retiredPathTrees;
+
 template <typename T>
 typename NixVectorRouting<T>::IpAddressToNodeMap NixVectorRouting<T>::g_ipAddressToNodeMap;
 
@@ -85,15 +124,27 @@ NixVectorRouting<T>::GetTypeId()
     static TypeId tid = TypeId("ns3::" + name + "NixVectorRouting")
                             .SetParent<T>()
                             .SetGroupName("NixVectorRouting")
-                            .template AddConstructor<NixVectorRouting<T>>();
+                            .template AddConstructor<NixVectorRouting<T>>()
+                            .AddAttribute("SharedPathCache",
+                                          "Build nix-vectors from shortest path trees shared by "
+                                          "all the nodes, one per destination, instead of running "
+                                          "a breadth first search per source and destination. "
+                                          "Paths are as short, but equal-cost ties may be broken "
+                                          "differently.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(
+                                              &NixVectorRouting<T>::m_sharedPathCache),
+                                          MakeBooleanChecker());
     return tid;
 }
 
 template <typename T>
 NixVectorRouting<T>::NixVectorRouting()
-    : m_totalNeighbors(0)
+    : m_sharedPathCache(false),
+      m_totalNeighbors(0)
 {
     NS_LOG_FUNCTION_NOARGS();
+    g_nInstances++;
 }
 
 template <typename T>
@@ -147,6 +198,12 @@ NixVectorRouting<T>::DoDispose()
     m_node = nullptr;
     m_ip = nullptr;
 
+    // The path trees are shared by all the routing protocols
+    if (--g_nInstances == 0)
+    {
+        ClearPathCache();
+    }
+
     T::DoDispose();
 }
 
@@ -185,6 +242,9 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
 #ifdef NS3_MTP
     g_isMapBuilt.store(false, std::memory_order_release);
 #endif
+
+    // Shared path trees are not flushed, they are rebuilt on their next use
+    g_pathEpoch++;
 }
 
 template <typename T>
@@ -234,6 +294,20 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
     {
         // otherwise proceed as normal
         // and build the nix vector
+        if (m_sharedPathCache && !oif)
+        {
+            const PathTree* tree = GetPathTree(destNode);
+            if (tree)
+            {
+                if (BuildNixVectorFromTree(tree, source, destNode, nixVector))
+                {
+                    return nixVector;
+                }
+                NS_LOG_ERROR("No routing path exists");
+                return nullptr;
+            }
+        }
+
         std::vector<Ptr<Node>> parentVector;
 
         if (BFS(NodeList::GetNNodes(), source, destNode, parentVector, oif))
@@ -316,6 +390,21 @@ NixVectorRouting<T>::BuildNixVector(const std::vector<Ptr<Node>>& parentVector,
     }
 
     Ptr<Node> parentNode = parentVector.at(dest);
+    AddNixHop(parentNode, dest, nixVector);
+
+    // recurse through T vector, grabbing the path
+    // and building the nix vector
+    BuildNixVector(parentVector, source, (parentVector.at(dest))->GetId(), nixVector);
+    return true;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::AddNixHop(Ptr<Node> parentNode,
+                               uint32_t childId,
+                               Ptr<NixVector> nixVector) const
+{
+    NS_LOG_FUNCTION(this << parentNode << childId << nixVector);
 
     uint32_t numberOfDevices = parentNode->GetNDevices();
     uint32_t destId = 0;
@@ -346,7 +435,7 @@ NixVectorRouting<T>::BuildNixVector(const std::vector<Ptr<Node>>& parentVector,
 
         // Finally we can get the adjacent nodes
         // and scan through them.  If we find the
-        // node that matches "dest" then we can add
+        // node that matches "childId" then we can add
         // the index  to the nix vector.
         // the index corresponds to the neighbor index
         uint32_t offset = 0;
@@ -354,7 +443,7 @@ NixVectorRouting<T>::BuildNixVector(const std::vector<Ptr<Node>>& parentVector,
         {
             Ptr<Node> remoteNode = (*iter)->GetNode();
 
-            if (remoteNode->GetId() == dest)
+            if (remoteNode->GetId() == childId)
             {
                 destId = totalNeighbors + offset;
             }
@@ -366,11 +455,6 @@ NixVectorRouting<T>::BuildNixVector(const std::vector<Ptr<Node>>& parentVector,
     NS_LOG_LOGIC("Adding Nix: " << destId << " with " << nixVector->BitCount(totalNeighbors)
                                 << " bits, for node " << parentNode->GetId());
     nixVector->AddNeighborIndex(destId, nixVector->BitCount(totalNeighbors));
-
-    // recurse through T vector, grabbing the path
-    // and building the nix vector
-    BuildNixVector(parentVector, source, (parentVector.at(dest))->GetId(), nixVector);
-    return true;
 }
 
 template <typename T>
@@ -526,6 +610,8 @@ NixVectorRouting<T>::BuildIpAddressToNodeMap() const
             }
         }
     }
+
+    ResizePathCache();
 }
 
 template <typename T>
@@ -1359,6 +1445,336 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
     return false;
 }
 
+template <typename T>
+const typename NixVectorRouting<T>::PathTree*
+NixVectorRouting<T>::GetPathTree(Ptr<Node> dest) const
+{
+    NS_LOG_FUNCTION(this << dest);
+
+    uint32_t id = dest->GetId();
+    if (id >= g_pathTrees.size())
+    {
+        // Nodes were added since the path cache was sized
+        ResizePathCache();
+        if (id >= g_pathTrees.size())
+        {
+            return nullptr;
+        }
+    }
+#ifdef NS3_MTP
+    uint32_t epoch = g_pathEpoch.load(std::memory_order_acquire);
+    const PathTree* tree = g_pathTrees[id].load(std::memory_order_acquire);
+#else
+    uint32_t epoch = g_pathEpoch;
+    const PathTree* tree = g_pathTrees[id];
+#endif
+    if (tree && tree->epoch == epoch)
+    {
+        return tree;
+    }
+
+    NS_LOG_LOGIC("Path tree to node " << id << " missing or stale, build: ");
+    const PathTree* fresh = BuildPathTree(dest, epoch);
+#ifdef NS3_MTP
+    // Readers never lock: publish the tree if the slot has not changed
+    // meanwhile, otherwise keep using it privately
+    if (!g_pathTrees[id].compare_exchange_strong(tree, fresh, std::memory_order_acq_rel))
+    {
+        tree = fresh;
+    }
+#else
+    g_pathTrees[id] = fresh;
+#endif
+    if (tree)
+    {
+        RetirePathTree(tree);
+    }
+    return fresh;
+}
+
+template <typename T>
+const typename NixVectorRouting<T>::PathTree*
+NixVectorRouting<T>::BuildPathTree(Ptr<Node> dest, uint32_t epoch) const
+{
+    NS_LOG_FUNCTION(this << dest << epoch);
+
+    auto tree = new PathTree;
+    tree->epoch = epoch;
+    tree->nextHop.assign(NodeList::GetNNodes(), NO_HOP);
+
+    // Search backward from the destination: a node discovered through a
+    // neighbor uses that neighbor as its next hop
+    std::queue<Ptr<Node>> greyNodeList;
+    greyNodeList.push(dest);
+    tree->nextHop.at(dest->GetId()) = dest->GetId();
+
+    while (!greyNodeList.empty())
+    {
+        Ptr<Node> currNode = greyNodeList.front();
+        greyNodeList.pop();
+
+        for (uint32_t i = 0; i < currNode->GetNDevices(); i++)
+        {
+            Ptr<NetDevice> localNetDevice = currNode->GetDevice(i);
+            Ptr<Channel> channel = localNetDevice->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+
+            NetDeviceContainer netDeviceContainer;
+            GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+
+            for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End(); iter++)
+            {
+                Ptr<Node> remoteNode = (*iter)->GetNode();
+                if (tree->nextHop.at(remoteNode->GetId()) != NO_HOP)
+                {
+                    continue;
+                }
+
+                // the hop is taken from the remote node, make sure
+                // that it can go this way
+                Ptr<IpL3Protocol> ip = remoteNode->GetObject<IpL3Protocol>();
+                if (ip)
+                {
+                    uint32_t interfaceIndex = ip->GetInterfaceForDevice(*iter);
+                    if (!(ip->IsUp(interfaceIndex)))
+                    {
+                        NS_LOG_LOGIC("IpInterface is down");
+                        continue;
+                    }
+                }
+                if (!((*iter)->IsLinkUp()))
+                {
+                    NS_LOG_LOGIC("Link is down.");
+                    continue;
+                }
+
+                tree->nextHop.at(remoteNode->GetId()) = currNode->GetId();
+                greyNodeList.push(remoteNode);
+            }
+        }
+    }
+    return tree;
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::BuildNixVectorFromTree(const PathTree* tree,
+                                            Ptr<Node> source,
+                                            Ptr<Node> dest,
+                                            Ptr<NixVector> nixVector) const
+{
+    NS_LOG_FUNCTION(this << source << dest << nixVector);
+
+    uint32_t curr = source->GetId();
+    if (curr >= tree->nextHop.size() || tree->nextHop[curr] == NO_HOP)
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> path;
+    while (curr != dest->GetId())
+    {
+        path.push_back(curr);
+        curr = tree->nextHop[curr];
+    }
+    path.push_back(curr);
+
+    // hops are added from the destination backward, as BuildNixVector does
+    for (std::size_t i = path.size() - 1; i > 0; i--)
+    {
+        AddNixHop(NodeList::GetNode(path[i - 1]), path[i], nixVector);
+    }
+    return true;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ResizePathCache()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    if (g_pathTrees.size() == NodeList::GetNNodes())
+    {
+        return;
+    }
+#ifdef NS3_MTP
+    if (IsPathCacheShared())
+    {
+        // Reallocate the slots between the rounds, when no thread reads them
+        if (MtpInterface::isPartitioned() &&
+            !g_pathTreesResizing.exchange(true, std::memory_order_relaxed))
+        {
+            MtpInterface::ScheduleGlobal(&NixVectorRouting<T>::ResizePathCache);
+        }
+        return;
+    }
+    g_pathTreesResizing.store(false, std::memory_order_relaxed);
+#endif
+    ClearPathCache();
+    g_pathTrees = std::vector<PathTreeSlot>(NodeList::GetNNodes());
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::IsPathCacheShared()
+{
+    if (g_pathCachePrecomputing)
+    {
+        return true;
+    }
+#ifdef NS3_MTP
+    // The public logical process runs alone, between the rounds
+    if (MtpInterface::isPartitioned())
+    {
+        LogicalProcess* system = MtpInterface::GetSystem();
+        return !system || system->GetSystemId() != 0;
+    }
+#endif
+    return false;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::RetirePathTree(const PathTree* tree)
+{
+    if (!IsPathCacheShared())
+    {
+        delete tree;
+        return;
+    }
+#ifdef NS3_MTP
+    while (g_pathTreesRetiring.exchange(true, std::memory_order_acquire))
+    {
+    };
+    g_retiredPathTrees.push_back(tree);
+    bool reclaim = !g_pathCachePrecomputing && !g_pathTreesReclaiming;
+    g_pathTreesReclaiming |= reclaim;
+    g_pathTreesRetiring.store(false, std::memory_order_release);
+    if (reclaim)
+    {
+        MtpInterface::ScheduleGlobal(&NixVectorRouting<T>::ReclaimPathTrees);
+    }
+#else
+    g_retiredPathTrees.push_back(tree);
+#endif
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ReclaimPathTrees()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    NS_LOG_LOGIC("Deleting " << g_retiredPathTrees.size() << " replaced path trees");
+    for (auto tree : g_retiredPathTrees)
+    {
+        delete tree;
+    }
+    g_retiredPathTrees.clear();
+#ifdef NS3_MTP
+    g_pathTreesReclaiming = false;
+#endif
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ClearPathCache()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    for (auto& slot : g_pathTrees)
+    {
+#ifdef NS3_MTP
+        delete slot.exchange(nullptr, std::memory_order_relaxed);
+#else
+        delete slot;
+        slot = nullptr;
+#endif
+    }
+    ReclaimPathTrees();
+}
+
+template <typename T>
+uint32_t
+NixVectorRouting<T>::GetPathCacheThreadCount()
+{
+#ifdef NS3_MTP
+    // Reuse the thread count of the multithreaded simulator
+    TypeId tid;
+    TypeId::AttributeInformation info;
+    if (TypeId::LookupByNameFailSafe("ns3::MultithreadedSimulatorImpl", &tid) &&
+        tid.LookupAttributeByName("MaxThreads", &info))
+    {
+        Ptr<const UintegerValue> maxThreads = DynamicCast<const UintegerValue>(info.initialValue);
+        if (maxThreads)
+        {
+            return std::max<uint32_t>(maxThreads->Get(), 1);
+        }
+    }
+#endif
+    return 1;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::PrecomputePathCache()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    Ptr<NixVectorRouting<T>> rp;
+    std::vector<Ptr<Node>> destinations;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<NixVectorRouting<T>> nodeRp = (*i)->GetObject<NixVectorRouting<T>>();
+        if (nodeRp && !rp)
+        {
+            rp = nodeRp;
+        }
+        if ((*i)->GetObject<IpL3Protocol>())
+        {
+            destinations.push_back(*i);
+        }
+    }
+    if (!rp)
+    {
+        return;
+    }
+
+    // Flush pending topology changes and build the lookup maps before
+    // the workers share them
+    rp->CheckCacheStateAndFlush();
+    rp->GetNodeByIp(IpAddress::GetZero());
+    ResizePathCache();
+
+    std::atomic<uint32_t> next(0);
+    auto worker = [&rp, &destinations, &next]() {
+        for (uint32_t i = next++; i < destinations.size(); i = next++)
+        {
+            rp->GetPathTree(destinations[i]);
+        }
+    };
+
+    uint32_t threadCount = std::min<uint32_t>(GetPathCacheThreadCount(), destinations.size());
+    NS_LOG_INFO("Building " << destinations.size() << " path trees on " << threadCount
+                            << " threads");
+    std::vector<std::thread> threads;
+    g_pathCachePrecomputing = threadCount > 1;
+    for (uint32_t i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    g_pathCachePrecomputing = false;
+    ReclaimPathTrees();
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::PrintRoutingPath(Ptr<Node> source,
@@ -1529,6 +1945,8 @@ template void NixVectorRouting<Ipv4RoutingProtocol>::SetNode(Ptr<Node> node);
 template void NixVectorRouting<Ipv6RoutingProtocol>::SetNode(Ptr<Node> node);
 template void NixVectorRouting<Ipv4RoutingProtocol>::FlushGlobalNixRoutingCache() const;
 template void NixVectorRouting<Ipv6RoutingProtocol>::FlushGlobalNixRoutingCache() const;
+template void NixVectorRouting<Ipv4RoutingProtocol>::PrecomputePathCache();
+template void NixVectorRouting<Ipv6RoutingProtocol>::PrecomputePathCache();
 template void NixVectorRouting<Ipv4RoutingProtocol>::PrintRoutingPath(
     Ptr<Node> source,
     IpAddress dest,
@@ -42,8 +42,10 @@
 #include "ns3/nstime.h"
 
 #include <atomic>
+#include <limits>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 // NOLINTBEGIN(modernize-use-override)
 
@@ -143,7 +145,100 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                           Ptr<OutputStreamWrapper> stream,
                           Time::Unit unit) const;
 
+    /**
+     * @brief Build the shared path trees of every destination node.
+     *
+     * The trees are otherwise built on demand, the first time a
+     * destination is routed to.  In multithreaded (MTP) builds the trees
+     * are built in parallel, on as many threads as the multithreaded
+     * simulator uses.  Only nodes whose routing protocol has the
+     * SharedPathCache attribute set use the trees.
+     */
+    static void PrecomputePathCache();
+
   private:
+    /**
+     * Shortest path tree toward one destination node, shared by the
+     * routing protocols of all the source nodes.  Trees are immutable once
+     * built; a tree built before the last topology change is stale and is
+     * replaced on its next use.
+     */
+    struct PathTree
+    {
+        uint32_t epoch;                //!< Path cache epoch the tree was built in
+        std::vector<uint32_t> nextHop; //!< Next hop toward the destination, by node id
+    };
+
+    /// Next hop of the nodes that cannot reach the destination of a PathTree
+    static constexpr uint32_t NO_HOP = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Get the current path tree toward a destination, building and
+     * publishing it if needed.
+     * \param dest Destination node
+     * \returns The path tree, or nullptr if the path cache is not sized for dest
+     */
+    const PathTree* GetPathTree(Ptr<Node> dest) const;
+
+    /**
+     * Breadth first search from a destination toward all the sources.
+     * \param dest Destination node
+     * \param epoch Path cache epoch of the tree
+     * \returns The newly built path tree
+     */
+    const PathTree* BuildPathTree(Ptr<Node> dest, uint32_t epoch) const;
+
+    /**
+     * Build the nix-vector of the path from a source to the destination
+     * of a path tree.
+     * \param [in] tree Path tree toward dest
+     * \param [in] source Source node
+     * \param [in] dest Destination node
+     * \param [out] nixVector the NixVector to be used for routing
+     * \returns true on success, false if dest is not reachable.
+     */
+    bool BuildNixVectorFromTree(const PathTree* tree,
+                                Ptr<Node> source,
+                                Ptr<Node> dest,
+                                Ptr<NixVector> nixVector) const;
+
+    /**
+     * Size the path cache for the nodes of the node list.
+     *
+     * The slots are not reallocated while other threads may read them, but
+     * after the current round of the multithreaded simulator.  Meanwhile,
+     * the nodes not in the path cache are routed without it.
+     */
+    static void ResizePathCache();
+
+    /**
+     * \returns whether other threads may be reading the path trees meanwhile
+     */
+    static bool IsPathCacheShared();
+
+    /**
+     * Delete a replaced path tree, or, if other threads may still be reading
+     * it, once they are done: after the current round of the multithreaded
+     * simulator, or after the precomputation.
+     * \param tree The replaced tree
+     */
+    static void RetirePathTree(const PathTree* tree);
+
+    /**
+     * Delete the replaced path trees no thread reads anymore.
+     */
+    static void ReclaimPathTrees();
+
+    /**
+     * Delete all the path trees.
+     */
+    static void ClearPathCache();
+
+    /**
+     * \returns the number of threads used to precompute the path cache
+     */
+    static uint32_t GetPathCacheThreadCount();
+
     /**
      * Flushes the cache which stores nix-vector based on
      * destination IP
@@ -230,6 +325,14 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                         uint32_t dest,
                         Ptr<NixVector> nixVector) const;
 
+    /**
+     * Adds to the nix-vector the neighbor index of a hop
+     * \param [in] parentNode Node the hop starts from
+     * \param [in] childId Index of the node the hop ends at
+     * \param [out] nixVector the NixVector to be used for routing
+     */
+    void AddNixHop(Ptr<Node> parentNode, uint32_t childId, Ptr<NixVector> nixVector) const;
+
     /**
      * Simply iterates through the nodes net-devices and determines
      * how many neighbors the node has.
@@ -499,6 +602,34 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     static uint32_t g_epoch;
 
+    /// Slot of the path tree of one destination
+#ifdef NS3_MTP
+    typedef std::atomic<const PathTree*> PathTreeSlot;
+#else
+    typedef const PathTree* PathTreeSlot;
+#endif
+
+    /**
+     * Path cache epoch, incremented each time the caches are flushed.
+     */
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> g_pathEpoch;
+    static std::atomic<bool> g_pathTreesRetiring; //!< Lock of g_retiredPathTrees
+    static bool g_pathTreesReclaiming;            //!< Whether a reclamation is scheduled
+    static std::atomic<bool> g_pathTreesResizing; //!< Whether a resize is scheduled
+    static std::atomic<uint32_t> g_nInstances;    //!< Number of routing protocols not disposed
+#else
+    static uint32_t g_pathEpoch;
+    static uint32_t g_nInstances; //!< Number of routing protocols not disposed
+#endif
+
+    static bool g_pathCachePrecomputing;          //!< Whether worker threads build path trees
+    static std::vector<PathTreeSlot> g_pathTrees; //!< Path trees by destination node id
+    static std::vector<const PathTree*> g_retiredPathTrees; //!< Replaced trees still read
+
+    /// Use the path trees shared by all nodes instead of a BFS per destination
+    bool m_sharedPathCache;
+
     /** Cache stores nix-vectors based on destination ip */
     mutable NixMap_t m_nixCache;
 
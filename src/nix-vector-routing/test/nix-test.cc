@@ -17,6 +17,7 @@
  * Author: Ameya Deshpande <ameyanrd@outlook.com>
  */
 
+#include "ns3/boolean.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
@@ -25,6 +26,7 @@
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
@@ -60,6 +62,9 @@ using namespace ns3;
  * (Set down the interface of nC on nB-nC channel.)
  * - Test that routing is not possible from nSrc to nDst.
  *
+ * The test is run both with per-source searches and with the shared path
+ * cache, which must find the same (unique) shortest paths.
+ *
  * \brief IPv4 Nix-Vector Routing Test
  */
 class NixVectorRoutingTest : public TestCase
@@ -98,7 +103,12 @@ class NixVectorRoutingTest : public TestCase
 
   public:
     void DoRun() override;
-    NixVectorRoutingTest();
+
+    /**
+     * Constructor.
+     * \param sharedPathCache Whether the nodes use the shared path cache.
+     */
+    NixVectorRoutingTest(bool sharedPathCache);
 
     /**
      * \brief Receive data.
@@ -107,10 +117,15 @@ class NixVectorRoutingTest : public TestCase
     void ReceivePkt(Ptr<Socket> socket);
 
     std::vector<uint32_t> m_receivedPacketSizes; //!< Received packet sizes
+
+  private:
+    bool m_sharedPathCache; //!< Whether the nodes use the shared path cache
 };
 
-NixVectorRoutingTest::NixVectorRoutingTest()
-    : TestCase("three router, two path test")
+NixVectorRoutingTest::NixVectorRoutingTest(bool sharedPathCache)
+    : TestCase(sharedPathCache ? "three router, two path test, shared path cache"
+                               : "three router, two path test"),
+      m_sharedPathCache(sharedPathCache)
 {
 }
 
@@ -212,6 +227,16 @@ NixVectorRoutingTest::DoRun()
     stack.SetRoutingHelper(ipv4NixRouting); // has effect on the next Install ()
     stack.SetRoutingHelper(ipv6NixRouting); // has effect on the next Install ()
     stack.Install(allNodes);
+    if (m_sharedPathCache)
+    {
+        for (auto i = allNodes.Begin(); i != allNodes.End(); i++)
+        {
+            (*i)->GetObject<Ipv4NixVectorRouting>()->SetAttribute("SharedPathCache",
+                                                                  BooleanValue(true));
+            (*i)->GetObject<Ipv6NixVectorRouting>()->SetAttribute("SharedPathCache",
+                                                                  BooleanValue(true));
+        }
+    }
 
     NetDeviceContainer dSrcdA;
     NetDeviceContainer dAdB;
@@ -258,6 +283,12 @@ NixVectorRoutingTest::DoRun()
     Ipv6InterfaceContainer iCiDstv6 = aCaDstv6.Assign(dCdDst);
     Ipv6InterfaceContainer iAiCv6 = aAaCv6.Assign(dAdC);
 
+    if (m_sharedPathCache)
+    {
+        Ipv4NixVectorRouting::PrecomputePathCache();
+        Ipv6NixVectorRouting::PrecomputePathCache();
+    }
+
     // Create the UDP sockets
     Ptr<SocketFactory> rxSocketFactory = nCnDst.Get(1)->GetObject<UdpSocketFactory>();
     Ptr<Socket> rxSocketv4 = rxSocketFactory->CreateSocket();
@@ -405,7 +436,8 @@ class NixVectorRoutingTestSuite : public TestSuite
     NixVectorRoutingTestSuite()
         : TestSuite("nix-vector-routing", UNIT)
     {
-        AddTestCase(new NixVectorRoutingTest(), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingTest(false), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingTest(true), TestCase::QUICK);
     }
 };
 
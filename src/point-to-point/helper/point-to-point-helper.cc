@@ -23,6 +23,7 @@
 #include "ns3/names.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/packet.h"
+#include "ns3/parallel-construction.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/simulator.h"
@@ -239,14 +240,19 @@ PointToPointHelper::Install(Ptr<Node> a, Ptr<Node> b)
 {
     NetDeviceContainer container;
 
+    // the nodes may be shared with other links created in parallel
     Ptr<PointToPointNetDevice> devA = m_deviceFactory.Create<PointToPointNetDevice>();
-    devA->SetAddress(Mac48Address::Allocate());
-    a->AddDevice(devA);
+    ParallelConstruction::Defer([a, devA]() {
+        devA->SetAddress(Mac48Address::Allocate());
+        a->AddDevice(devA);
+    });
     Ptr<Queue<Packet>> queueA = m_queueFactory.Create<Queue<Packet>>();
     devA->SetQueue(queueA);
     Ptr<PointToPointNetDevice> devB = m_deviceFactory.Create<PointToPointNetDevice>();
-    devB->SetAddress(Mac48Address::Allocate());
-    b->AddDevice(devB);
+    ParallelConstruction::Defer([b, devB]() {
+        devB->SetAddress(Mac48Address::Allocate());
+        b->AddDevice(devB);
+    });
     Ptr<Queue<Packet>> queueB = m_queueFactory.Create<Queue<Packet>>();
     devB->SetQueue(queueB);
     if (m_enableFlowControl)
@@ -305,6 +311,35 @@ PointToPointHelper::Install(Ptr<Node> a, Ptr<Node> b)
     return container;
 }
 
+NetDeviceContainer
+PointToPointHelper::InstallParallel(NodeContainer a, NodeContainer b)
+{
+    NS_ASSERT_MSG(a.GetN() == b.GetN(), "Nodes to link must be paired");
+    std::vector<NetDeviceContainer> links(a.GetN());
+    auto install = [&](uint32_t i) { links[i] = Install(a.Get(i), b.Get(i)); };
+#ifdef NS3_MPI
+    // the channel factory is modified by the links of distributed simulations
+    if (MpiInterface::IsEnabled())
+    {
+        for (uint32_t i = 0; i < a.GetN(); i++)
+        {
+            install(i);
+        }
+    }
+    else
+#endif
+    {
+        ParallelConstruction::For(a.GetN(), install);
+    }
+
+    NetDeviceContainer container;
+    for (const auto& link : links)
+    {
+        container.Add(link);
+    }
+    return container;
+}
+
 NetDeviceContainer
 PointToPointHelper::Install(Ptr<Node> a, std::string bName)
 {
@@ -153,6 +153,21 @@ class PointToPointHelper : public PcapHelperForDevice, public AsciiTraceHelperFo
      */
     NetDeviceContainer Install(std::string aNode, std::string bNode);
 
+    /**
+     * \param a the first node of each link
+     * \param b the second node of each link
+     * \return a NetDeviceContainer for nodes, the two devices of each link
+     *         in turn
+     *
+     * Link each node of a to the node of b with the same index, like
+     * Install(Ptr<Node>, Ptr<Node>) does, the links being created in
+     * parallel.  The devices get the same addresses and indexes as if the
+     * links were created in order.
+     *
+     * \see ParallelConstruction
+     */
+    NetDeviceContainer InstallParallel(NodeContainer a, NodeContainer b);
+
   private:
     /**
      * \brief Enable pcap output the indicated net device.
@@ -19,6 +19,7 @@
 
 #include "point-to-point-net-device.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
@@ -44,6 +45,19 @@ PointToPointChannel::GetTypeId()
                           TimeValue(Seconds(0)),
                           MakeTimeAccessor(&PointToPointChannel::m_delay),
                           MakeTimeChecker())
+            .AddAttribute("Batching",
+                          "Whether the packets in flight on a wire are delivered by a single "
+                          "event, rather than by one event per packet.  Wires between two "
+                          "logical processes always use one event per packet.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PointToPointChannel::m_batching),
+                          MakeBooleanChecker())
+            .AddAttribute("LinkCompression",
+                          "Whether both devices attached complete the transmissions of "
+                          "uncongested hops without an event, as with their own attribute.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PointToPointChannel::m_compression),
+                          MakeBooleanChecker())
             .AddTraceSource("TxRxPointToPoint",
                             "Trace source indicating transmission of packet "
                             "from the PointToPointChannel, used by the Animation "
@@ -59,6 +73,8 @@ PointToPointChannel::GetTypeId()
 PointToPointChannel::PointToPointChannel()
     : Channel(),
       m_delay(Seconds(0.)),
+      m_batching(false),
+      m_compression(false),
       m_nDevices(0)
 {
     NS_LOG_FUNCTION_NOARGS();
@@ -96,11 +112,31 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
-    Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
-                                   txTime + m_delay,
-                                   &PointToPointNetDevice::Receive,
-                                   m_link[wire].m_dst,
-                                   p->Copy());
+    Ptr<Packet> copy = p->Copy();
+    bool batching = m_batching;
+#ifdef NS3_MTP
+    // the link may cross logical processes, which must not count the
+    // references to the buffers shared with p concurrently
+    if (src->GetNode()->GetSystemId() != m_link[wire].m_dst->GetNode()->GetSystemId())
+    {
+        copy->Share();
+        // whether a packet joins a train would depend on when the
+        // destination delivers the previous one
+        batching = false;
+    }
+#endif
+    if (batching && !m_link[wire].m_train)
+    {
+        m_link[wire].m_train = Create<Train>(m_link[wire].m_dst);
+    }
+    if (!batching || !m_link[wire].m_train->Add(copy, txTime + m_delay))
+    {
+        Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
+                                       txTime + m_delay,
+                                       &PointToPointNetDevice::Receive,
+                                       m_link[wire].m_dst,
+                                       copy);
+    }
 
     // Call the tx anim callback on the net device
     m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
@@ -129,6 +165,12 @@ PointToPointChannel::GetDevice(std::size_t i) const
     return GetPointToPointDevice(i);
 }
 
+bool
+PointToPointChannel::GetLinkCompression() const
+{
+    return m_compression;
+}
+
 Time
 PointToPointChannel::GetDelay() const
 {
@@ -155,4 +197,49 @@ PointToPointChannel::IsInitialized() const
     return true;
 }
 
+PointToPointChannel::Train::Train(Ptr<PointToPointNetDevice> dst)
+    : m_dst(dst),
+      m_pending(false)
+{
+}
+
+bool
+PointToPointChannel::Train::Add(Ptr<Packet> p, const Time& delay)
+{
+    NS_LOG_FUNCTION(this << p << delay);
+    int64_t ts = Simulator::Now().GetTimeStep() + delay.GetTimeStep();
+    if (!m_packets.empty() && ts < m_packets.back().first)
+    {
+        return false;
+    }
+    m_packets.emplace_back(ts, p);
+    if (!m_pending)
+    {
+        m_pending = true;
+        // the reference is released by the event list once invoked
+        Ref();
+        Simulator::ScheduleWithContext(m_dst->GetNode()->GetId(), delay, this);
+    }
+    return true;
+}
+
+void
+PointToPointChannel::Train::Notify()
+{
+    NS_LOG_FUNCTION(this);
+    Ptr<Packet> p = m_packets.front().second;
+    m_packets.pop_front();
+    if (!m_packets.empty())
+    {
+        // scheduled before the receive, as it would have been by the source
+        Simulator::Schedule(TimeStep(m_packets.front().first - Simulator::Now().GetTimeStep()),
+                            Ptr<EventImpl>(this));
+    }
+    else
+    {
+        m_pending = false;
+    }
+    m_dst->Receive(p);
+}
+
 } // namespace ns3
@@ -20,10 +20,12 @@
 
 #include "ns3/channel.h"
 #include "ns3/data-rate.h"
+#include "ns3/event-impl.h"
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
 #include "ns3/traced-callback.h"
 
+#include <deque>
 #include <list>
 
 namespace ns3
@@ -45,6 +47,15 @@ class Packet;
  * [0] wire to transmit on.  The second device gets the [1] wire.  There is a
  * state (IDLE, TRANSMITTING) associated with each wire.
  *
+ * With the Batching attribute, the packets in flight on a wire form a
+ * train delivered by a single event, re-scheduled at the receive time of
+ * each packet.  A train towards another logical process is posted once to
+ * its mailbox, and extended by the source while it is being delivered.
+ *
+ * With the LinkCompression attribute, the devices attached do not schedule
+ * the completion of a transmission on an uncongested hop, see
+ * PointToPointNetDevice::TransmitStart: only its receive is scheduled.
+ *
  * \see Attach
  * \see TransmitStart
  */
@@ -101,6 +112,13 @@ class PointToPointChannel : public Channel
      */
     Ptr<NetDevice> GetDevice(std::size_t i) const override;
 
+    /**
+     * \brief Get whether the devices attached compress the uncongested hops
+     * \returns true if the link is compressed, whatever the attribute of
+     * the devices
+     */
+    bool GetLinkCompression() const;
+
   protected:
     /**
      * \brief Get the delay associated with this channel
@@ -152,6 +170,8 @@ class PointToPointChannel : public Channel
     static const std::size_t N_DEVICES = 2;
 
     Time m_delay;           //!< Propagation delay
+    bool m_batching;        //!< Whether the packets in flight are delivered as trains
+    bool m_compression;     //!< Whether the devices compress the uncongested hops
     std::size_t m_nDevices; //!< Devices of this channel
 
     /**
@@ -188,6 +208,39 @@ class PointToPointChannel : public Channel
         PROPAGATING
     };
 
+    /**
+     * \brief The packets in flight on a wire, delivered to its destination
+     * by a single event re-scheduled for each of them.
+     *
+     * The source and the destination of the wire must run in the same
+     * logical process.
+     */
+    class Train : public EventImpl
+    {
+      public:
+        /**
+         * \brief Create an idle train
+         * \param dst The destination of the wire
+         */
+        Train(Ptr<PointToPointNetDevice> dst);
+
+        /**
+         * \brief Add a packet to the train, scheduling the train if idle
+         * \param p The packet
+         * \param delay The delay until the packet is received
+         * \returns false if the packet is received before the last packet
+         * of the train, in which case it was not added
+         */
+        bool Add(Ptr<Packet> p, const Time& delay);
+
+      private:
+        void Notify() override;
+
+        Ptr<PointToPointNetDevice> m_dst;                      //!< Destination
+        std::deque<std::pair<int64_t, Ptr<Packet>>> m_packets; //!< Receive times and packets
+        bool m_pending;                                        //!< Whether the train is scheduled
+    };
+
     /**
      * \brief Wire model for the PointToPointChannel
      */
@@ -207,6 +260,7 @@ class PointToPointChannel : public Channel
         WireState m_state;                //!< State of the link
         Ptr<PointToPointNetDevice> m_src; //!< First NetDevice
         Ptr<PointToPointNetDevice> m_dst; //!< Second NetDevice
+        Ptr<Train> m_train;               //!< Packets in flight, with Batching
     };
 
     Link m_link[N_DEVICES]; //!< Link model
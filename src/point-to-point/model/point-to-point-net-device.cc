@@ -20,6 +20,7 @@
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
 
+#include "ns3/boolean.h"
 #include "ns3/error-model.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
@@ -59,7 +60,8 @@ PointToPointNetDevice::GetTypeId()
             .AddAttribute("DataRate",
                           "The default data rate for point to point links",
                           DataRateValue(DataRate("32768b/s")),
-                          MakeDataRateAccessor(&PointToPointNetDevice::m_bps),
+                          MakeDataRateAccessor(&PointToPointNetDevice::SetDataRate,
+                                               &PointToPointNetDevice::GetDataRate),
                           MakeDataRateChecker())
             .AddAttribute("ReceiveErrorModel",
                           "The receiver error model used to simulate packet loss",
@@ -71,6 +73,20 @@ PointToPointNetDevice::GetTypeId()
                           TimeValue(Seconds(0.0)),
                           MakeTimeAccessor(&PointToPointNetDevice::m_tInterframeGap),
                           MakeTimeChecker())
+            .AddAttribute("TxBatching",
+                          "Whether the transmit completions of the packets sent back-to-back "
+                          "reuse a single event, rather than scheduling one event per packet.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PointToPointNetDevice::m_txBatching),
+                          MakeBooleanChecker())
+            .AddAttribute("LinkCompression",
+                          "Whether a packet transmitted while nothing else waits in the queue "
+                          "completes its transmission without an event, unless another packet "
+                          "is sent before its end.  Only used while the PhyTxEnd trace source "
+                          "is not connected.  See also the attribute of the channel.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PointToPointNetDevice::m_linkCompression),
+                          MakeBooleanChecker())
 
             //
             // Transmit queueing discipline for the device which includes its own set
@@ -176,11 +192,15 @@ PointToPointNetDevice::GetTypeId()
 
 PointToPointNetDevice::PointToPointNetDevice()
     : m_txMachineState(READY),
+      m_txBatching(false),
+      m_linkCompression(false),
+      m_txDeferred(false),
       m_channel(nullptr),
       m_linkUp(false),
       m_currentPkt(nullptr)
 {
     NS_LOG_FUNCTION(this);
+    m_txCompleteTimer.SetFunction(MakeCallback(&PointToPointNetDevice::TransmitComplete, this));
 }
 
 PointToPointNetDevice::~PointToPointNetDevice()
@@ -211,6 +231,7 @@ void
 PointToPointNetDevice::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_txCompleteTimer.Cancel();
     m_node = nullptr;
     m_channel = nullptr;
     m_receiveErrorModel = nullptr;
@@ -224,6 +245,13 @@ PointToPointNetDevice::SetDataRate(DataRate bps)
 {
     NS_LOG_FUNCTION(this);
     m_bps = bps;
+    m_txTime.SetDataRate(bps);
+}
+
+DataRate
+PointToPointNetDevice::GetDataRate() const
+{
+    return m_bps;
 }
 
 void
@@ -249,11 +277,28 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     m_currentPkt = p;
     m_phyTxBeginTrace(m_currentPkt);
 
-    Time txTime = m_bps.CalculateBytesTxTime(p->GetSize());
+    Time txTime = m_txTime.CalculateBytesTxTime(p->GetSize());
     Time txCompleteTime = txTime + m_tInterframeGap;
 
-    NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << txCompleteTime.As(Time::S));
-    Simulator::Schedule(txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+    if ((m_linkCompression || m_channel->GetLinkCompression()) && m_queue->IsEmpty() &&
+        m_phyTxEndTrace.IsEmpty())
+    {
+        // uncongested hop: nothing happens at the end of the transmission,
+        // unless a packet is sent before
+        NS_LOG_LOGIC("Defer TransmitCompleteEvent in " << txCompleteTime.As(Time::S));
+        m_txDeferred = true;
+        m_txEnd = Simulator::Now() + txCompleteTime;
+    }
+    else if (m_txBatching)
+    {
+        // the event of the previous packet of the train, if any, is re-armed
+        m_txCompleteTimer.Schedule(txCompleteTime);
+    }
+    else
+    {
+        NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << txCompleteTime.As(Time::S));
+        Simulator::Schedule(txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+    }
 
     bool result = m_channel->TransmitStart(p, this, txTime);
     if (!result)
@@ -297,6 +342,33 @@ PointToPointNetDevice::TransmitComplete()
     TransmitStart(p);
 }
 
+void
+PointToPointNetDevice::ResumeTransmission()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(m_txDeferred, "No transmission deferred");
+    m_txDeferred = false;
+
+    Time left = m_txEnd - Simulator::Now();
+    if (left.IsStrictlyPositive())
+    {
+        // contention: model the end of the transmission in progress
+        NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << left.As(Time::S));
+        if (m_txBatching)
+        {
+            m_txCompleteTimer.Schedule(left);
+        }
+        else
+        {
+            Simulator::Schedule(left, &PointToPointNetDevice::TransmitComplete, this);
+        }
+        return;
+    }
+    NS_LOG_LOGIC("Transmission completed at " << m_txEnd.As(Time::S));
+    m_txMachineState = READY;
+    m_currentPkt = nullptr;
+}
+
 bool
 PointToPointNetDevice::Attach(Ptr<PointToPointChannel> ch)
 {
@@ -356,9 +428,13 @@ PointToPointNetDevice::Receive(Ptr<Packet> packet)
 
         //
         // Trace sinks will expect complete packets, not packets without some of the
-        // headers.
+        // headers.  Copy the packet only if someone listens.
         //
-        Ptr<Packet> originalPacket = packet->Copy();
+        Ptr<Packet> originalPacket = packet;
+        if (!m_macRxTrace.IsEmpty() || !m_macPromiscRxTrace.IsEmpty())
+        {
+            originalPacket = packet->Copy();
+        }
 
         //
         // Strip off the point-to-point protocol header and forward this packet
@@ -534,6 +610,11 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
 
     m_macTxTrace(packet);
 
+    if (m_txDeferred)
+    {
+        ResumeTransmission();
+    }
+
     //
     // We should enqueue and dequeue the packet to hit the tracing hooks.
     //
@@ -21,6 +21,7 @@
 #include "ns3/address.h"
 #include "ns3/callback.h"
 #include "ns3/data-rate.h"
+#include "ns3/deadline-timer.h"
 #include "ns3/mac48-address.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
@@ -99,6 +100,13 @@ class PointToPointNetDevice : public NetDevice
      */
     void SetDataRate(DataRate bps);
 
+    /**
+     * Get the Data Rate used for transmission of packets.
+     *
+     * \return the data rate at which this object operates
+     */
+    DataRate GetDataRate() const;
+
     /**
      * Set the interframe gap used to separate packets.  The interframe gap
      * defines the minimum space required between packets sent by this device.
@@ -244,7 +252,10 @@ class PointToPointNetDevice : public NetDevice
      * the channel.  The corresponding method is called on the channel to let
      * it know that the physical device this class represents has virtually
      * started sending signals.  An event is scheduled for the time at which
-     * the bits have been completely transmitted.
+     * the bits have been completely transmitted.  With TxBatching, a single
+     * event is re-armed for all the packets of a busy period.  With
+     * LinkCompression, no event is scheduled when nothing is waiting to be
+     * transmitted, see ResumeTransmission().
      *
      * \see PointToPointChannel::TransmitStart ()
      * \see TransmitComplete()
@@ -261,6 +272,17 @@ class PointToPointNetDevice : public NetDevice
      */
     void TransmitComplete();
 
+    /**
+     * Catch up with a transmission started without a completion event, as
+     * a packet is sent.
+     *
+     * If the transmission is still in progress, its completion is
+     * scheduled as for any other transmission.  Otherwise, the device
+     * became ready at the end of the transmission, without any packet to
+     * transmit nor trace to fire then.
+     */
+    void ResumeTransmission();
+
     /**
      * \brief Make the link up and running
      *
@@ -288,12 +310,45 @@ class PointToPointNetDevice : public NetDevice
      */
     DataRate m_bps;
 
+    /**
+     * The transmission times at m_bps, updated when the data rate is set.
+     */
+    TxTimeCalculator m_txTime;
+
     /**
      * The interframe gap that the Net Device uses to throttle packet
      * transmission
      */
     Time m_tInterframeGap;
 
+    /**
+     * Whether the transmit completions of a busy period reuse a single event
+     */
+    bool m_txBatching;
+
+    /**
+     * The transmit completion of the packets sent back-to-back, used with
+     * TxBatching
+     */
+    DeadlineTimer m_txCompleteTimer;
+
+    /**
+     * Whether the transmissions of uncongested hops complete without an
+     * event
+     */
+    bool m_linkCompression;
+
+    /**
+     * Whether the current transmission completes without an event
+     */
+    bool m_txDeferred;
+
+    /**
+     * The end of the current transmission, including the interframe gap,
+     * if deferred
+     */
+    Time m_txEnd;
+
     /**
      * The PointToPointChannel to which this PointToPointNetDevice has been
      * attached.
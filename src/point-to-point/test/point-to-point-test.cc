@@ -17,6 +17,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include "ns3/boolean.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/point-to-point-channel.h"
@@ -24,7 +25,15 @@
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#ifdef NS3_MTP
+#include "ns3/global-value.h"
+#include "ns3/mtp-interface.h"
+#include "ns3/string.h"
+#endif
+
+#include <algorithm>
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -139,6 +148,359 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test the optional modes of PointToPoint devices and channels
+ *
+ * It sends single packets and bursts of back-to-back packets, and checks
+ * that the transmissions and the receptions happen at the same times with
+ * and without the mode enabled.
+ */
+class PointToPointModeTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     *
+     * \param name The name of the test.
+     * \param deviceAttribute Boolean attribute of the devices enabling the
+     * mode, if any.
+     * \param channelAttribute Boolean attribute of the channel enabling the
+     * mode, if any.
+     * \param traceTxEnd Whether the PhyTxEnd trace source is connected.
+     */
+    PointToPointModeTest(std::string name,
+                         std::string deviceAttribute,
+                         std::string channelAttribute,
+                         bool traceTxEnd);
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Send packets back-to-back through a device
+     *
+     * \param device NetDevice to send to.
+     * \param count Number of packets.
+     */
+    void SendBurst(Ptr<PointToPointNetDevice> device, uint32_t count);
+    /**
+     * \brief Record the start of a transmission
+     *
+     * \param pkt The packet transmitted.
+     */
+    void TxBegin(Ptr<const Packet> pkt);
+    /**
+     * \brief Record the end of a transmission
+     *
+     * \param pkt The packet transmitted.
+     */
+    void TxEnd(Ptr<const Packet> pkt);
+    /**
+     * \brief Record a received packet
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    /**
+     * \brief Run a simulation
+     *
+     * \param enabled Whether the mode is enabled.
+     */
+    void RunOnce(bool enabled);
+
+    std::string m_deviceAttribute;               //!< Attribute of the devices
+    std::string m_channelAttribute;              //!< Attribute of the channel
+    bool m_traceTxEnd;                           //!< Whether PhyTxEnd is traced
+    std::vector<std::pair<Time, uint32_t>> m_tx; //!< Transmission starts and ends
+    std::vector<std::pair<Time, uint32_t>> m_rx; //!< Receptions
+};
+
+PointToPointModeTest::PointToPointModeTest(std::string name,
+                                           std::string deviceAttribute,
+                                           std::string channelAttribute,
+                                           bool traceTxEnd)
+    : TestCase(name),
+      m_deviceAttribute(deviceAttribute),
+      m_channelAttribute(channelAttribute),
+      m_traceTxEnd(traceTxEnd)
+{
+}
+
+void
+PointToPointModeTest::SendBurst(Ptr<PointToPointNetDevice> device, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        device->Send(Create<Packet>(100 + 137 * i % 1400), device->GetBroadcast(), 0x800);
+    }
+}
+
+void
+PointToPointModeTest::TxBegin(Ptr<const Packet> pkt)
+{
+    m_tx.emplace_back(Simulator::Now(), pkt->GetSize());
+}
+
+void
+PointToPointModeTest::TxEnd(Ptr<const Packet> pkt)
+{
+    m_tx.emplace_back(Simulator::Now(), 0);
+}
+
+bool
+PointToPointModeTest::RxPacket(Ptr<NetDevice> dev,
+                               Ptr<const Packet> pkt,
+                               uint16_t mode,
+                               const Address& sender)
+{
+    m_rx.emplace_back(Simulator::Now(), pkt->GetSize());
+    return true;
+}
+
+void
+PointToPointModeTest::RunOnce(bool enabled)
+{
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+    channel->SetAttribute("Delay", TimeValue(MicroSeconds(10)));
+    if (!m_channelAttribute.empty())
+    {
+        channel->SetAttribute(m_channelAttribute, BooleanValue(enabled));
+    }
+
+    for (auto dev : {devA, devB})
+    {
+        dev->SetAttribute("DataRate", DataRateValue(DataRate("1Gbps")));
+        dev->SetAttribute("InterframeGap", TimeValue(NanoSeconds(96)));
+        if (!m_deviceAttribute.empty())
+        {
+            dev->SetAttribute(m_deviceAttribute, BooleanValue(enabled));
+        }
+        dev->Attach(channel);
+        dev->SetAddress(Mac48Address::Allocate());
+        dev->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    }
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    devA->TraceConnectWithoutContext("PhyTxBegin",
+                                     MakeCallback(&PointToPointModeTest::TxBegin, this));
+    if (m_traceTxEnd)
+    {
+        devA->TraceConnectWithoutContext("PhyTxEnd",
+                                         MakeCallback(&PointToPointModeTest::TxEnd, this));
+    }
+    devB->SetReceiveCallback(MakeCallback(&PointToPointModeTest::RxPacket, this));
+
+    // a burst longer than the propagation delay, another one once the link
+    // is idle, and one sent while the first packets are still in flight;
+    // then single packets on an idle link, during transmissions and after
+    // them
+    const std::pair<Time, uint32_t> sends[] = {
+        {Seconds(1), 50},
+        {Seconds(2), 3},
+        {Seconds(2) + MicroSeconds(5), 5},
+        {Seconds(3), 1},
+        {Seconds(3) + NanoSeconds(500), 1},
+        {Seconds(3) + NanoSeconds(1000), 1},
+        {Seconds(3) + NanoSeconds(2000), 1},
+        {Seconds(3) + MicroSeconds(10), 1},
+    };
+    for (const auto& [time, count] : sends)
+    {
+        Simulator::Schedule(time, &PointToPointModeTest::SendBurst, this, devA, count);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+PointToPointModeTest::DoRun()
+{
+    RunOnce(false);
+    auto tx = m_tx;
+    auto rx = m_rx;
+    m_tx.clear();
+    m_rx.clear();
+    RunOnce(true);
+
+    NS_TEST_ASSERT_MSG_EQ(rx.size(), 63, "Not all the packets were received");
+    NS_TEST_ASSERT_MSG_EQ(m_tx.size(), tx.size(), "Different transmissions with the mode");
+    NS_TEST_ASSERT_MSG_EQ(m_rx.size(), rx.size(), "Different receptions with the mode");
+    for (std::size_t i = 0; i < tx.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_tx[i].first, tx[i].first, "Transmission " << i);
+        NS_TEST_EXPECT_MSG_EQ(m_tx[i].second, tx[i].second, "Transmission " << i);
+    }
+    for (std::size_t i = 0; i < rx.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_rx[i].first, rx[i].first, "Reception " << i);
+        NS_TEST_EXPECT_MSG_EQ(m_rx[i].second, rx[i].second, "Reception " << i);
+    }
+}
+
+#ifdef NS3_MTP
+/**
+ * \brief Test batched transmissions with the multithreaded simulator
+ *
+ * Two nodes linked by a short wire share a logical process, and a long
+ * wire links them to a third one, in another logical process.  It checks
+ * that the packets are received at the same times and in the same order
+ * with and without batching.
+ */
+class PointToPointMtpTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointMtpTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Send packets back-to-back through a device
+     *
+     * \param device NetDevice to send to.
+     * \param count Number of packets.
+     */
+    void SendBurst(Ptr<PointToPointNetDevice> device, uint32_t count);
+    /**
+     * \brief Record a received packet
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    /**
+     * \brief Run a simulation
+     *
+     * \param batching Whether the devices and channels batch transmissions.
+     */
+    void RunOnce(bool batching);
+
+    std::vector<Ptr<NetDevice>> m_devices; //!< Devices, in creation order
+    /// Receptions by device, each written by the logical process of the device only
+    std::vector<std::vector<std::pair<Time, uint32_t>>> m_rx;
+};
+
+PointToPointMtpTest::PointToPointMtpTest()
+    : TestCase("PointToPoint batched transmissions between logical processes")
+{
+}
+
+void
+PointToPointMtpTest::SendBurst(Ptr<PointToPointNetDevice> device, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        device->Send(Create<Packet>(100 + 137 * i % 1400), device->GetBroadcast(), 0x800);
+    }
+}
+
+bool
+PointToPointMtpTest::RxPacket(Ptr<NetDevice> dev,
+                              Ptr<const Packet> pkt,
+                              uint16_t mode,
+                              const Address& sender)
+{
+    std::size_t i = std::find(m_devices.begin(), m_devices.end(), dev) - m_devices.begin();
+    m_rx[i].emplace_back(Simulator::Now(), pkt->GetSize());
+    return true;
+}
+
+void
+PointToPointMtpTest::RunOnce(bool batching)
+{
+    MtpInterface::Enable(2);
+    m_rx.assign(4, {});
+
+    Ptr<Node> nodes[] = {CreateObject<Node>(), CreateObject<Node>(), CreateObject<Node>()};
+    // wire to the third node first, so that the median delay separates it
+    const std::pair<uint32_t, Time> links[] = {
+        {2, MicroSeconds(10)},
+        {1, MicroSeconds(1)},
+    };
+    std::vector<Ptr<PointToPointNetDevice>> devices;
+    m_devices.clear();
+    for (const auto& [peer, delay] : links)
+    {
+        Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+        channel->SetAttribute("Delay", TimeValue(delay));
+        channel->SetAttribute("Batching", BooleanValue(batching));
+        for (auto node : {nodes[0], nodes[peer]})
+        {
+            Ptr<PointToPointNetDevice> dev = CreateObject<PointToPointNetDevice>();
+            dev->SetAttribute("DataRate", DataRateValue(DataRate("1Gbps")));
+            dev->SetAttribute("TxBatching", BooleanValue(batching));
+            dev->Attach(channel);
+            dev->SetAddress(Mac48Address::Allocate());
+            dev->SetQueue(CreateObject<DropTailQueue<Packet>>());
+            node->AddDevice(dev);
+            dev->SetReceiveCallback(MakeCallback(&PointToPointMtpTest::RxPacket, this));
+            devices.push_back(dev);
+            m_devices.push_back(dev);
+        }
+    }
+
+    // bursts longer than the propagation delays in both directions of both
+    // wires, overlapping each other
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        for (auto dev : devices)
+        {
+            Simulator::ScheduleWithContext(dev->GetNode()->GetId(),
+                                           Seconds(1) + MicroSeconds(7 * i),
+                                           &PointToPointMtpTest::SendBurst,
+                                           this,
+                                           dev,
+                                           20);
+        }
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+void
+PointToPointMtpTest::DoRun()
+{
+    RunOnce(false);
+    auto rx = m_rx;
+    RunOnce(true);
+
+    for (std::size_t i = 0; i < rx.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(rx[i].size(), 80, "Not all the packets were received, device " << i);
+        NS_TEST_ASSERT_MSG_EQ(m_rx[i].size(), rx[i].size(), "Different receptions, device " << i);
+        for (std::size_t j = 0; j < rx[i].size(); j++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(m_rx[i][j].first, rx[i][j].first, "Reception " << j);
+            NS_TEST_EXPECT_MSG_EQ(m_rx[i][j].second, rx[i][j].second, "Reception " << j);
+        }
+    }
+}
+#endif
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -155,6 +517,29 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::QUICK);
+    AddTestCase(new PointToPointModeTest("PointToPoint batched transmissions",
+                                         "TxBatching",
+                                         "Batching",
+                                         true),
+                TestCase::QUICK);
+    AddTestCase(new PointToPointModeTest("PointToPoint compressed devices",
+                                         "LinkCompression",
+                                         "",
+                                         false),
+                TestCase::QUICK);
+    AddTestCase(new PointToPointModeTest("PointToPoint compressed channel",
+                                         "",
+                                         "LinkCompression",
+                                         false),
+                TestCase::QUICK);
+    AddTestCase(new PointToPointModeTest("PointToPoint compressed channel, traced",
+                                         "",
+                                         "LinkCompression",
+                                         true),
+                TestCase::QUICK);
+#ifdef NS3_MTP
+    AddTestCase(new PointToPointMtpTest, TestCase::QUICK);
+#endif
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
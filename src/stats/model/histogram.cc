@@ -92,6 +92,16 @@ Histogram::AddValue(double value)
     m_histogram[index]++;
 }
 
+void
+Histogram::AddBinCount(uint32_t index, uint32_t count)
+{
+    if (index >= m_histogram.size())
+    {
+        m_histogram.resize(index + 1, 0);
+    }
+    m_histogram[index] += count;
+}
+
 void
 Histogram::Clear()
 {
@@ -69,6 +69,16 @@ HistogramTestCase::DoRun()
         NS_TEST_EXPECT_MSG_EQ(h0.GetNBins(), 22, "");
         NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(21), 1, "");
     }
+
+    {
+        // Testing bin counts added at once
+        h0.AddBinCount(1, 3);
+        h0.AddBinCount(24, 2);
+        NS_TEST_EXPECT_MSG_EQ(h0.GetNBins(), 25, "");
+        NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(1), 8, "");
+        NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(23), 0, "");
+        NS_TEST_EXPECT_MSG_EQ(h0.GetBinCount(24), 2, "");
+    }
 }
 
 /**
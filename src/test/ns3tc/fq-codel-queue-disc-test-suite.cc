@@ -34,6 +34,8 @@
 #include "ns3/test.h"
 #include "ns3/udp-header.h"
 
+#include <sstream>
+
 using namespace ns3;
 
 /// Variable to assign g_hash to a new packet's flow
@@ -1756,6 +1758,238 @@ FqCoDelQueueDiscL4sMode::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup system-tests-tc
+ *
+ * This class checks that the compact mode of FqCoDelQueueDisc behaves exactly
+ * as the default one: the same workload, which overflows the queue disc, makes
+ * CoDel drop or mark packets and lets the flows go idle, is run with and
+ * without the CompactFlows attribute, and the packets dequeued (with their
+ * ECN codepoint), dropped and marked (with the reason), and the statistics
+ * of the queue disc must be the same.
+ */
+class FqCoDelQueueDiscCompactFlows : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param desc the test description
+     * \param useEcn true to use ECN
+     * \param useL4s true to use L4S
+     * \param ceThreshold the CE threshold
+     * \param setAssociativeHash true to use the set associative hash
+     */
+    FqCoDelQueueDiscCompactFlows(std::string desc,
+                                 bool useEcn,
+                                 bool useL4s,
+                                 Time ceThreshold,
+                                 bool setAssociativeHash);
+
+  private:
+    void DoRun() override;
+    /**
+     * Run the workload.
+     * \param compactFlows the value of the CompactFlows attribute
+     * \return the log of the packets dequeued, dropped and marked, and the statistics
+     */
+    std::string RunWorkload(bool compactFlows);
+    /**
+     * Enqueue a packet.
+     * \param queue the queue disc
+     * \param flow the flow of the packet
+     * \param size the size of the packet
+     * \param ecn the ECN codepoint of the packet
+     */
+    void AddPacket(Ptr<FqCoDelQueueDisc> queue,
+                   int32_t flow,
+                   uint32_t size,
+                   Ipv4Header::EcnType ecn);
+    /**
+     * Dequeue a packet and log it.
+     * \param queue the queue disc
+     */
+    void Dequeue(Ptr<FqCoDelQueueDisc> queue);
+    /**
+     * Log a packet dropped or marked.
+     * \param event the event
+     * \param item the packet
+     * \param reason the reason
+     */
+    void Log(std::string event, Ptr<const QueueDiscItem> item, const char* reason);
+
+    bool m_useEcn;             //!< True to use ECN
+    bool m_useL4s;             //!< True to use L4S
+    Time m_ceThreshold;        //!< The CE threshold
+    bool m_setAssociativeHash; //!< True to use the set associative hash
+    std::ostringstream m_log;  //!< The log of the current run
+    uint64_t m_firstUid;       //!< The UID of the first packet of the current run
+};
+
+FqCoDelQueueDiscCompactFlows::FqCoDelQueueDiscCompactFlows(std::string desc,
+                                                           bool useEcn,
+                                                           bool useL4s,
+                                                           Time ceThreshold,
+                                                           bool setAssociativeHash)
+    : TestCase(desc),
+      m_useEcn(useEcn),
+      m_useL4s(useL4s),
+      m_ceThreshold(ceThreshold),
+      m_setAssociativeHash(setAssociativeHash),
+      m_firstUid(0)
+{
+}
+
+void
+FqCoDelQueueDiscCompactFlows::AddPacket(Ptr<FqCoDelQueueDisc> queue,
+                                        int32_t flow,
+                                        uint32_t size,
+                                        Ipv4Header::EcnType ecn)
+{
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(size);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetDestination(Ipv4Address("10.10.1.2"));
+    hdr.SetProtocol(7);
+    hdr.SetEcn(ecn);
+    Ptr<Packet> p = Create<Packet>(size);
+    Address dest;
+    Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem>(p, dest, 0, hdr);
+    g_hash = flow;
+    queue->Enqueue(item);
+}
+
+void
+FqCoDelQueueDiscCompactFlows::Dequeue(Ptr<FqCoDelQueueDisc> queue)
+{
+    Ptr<QueueDiscItem> item = queue->Dequeue();
+    if (item)
+    {
+        m_log << Simulator::Now().GetNanoSeconds() << " dequeue "
+              << item->GetPacket()->GetUid() - m_firstUid << " "
+              << DynamicCast<Ipv4QueueDiscItem>(item)->GetHeader().GetEcn() << "\n";
+    }
+}
+
+void
+FqCoDelQueueDiscCompactFlows::Log(std::string event,
+                                  Ptr<const QueueDiscItem> item,
+                                  const char* reason)
+{
+    m_log << Simulator::Now().GetNanoSeconds() << " " << event << " "
+          << item->GetPacket()->GetUid() - m_firstUid << " " << reason << "\n";
+}
+
+std::string
+FqCoDelQueueDiscCompactFlows::RunWorkload(bool compactFlows)
+{
+    Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc>(
+        "MaxSize",
+        QueueSizeValue(QueueSize("256p")),
+        "Flows",
+        UintegerValue(32),
+        "DropBatchSize",
+        UintegerValue(8),
+        "UseEcn",
+        BooleanValue(m_useEcn),
+        "UseL4s",
+        BooleanValue(m_useL4s),
+        "CeThreshold",
+        TimeValue(m_ceThreshold),
+        "EnableSetAssociativeHash",
+        BooleanValue(m_setAssociativeHash),
+        "CompactFlows",
+        BooleanValue(compactFlows));
+    queueDisc->SetQuantum(1500);
+    queueDisc->AddPacketFilter(CreateObject<Ipv4TestPacketFilter>());
+    queueDisc->Initialize();
+
+    queueDisc->TraceConnectWithoutContext(
+        "DropBeforeEnqueue",
+        MakeCallback(&FqCoDelQueueDiscCompactFlows::Log, this).Bind(std::string("dbe")));
+    queueDisc->TraceConnectWithoutContext(
+        "DropAfterDequeue",
+        MakeCallback(&FqCoDelQueueDiscCompactFlows::Log, this).Bind(std::string("dad")));
+    queueDisc->TraceConnectWithoutContext(
+        "Mark",
+        MakeCallback(&FqCoDelQueueDiscCompactFlows::Log, this).Bind(std::string("mark")));
+
+    m_log.str("");
+    m_firstUid = Create<Packet>()->GetUid() + 1;
+
+    // Every 100us for the first 120ms of each 200ms period, a few packets
+    // arrive from four heavy flows and many light ones, while a packet is
+    // dequeued every 250us: the queue disc overflows, the heavy flows build
+    // standing queues and all the flows go idle at the end of each period
+    uint32_t rand = 12345;
+    auto next = [&rand]() {
+        rand = rand * 1103515245 + 12345;
+        return (rand >> 16) & 0x7fff;
+    };
+    for (uint32_t slot = 0; slot < 10000; slot++)
+    {
+        if (slot % 2000 >= 1200)
+        {
+            continue;
+        }
+        for (uint32_t n = next() % 4; n > 0; n--)
+        {
+            int32_t flow = (next() % 2) ? next() % 4 : next() % 40;
+            uint32_t size = 100 + next() % 1401;
+            auto ecn = static_cast<Ipv4Header::EcnType>(next() % 3);
+            Simulator::Schedule(MicroSeconds(100 * slot),
+                                &FqCoDelQueueDiscCompactFlows::AddPacket,
+                                this,
+                                queueDisc,
+                                flow,
+                                size,
+                                ecn);
+        }
+    }
+    for (uint32_t slot = 0; slot < 10000; slot++)
+    {
+        Simulator::Schedule(MicroSeconds(250 * slot + 50),
+                            &FqCoDelQueueDiscCompactFlows::Dequeue,
+                            this,
+                            queueDisc);
+    }
+    Simulator::Run();
+
+    m_log << queueDisc->GetStats() << "\n" << queueDisc->GetNPackets() << " packets left\n";
+    Simulator::Destroy();
+    return m_log.str();
+}
+
+void
+FqCoDelQueueDiscCompactFlows::DoRun()
+{
+    std::string expected = RunWorkload(false);
+    std::string actual = RunWorkload(true);
+
+    NS_TEST_ASSERT_MSG_EQ((expected.find(CoDelQueueDisc::TARGET_EXCEEDED_DROP) !=
+                           std::string::npos),
+                          true,
+                          "The workload should make CoDel drop packets");
+    NS_TEST_ASSERT_MSG_EQ((expected.find(FqCoDelQueueDisc::OVERLIMIT_DROP) != std::string::npos),
+                          true,
+                          "The workload should overflow the queue disc");
+    // compare line by line to report the first difference only
+    std::istringstream expectedLines(expected);
+    std::istringstream actualLines(actual);
+    std::string expectedLine;
+    std::string actualLine;
+    for (uint32_t line = 1; std::getline(expectedLines, expectedLine); line++)
+    {
+        actualLine.clear();
+        std::getline(actualLines, actualLine);
+        NS_TEST_ASSERT_MSG_EQ(actualLine,
+                              expectedLine,
+                              "The compact mode should behave as the default one (line "
+                                  << line << ")");
+    }
+    NS_TEST_ASSERT_MSG_EQ(actual.size(), expected.size(), "The compact mode logged more events");
+}
+
 /**
  * \ingroup system-tests-tc
  *
@@ -1778,6 +2012,25 @@ FqCoDelQueueDiscTestSuite::FqCoDelQueueDiscTestSuite()
     AddTestCase(new FqCoDelQueueDiscECNMarking, TestCase::QUICK);
     AddTestCase(new FqCoDelQueueDiscSetLinearProbing, TestCase::QUICK);
     AddTestCase(new FqCoDelQueueDiscL4sMode, TestCase::QUICK);
+    AddTestCase(new FqCoDelQueueDiscCompactFlows("Test the compact mode",
+                                                 false,
+                                                 false,
+                                                 Time::Max(),
+                                                 false),
+                TestCase::QUICK);
+    AddTestCase(new FqCoDelQueueDiscCompactFlows(
+                    "Test the compact mode with ECN, CE threshold and set associative hash",
+                    true,
+                    false,
+                    MilliSeconds(2),
+                    true),
+                TestCase::QUICK);
+    AddTestCase(new FqCoDelQueueDiscCompactFlows("Test the compact mode in L4S mode",
+                                                 true,
+                                                 true,
+                                                 MilliSeconds(1),
+                                                 false),
+                TestCase::QUICK);
 }
 
 /// Do not forget to allocate an instance of this TestSuite.
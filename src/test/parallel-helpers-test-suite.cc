@@ -0,0 +1,230 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This is not a test of a single helper, but checks that a topology built
+// with the parallel variants of the point-to-point, internet stack, traffic
+// control and IPv4 address helpers is the same as one built serially.
+
+#include "ns3/channel.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4.h"
+#include "ns3/mac48-address.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/parallel-construction.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup system-tests-tc
+ *
+ * \brief Compare a two-tier topology built with the parallel helpers to the
+ * same topology built serially.
+ *
+ * Eight hosts are linked to four edge switches, each linked to two core
+ * switches.  The switch devices get a RED root queue disc and every link
+ * its own subnet.  The node ids, the MAC addresses, interface indexes and
+ * IPv4 addresses of the devices, their queue discs, the number of random
+ * variable streams allocated and the global routing tables must be the same.
+ */
+class ParallelHelpersTestCase : public TestCase
+{
+  public:
+    ParallelHelpersTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Build the topology and describe it
+     * \param parallel whether to use the parallel variants of the helpers
+     * \returns the description of the topology
+     */
+    std::string Build(bool parallel);
+};
+
+ParallelHelpersTestCase::ParallelHelpersTestCase()
+    : TestCase("Check that the parallel helpers build the same topology as the serial ones")
+{
+}
+
+std::string
+ParallelHelpersTestCase::Build(bool parallel)
+{
+    const uint32_t nHosts = 8;
+    const uint32_t nEdges = 4;
+    const uint32_t nCores = 2;
+
+    Mac48Address::ResetAllocationIndex();
+    Ipv4AddressGenerator::Reset();
+    uint64_t firstStream = RngSeedManager::GetNextStreamIndex();
+
+    NodeContainer hosts(nHosts);
+    NodeContainer edges(nEdges);
+    NodeContainer cores(nCores);
+
+    // the host links, then the core links
+    NodeContainer ends[2];
+    for (uint32_t i = 0; i < nHosts; i++)
+    {
+        ends[0].Add(hosts.Get(i));
+        ends[1].Add(edges.Get(i * nEdges / nHosts));
+    }
+    for (uint32_t i = 0; i < nEdges; i++)
+    {
+        for (uint32_t j = 0; j < nCores; j++)
+        {
+            ends[0].Add(edges.Get(i));
+            ends[1].Add(cores.Get(j));
+        }
+    }
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("1ms"));
+    InternetStackHelper internet;
+    TrafficControlHelper red;
+    red.SetRootQueueDisc("ns3::RedQueueDisc");
+    Ipv4AddressHelper addr;
+
+    NetDeviceContainer devices;
+    if (parallel)
+    {
+        devices = p2p.InstallParallel(ends[0], ends[1]);
+        internet.InstallParallel(NodeContainer::GetGlobal());
+    }
+    else
+    {
+        for (uint32_t i = 0; i < ends[0].GetN(); i++)
+        {
+            devices.Add(p2p.Install(ends[0].Get(i), ends[1].Get(i)));
+        }
+        internet.Install(NodeContainer::GetGlobal());
+    }
+
+    NetDeviceContainer switchDevices;
+    for (uint32_t i = 0; i < devices.GetN(); i++)
+    {
+        if (i >= nHosts * 2 || i % 2 == 1)
+        {
+            switchDevices.Add(devices.Get(i));
+        }
+    }
+    if (parallel)
+    {
+        red.InstallParallel(switchDevices);
+    }
+    else
+    {
+        red.Install(switchDevices);
+    }
+
+    for (uint32_t i = 0; i < ends[0].GetN(); i++)
+    {
+        std::ostringstream subnet;
+        subnet << "10." << i / 256 << "." << i % 256 << ".0";
+        addr.SetBase(subnet.str().c_str(), "255.255.255.0");
+        NetDeviceContainer link(devices.Get(i * 2), devices.Get(i * 2 + 1));
+        if (parallel)
+        {
+            addr.AssignParallel(link);
+        }
+        else
+        {
+            addr.Assign(link);
+        }
+    }
+
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    std::ostringstream oss;
+    oss << "streams " << RngSeedManager::GetNextStreamIndex() - firstStream << std::endl;
+    for (uint32_t i = 0; i < NodeList::GetNNodes(); i++)
+    {
+        Ptr<Node> node = NodeList::GetNode(i);
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+        oss << "node " << node->GetId() << std::endl;
+        for (uint32_t j = 0; j < node->GetNDevices(); j++)
+        {
+            Ptr<NetDevice> device = node->GetDevice(j);
+            oss << " device " << device->GetIfIndex() << " " << device->GetAddress();
+            if (device->GetChannel())
+            {
+                oss << " channel " << device->GetChannel()->GetId();
+            }
+            int32_t interface = ipv4->GetInterfaceForDevice(device);
+            oss << " interface " << interface;
+            for (uint32_t k = 0; interface >= 0 && k < ipv4->GetNAddresses(interface); k++)
+            {
+                oss << " " << ipv4->GetAddress(interface, k).GetLocal();
+            }
+            Ptr<QueueDisc> qd = tc->GetRootQueueDiscOnDevice(device);
+            oss << " " << (qd ? qd->GetInstanceTypeId().GetName() : "none") << std::endl;
+        }
+        ipv4->GetRoutingProtocol()->PrintRoutingTable(Create<OutputStreamWrapper>(&oss), Time::S);
+    }
+
+    Simulator::Destroy();
+    return oss.str();
+}
+
+void
+ParallelHelpersTestCase::DoRun()
+{
+    std::string serial = Build(false);
+    // use several threads even on a single processor
+    ParallelConstruction::SetMaxThreads(4);
+    std::string parallel = Build(true);
+    ParallelConstruction::SetMaxThreads(0);
+
+    NS_TEST_EXPECT_MSG_EQ(parallel, serial, "The parallel helpers built another topology");
+}
+
+/**
+ * \ingroup system-tests-tc
+ *
+ * The parallel helpers test suite.
+ */
+class ParallelHelpersTestSuite : public TestSuite
+{
+  public:
+    ParallelHelpersTestSuite();
+};
+
+ParallelHelpersTestSuite::ParallelHelpersTestSuite()
+    : TestSuite("parallel-helpers", SYSTEM)
+{
+    AddTestCase(new ParallelHelpersTestCase(), TestCase::QUICK);
+}
+
+/// Do not forget to allocate an instance of this TestSuite
+static ParallelHelpersTestSuite g_parallelHelpersTestSuite;
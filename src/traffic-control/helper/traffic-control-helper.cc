@@ -22,11 +22,14 @@
 #include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/parallel-construction.h"
 #include "ns3/pointer.h"
 #include "ns3/queue-limits.h"
 #include "ns3/traffic-control-layer.h"
 #include "ns3/uinteger.h"
 
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -258,6 +261,38 @@ TrafficControlHelper::Install(NetDeviceContainer c)
     return container;
 }
 
+QueueDiscContainer
+TrafficControlHelper::InstallParallel(NetDeviceContainer c)
+{
+    // the devices of a node share its traffic control layer
+    std::vector<std::vector<uint32_t>> groups;
+    std::unordered_map<Ptr<Node>, std::size_t> groupOfNode;
+    for (uint32_t i = 0; i < c.GetN(); i++)
+    {
+        auto [it, added] = groupOfNode.emplace(c.Get(i)->GetNode(), groups.size());
+        if (added)
+        {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(i);
+    }
+
+    // Install() keeps the queue discs being created in the helper, hence
+    // each device is handled by a copy of the helper
+    std::vector<QueueDiscContainer> queueDiscs(c.GetN());
+    ParallelConstruction::For(groups, [&](uint32_t i) {
+        TrafficControlHelper helper = *this;
+        queueDiscs[i] = helper.Install(c.Get(i));
+    });
+
+    QueueDiscContainer container;
+    for (const auto& qd : queueDiscs)
+    {
+        container.Add(qd);
+    }
+    return container;
+}
+
 void
 TrafficControlHelper::Uninstall(Ptr<NetDevice> d)
 {
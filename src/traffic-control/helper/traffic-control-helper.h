@@ -267,6 +267,18 @@ class TrafficControlHelper
      */
     QueueDiscContainer Install(NetDeviceContainer c);
 
+    /**
+     * \param c set of devices
+     * \returns a QueueDisc container with the root queue discs installed on the devices
+     *
+     * This method installs the queue discs on each device in the given
+     * container, like Install(NetDeviceContainer), the nodes being handled
+     * in parallel.
+     *
+     * \see ParallelConstruction
+     */
+    QueueDiscContainer InstallParallel(NetDeviceContainer c);
+
     /**
      * \param d device
      * \returns a QueueDisc container with the root queue disc installed on the device
@@ -177,8 +177,6 @@ CobaltQueueDisc::InitializeParams()
 {
     // Cobalt parameters
     NS_LOG_FUNCTION(this);
-    m_recInvSqrtCache[0] = ~0;
-    CacheInit();
     m_count = 0;
     m_dropping = false;
     m_recInvSqrt = ~0U;
@@ -199,7 +197,7 @@ CobaltQueueDisc::CoDelTimeAfterEq(int64_t a, int64_t b)
 }
 
 int64_t
-CobaltQueueDisc::Time2CoDel(Time t) const
+CobaltQueueDisc::Time2CoDel(Time t)
 {
     return (t.GetNanoSeconds());
 }
@@ -222,53 +220,84 @@ CobaltQueueDisc::GetDropNext() const
     return m_dropNext;
 }
 
-void
-CobaltQueueDisc::NewtonStep()
+CobaltQueueDisc::Params
+CobaltQueueDisc::GetParams() const
 {
-    NS_LOG_FUNCTION(this);
-    uint32_t invsqrt = ((uint32_t)m_recInvSqrt);
+    return Params{m_useEcn,
+                  m_useL4s,
+                  Time2CoDel(m_interval),
+                  Time2CoDel(m_target),
+                  Time2CoDel(m_ceThreshold),
+                  Time2CoDel(m_blueThreshold),
+                  m_increment,
+                  m_decrement};
+}
+
+CobaltQueueDisc::TracedState
+CobaltQueueDisc::GetState()
+{
+    return TracedState{m_count,
+                       m_dropNext,
+                       m_dropping,
+                       m_recInvSqrt,
+                       m_lastUpdateTimeBlue,
+                       m_pDrop,
+                       m_uv};
+}
+
+uint32_t
+CobaltQueueDisc::NewtonStep(uint32_t recInvSqrt, uint32_t count)
+{
+    NS_LOG_FUNCTION_NOARGS();
+    uint32_t invsqrt = recInvSqrt;
     uint32_t invsqrt2 = ((uint64_t)invsqrt * invsqrt) >> 32;
-    uint64_t val = (3LL << 32) - ((uint64_t)m_count * invsqrt2);
+    uint64_t val = (3LL << 32) - ((uint64_t)count * invsqrt2);
 
     val >>= 2; /* avoid overflow */
     val = (val * invsqrt) >> (32 - 2 + 1);
-    m_recInvSqrt = val;
+    return val;
 }
 
-void
-CobaltQueueDisc::CacheInit()
+const std::array<uint32_t, REC_INV_SQRT_CACHE>&
+CobaltQueueDisc::GetRecInvSqrtCache()
 {
-    m_recInvSqrt = ~0U;
-    m_recInvSqrtCache[0] = m_recInvSqrt;
+    static const std::array<uint32_t, REC_INV_SQRT_CACHE> cache = [] {
+        std::array<uint32_t, REC_INV_SQRT_CACHE> values;
+        uint32_t recInvSqrt = ~0U;
+        values[0] = recInvSqrt;
 
-    for (m_count = 1; m_count < (uint32_t)(REC_INV_SQRT_CACHE); m_count++)
-    {
-        NewtonStep();
-        NewtonStep();
-        NewtonStep();
-        NewtonStep();
-        m_recInvSqrtCache[m_count] = m_recInvSqrt;
-    }
+        for (uint32_t count = 1; count < values.size(); count++)
+        {
+            recInvSqrt = NewtonStep(recInvSqrt, count);
+            recInvSqrt = NewtonStep(recInvSqrt, count);
+            recInvSqrt = NewtonStep(recInvSqrt, count);
+            recInvSqrt = NewtonStep(recInvSqrt, count);
+            values[count] = recInvSqrt;
+        }
+        return values;
+    }();
+    return cache;
 }
 
+template <typename State>
 void
-CobaltQueueDisc::InvSqrt()
+CobaltQueueDisc::InvSqrt(State& state)
 {
-    if (m_count < (uint32_t)REC_INV_SQRT_CACHE)
+    if (state.count < (uint32_t)REC_INV_SQRT_CACHE)
     {
-        m_recInvSqrt = m_recInvSqrtCache[m_count];
+        state.recInvSqrt = GetRecInvSqrtCache()[state.count];
     }
     else
     {
-        NewtonStep();
+        state.recInvSqrt = NewtonStep(state.recInvSqrt, state.count);
     }
 }
 
 int64_t
-CobaltQueueDisc::ControlLaw(int64_t t)
+CobaltQueueDisc::ControlLaw(int64_t t, int64_t interval, uint32_t recInvSqrt)
 {
-    NS_LOG_FUNCTION(this);
-    return t + ReciprocalDivide(Time2CoDel(m_interval), m_recInvSqrt);
+    NS_LOG_FUNCTION_NOARGS();
+    return t + ReciprocalDivide(interval, recInvSqrt);
 }
 
 void
@@ -338,7 +367,8 @@ CobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         NS_LOG_LOGIC("Queue full -- dropping pkt");
         int64_t now = CoDelGetTime();
         // Call this to update Blue's drop probability
-        CobaltQueueFull(now);
+        TracedState state = GetState();
+        CobaltQueueFull(GetParams(), state, now);
         DropBeforeEnqueue(item, OVERLIMIT_DROP);
         return false;
     }
@@ -359,33 +389,86 @@ CobaltQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
+    /// The internal queue of this queue disc
+    class InternalPacketQueue : public PacketQueue
+    {
+      public:
+        /**
+         * Constructor
+         * \param qd the queue disc
+         */
+        InternalPacketQueue(CobaltQueueDisc* qd)
+            : m_qd(qd)
+        {
+        }
+
+        Ptr<QueueDiscItem> Pop() override
+        {
+            return m_qd->GetInternalQueue(0)->Dequeue();
+        }
+
+        uint32_t GetNPackets() const override
+        {
+            return m_qd->GetInternalQueue(0)->GetNPackets();
+        }
+
+        uint32_t GetNBytes() const override
+        {
+            return m_qd->GetInternalQueue(0)->GetNBytes();
+        }
+
+        bool Mark(Ptr<QueueDiscItem> item, const char* reason) override
+        {
+            return m_qd->Mark(item, reason);
+        }
+
+        void Drop(Ptr<QueueDiscItem> item, const char* reason) override
+        {
+            m_qd->DropAfterDequeue(item, reason);
+        }
+
+      private:
+        CobaltQueueDisc* m_qd; //!< The queue disc
+    };
+
+    TracedState state = GetState();
+    InternalPacketQueue queue(this);
+    return DequeueFrom(GetParams(), state, queue);
+}
+
+template <typename State>
+Ptr<QueueDiscItem>
+CobaltQueueDisc::DequeueFrom(const Params& params, State& state, PacketQueue& queue)
+{
+    NS_LOG_FUNCTION_NOARGS();
+
     while (true)
     {
-        Ptr<QueueDiscItem> item = GetInternalQueue(0)->Dequeue();
+        Ptr<QueueDiscItem> item = queue.Pop();
         if (!item)
         {
             // Leave dropping state when queue is empty (derived from Codel)
-            m_dropping = false;
+            state.dropping = false;
             NS_LOG_LOGIC("Queue empty");
             int64_t now = CoDelGetTime();
             // Call this to update Blue's drop probability
-            CobaltQueueEmpty(now);
+            CobaltQueueEmpty(params, state, now);
             return nullptr;
         }
 
         int64_t now = CoDelGetTime();
 
         NS_LOG_LOGIC("Popped " << item);
-        NS_LOG_LOGIC("Number packets remaining " << GetInternalQueue(0)->GetNPackets());
-        NS_LOG_LOGIC("Number bytes remaining " << GetInternalQueue(0)->GetNBytes());
+        NS_LOG_LOGIC("Number packets remaining " << queue.GetNPackets());
+        NS_LOG_LOGIC("Number bytes remaining " << queue.GetNBytes());
 
         // Determine if item should be dropped
         // ECN marking happens inside this function, so it need not be done here
-        bool drop = CobaltShouldDrop(item, now);
+        bool drop = CobaltShouldDrop(params, state, queue, item, now);
 
         if (drop)
         {
-            DropAfterDequeue(item, TARGET_EXCEEDED_DROP);
+            queue.Drop(item, TARGET_EXCEEDED_DROP);
         }
         else
         {
@@ -395,65 +478,72 @@ CobaltQueueDisc::DoDequeue()
 }
 
 // Call this when a packet had to be dropped due to queue overflow.
+template <typename State>
 void
-CobaltQueueDisc::CobaltQueueFull(int64_t now)
+CobaltQueueDisc::CobaltQueueFull(const Params& params, State& state, int64_t now)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION_NOARGS();
     NS_LOG_LOGIC("Outside IF block");
-    if (CoDelTimeAfter((now - m_lastUpdateTimeBlue), Time2CoDel(m_target)))
+    if (CoDelTimeAfter((now - state.lastUpdateTimeBlue), params.target))
     {
         NS_LOG_LOGIC("inside IF block");
-        m_pDrop = std::min(m_pDrop + m_increment, 1.0);
-        m_lastUpdateTimeBlue = now;
+        state.pDrop = std::min(state.pDrop + params.increment, 1.0);
+        state.lastUpdateTimeBlue = now;
     }
-    m_dropping = true;
-    m_dropNext = now;
-    if (!m_count)
+    state.dropping = true;
+    state.dropNext = now;
+    if (!state.count)
     {
-        m_count = 1;
+        state.count = 1;
     }
 }
 
 // Call this when the queue was serviced but turned out to be empty.
+template <typename State>
 void
-CobaltQueueDisc::CobaltQueueEmpty(int64_t now)
+CobaltQueueDisc::CobaltQueueEmpty(const Params& params, State& state, int64_t now)
 {
-    NS_LOG_FUNCTION(this);
-    if (m_pDrop && CoDelTimeAfter((now - m_lastUpdateTimeBlue), Time2CoDel(m_target)))
+    NS_LOG_FUNCTION_NOARGS();
+    if (state.pDrop && CoDelTimeAfter((now - state.lastUpdateTimeBlue), params.target))
     {
-        m_pDrop = std::max(m_pDrop - m_decrement, 0.0);
-        m_lastUpdateTimeBlue = now;
+        state.pDrop = std::max(state.pDrop - params.decrement, 0.0);
+        state.lastUpdateTimeBlue = now;
     }
-    m_dropping = false;
+    state.dropping = false;
 
-    if (m_count && CoDelTimeAfterEq((now - m_dropNext), 0))
+    if (state.count && CoDelTimeAfterEq((now - state.dropNext), 0))
     {
-        m_count--;
-        InvSqrt();
-        m_dropNext = ControlLaw(m_dropNext);
+        state.count--;
+        InvSqrt(state);
+        state.dropNext = ControlLaw(state.dropNext, params.interval, state.recInvSqrt);
     }
 }
 
 // Determines if Cobalt should drop the packet
+template <typename State>
 bool
-CobaltQueueDisc::CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now)
+CobaltQueueDisc::CobaltShouldDrop(const Params& params,
+                                  State& state,
+                                  PacketQueue& queue,
+                                  Ptr<QueueDiscItem> item,
+                                  int64_t now)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION_NOARGS();
     bool drop = false;
 
     /* Simplified Codel implementation */
     Time delta = Simulator::Now() - item->GetTimeStamp();
     NS_LOG_INFO("Sojourn time " << delta.As(Time::S));
     int64_t sojournTime = Time2CoDel(delta);
-    int64_t schedule = now - m_dropNext;
-    bool over_target = CoDelTimeAfter(sojournTime, Time2CoDel(m_target));
-    bool next_due = m_count && schedule >= 0;
+    int64_t schedule = now - state.dropNext;
+    bool over_target = CoDelTimeAfter(sojournTime, params.target);
+    bool next_due = state.count && schedule >= 0;
     bool isMarked = false;
 
     // If L4S mode is enabled then check if the packet is ECT1 or CE and
     // if sojourn time is greater than CE threshold then the packet is marked.
     // If packet is marked successfully then the CoDel steps can be skipped.
-    if (item && m_useL4s)
+    if (item && params.useL4s)
     {
         uint8_t tosByte = 0;
         if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
@@ -467,10 +557,10 @@ CobaltQueueDisc::CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now)
             {
                 NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
             }
-            if (CoDelTimeAfter(sojournTime, Time2CoDel(m_ceThreshold)) &&
-                Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+            if (CoDelTimeAfter(sojournTime, params.ceThreshold) &&
+                queue.Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
             {
-                NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+                NS_LOG_LOGIC("Marking due to CeThreshold " << params.ceThreshold);
             }
             return false;
         }
@@ -478,84 +568,97 @@ CobaltQueueDisc::CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now)
 
     if (over_target)
     {
-        if (!m_dropping)
+        if (!state.dropping)
         {
-            m_dropping = true;
-            m_dropNext = ControlLaw(now);
+            state.dropping = true;
+            state.dropNext = ControlLaw(now, params.interval, state.recInvSqrt);
         }
-        if (!m_count)
+        if (!state.count)
         {
-            m_count = 1;
+            state.count = 1;
         }
     }
-    else if (m_dropping)
+    else if (state.dropping)
     {
-        m_dropping = false;
+        state.dropping = false;
     }
 
-    if (next_due && m_dropping)
+    if (next_due && state.dropping)
     {
         /* Check for marking possibility only if BLUE decides NOT to drop. */
         /* Check if router and packet, both have ECN enabled. Only if this is true, mark the packet.
          */
-        isMarked = (m_useEcn && Mark(item, FORCED_MARK));
+        isMarked = (params.useEcn && queue.Mark(item, FORCED_MARK));
         drop = !isMarked;
 
-        m_count = std::max(m_count, m_count + 1);
+        state.count = std::max(state.count, state.count + 1);
 
-        InvSqrt();
-        m_dropNext = ControlLaw(m_dropNext);
-        schedule = now - m_dropNext;
+        InvSqrt(state);
+        state.dropNext = ControlLaw(state.dropNext, params.interval, state.recInvSqrt);
+        schedule = now - state.dropNext;
     }
     else
     {
         while (next_due)
         {
-            m_count--;
-            InvSqrt();
-            m_dropNext = ControlLaw(m_dropNext);
-            schedule = now - m_dropNext;
-            next_due = m_count && schedule >= 0;
+            state.count--;
+            InvSqrt(state);
+            state.dropNext = ControlLaw(state.dropNext, params.interval, state.recInvSqrt);
+            schedule = now - state.dropNext;
+            next_due = state.count && schedule >= 0;
         }
     }
 
     // If CE threshold is enabled then isMarked flag is used to determine whether
     // packet is marked and if the packet is marked then a second attempt at marking should be
     // suppressed. If UseL4S attribute is enabled then ECT0 packets should not be marked.
-    if (!isMarked && !m_useL4s && m_useEcn &&
-        CoDelTimeAfter(sojournTime, Time2CoDel(m_ceThreshold)) &&
-        Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+    if (!isMarked && !params.useL4s && params.useEcn &&
+        CoDelTimeAfter(sojournTime, params.ceThreshold) &&
+        queue.Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
     {
-        NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+        NS_LOG_LOGIC("Marking due to CeThreshold " << params.ceThreshold);
     }
 
-    // Enable Blue Enhancement if sojourn time is greater than blueThreshold and its been m_target
+    // Enable Blue Enhancement if sojourn time is greater than blueThreshold and its been target
     // time until the last time blue was updated
-    if (CoDelTimeAfter(sojournTime, Time2CoDel(m_blueThreshold)) &&
-        CoDelTimeAfter((now - m_lastUpdateTimeBlue), Time2CoDel(m_target)))
+    if (CoDelTimeAfter(sojournTime, params.blueThreshold) &&
+        CoDelTimeAfter((now - state.lastUpdateTimeBlue), params.target))
     {
-        m_pDrop = std::min(m_pDrop + m_increment, 1.0);
-        m_lastUpdateTimeBlue = now;
+        state.pDrop = std::min(state.pDrop + params.increment, 1.0);
+        state.lastUpdateTimeBlue = now;
     }
 
     /* Simple BLUE implementation. Lack of ECN is deliberate. */
-    if (m_pDrop)
+    if (state.pDrop)
     {
-        double u = m_uv->GetValue();
-        drop = drop || (u < m_pDrop);
+        double u = state.uv->GetValue();
+        drop = drop || (u < state.pDrop);
     }
 
     /* Overload the drop_next field as an activity timeout */
-    if (!m_count)
+    if (!state.count)
     {
-        m_dropNext = now + Time2CoDel(m_interval);
+        state.dropNext = now + params.interval;
     }
     else if (schedule > 0 && !drop)
     {
-        m_dropNext = now;
+        state.dropNext = now;
     }
 
     return drop;
 }
 
+template Ptr<QueueDiscItem> CobaltQueueDisc::DequeueFrom(const Params& params,
+                                                         TracedState& state,
+                                                         PacketQueue& queue);
+template Ptr<QueueDiscItem> CobaltQueueDisc::DequeueFrom(const Params& params,
+                                                         FlowState& state,
+                                                         PacketQueue& queue);
+template void CobaltQueueDisc::CobaltQueueFull(const Params& params,
+                                               TracedState& state,
+                                               int64_t now);
+template void CobaltQueueDisc::CobaltQueueFull(const Params& params,
+                                               FlowState& state,
+                                               int64_t now);
+
 } // namespace ns3
@@ -39,6 +39,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traced-value.h"
 
+#include <array>
+
 namespace ns3
 {
 
@@ -132,7 +134,7 @@ class CobaltQueueDisc : public QueueDisc
      * @param t the input Time Object
      * @return the unsigned 32-bit integer representation
      */
-    int64_t Time2CoDel(Time t) const;
+    static int64_t Time2CoDel(Time t);
 
   protected:
     /**
@@ -151,28 +153,130 @@ class CobaltQueueDisc : public QueueDisc
      */
     void InitializeParams() override;
 
+    friend class FqCobaltQueueDisc; // Cobalt of its compact flows
+
+    /// The parameters of the Cobalt algorithm, in CoDel time units
+    struct Params
+    {
+        bool useEcn;           //!< True if ECN is used
+        bool useL4s;           //!< True if L4S is used
+        int64_t interval;      //!< Sliding minimum time window width
+        int64_t target;        //!< Target queue delay
+        int64_t ceThreshold;   //!< Threshold above which to CE mark
+        int64_t blueThreshold; //!< Threshold to enable blue enhancement
+        double increment;      //!< Increment value for marking probability
+        double decrement;      //!< Decrement value for marking probability
+    };
+
+    /**
+     * The Cobalt state of a flow queue, for the queue discs keeping the state
+     * of many flows, such as FqCobaltQueueDisc in its compact mode
+     */
+    struct FlowState
+    {
+        uint32_t count{0};              //!< Packets dropped since entering drop state
+        int64_t dropNext{0};            //!< Time to drop next packet
+        bool dropping{false};           //!< True if in dropping state
+        uint32_t recInvSqrt{~0U};       //!< Reciprocal inverse square root
+        uint32_t lastUpdateTimeBlue{0}; //!< Blue's last update time for drop probability
+        double pDrop{0};                //!< Drop Probability
+        Ptr<UniformRandomVariable> uv;  //!< Rng stream
+    };
+
+    /// The Cobalt state of this queue disc, whose traced values fire as they change
+    struct TracedState
+    {
+        TracedValue<uint32_t>& count;   //!< Packets dropped since entering drop state
+        TracedValue<int64_t>& dropNext; //!< Time to drop next packet
+        TracedValue<bool>& dropping;    //!< True if in dropping state
+        uint32_t& recInvSqrt;           //!< Reciprocal inverse square root
+        uint32_t& lastUpdateTimeBlue;   //!< Blue's last update time for drop probability
+        double& pDrop;                  //!< Drop Probability
+        Ptr<UniformRandomVariable>& uv; //!< Rng stream
+    };
+
+    /// The packets of a queue the Cobalt algorithm is applied to
+    class PacketQueue
+    {
+      public:
+        virtual ~PacketQueue() = default;
+
+        /**
+         * \brief Remove the packet at the head of the queue
+         * \return the packet, or nullptr if the queue is empty
+         */
+        virtual Ptr<QueueDiscItem> Pop() = 0;
+
+        /** \return the number of packets in the queue */
+        virtual uint32_t GetNPackets() const = 0;
+
+        /** \return the number of bytes in the queue */
+        virtual uint32_t GetNBytes() const = 0;
+
+        /**
+         * \brief Mark a packet, as QueueDisc::Mark
+         * \param item the packet
+         * \param reason the reason why the packet is marked
+         * \return true if the packet is marked
+         */
+        virtual bool Mark(Ptr<QueueDiscItem> item, const char* reason) = 0;
+
+        /**
+         * \brief Drop a packet removed from the queue, as QueueDisc::DropAfterDequeue
+         * \param item the packet
+         * \param reason the reason why the packet is dropped
+         */
+        virtual void Drop(Ptr<QueueDiscItem> item, const char* reason) = 0;
+    };
+
+    /**
+     * \return the parameters of the algorithm, as set by the attributes
+     */
+    Params GetParams() const;
+
     /**
-     * \brief Calculate the reciprocal square root of m_count by using Newton's method
+     * \brief Remove a packet from a queue according to its Cobalt state
+     *
+     * This is the Cobalt algorithm of DoDequeue, instantiated for the
+     * TracedState of this queue disc and for a FlowState.
+     *
+     * \param params the parameters of the algorithm
+     * \param state the Cobalt state of the queue
+     * \param queue the queue
+     * \returns The packet dequeued, or nullptr if none is left
+     */
+    template <typename State>
+    static Ptr<QueueDiscItem> DequeueFrom(const Params& params, State& state, PacketQueue& queue);
+
+    /**
+     * \brief Calculate the reciprocal square root of the count by using Newton's method
      *  http://en.wikipedia.org/wiki/Methods_of_computing_square_roots#Iterative_methods_for_reciprocal_square_roots
-     * m_recInvSqrt (new) = (m_recInvSqrt (old) / 2) * (3 - m_count * m_recInvSqrt^2)
+     * recInvSqrt (new) = (recInvSqrt (old) / 2) * (3 - count * recInvSqrt^2)
+     * \param recInvSqrt reciprocal value of sqrt (count)
+     * \param count count value
+     * \return The new recInvSqrt value
      */
-    void NewtonStep();
+    static uint32_t NewtonStep(uint32_t recInvSqrt, uint32_t count);
 
     /**
      * \brief Determine the time for next drop
-     * CoDel control law is t + m_interval/sqrt(m_count).
-     * Here, we use m_recInvSqrt calculated by Newton's method in NewtonStep() to avoid
+     * CoDel control law is t + interval/sqrt(count).
+     * Here, we use the recInvSqrt calculated by Newton's method in NewtonStep() to avoid
      * both sqrt() and divide operations
      *
      * \param t Current next drop time
+     * \param interval interval
+     * \param recInvSqrt reciprocal value of sqrt (count)
      * \returns The new next drop time:
      */
-    int64_t ControlLaw(int64_t t);
+    static int64_t ControlLaw(int64_t t, int64_t interval, uint32_t recInvSqrt);
 
     /**
      * \brief Updates the inverse square root
+     * \param state the Cobalt state of the queue
      */
-    void InvSqrt();
+    template <typename State>
+    static void InvSqrt(State& state);
 
     /**
      * There is a big difference in timing between the accurate values placed in
@@ -183,8 +287,10 @@ class CobaltQueueDisc : public QueueDisc
      *
      * The magnitude of the error when stepping up to count 2 is such as to give
      * the value that *should* have been produced at count 4.
+     *
+     * \return the cache of the initial values of InvSqrt, shared by all queues
      */
-    void CacheInit();
+    static const std::array<uint32_t, REC_INV_SQRT_CACHE>& GetRecInvSqrtCache();
 
     /**
      * Check if CoDel time a is successive to b
@@ -193,7 +299,7 @@ class CobaltQueueDisc : public QueueDisc
      * @return true if a is greater than b
      */
 
-    bool CoDelTimeAfter(int64_t a, int64_t b);
+    static bool CoDelTimeAfter(int64_t a, int64_t b);
 
     /**
      * Check if CoDel time a is successive or equal to b
@@ -201,29 +307,46 @@ class CobaltQueueDisc : public QueueDisc
      * @param b right operand
      * @return true if a is greater than or equal to b
      */
-    bool CoDelTimeAfterEq(int64_t a, int64_t b);
+    static bool CoDelTimeAfterEq(int64_t a, int64_t b);
 
     /**
      * Called when the queue becomes full to alter the drop probabilities of Blue
+     * \param params the parameters of the algorithm
+     * \param state the Cobalt state of the queue
      * \param now time in CoDel time units (microseconds)
      */
-    void CobaltQueueFull(int64_t now);
+    template <typename State>
+    static void CobaltQueueFull(const Params& params, State& state, int64_t now);
 
     /**
      * Called when the queue becomes empty to alter the drop probabilities of Blue
+     * \param params the parameters of the algorithm
+     * \param state the Cobalt state of the queue
      * \param now time in CoDel time units (microseconds)
      */
-    void CobaltQueueEmpty(int64_t now);
+    template <typename State>
+    static void CobaltQueueEmpty(const Params& params, State& state, int64_t now);
 
     /**
      * Called to decide whether the current packet should be dropped based on decisions taken by
      * Blue and Codel working parallelly
      *
      * \return true if the packet should be dropped, false otherwise
+     * \param params the parameters of the algorithm
+     * \param state the Cobalt state of the queue
+     * \param queue the queue
      * \param item current packet
      * \param now time in CoDel time units (microseconds)
      */
-    bool CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now);
+    template <typename State>
+    static bool CobaltShouldDrop(const Params& params,
+                                 State& state,
+                                 PacketQueue& queue,
+                                 Ptr<QueueDiscItem> item,
+                                 int64_t now);
+
+    /** \return the Cobalt state of this queue disc */
+    TracedState GetState();
 
     // Common to CoDel and Blue
     // Maintained by Cobalt
@@ -235,8 +358,6 @@ class CobaltQueueDisc : public QueueDisc
     TracedValue<int64_t> m_dropNext; //!< Time to drop next packet
     TracedValue<bool> m_dropping;    //!< True if in dropping state
     uint32_t m_recInvSqrt;           //!< Reciprocal inverse square root
-    uint32_t m_recInvSqrtCache[REC_INV_SQRT_CACHE] = {
-        0}; //!< Cache to maintain some initial values of InvSqrt
 
     // Supplied by user
     Time m_interval;      //!< sliding minimum time window width
@@ -194,15 +194,31 @@ CoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     return retval;
 }
 
+CoDelQueueDisc::Params
+CoDelQueueDisc::GetParams() const
+{
+    return Params{m_useEcn,
+                  m_useL4s,
+                  m_minBytes,
+                  Time2CoDel(m_interval),
+                  Time2CoDel(m_target),
+                  Time2CoDel(m_ceThreshold)};
+}
+
+template <typename State>
 bool
-CoDelQueueDisc::OkToDrop(Ptr<QueueDiscItem> item, uint32_t now)
+CoDelQueueDisc::OkToDrop(const Params& params,
+                         State& state,
+                         const PacketQueue& queue,
+                         Ptr<QueueDiscItem> item,
+                         uint32_t now)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION_NOARGS();
     bool okToDrop;
 
     if (!item)
     {
-        m_firstAboveTime = 0;
+        state.firstAboveTime = 0;
         return false;
     }
 
@@ -210,26 +226,25 @@ CoDelQueueDisc::OkToDrop(Ptr<QueueDiscItem> item, uint32_t now)
     NS_LOG_INFO("Sojourn time " << delta.As(Time::MS));
     uint32_t sojournTime = Time2CoDel(delta);
 
-    if (CoDelTimeBefore(sojournTime, Time2CoDel(m_target)) ||
-        GetInternalQueue(0)->GetNBytes() < m_minBytes)
+    if (CoDelTimeBefore(sojournTime, params.target) || queue.GetNBytes() < params.minBytes)
     {
         // went below so we'll stay below for at least q->interval
         NS_LOG_LOGIC("Sojourn time is below target or number of bytes in queue is less than "
                      "minBytes; packet should not be dropped");
-        m_firstAboveTime = 0;
+        state.firstAboveTime = 0;
         return false;
     }
     okToDrop = false;
-    if (m_firstAboveTime == 0)
+    if (state.firstAboveTime == 0)
     {
         /* just went above from below. If we stay above
          * for at least q->interval we'll say it's ok to drop
          */
         NS_LOG_LOGIC("Sojourn time has just gone above target from below, need to stay above for "
                      "at least q->interval before packet can be dropped. ");
-        m_firstAboveTime = now + Time2CoDel(m_interval);
+        state.firstAboveTime = now + params.interval;
     }
-    else if (CoDelTimeAfter(now, m_firstAboveTime))
+    else if (CoDelTimeAfter(now, state.firstAboveTime))
     {
         NS_LOG_LOGIC("Sojourn time has been above target for at least q->interval; it's OK to "
                      "(possibly) drop packet.");
@@ -243,16 +258,69 @@ CoDelQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<QueueDiscItem> item = GetInternalQueue(0)->Dequeue();
+    /// The internal queue of this queue disc
+    class InternalPacketQueue : public PacketQueue
+    {
+      public:
+        /**
+         * Constructor
+         * \param qd the queue disc
+         */
+        InternalPacketQueue(CoDelQueueDisc* qd)
+            : m_qd(qd)
+        {
+        }
+
+        Ptr<QueueDiscItem> Pop() override
+        {
+            return m_qd->GetInternalQueue(0)->Dequeue();
+        }
+
+        uint32_t GetNPackets() const override
+        {
+            return m_qd->GetInternalQueue(0)->GetNPackets();
+        }
+
+        uint32_t GetNBytes() const override
+        {
+            return m_qd->GetInternalQueue(0)->GetNBytes();
+        }
+
+        bool Mark(Ptr<QueueDiscItem> item, const char* reason) override
+        {
+            return m_qd->Mark(item, reason);
+        }
+
+        void Drop(Ptr<QueueDiscItem> item, const char* reason) override
+        {
+            m_qd->DropAfterDequeue(item, reason);
+        }
+
+      private:
+        CoDelQueueDisc* m_qd; //!< The queue disc
+    };
+
+    TracedState state{m_count, m_lastCount, m_dropping, m_recInvSqrt, m_firstAboveTime, m_dropNext};
+    InternalPacketQueue queue(this);
+    return DequeueFrom(GetParams(), state, queue);
+}
+
+template <typename State>
+Ptr<QueueDiscItem>
+CoDelQueueDisc::DequeueFrom(const Params& params, State& state, PacketQueue& queue)
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    Ptr<QueueDiscItem> item = queue.Pop();
     if (!item)
     {
         // Leave dropping state when queue is empty
-        m_dropping = false;
+        state.dropping = false;
         NS_LOG_LOGIC("Queue empty");
         return nullptr;
     }
     uint32_t ldelay = Time2CoDel(Simulator::Now() - item->GetTimeStamp());
-    if (item && m_useL4s)
+    if (item && params.useL4s)
     {
         uint8_t tosByte = 0;
         if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
@@ -267,10 +335,10 @@ CoDelQueueDisc::DoDequeue()
                 NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
             }
 
-            if (CoDelTimeAfter(ldelay, Time2CoDel(m_ceThreshold)) &&
-                Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+            if (CoDelTimeAfter(ldelay, params.ceThreshold) &&
+                queue.Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
             {
-                NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+                NS_LOG_LOGIC("Marking due to CeThreshold " << params.ceThreshold);
             }
             return item;
         }
@@ -279,14 +347,14 @@ CoDelQueueDisc::DoDequeue()
     uint32_t now = CoDelGetTime();
 
     NS_LOG_LOGIC("Popped " << item);
-    NS_LOG_LOGIC("Number packets remaining " << GetInternalQueue(0)->GetNPackets());
-    NS_LOG_LOGIC("Number bytes remaining " << GetInternalQueue(0)->GetNBytes());
+    NS_LOG_LOGIC("Number packets remaining " << queue.GetNPackets());
+    NS_LOG_LOGIC("Number bytes remaining " << queue.GetNBytes());
 
     // Determine if item should be dropped
-    bool okToDrop = OkToDrop(item, now);
+    bool okToDrop = OkToDrop(params, state, queue, item, now);
     bool isMarked = false;
 
-    if (m_dropping)
+    if (state.dropping)
     { // In the dropping state (sojourn time has gone above target and hasn't come down yet)
         // Check if we can leave the dropping state or next drop should occur
         NS_LOG_LOGIC("In dropping state, check if it's OK to leave or next drop should occur");
@@ -294,59 +362,59 @@ CoDelQueueDisc::DoDequeue()
         {
             /* sojourn time fell below target - leave dropping state */
             NS_LOG_LOGIC("Sojourn time goes below target, it's OK to leave dropping state.");
-            m_dropping = false;
+            state.dropping = false;
         }
-        else if (CoDelTimeAfterEq(now, m_dropNext))
+        else if (CoDelTimeAfterEq(now, state.dropNext))
         {
-            while (m_dropping && CoDelTimeAfterEq(now, m_dropNext))
+            while (state.dropping && CoDelTimeAfterEq(now, state.dropNext))
             {
-                ++m_count;
-                m_recInvSqrt = NewtonStep(m_recInvSqrt, m_count);
+                ++state.count;
+                state.recInvSqrt = NewtonStep(state.recInvSqrt, state.count);
                 // It's time for the next drop. Drop the current packet and
                 // dequeue the next. The dequeue might take us out of dropping
                 // state. If not, schedule the next drop.
                 // A large amount of packets in queue might result in drop
                 // rates so high that the next drop should happen now,
                 // hence the while loop.
-                if (m_useEcn && Mark(item, TARGET_EXCEEDED_MARK))
+                if (params.useEcn && queue.Mark(item, TARGET_EXCEEDED_MARK))
                 {
                     isMarked = true;
                     NS_LOG_LOGIC("Sojourn time is still above target and it's time for next drop "
                                  "or mark; marking "
                                  << item);
-                    NS_LOG_LOGIC("Running ControlLaw for input m_dropNext: " << (double)m_dropNext /
-                                                                                    1000000);
-                    m_dropNext = ControlLaw(now, Time2CoDel(m_interval), m_recInvSqrt);
-                    NS_LOG_LOGIC("Scheduled next drop at " << (double)m_dropNext / 1000000);
-                    goto end;
+                    NS_LOG_LOGIC("Running ControlLaw for input dropNext: "
+                                 << (double)state.dropNext / 1000000);
+                    state.dropNext = ControlLaw(now, params.interval, state.recInvSqrt);
+                    NS_LOG_LOGIC("Scheduled next drop at " << (double)state.dropNext / 1000000);
+                    break;
                 }
                 NS_LOG_LOGIC(
                     "Sojourn time is still above target and it's time for next drop; dropping "
                     << item);
-                DropAfterDequeue(item, TARGET_EXCEEDED_DROP);
+                queue.Drop(item, TARGET_EXCEEDED_DROP);
 
-                item = GetInternalQueue(0)->Dequeue();
+                item = queue.Pop();
 
                 if (item)
                 {
                     NS_LOG_LOGIC("Popped " << item);
-                    NS_LOG_LOGIC("Number packets remaining " << GetInternalQueue(0)->GetNPackets());
-                    NS_LOG_LOGIC("Number bytes remaining " << GetInternalQueue(0)->GetNBytes());
+                    NS_LOG_LOGIC("Number packets remaining " << queue.GetNPackets());
+                    NS_LOG_LOGIC("Number bytes remaining " << queue.GetNBytes());
                 }
 
-                if (!OkToDrop(item, now))
+                if (!OkToDrop(params, state, queue, item, now))
                 {
                     /* leave dropping state */
                     NS_LOG_LOGIC("Leaving dropping state");
-                    m_dropping = false;
+                    state.dropping = false;
                 }
                 else
                 {
                     /* schedule the next drop */
-                    NS_LOG_LOGIC("Running ControlLaw for input m_dropNext: " << (double)m_dropNext /
-                                                                                    1000000);
-                    m_dropNext = ControlLaw(m_dropNext, Time2CoDel(m_interval), m_recInvSqrt);
-                    NS_LOG_LOGIC("Scheduled next drop at " << (double)m_dropNext / 1000000);
+                    NS_LOG_LOGIC("Running ControlLaw for input dropNext: "
+                                 << (double)state.dropNext / 1000000);
+                    state.dropNext = ControlLaw(state.dropNext, params.interval, state.recInvSqrt);
+                    NS_LOG_LOGIC("Scheduled next drop at " << (double)state.dropNext / 1000000);
                 }
             }
         }
@@ -359,7 +427,7 @@ CoDelQueueDisc::DoDequeue()
                      "first packet");
         if (okToDrop)
         {
-            if (m_useEcn && Mark(item, TARGET_EXCEEDED_MARK))
+            if (params.useEcn && queue.Mark(item, TARGET_EXCEEDED_MARK))
             {
                 isMarked = true;
                 NS_LOG_LOGIC("Sojourn time goes above target, marking the first packet "
@@ -370,54 +438,63 @@ CoDelQueueDisc::DoDequeue()
                 // Drop the first packet and enter dropping state unless the queue is empty
                 NS_LOG_LOGIC("Sojourn time goes above target, dropping the first packet "
                              << item << " and entering the dropping state");
-                DropAfterDequeue(item, TARGET_EXCEEDED_DROP);
-                item = GetInternalQueue(0)->Dequeue();
+                queue.Drop(item, TARGET_EXCEEDED_DROP);
+                item = queue.Pop();
                 if (item)
                 {
                     NS_LOG_LOGIC("Popped " << item);
-                    NS_LOG_LOGIC("Number packets remaining " << GetInternalQueue(0)->GetNPackets());
-                    NS_LOG_LOGIC("Number bytes remaining " << GetInternalQueue(0)->GetNBytes());
+                    NS_LOG_LOGIC("Number packets remaining " << queue.GetNPackets());
+                    NS_LOG_LOGIC("Number bytes remaining " << queue.GetNBytes());
                 }
-                OkToDrop(item, now);
+                OkToDrop(params, state, queue, item, now);
             }
-            m_dropping = true;
+            state.dropping = true;
             /*
              * if min went above target close to when we last went below it
              * assume that the drop rate that controlled the queue on the
              * last cycle is a good starting point to control it now.
              */
-            int delta = m_count - m_lastCount;
-            if (delta > 1 && CoDelTimeBefore(now - m_dropNext, 16 * Time2CoDel(m_interval)))
+            int delta = state.count - state.lastCount;
+            if (delta > 1 && CoDelTimeBefore(now - state.dropNext, 16 * params.interval))
             {
-                m_count = delta;
-                m_recInvSqrt = NewtonStep(m_recInvSqrt, m_count);
+                state.count = delta;
+                state.recInvSqrt = NewtonStep(state.recInvSqrt, state.count);
             }
             else
             {
-                m_count = 1;
-                m_recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+                state.count = 1;
+                state.recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
             }
-            m_lastCount = m_count;
+            state.lastCount = state.count;
             NS_LOG_LOGIC("Running ControlLaw for input now: " << (double)now);
-            m_dropNext = ControlLaw(now, Time2CoDel(m_interval), m_recInvSqrt);
-            NS_LOG_LOGIC("Scheduled next drop at " << (double)m_dropNext / 1000000 << " now "
+            state.dropNext = ControlLaw(now, params.interval, state.recInvSqrt);
+            NS_LOG_LOGIC("Scheduled next drop at " << (double)state.dropNext / 1000000 << " now "
                                                    << (double)now / 1000000);
         }
     }
-end:
-    ldelay = Time2CoDel(Simulator::Now() - item->GetTimeStamp());
     // In Linux, this branch of code is executed even if the packet has been marked
     // according to the target delay above. If the ns-3 code were to do the same here,
     // it would result in two counts of mark in the queue statistics. Therefore, we
     // use the isMarked flag to suppress a second attempt at marking.
-    if (!isMarked && item && !m_useL4s && m_useEcn &&
-        CoDelTimeAfter(ldelay, Time2CoDel(m_ceThreshold)) && Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+    if (!isMarked && item && !params.useL4s && params.useEcn)
     {
-        NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+        ldelay = Time2CoDel(Simulator::Now() - item->GetTimeStamp());
+        if (CoDelTimeAfter(ldelay, params.ceThreshold) &&
+            queue.Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+        {
+            NS_LOG_LOGIC("Marking due to CeThreshold " << params.ceThreshold);
+        }
     }
     return item;
 }
 
+template Ptr<QueueDiscItem> CoDelQueueDisc::DequeueFrom(const Params& params,
+                                                        TracedState& state,
+                                                        PacketQueue& queue);
+template Ptr<QueueDiscItem> CoDelQueueDisc::DequeueFrom(const Params& params,
+                                                        FlowState& state,
+                                                        PacketQueue& queue);
+
 Time
 CoDelQueueDisc::GetTarget()
 {
@@ -113,6 +113,7 @@ class CoDelQueueDisc : public QueueDisc
   private:
     friend class ::CoDelQueueDiscNewtonStepTest; // Test code
     friend class ::CoDelQueueDiscControlLawTest; // Test code
+    friend class FqCoDelQueueDisc;               // CoDel of its compact flows
     /**
      * \brief Add a packet to the queue
      *
@@ -157,16 +158,114 @@ class CoDelQueueDisc : public QueueDisc
      */
     static uint32_t ControlLaw(uint32_t t, uint32_t interval, uint32_t recInvSqrt);
 
+    /// The parameters of the CoDel algorithm, in CoDel time units
+    struct Params
+    {
+        bool useEcn;          //!< True if ECN is used
+        bool useL4s;          //!< True if L4S is used
+        uint32_t minBytes;    //!< Minimum bytes in queue to allow a packet drop
+        uint32_t interval;    //!< Sliding minimum time window width
+        uint32_t target;      //!< Target queue delay
+        uint32_t ceThreshold; //!< Threshold above which to CE mark
+    };
+
     /**
-     * \brief Determine whether a packet is OK to be dropped. The packet
+     * The CoDel state of a flow queue, for the queue discs keeping the state
+     * of many flows, such as FqCoDelQueueDisc in its compact mode
+     */
+    struct FlowState
+    {
+        uint32_t count{0};                              //!< Drops since entering drop state
+        uint32_t lastCount{0};                          //!< Last value of the count
+        bool dropping{false};                           //!< True if in dropping state
+        uint16_t recInvSqrt{~0U >> REC_INV_SQRT_SHIFT}; //!< Reciprocal inverse square root
+        uint32_t firstAboveTime{0};                     //!< Time sojourn time is above target
+        uint32_t dropNext{0};                           //!< Time to drop next packet
+    };
+
+    /// The CoDel state of this queue disc, whose traced values fire as they change
+    struct TracedState
+    {
+        TracedValue<uint32_t>& count;     //!< Packets dropped since entering drop state
+        TracedValue<uint32_t>& lastCount; //!< Last value of the count
+        TracedValue<bool>& dropping;      //!< True if in dropping state
+        uint16_t& recInvSqrt;             //!< Reciprocal inverse square root
+        uint32_t& firstAboveTime;         //!< Time to declare sojourn time above target
+        TracedValue<uint32_t>& dropNext;  //!< Time to drop next packet
+    };
+
+    /// The packets of a queue the CoDel algorithm is applied to
+    class PacketQueue
+    {
+      public:
+        virtual ~PacketQueue() = default;
+
+        /**
+         * rief Remove the packet at the head of the queue
+         * 
+eturn the packet, or nullptr if the queue is empty
+         */
+        virtual Ptr<QueueDiscItem> Pop() = 0;
+
+        /** 
+eturn the number of packets in the queue */
+        virtual uint32_t GetNPackets() const = 0;
+
+        /** 
+eturn the number of bytes in the queue */
+        virtual uint32_t GetNBytes() const = 0;
+
+        /**
+         * rief Mark a packet, as QueueDisc::Mark
+         * \param item the packet
+         * \param reason the reason why the packet is marked
+         * 
+eturn true if the packet is marked
+         */
+        virtual bool Mark(Ptr<QueueDiscItem> item, const char* reason) = 0;
+
+        /**
+         * rief Drop a packet removed from the queue, as QueueDisc::DropAfterDequeue
+         * \param item the packet
+         * \param reason the reason why the packet is dropped
+         */
+        virtual void Drop(Ptr<QueueDiscItem> item, const char* reason) = 0;
+    };
+
+    /**
+     * rief Remove a packet from a queue according to its CoDel state
+     *
+     * This is the CoDel algorithm of DoDequeue, instantiated for the
+     * TracedState of this queue disc and for a FlowState.
+     *
+     * \param params the parameters of the algorithm
+     * \param state the CoDel state of the queue
+     * \param queue the queue
+     * 
+eturns The packet dequeued, or nullptr if none is left
+     */
+    template <typename State>
+    static Ptr<QueueDiscItem> DequeueFrom(const Params& params, State& state, PacketQueue& queue);
+
+    /**
+     * rief Determine whether a packet is OK to be dropped. The packet
      * may not be actually dropped (depending on the drop state)
      *
+     * \param params the parameters of the algorithm
+     * \param state the CoDel state of the queue
+     * \param queue the queue
      * \param item The packet that is considered
      * \param now The current time represented as 32-bit unsigned integer (us)
-     * \returns True if it is OK to drop the packet (sojourn time above target for at least
+     * 
+eturns True if it is OK to drop the packet (sojourn time above target for at least
      * interval)
      */
-    bool OkToDrop(Ptr<QueueDiscItem> item, uint32_t now);
+    template <typename State>
+    static bool OkToDrop(const Params& params,
+                         State& state,
+                         const PacketQueue& queue,
+                         Ptr<QueueDiscItem> item,
+                         uint32_t now);
 
     /**
      * Check if CoDel time a is successive to b
@@ -174,28 +273,28 @@ class CoDelQueueDisc : public QueueDisc
      * @param b right operand
      * @return true if a is greater than b
      */
-    bool CoDelTimeAfter(uint32_t a, uint32_t b);
+    static bool CoDelTimeAfter(uint32_t a, uint32_t b);
     /**
      * Check if CoDel time a is successive or equal to b
      * @param a left operand
      * @param b right operand
      * @return true if a is greater than or equal to b
      */
-    bool CoDelTimeAfterEq(uint32_t a, uint32_t b);
+    static bool CoDelTimeAfterEq(uint32_t a, uint32_t b);
     /**
      * Check if CoDel time a is preceding b
      * @param a left operand
      * @param b right operand
      * @return true if a is less than to b
      */
-    bool CoDelTimeBefore(uint32_t a, uint32_t b);
+    static bool CoDelTimeBefore(uint32_t a, uint32_t b);
     /**
      * Check if CoDel time a is preceding or equal to b
      * @param a left operand
      * @param b right operand
      * @return true if a is less than or equal to b
      */
-    bool CoDelTimeBeforeEq(uint32_t a, uint32_t b);
+    static bool CoDelTimeBeforeEq(uint32_t a, uint32_t b);
 
     /**
      * Return the unsigned 32-bit integer representation of the input Time
@@ -203,7 +302,13 @@ class CoDelQueueDisc : public QueueDisc
      * @param t the input Time Object
      * @return the unsigned 32-bit integer representation
      */
-    uint32_t Time2CoDel(Time t);
+    static uint32_t Time2CoDel(Time t);
+
+    /**
+     * 
+eturn the parameters of the algorithm, as set by the attributes
+     */
+    Params GetParams() const;
 
     void InitializeParams() override;
 
@@ -32,6 +32,7 @@
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/queue.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -196,13 +197,21 @@ FqCobaltQueueDisc::GetTypeId()
                           "The Threshold after which Blue is enabled",
                           TimeValue(MilliSeconds(400)),
                           MakeTimeAccessor(&FqCobaltQueueDisc::m_blueThreshold),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("CompactFlows",
+                          "True to keep the flow queues and their Cobalt state in arrays "
+                          "instead of creating a queue disc class and a child queue disc per flow; "
+                          "each flow still has its own random variable for Blue",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FqCobaltQueueDisc::m_compactFlows),
+                          MakeBooleanChecker());
     return tid;
 }
 
 FqCobaltQueueDisc::FqCobaltQueueDisc()
     : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS),
-      m_quantum(0)
+      m_quantum(0),
+      m_cobaltParams{}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -212,6 +221,15 @@ FqCobaltQueueDisc::~FqCobaltQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+FqCobaltQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_flowTable.Reset(0);
+    m_cobaltFlows.clear();
+    QueueDisc::DoDispose();
+}
+
 void
 FqCobaltQueueDisc::SetQuantum(uint32_t quantum)
 {
@@ -283,6 +301,14 @@ FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         }
     }
 
+    if (m_compactFlows)
+    {
+        h = m_enableSetAssociativeHash ? m_flowTable.SetAssociativeHash(flowHash, m_setWays)
+                                       : flowHash % m_flows;
+        CompactEnqueue(item, h);
+        return true;
+    }
+
     if (m_enableSetAssociativeHash)
     {
         h = SetAssociativeHash(flowHash);
@@ -339,11 +365,67 @@ FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     return true;
 }
 
+void
+FqCobaltQueueDisc::CompactEnqueue(Ptr<QueueDiscItem> item, uint32_t h)
+{
+    NS_LOG_FUNCTION(this << item << h);
+
+    uint32_t flow = m_flowTable.GetFlow(h);
+    if (flow == FqFlowTable::NONE)
+    {
+        NS_LOG_DEBUG("Creating a new flow queue with index " << h);
+        flow = m_flowTable.AddFlow(h);
+        CobaltQueueDisc::FlowState state;
+        state.pDrop = m_Pdrop;
+        // a child CobaltQueueDisc creates its random variable at this time
+        state.uv = CreateObject<UniformRandomVariable>();
+        m_cobaltFlows.push_back(state);
+    }
+
+    if (m_flowTable.GetStatus(flow) == FqFlowTable::INACTIVE)
+    {
+        m_flowTable.SetStatus(flow, FqFlowTable::NEW_FLOW);
+        m_flowTable.SetDeficit(flow, m_quantum);
+        m_flowTable.PushBack(FqFlowTable::NEW_FLOWS, flow);
+    }
+
+    // the limit of the flow is the limit of this queue disc, as for a child
+    // CobaltQueueDisc
+    if (m_flowTable.GetNPackets(flow) + 1 > GetMaxSize().GetValue())
+    {
+        NS_LOG_LOGIC("Flow queue full -- dropping pkt");
+        // Call this to update Blue's drop probability
+        CobaltQueueDisc::CobaltQueueFull(m_cobaltParams,
+                                         m_cobaltFlows[flow],
+                                         CobaltQueueDisc::Time2CoDel(Simulator::Now()));
+        m_compactReason.assign(CHILD_QUEUE_DISC_DROP).append(CobaltQueueDisc::OVERLIMIT_DROP);
+        DropBeforeEnqueue(item, m_compactReason.c_str());
+    }
+    else
+    {
+        m_flowTable.Enqueue(flow, item);
+        PacketEnqueued(item);
+    }
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << flow);
+
+    if (GetCurrentSize() > GetMaxSize())
+    {
+        NS_LOG_DEBUG("Overload; enter CompactDrop ()");
+        CompactDrop();
+    }
+}
+
 Ptr<QueueDiscItem>
 FqCobaltQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_compactFlows)
+    {
+        return CompactDequeue();
+    }
+
     Ptr<FqCobaltFlow> flow;
     Ptr<QueueDiscItem> item;
 
@@ -422,6 +504,150 @@ FqCobaltQueueDisc::DoDequeue()
     return item;
 }
 
+Ptr<QueueDiscItem>
+FqCobaltQueueDisc::CompactDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    /// A flow queue, whose drops and marks are reported as those of a child queue disc
+    class FlowQueue : public CobaltQueueDisc::PacketQueue
+    {
+      public:
+        /**
+         * Constructor
+         * \param qd the queue disc
+         * \param flow the flow
+         */
+        FlowQueue(FqCobaltQueueDisc* qd, uint32_t flow)
+            : m_qd(qd),
+              m_flow(flow)
+        {
+        }
+
+        Ptr<QueueDiscItem> Pop() override
+        {
+            return m_qd->FlowPop(m_flow);
+        }
+
+        uint32_t GetNPackets() const override
+        {
+            return m_qd->m_flowTable.GetNPackets(m_flow);
+        }
+
+        uint32_t GetNBytes() const override
+        {
+            return m_qd->m_flowTable.GetNBytes(m_flow);
+        }
+
+        bool Mark(Ptr<QueueDiscItem> item, const char* reason) override
+        {
+            m_qd->m_compactReason.assign(CHILD_QUEUE_DISC_MARK).append(reason);
+            return m_qd->Mark(item, m_qd->m_compactReason.c_str());
+        }
+
+        void Drop(Ptr<QueueDiscItem> item, const char* reason) override
+        {
+            m_qd->m_compactReason.assign(CHILD_QUEUE_DISC_DROP).append(reason);
+            m_qd->DropAfterDequeue(item, m_qd->m_compactReason.c_str());
+        }
+
+      private:
+        FqCobaltQueueDisc* m_qd; //!< The queue disc
+        uint32_t m_flow;         //!< The flow
+    };
+
+    uint32_t flow = FqFlowTable::NONE;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        bool found = false;
+
+        while (!found && !m_flowTable.IsEmpty(FqFlowTable::NEW_FLOWS))
+        {
+            flow = m_flowTable.Front(FqFlowTable::NEW_FLOWS);
+
+            if (m_flowTable.GetDeficit(flow) <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for new flow index " << flow);
+                m_flowTable.IncreaseDeficit(flow, m_quantum);
+                m_flowTable.SetStatus(flow, FqFlowTable::OLD_FLOW);
+                m_flowTable.PopFront(FqFlowTable::NEW_FLOWS);
+                m_flowTable.PushBack(FqFlowTable::OLD_FLOWS, flow);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found a new flow " << flow << " with positive deficit");
+                found = true;
+            }
+        }
+
+        while (!found && !m_flowTable.IsEmpty(FqFlowTable::OLD_FLOWS))
+        {
+            flow = m_flowTable.Front(FqFlowTable::OLD_FLOWS);
+
+            if (m_flowTable.GetDeficit(flow) <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for old flow index " << flow);
+                m_flowTable.IncreaseDeficit(flow, m_quantum);
+                m_flowTable.PopFront(FqFlowTable::OLD_FLOWS);
+                m_flowTable.PushBack(FqFlowTable::OLD_FLOWS, flow);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found an old flow " << flow << " with positive deficit");
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            NS_LOG_DEBUG("No flow found to dequeue a packet");
+            return nullptr;
+        }
+
+        // the dequeue of the child CobaltQueueDisc of the flow
+        FlowQueue queue(this, flow);
+        item = CobaltQueueDisc::DequeueFrom(m_cobaltParams, m_cobaltFlows[flow], queue);
+
+        if (!item)
+        {
+            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
+            if (!m_flowTable.IsEmpty(FqFlowTable::NEW_FLOWS))
+            {
+                m_flowTable.SetStatus(flow, FqFlowTable::OLD_FLOW);
+                m_flowTable.PopFront(FqFlowTable::NEW_FLOWS);
+                m_flowTable.PushBack(FqFlowTable::OLD_FLOWS, flow);
+            }
+            else
+            {
+                m_flowTable.SetStatus(flow, FqFlowTable::INACTIVE);
+                m_flowTable.PopFront(FqFlowTable::OLD_FLOWS);
+            }
+        }
+        else
+        {
+            NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
+        }
+    } while (!item);
+
+    m_flowTable.IncreaseDeficit(flow, item->GetSize() * -1);
+
+    return item;
+}
+
+Ptr<QueueDiscItem>
+FqCobaltQueueDisc::FlowPop(uint32_t flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+    Ptr<QueueDiscItem> item = m_flowTable.Dequeue(flow);
+    if (item)
+    {
+        PacketDequeued(item);
+    }
+    return item;
+}
+
 bool
 FqCobaltQueueDisc::CheckConfig()
 {
@@ -491,6 +717,24 @@ FqCobaltQueueDisc::InitializeParams()
     m_queueDiscFactory.Set("Pdrop", DoubleValue(m_Pdrop));
     m_queueDiscFactory.Set("Increment", DoubleValue(m_increment));
     m_queueDiscFactory.Set("Decrement", DoubleValue(m_decrement));
+
+    if (m_compactFlows)
+    {
+        // the Cobalt parameters of the children of the other mode, which
+        // cannot be read from a template child without consuming the random
+        // variable stream it would create
+        m_cobaltParams = CobaltQueueDisc::Params{m_useEcn,
+                                                 m_useL4s,
+                                                 CobaltQueueDisc::Time2CoDel(Time(m_interval)),
+                                                 CobaltQueueDisc::Time2CoDel(Time(m_target)),
+                                                 CobaltQueueDisc::Time2CoDel(m_ceThreshold),
+                                                 CobaltQueueDisc::Time2CoDel(m_blueThreshold),
+                                                 m_increment,
+                                                 m_decrement};
+
+        m_flowTable.Reset(m_flows);
+        m_cobaltFlows.clear();
+    }
 }
 
 uint32_t
@@ -533,4 +777,30 @@ FqCobaltQueueDisc::FqCobaltDrop()
     return index;
 }
 
+uint32_t
+FqCobaltQueueDisc::CompactDrop()
+{
+    NS_LOG_FUNCTION(this);
+
+    /* Queue is full! Find the fat flow and drop packet(s) from it */
+    uint32_t index = m_flowTable.GetFattestFlow();
+
+    /* Our goal is to drop half of this fat flow backlog */
+    uint32_t len = 0;
+    uint32_t count = 0;
+    uint32_t threshold = m_flowTable.GetNBytes(index) >> 1;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
+                                                       << " threshold: " << threshold);
+        item = FlowPop(index);
+        DropAfterDequeue(item, OVERLIMIT_DROP);
+        len += item->GetSize();
+    } while (++count < m_dropBatchSize && len < threshold);
+
+    return index;
+}
+
 } // namespace ns3
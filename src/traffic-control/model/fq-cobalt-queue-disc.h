@@ -27,6 +27,8 @@
 #ifndef FQ_COBALT_QUEUE_DISC
 #define FQ_COBALT_QUEUE_DISC
 
+#include "cobalt-queue-disc.h"
+#include "fq-flow-table.h"
 #include "queue-disc.h"
 
 #include "ns3/object-factory.h"
@@ -115,6 +117,20 @@ class FqCobaltFlow : public QueueDiscClass
  * \ingroup traffic-control
  *
  * \brief A FqCobalt packet queue disc
+ *
+ * By default, a FqCobaltFlow class and a child CobaltQueueDisc are created
+ * for each flow queue in use.  When the CompactFlows attribute is true, the
+ * flow queues are instead kept in a FqFlowTable and the state of their
+ * Cobalt algorithm in an array of this queue disc, which runs the dequeue of
+ * CobaltQueueDisc on the state of each flow and behaves exactly the same
+ * (packets, statistics, traces of this queue disc and random variable
+ * streams) but has no queue disc class: the flow queues cannot be inspected,
+ * and the traces of the Cobalt state of each flow are not available.
+ *
+ * The state of each flow still holds a UniformRandomVariable for Blue, which
+ * is created when the flow is, as the child CobaltQueueDisc creates its own:
+ * each flow thus takes a random variable stream and draws the same values
+ * in both modes.
  */
 
 class FqCobaltQueueDisc : public QueueDisc
@@ -153,6 +169,9 @@ class FqCobaltQueueDisc : public QueueDisc
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
 
+  protected:
+    void DoDispose() override;
+
   private:
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
@@ -165,6 +184,33 @@ class FqCobaltQueueDisc : public QueueDisc
      */
     uint32_t FqCobaltDrop();
 
+    /**
+     * \brief Enqueue a packet into a flow queue of the compact mode
+     * \param item the packet
+     * \param h the index of the flow queue
+     */
+    void CompactEnqueue(Ptr<QueueDiscItem> item, uint32_t h);
+
+    /**
+     * \brief Dequeue a packet from the flow queues of the compact mode
+     * \return the packet, or nullptr if no flow queue has any
+     */
+    Ptr<QueueDiscItem> CompactDequeue();
+
+    /**
+     * \brief Drop packets from the flow with the largest current byte count,
+     * in the compact mode
+     * \return the flow with the largest current byte count
+     */
+    uint32_t CompactDrop();
+
+    /**
+     * \brief Remove the packet at the head of a flow, as its internal queue would
+     * \param flow the flow
+     * \return the packet, or nullptr if the flow has none
+     */
+    Ptr<QueueDiscItem> FlowPop(uint32_t flow);
+
     /**
      * Compute the index of the queue for the flow having the given flowHash,
      * according to the set associative hash approach.
@@ -189,6 +235,7 @@ class FqCobaltQueueDisc : public QueueDisc
     double m_decrement;   //!< decrement value for marking probability
     double m_Pdrop;       //!< Drop Probability
     Time m_blueThreshold; //!< Threshold to enable blue enhancement
+    bool m_compactFlows;  //!< whether to keep the flows in a FqFlowTable
 
     std::list<Ptr<FqCobaltFlow>> m_newFlows; //!< The list of new flows
     std::list<Ptr<FqCobaltFlow>> m_oldFlows; //!< The list of old flows
@@ -198,6 +245,12 @@ class FqCobaltQueueDisc : public QueueDisc
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+
+    FqFlowTable m_flowTable; //!< The flow queues of the compact mode
+
+    CobaltQueueDisc::Params m_cobaltParams;                 //!< Cobalt parameters of the flows
+    std::vector<CobaltQueueDisc::FlowState> m_cobaltFlows; //!< Cobalt state of each flow
+    std::string m_compactReason; //!< Reason why a packet of a flow is dropped or marked
 };
 
 } // namespace ns3
@@ -26,6 +26,7 @@
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/queue.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -170,13 +171,20 @@ FqCoDelQueueDisc::GetTypeId()
                           "True to use L4S (only ECT1 packets are marked at CE threshold)",
                           BooleanValue(false),
                           MakeBooleanAccessor(&FqCoDelQueueDisc::m_useL4s),
+                          MakeBooleanChecker())
+            .AddAttribute("CompactFlows",
+                          "True to keep the flow queues and their CoDel state in flat arrays "
+                          "instead of creating a queue disc class and a child queue disc per flow",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FqCoDelQueueDisc::m_compactFlows),
                           MakeBooleanChecker());
     return tid;
 }
 
 FqCoDelQueueDisc::FqCoDelQueueDisc()
     : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS),
-      m_quantum(0)
+      m_quantum(0),
+      m_codelParams{}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -186,6 +194,14 @@ FqCoDelQueueDisc::~FqCoDelQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+FqCoDelQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_flowTable.Reset(0);
+    QueueDisc::DoDispose();
+}
+
 void
 FqCoDelQueueDisc::SetQuantum(uint32_t quantum)
 {
@@ -257,6 +273,14 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         }
     }
 
+    if (m_compactFlows)
+    {
+        h = m_enableSetAssociativeHash ? m_flowTable.SetAssociativeHash(flowHash, m_setWays)
+                                       : flowHash % m_flows;
+        CompactEnqueue(item, h);
+        return true;
+    }
+
     if (m_enableSetAssociativeHash)
     {
         h = SetAssociativeHash(flowHash);
@@ -312,11 +336,59 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     return true;
 }
 
+void
+FqCoDelQueueDisc::CompactEnqueue(Ptr<QueueDiscItem> item, uint32_t h)
+{
+    NS_LOG_FUNCTION(this << item << h);
+
+    uint32_t flow = m_flowTable.GetFlow(h);
+    if (flow == FqFlowTable::NONE)
+    {
+        NS_LOG_DEBUG("Creating a new flow queue with index " << h);
+        flow = m_flowTable.AddFlow(h);
+        m_codelFlows.emplace_back();
+    }
+
+    if (m_flowTable.GetStatus(flow) == FqFlowTable::INACTIVE)
+    {
+        m_flowTable.SetStatus(flow, FqFlowTable::NEW_FLOW);
+        m_flowTable.SetDeficit(flow, m_quantum);
+        m_flowTable.PushBack(FqFlowTable::NEW_FLOWS, flow);
+    }
+
+    // the limit of the flow is the limit of this queue disc, as for a child
+    // CoDelQueueDisc
+    if (m_flowTable.GetNPackets(flow) + 1 > GetMaxSize().GetValue())
+    {
+        NS_LOG_LOGIC("Flow queue full -- dropping pkt");
+        m_compactReason.assign(CHILD_QUEUE_DISC_DROP).append(CoDelQueueDisc::OVERLIMIT_DROP);
+        DropBeforeEnqueue(item, m_compactReason.c_str());
+    }
+    else
+    {
+        m_flowTable.Enqueue(flow, item);
+        PacketEnqueued(item);
+    }
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << flow);
+
+    if (GetCurrentSize() > GetMaxSize())
+    {
+        NS_LOG_DEBUG("Overload; enter CompactDrop ()");
+        CompactDrop();
+    }
+}
+
 Ptr<QueueDiscItem>
 FqCoDelQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_compactFlows)
+    {
+        return CompactDequeue();
+    }
+
     Ptr<FqCoDelFlow> flow;
     Ptr<QueueDiscItem> item;
 
@@ -393,6 +465,150 @@ FqCoDelQueueDisc::DoDequeue()
     return item;
 }
 
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::CompactDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    /// A flow queue, whose drops and marks are reported as those of a child queue disc
+    class FlowQueue : public CoDelQueueDisc::PacketQueue
+    {
+      public:
+        /**
+         * Constructor
+         * \param qd the queue disc
+         * \param flow the flow
+         */
+        FlowQueue(FqCoDelQueueDisc* qd, uint32_t flow)
+            : m_qd(qd),
+              m_flow(flow)
+        {
+        }
+
+        Ptr<QueueDiscItem> Pop() override
+        {
+            return m_qd->FlowPop(m_flow);
+        }
+
+        uint32_t GetNPackets() const override
+        {
+            return m_qd->m_flowTable.GetNPackets(m_flow);
+        }
+
+        uint32_t GetNBytes() const override
+        {
+            return m_qd->m_flowTable.GetNBytes(m_flow);
+        }
+
+        bool Mark(Ptr<QueueDiscItem> item, const char* reason) override
+        {
+            m_qd->m_compactReason.assign(CHILD_QUEUE_DISC_MARK).append(reason);
+            return m_qd->Mark(item, m_qd->m_compactReason.c_str());
+        }
+
+        void Drop(Ptr<QueueDiscItem> item, const char* reason) override
+        {
+            m_qd->m_compactReason.assign(CHILD_QUEUE_DISC_DROP).append(reason);
+            m_qd->DropAfterDequeue(item, m_qd->m_compactReason.c_str());
+        }
+
+      private:
+        FqCoDelQueueDisc* m_qd; //!< The queue disc
+        uint32_t m_flow;        //!< The flow
+    };
+
+    uint32_t flow = FqFlowTable::NONE;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        bool found = false;
+
+        while (!found && !m_flowTable.IsEmpty(FqFlowTable::NEW_FLOWS))
+        {
+            flow = m_flowTable.Front(FqFlowTable::NEW_FLOWS);
+
+            if (m_flowTable.GetDeficit(flow) <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for new flow index " << flow);
+                m_flowTable.IncreaseDeficit(flow, m_quantum);
+                m_flowTable.SetStatus(flow, FqFlowTable::OLD_FLOW);
+                m_flowTable.PopFront(FqFlowTable::NEW_FLOWS);
+                m_flowTable.PushBack(FqFlowTable::OLD_FLOWS, flow);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found a new flow " << flow << " with positive deficit");
+                found = true;
+            }
+        }
+
+        while (!found && !m_flowTable.IsEmpty(FqFlowTable::OLD_FLOWS))
+        {
+            flow = m_flowTable.Front(FqFlowTable::OLD_FLOWS);
+
+            if (m_flowTable.GetDeficit(flow) <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for old flow index " << flow);
+                m_flowTable.IncreaseDeficit(flow, m_quantum);
+                m_flowTable.PopFront(FqFlowTable::OLD_FLOWS);
+                m_flowTable.PushBack(FqFlowTable::OLD_FLOWS, flow);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found an old flow " << flow << " with positive deficit");
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            NS_LOG_DEBUG("No flow found to dequeue a packet");
+            return nullptr;
+        }
+
+        // the dequeue of the child CoDelQueueDisc of the flow
+        FlowQueue queue(this, flow);
+        item = CoDelQueueDisc::DequeueFrom(m_codelParams, m_codelFlows[flow], queue);
+
+        if (!item)
+        {
+            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
+            if (!m_flowTable.IsEmpty(FqFlowTable::NEW_FLOWS))
+            {
+                m_flowTable.SetStatus(flow, FqFlowTable::OLD_FLOW);
+                m_flowTable.PopFront(FqFlowTable::NEW_FLOWS);
+                m_flowTable.PushBack(FqFlowTable::OLD_FLOWS, flow);
+            }
+            else
+            {
+                m_flowTable.SetStatus(flow, FqFlowTable::INACTIVE);
+                m_flowTable.PopFront(FqFlowTable::OLD_FLOWS);
+            }
+        }
+        else
+        {
+            NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
+        }
+    } while (!item);
+
+    m_flowTable.IncreaseDeficit(flow, item->GetSize() * -1);
+
+    return item;
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::FlowPop(uint32_t flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+    Ptr<QueueDiscItem> item = m_flowTable.Dequeue(flow);
+    if (item)
+    {
+        PacketDequeued(item);
+    }
+    return item;
+}
+
 bool
 FqCoDelQueueDisc::CheckConfig()
 {
@@ -459,6 +675,20 @@ FqCoDelQueueDisc::InitializeParams()
     m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
     m_queueDiscFactory.Set("Interval", StringValue(m_interval));
     m_queueDiscFactory.Set("Target", StringValue(m_target));
+
+    if (m_compactFlows)
+    {
+        // take the CoDel parameters from a queue disc such as the children
+        // of the other mode, to honor the defaults of their attributes
+        Ptr<CoDelQueueDisc> codel = m_queueDiscFactory.Create<CoDelQueueDisc>();
+        codel->SetAttribute("UseEcn", BooleanValue(m_useEcn));
+        codel->SetAttribute("CeThreshold", TimeValue(m_ceThreshold));
+        codel->SetAttribute("UseL4s", BooleanValue(m_useL4s));
+        m_codelParams = codel->GetParams();
+
+        m_flowTable.Reset(m_flows);
+        m_codelFlows.clear();
+    }
 }
 
 uint32_t
@@ -501,4 +731,30 @@ FqCoDelQueueDisc::FqCoDelDrop()
     return index;
 }
 
+uint32_t
+FqCoDelQueueDisc::CompactDrop()
+{
+    NS_LOG_FUNCTION(this);
+
+    /* Queue is full! Find the fat flow and drop packet(s) from it */
+    uint32_t index = m_flowTable.GetFattestFlow();
+
+    /* Our goal is to drop half of this fat flow backlog */
+    uint32_t len = 0;
+    uint32_t count = 0;
+    uint32_t threshold = m_flowTable.GetNBytes(index) >> 1;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
+                                                       << " threshold: " << threshold);
+        item = FlowPop(index);
+        DropAfterDequeue(item, OVERLIMIT_DROP);
+        len += item->GetSize();
+    } while (++count < m_dropBatchSize && len < threshold);
+
+    return index;
+}
+
 } // namespace ns3
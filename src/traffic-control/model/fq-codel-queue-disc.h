@@ -21,6 +21,8 @@
 #ifndef FQ_CODEL_QUEUE_DISC
 #define FQ_CODEL_QUEUE_DISC
 
+#include "codel-queue-disc.h"
+#include "fq-flow-table.h"
 #include "queue-disc.h"
 
 #include "ns3/object-factory.h"
@@ -109,6 +111,15 @@ class FqCoDelFlow : public QueueDiscClass
  * \ingroup traffic-control
  *
  * \brief A FqCoDel packet queue disc
+ *
+ * By default, a FqCoDelFlow class and a child CoDelQueueDisc are created for
+ * each flow queue in use.  When the CompactFlows attribute is true, the
+ * flow queues are instead kept in a FqFlowTable and the state of their
+ * CoDel algorithm in an array of this queue disc, which runs the dequeue of
+ * CoDelQueueDisc on the state of each flow and behaves exactly the
+ * same (packets, statistics and traces of this queue disc) but has no
+ * queue disc class: the flow queues cannot be inspected, and the traces of
+ * the CoDel state of each flow are not available.
  */
 
 class FqCoDelQueueDisc : public QueueDisc
@@ -147,6 +158,9 @@ class FqCoDelQueueDisc : public QueueDisc
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
 
+  protected:
+    void DoDispose() override;
+
   private:
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
@@ -159,6 +173,33 @@ class FqCoDelQueueDisc : public QueueDisc
      */
     uint32_t FqCoDelDrop();
 
+    /**
+     * \brief Enqueue a packet into a flow queue of the compact mode
+     * \param item the packet
+     * \param h the index of the flow queue
+     */
+    void CompactEnqueue(Ptr<QueueDiscItem> item, uint32_t h);
+
+    /**
+     * \brief Dequeue a packet from the flow queues of the compact mode
+     * \return the packet, or nullptr if no flow queue has any
+     */
+    Ptr<QueueDiscItem> CompactDequeue();
+
+    /**
+     * \brief Drop packets from the flow with the largest current byte count,
+     * in the compact mode
+     * \return the flow with the largest current byte count
+     */
+    uint32_t CompactDrop();
+
+    /**
+     * \brief Remove the packet at the head of a flow, as its internal queue would
+     * \param flow the flow
+     * \return the packet, or nullptr if the flow has none
+     */
+    Ptr<QueueDiscItem> FlowPop(uint32_t flow);
+
     bool m_useEcn; //!< True if ECN is used (packets are marked instead of being dropped)
     /**
      * Compute the index of the queue for the flow having the given flowHash,
@@ -179,6 +220,7 @@ class FqCoDelQueueDisc : public QueueDisc
     Time m_ceThreshold;              //!< Threshold above which to CE mark
     bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
     bool m_useL4s; //!< True if L4S is used (ECT1 packets are marked at CE threshold)
+    bool m_compactFlows;             //!< whether to keep the flows in a FqFlowTable
 
     std::list<Ptr<FqCoDelFlow>> m_newFlows; //!< The list of new flows
     std::list<Ptr<FqCoDelFlow>> m_oldFlows; //!< The list of old flows
@@ -188,6 +230,12 @@ class FqCoDelQueueDisc : public QueueDisc
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+
+    FqFlowTable m_flowTable; //!< The flow queues of the compact mode
+
+    CoDelQueueDisc::Params m_codelParams;                //!< CoDel parameters of the flows
+    std::vector<CoDelQueueDisc::FlowState> m_codelFlows; //!< CoDel state of each flow
+    std::string m_compactReason; //!< Reason why a packet of a flow is dropped or marked
 };
 
 } // namespace ns3
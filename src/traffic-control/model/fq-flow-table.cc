@@ -0,0 +1,214 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fq-flow-table.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FqFlowTable");
+
+FqFlowTable::FqFlowTable()
+    : m_listHead{NONE, NONE},
+      m_listTail{NONE, NONE},
+      m_freeItem(NONE)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FqFlowTable::Reset(uint32_t buckets)
+{
+    NS_LOG_FUNCTION(this << buckets);
+    m_flowOfBucket.assign(buckets, NONE);
+    m_tags.clear();
+    m_tagged.clear();
+    m_bucket.clear();
+    m_deficit.clear();
+    m_status.clear();
+    m_next.clear();
+    m_head.clear();
+    m_tail.clear();
+    m_nPackets.clear();
+    m_nBytes.clear();
+    m_listHead[NEW_FLOWS] = m_listHead[OLD_FLOWS] = NONE;
+    m_listTail[NEW_FLOWS] = m_listTail[OLD_FLOWS] = NONE;
+    m_items.clear();
+    m_nextItem.clear();
+    m_freeItem = NONE;
+}
+
+uint32_t
+FqFlowTable::AddFlow(uint32_t bucket)
+{
+    NS_LOG_FUNCTION(this << bucket);
+    NS_ASSERT(m_flowOfBucket[bucket] == NONE);
+    uint32_t flow = m_bucket.size();
+    m_flowOfBucket[bucket] = flow;
+    m_bucket.push_back(bucket);
+    m_deficit.push_back(0);
+    m_status.push_back(INACTIVE);
+    m_next.push_back(NONE);
+    m_head.push_back(NONE);
+    m_tail.push_back(NONE);
+    m_nPackets.push_back(0);
+    m_nBytes.push_back(0);
+    return flow;
+}
+
+uint32_t
+FqFlowTable::SetAssociativeHash(uint32_t flowHash, uint32_t ways)
+{
+    NS_LOG_FUNCTION(this << flowHash << ways);
+
+    if (m_tags.empty())
+    {
+        m_tags.assign(m_flowOfBucket.size(), 0);
+        m_tagged.assign(m_flowOfBucket.size(), false);
+    }
+
+    uint32_t h = (flowHash % m_flowOfBucket.size());
+    uint32_t innerHash = h % ways;
+    uint32_t outerHash = h - innerHash;
+
+    for (uint32_t i = outerHash; i < outerHash + ways; i++)
+    {
+        uint32_t flow = m_flowOfBucket[i];
+
+        if (flow == NONE || (m_tagged[i] && m_tags[i] == flowHash) ||
+            m_status[flow] == INACTIVE)
+        {
+            // this bucket has no flow yet or is associated with this flow
+            // or its flow is inactive, hence we can use it
+            m_tags[i] = flowHash;
+            m_tagged[i] = true;
+            return i;
+        }
+    }
+
+    // all the buckets of the set are used. Use the first bucket of the set
+    m_tags[outerHash] = flowHash;
+    m_tagged[outerHash] = true;
+    return outerHash;
+}
+
+void
+FqFlowTable::PushBack(FlowList list, uint32_t flow)
+{
+    NS_LOG_FUNCTION(this << +list << flow);
+    m_next[flow] = NONE;
+    if (m_listHead[list] == NONE)
+    {
+        m_listHead[list] = flow;
+    }
+    else
+    {
+        m_next[m_listTail[list]] = flow;
+    }
+    m_listTail[list] = flow;
+}
+
+void
+FqFlowTable::PopFront(FlowList list)
+{
+    NS_LOG_FUNCTION(this << +list);
+    NS_ASSERT(m_listHead[list] != NONE);
+    uint32_t flow = m_listHead[list];
+    m_listHead[list] = m_next[flow];
+    if (m_listHead[list] == NONE)
+    {
+        m_listTail[list] = NONE;
+    }
+    m_next[flow] = NONE;
+}
+
+void
+FqFlowTable::Enqueue(uint32_t flow, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << flow << item);
+
+    uint32_t i = m_freeItem;
+    if (i == NONE)
+    {
+        i = m_items.size();
+        m_items.push_back(item);
+        m_nextItem.push_back(NONE);
+    }
+    else
+    {
+        m_freeItem = m_nextItem[i];
+        m_items[i] = item;
+        m_nextItem[i] = NONE;
+    }
+
+    if (m_head[flow] == NONE)
+    {
+        m_head[flow] = i;
+    }
+    else
+    {
+        m_nextItem[m_tail[flow]] = i;
+    }
+    m_tail[flow] = i;
+    m_nPackets[flow]++;
+    m_nBytes[flow] += item->GetSize();
+}
+
+Ptr<QueueDiscItem>
+FqFlowTable::Dequeue(uint32_t flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    uint32_t i = m_head[flow];
+    if (i == NONE)
+    {
+        return nullptr;
+    }
+
+    Ptr<QueueDiscItem> item = std::move(m_items[i]);
+    m_head[flow] = m_nextItem[i];
+    if (m_head[flow] == NONE)
+    {
+        m_tail[flow] = NONE;
+    }
+    m_nextItem[i] = m_freeItem;
+    m_freeItem = i;
+    m_nPackets[flow]--;
+    m_nBytes[flow] -= item->GetSize();
+    return item;
+}
+
+uint32_t
+FqFlowTable::GetFattestFlow() const
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t maxBacklog = 0;
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < m_nBytes.size(); i++)
+    {
+        if (m_nBytes[i] > maxBacklog)
+        {
+            maxBacklog = m_nBytes[i];
+            index = i;
+        }
+    }
+    return index;
+}
+
+} // namespace ns3
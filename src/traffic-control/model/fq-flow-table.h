@@ -0,0 +1,260 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_FLOW_TABLE_H
+#define FQ_FLOW_TABLE_H
+
+#include "ns3/queue-item.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The flow queues of a flow queueing queue disc, stored in flat arrays.
+ *
+ * FqCoDelQueueDisc and FqCobaltQueueDisc create, for each flow bucket in
+ * use, a QueueDiscClass, a child queue disc and its internal queue.  In
+ * their compact mode, they use a FqFlowTable instead: a flow is an index
+ * into arrays holding its deficit, status, link in the list of new or old
+ * flows and the head and tail of its packets, and the packets of all the
+ * flows are chained in a single pool, so that a bucket costs a few bytes
+ * and enqueuing or dequeuing a packet allocates nothing once the pool has
+ * grown to the size of the queue disc.  The state of the AQM algorithm of
+ * each flow is kept by the queue disc, in arrays indexed by flow as well.
+ *
+ * Flows are numbered in the order they are added, which is the order in
+ * which the child queue discs are created in the other mode.
+ */
+class FqFlowTable
+{
+  public:
+    /// Index meaning no flow or no packet.
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    /// The status of a flow.
+    enum FlowStatus : uint8_t
+    {
+        INACTIVE,
+        NEW_FLOW,
+        OLD_FLOW
+    };
+
+    /// The lists of flows served in a round robin fashion.
+    enum FlowList : uint8_t
+    {
+        NEW_FLOWS = 0,
+        OLD_FLOWS = 1
+    };
+
+    FqFlowTable();
+
+    /**
+     * Remove all the flows and packets, and set the number of buckets.
+     *
+     * \param buckets the number of buckets
+     */
+    void Reset(uint32_t buckets);
+
+    /**
+     * \param bucket the bucket
+     * \return the flow of the given bucket, or NONE if it has none yet
+     */
+    uint32_t GetFlow(uint32_t bucket) const
+    {
+        return m_flowOfBucket[bucket];
+    }
+
+    /**
+     * Add an inactive flow for the given bucket, which must have none.
+     *
+     * \param bucket the bucket
+     * \return the new flow
+     */
+    uint32_t AddFlow(uint32_t bucket);
+
+    /** \return the number of flows */
+    uint32_t GetNFlows() const
+    {
+        return m_bucket.size();
+    }
+
+    /**
+     * \param flow the flow
+     * \return the bucket of the given flow
+     */
+    uint32_t GetBucket(uint32_t flow) const
+    {
+        return m_bucket[flow];
+    }
+
+    /**
+     * Compute the bucket for the flow having the given hash, according to the
+     * set associative hash approach.
+     *
+     * \param flowHash the hash of the flow 5-tuple
+     * \param ways the size of a set of buckets
+     * \return the bucket for the given flow
+     */
+    uint32_t SetAssociativeHash(uint32_t flowHash, uint32_t ways);
+
+    /**
+     * \param flow the flow
+     * \return the status of the flow
+     */
+    FlowStatus GetStatus(uint32_t flow) const
+    {
+        return m_status[flow];
+    }
+
+    /**
+     * \param flow the flow
+     * \param status the status of the flow
+     */
+    void SetStatus(uint32_t flow, FlowStatus status)
+    {
+        m_status[flow] = status;
+    }
+
+    /**
+     * \param flow the flow
+     * \return the deficit of the flow
+     */
+    int32_t GetDeficit(uint32_t flow) const
+    {
+        return m_deficit[flow];
+    }
+
+    /**
+     * \param flow the flow
+     * \param deficit the deficit of the flow
+     */
+    void SetDeficit(uint32_t flow, int32_t deficit)
+    {
+        m_deficit[flow] = deficit;
+    }
+
+    /**
+     * \param flow the flow
+     * \param deficit the amount by which the deficit is increased
+     */
+    void IncreaseDeficit(uint32_t flow, int32_t deficit)
+    {
+        m_deficit[flow] += deficit;
+    }
+
+    /**
+     * \param list the list
+     * \return true if the list has no flow
+     */
+    bool IsEmpty(FlowList list) const
+    {
+        return m_listHead[list] == NONE;
+    }
+
+    /**
+     * \param list the list, which must not be empty
+     * \return the flow at the front of the list
+     */
+    uint32_t Front(FlowList list) const
+    {
+        return m_listHead[list];
+    }
+
+    /**
+     * Append a flow, which must be in no list, to a list.
+     *
+     * \param list the list
+     * \param flow the flow
+     */
+    void PushBack(FlowList list, uint32_t flow);
+
+    /**
+     * Remove the flow at the front of a list, which must not be empty.
+     *
+     * \param list the list
+     */
+    void PopFront(FlowList list);
+
+    /**
+     * Append a packet to the queue of a flow.
+     *
+     * \param flow the flow
+     * \param item the packet
+     */
+    void Enqueue(uint32_t flow, Ptr<QueueDiscItem> item);
+
+    /**
+     * Remove the packet at the head of the queue of a flow.
+     *
+     * \param flow the flow
+     * \return the packet, or nullptr if the queue is empty
+     */
+    Ptr<QueueDiscItem> Dequeue(uint32_t flow);
+
+    /**
+     * \param flow the flow
+     * \return the number of packets in the queue of the flow
+     */
+    uint32_t GetNPackets(uint32_t flow) const
+    {
+        return m_nPackets[flow];
+    }
+
+    /**
+     * \param flow the flow
+     * \return the number of bytes in the queue of the flow
+     */
+    uint32_t GetNBytes(uint32_t flow) const
+    {
+        return m_nBytes[flow];
+    }
+
+    /**
+     * \return the first flow having the largest number of bytes queued, or 0
+     * if no flow has any
+     */
+    uint32_t GetFattestFlow() const;
+
+  private:
+    std::vector<uint32_t> m_flowOfBucket; //!< The flow of each bucket, or NONE
+    std::vector<uint32_t> m_tags;         //!< The hash of the flow of each bucket
+    std::vector<bool> m_tagged;           //!< Whether each bucket has a tag
+
+    std::vector<uint32_t> m_bucket;   //!< The bucket of each flow
+    std::vector<int32_t> m_deficit;   //!< The deficit of each flow
+    std::vector<FlowStatus> m_status; //!< The status of each flow
+    std::vector<uint32_t> m_next;     //!< The next flow in the list of each flow
+    std::vector<uint32_t> m_head;     //!< The first packet of each flow
+    std::vector<uint32_t> m_tail;     //!< The last packet of each flow
+    std::vector<uint32_t> m_nPackets; //!< The number of packets of each flow
+    std::vector<uint32_t> m_nBytes;   //!< The number of bytes of each flow
+
+    uint32_t m_listHead[2]; //!< The first flow of each list
+    uint32_t m_listTail[2]; //!< The last flow of each list
+
+    std::vector<Ptr<QueueDiscItem>> m_items; //!< The pool of packets
+    std::vector<uint32_t> m_nextItem;        //!< The next packet of each packet of the pool
+    uint32_t m_freeItem;                     //!< The first free entry of the pool
+};
+
+} // namespace ns3
+
+#endif /* FQ_FLOW_TABLE_H */
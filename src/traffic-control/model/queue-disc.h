@@ -572,6 +572,24 @@ class QueueDisc : public Object
      */
     bool Mark(Ptr<QueueDiscItem> item, const char* reason);
 
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet enqueue
+     * \param item item that was enqueued
+     * This method is called by the internal queues; subclasses which store
+     * packets themselves must call it for each packet they store
+     */
+    void PacketEnqueued(Ptr<const QueueDiscItem> item);
+
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet dequeue
+     * \param item item that was dequeued
+     * This method is called by the internal queues; subclasses which store
+     * packets themselves must call it for each packet they remove
+     */
+    void PacketDequeued(Ptr<const QueueDiscItem> item);
+
   private:
     /**
      * This function actually enqueues a packet into the queue disc.
@@ -670,20 +688,6 @@ class QueueDisc : public Object
      */
     bool Transmit(Ptr<QueueDiscItem> item);
 
-    /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet enqueue
-     * \param item item that was enqueued
-     */
-    void PacketEnqueued(Ptr<const QueueDiscItem> item);
-
-    /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet dequeue
-     * \param item item that was dequeued
-     */
-    void PacketDequeued(Ptr<const QueueDiscItem> item);
-
     /// Default quota (as in /proc/sys/net/core/dev_weight)
     static const uint32_t DEFAULT_QUOTA = 64;
 
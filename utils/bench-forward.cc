@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the IPv4 forwarding path: a source sends UDP
+// packets back-to-back through a chain of routers connected by
+// point-to-point links to a sink, and the wall clock time per forwarded
+// packet is reported.
+// Sample usage:  ./ns3 run 'bench-forward --n=1000000 --hops=8'
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+/// The number of packets received by the sink.
+static uint64_t g_received = 0;
+
+/**
+ * Receive all the packets available on the socket of the sink.
+ *
+ * \param socket the socket
+ */
+static void
+Receive(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+        g_received++;
+    }
+}
+
+/**
+ * Send a packet, and schedule the next one until n packets are sent.
+ *
+ * \param socket the socket of the source
+ * \param size the size of the packets
+ * \param n the number of packets left to send
+ * \param interval the time between two packets
+ */
+static void
+Send(Ptr<Socket> socket, uint32_t size, uint64_t n, Time interval)
+{
+    socket->Send(Create<Packet>(size));
+    if (n > 1)
+    {
+        Simulator::Schedule(interval, &Send, socket, size, n - 1, interval);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t n = 1000000;
+    uint32_t hops = 8;
+    uint32_t size = 1000;
+    std::string rate = "10Gbps";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the IPv4 forwarding throughput over a chain of point-to-point links");
+    cmd.AddValue("n", "number of packets sent", n);
+    cmd.AddValue("hops", "number of routers between the source and the sink", hops);
+    cmd.AddValue("size", "UDP payload size of the packets", size);
+    cmd.AddValue("rate", "data rate of the links", rate);
+    cmd.Parse(argc, argv);
+
+    NodeContainer nodes;
+    nodes.Create(hops + 2);
+
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue(rate));
+    p2p.SetChannelAttribute("Delay", StringValue("1us"));
+    Ipv4AddressHelper addr;
+    addr.SetBase("10.0.0.0", "255.255.255.252");
+    Ipv4InterfaceContainer last;
+    for (uint32_t i = 0; i + 1 < nodes.GetN(); i++)
+    {
+        last = addr.Assign(p2p.Install(nodes.Get(i), nodes.Get(i + 1)));
+        addr.NewNetwork();
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    Ptr<Socket> sink = Socket::CreateSocket(nodes.Get(hops + 1), UdpSocketFactory::GetTypeId());
+    sink->Bind(InetSocketAddress(Ipv4Address::GetAny(), 9));
+    sink->SetRecvCallback(MakeCallback(&Receive));
+
+    Ptr<Socket> source = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+    source->Connect(InetSocketAddress(last.GetAddress(1), 9));
+
+    // send at the rate of the links, so that no queue builds up
+    Time interval = DataRate(rate).CalculateBytesTxTime(size + 8 + 20 + 2);
+    Simulator::ScheduleWithContext(0, Seconds(1), &Send, source, size, n, interval);
+
+    SystemWallClockMs timer;
+    timer.Start();
+    Simulator::Run();
+    int64_t ms = timer.End();
+    Simulator::Destroy();
+
+    uint64_t forwarded = g_received * hops;
+    std::cout << std::setw(6) << "hops" << std::setw(12) << "received" << std::setw(10) << "ms"
+              << std::setw(14) << "ns/forward" << std::endl;
+    std::cout << std::setw(6) << hops << std::setw(12) << g_received << std::setw(10) << ms
+              << std::setw(14) << std::fixed << std::setprecision(2)
+              << (forwarded ? (ms * 1e6) / forwarded : 0) << std::endl;
+
+    if (g_received != n)
+    {
+        std::cerr << "unexpected number of packets received: " << g_received << std::endl;
+        return 1;
+    }
+    return 0;
+}
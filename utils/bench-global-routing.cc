@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#ifdef NS3_MTP
+#include "ns3/mtp-module.h"
+#endif
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Build a k-ary fat-tree of point-to-point links with global routing.
+ *
+ * \param k the number of pods, must be even
+ * \returns the number of nodes created
+ */
+static uint32_t
+BuildFatTree(uint32_t k)
+{
+    uint32_t half = k / 2;
+    NodeContainer core;
+    NodeContainer agg;
+    NodeContainer edge;
+    NodeContainer host;
+    core.Create(half * half);
+    agg.Create(k * half);
+    edge.Create(k * half);
+    host.Create(k * half * half);
+
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(Ipv4GlobalRoutingHelper());
+    internet.SetIpv6StackInstall(false);
+    internet.InstallAll();
+
+    PointToPointHelper p2p;
+    Ipv4AddressHelper addr;
+    addr.SetBase("10.0.0.0", "255.255.255.252");
+    auto connect = [&p2p, &addr](Ptr<Node> a, Ptr<Node> b) {
+        addr.Assign(p2p.Install(a, b));
+        addr.NewNetwork();
+    };
+
+    for (uint32_t pod = 0; pod < k; pod++)
+    {
+        for (uint32_t i = 0; i < half; i++)
+        {
+            Ptr<Node> e = edge.Get(pod * half + i);
+            for (uint32_t j = 0; j < half; j++)
+            {
+                connect(host.Get((pod * half + i) * half + j), e);
+                connect(agg.Get(pod * half + j), e);
+            }
+        }
+        for (uint32_t i = 0; i < half; i++)
+        {
+            for (uint32_t j = 0; j < half; j++)
+            {
+                connect(core.Get(i * half + j), agg.Get(pod * half + i));
+            }
+        }
+    }
+    return NodeList::GetNNodes();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t minK = 4;
+    uint32_t maxK = 16;
+    uint32_t threads = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark global routing table population on growing fat-trees");
+    cmd.AddValue("min-k", "smallest fat-tree size (number of pods)", minK);
+    cmd.AddValue("max-k", "largest fat-tree size (number of pods)", maxK);
+    cmd.AddValue("threads", "number of threads for the SPF calculations (MTP builds)", threads);
+    cmd.Parse(argc, argv);
+
+#ifdef NS3_MTP
+    MtpInterface::Enable(threads);
+#endif
+
+    std::cout << std::setw(6) << "k" << std::setw(10) << "nodes" << std::setw(12) << "build ms"
+              << std::setw(12) << "route ms" << std::endl;
+    for (uint32_t k = std::max(minK, 2U) & ~1U; k <= maxK; k += 2)
+    {
+        SystemWallClockMs timer;
+        timer.Start();
+        uint32_t nodes = BuildFatTree(k);
+        int64_t buildMs = timer.End();
+
+        timer.Start();
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+        int64_t routeMs = timer.End();
+
+        std::cout << std::setw(6) << k << std::setw(10) << nodes << std::setw(12) << buildMs
+                  << std::setw(12) << routeMs << std::endl;
+        Simulator::Destroy();
+    }
+
+    return 0;
+}
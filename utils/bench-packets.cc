@@ -147,6 +147,9 @@ BenchHeader<N>::Deserialize(Buffer::Iterator start)
     return N;
 }
 
+/// Whether the headers are added lazily
+static bool g_lazyHeaders = false;
+
 /// BenchTag class used for benchmarking packet serialization/deserialization
 template <int N>
 class BenchTag : public Tag
@@ -255,7 +258,8 @@ benchA(uint32_t n)
         o->RemoveHeader(ipv4);
         o->RemoveHeader(udp);
     }
-    NS_ASSERT_MSG(ipv4.IsOk() == true, "IsOk() should be true after deserialization");
+    // lazy headers are copied rather than deserialized
+    NS_ASSERT_MSG(ipv4.IsOk() == !g_lazyHeaders, "IsOk() should be true after deserialization");
 }
 
 static void
@@ -303,6 +307,36 @@ benchC(uint32_t n)
     }
 }
 
+static void
+benchForward(uint32_t n)
+{
+    BenchHeader<20> tcp;
+    BenchHeader<20> ipv4;
+    BenchHeader<2> ppp;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddHeader(tcp);
+        p->AddHeader(ipv4);
+        p->AddHeader(ppp);
+        // each router of a 5-hop path strips the link and network headers
+        // of its copy of the packet, then adds them back
+        for (uint32_t hop = 0; hop < 5; hop++)
+        {
+            Ptr<Packet> q = p->Copy();
+            q->RemoveHeader(ppp);
+            q->RemoveHeader(ipv4);
+            q->AddHeader(ipv4);
+            q->AddHeader(ppp);
+            p = q;
+        }
+        p->RemoveHeader(ppp);
+        p->RemoveHeader(ipv4);
+        p->RemoveHeader(tcp);
+    }
+}
+
 static void
 benchFragment(uint32_t n)
 {
@@ -390,6 +424,7 @@ main(int argc, char* argv[])
                  "number of subiterations to minimize iteration time over",
                  minIterations);
     cmd.AddValue("enable-printing", "enable packet printing", enablePrinting);
+    cmd.AddValue("lazy-headers", "keep the headers as objects until needed", g_lazyHeaders);
     cmd.Parse(argc, argv);
 
     if (n == 0)
@@ -398,6 +433,10 @@ main(int argc, char* argv[])
                   << "by command-line argument --n=(number of packets)" << std::endl;
         exit(1);
     }
+    if (g_lazyHeaders)
+    {
+        Packet::EnableLazyHeaders();
+    }
     std::cout << "Running bench-packets with n=" << n << std::endl;
     std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
 
@@ -405,6 +444,7 @@ main(int argc, char* argv[])
     runBench(&benchB, n, minIterations, "Just add headers");
     runBench(&benchC, n, minIterations, "Remove by func call");
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
+    runBench(&benchForward, n, minIterations, "Forward through 5 hops");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
 
@@ -0,0 +1,150 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the enqueue/dequeue throughput of DropTailQueue,
+// whose items are stored in a RingBuffer, against the same queue storing
+// its items in a std::list, as done by all the queues previously.
+// Sample usage:  ./ns3 run 'bench-queue --n=10000000 --depth=100'
+
+#include "ns3/command-line.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <string>
+
+using namespace ns3;
+
+/// The queue of packets stored in a std::list.
+using ListQueue = Queue<Packet, std::list<Ptr<Packet>>>;
+
+namespace ns3
+{
+
+/**
+ * \return the name of the queue of packets stored in a std::list
+ */
+template <>
+std::string
+DoGetTemplateClassName<ListQueue>()
+{
+    return "ns3::Queue<Packet,std::list>";
+}
+
+} // namespace ns3
+
+/// A drop tail queue of packets stored in a std::list
+class ListDropTailQueue : public ListQueue
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ListDropTailQueue")
+                                .SetParent<ListQueue>()
+                                .AddConstructor<ListDropTailQueue>();
+        return tid;
+    }
+
+    bool Enqueue(Ptr<Packet> item) override
+    {
+        return DoEnqueue(GetContainer().end(), item);
+    }
+
+    Ptr<Packet> Dequeue() override
+    {
+        return DoDequeue(GetContainer().begin());
+    }
+
+    Ptr<Packet> Remove() override
+    {
+        return DoRemove(GetContainer().begin());
+    }
+
+    Ptr<const Packet> Peek() const override
+    {
+        return DoPeek(GetContainer().begin());
+    }
+};
+
+/**
+ * Time n enqueue/dequeue pairs on a queue holding depth packets, and print
+ * the time per pair.
+ *
+ * \param name the name of the benchmark
+ * \param queue the queue
+ * \param n the number of enqueue/dequeue pairs
+ * \param depth the number of packets in the queue
+ * \return the number of packets dequeued
+ */
+template <typename Q>
+static uint64_t
+Run(const std::string& name, Ptr<Q> queue, uint64_t n, uint32_t depth)
+{
+    queue->SetMaxSize(QueueSize(QueueSizeUnit::PACKETS, depth + 1));
+    Ptr<Packet> packet = Create<Packet>(1000);
+    for (uint32_t i = 0; i < depth; i++)
+    {
+        queue->Enqueue(packet->Copy());
+    }
+
+    uint64_t dequeued = 0;
+    SystemWallClockMs timer;
+    timer.Start();
+    for (uint64_t i = 0; i < n; i++)
+    {
+        queue->Enqueue(packet);
+        dequeued += (queue->Dequeue() != nullptr);
+    }
+    int64_t ms = timer.End();
+    std::cout << std::left << std::setw(32) << name << std::right << std::setw(10) << ms
+              << std::setw(12) << std::fixed << std::setprecision(2) << (ms * 1e6) / n
+              << std::endl;
+
+    queue->Flush();
+    return dequeued;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t n = 10000000;
+    uint32_t depth = 100;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the enqueue/dequeue throughput of the packet queues");
+    cmd.AddValue("n", "number of enqueue/dequeue pairs of each kind", n);
+    cmd.AddValue("depth", "number of packets in the queues", depth);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::left << std::setw(32) << "queue" << std::right << std::setw(10) << "ms"
+              << std::setw(12) << "ns/pair" << std::endl;
+    uint64_t dequeued = 0;
+    dequeued += Run("DropTailQueue (RingBuffer)", CreateObject<DropTailQueue<Packet>>(), n, depth);
+    dequeued += Run("DropTailQueue (std::list)", CreateObject<ListDropTailQueue>(), n, depth);
+
+    if (dequeued != 2 * n)
+    {
+        std::cerr << "unexpected number of packets dequeued: " << dequeued << std::endl;
+        return 1;
+    }
+    return 0;
+}
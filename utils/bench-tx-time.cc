@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the per-packet timing math of a device: the
+// transmission time of a packet at the device rate, plus the interframe
+// gap, calculated by DataRate::CalculateBytesTxTime against the times
+// precomputed by TxTimeCalculator, and checks that both agree.
+// Sample usage:  ./ns3 run 'bench-tx-time --n=10000000 --rate=10Gbps'
+
+#include "ns3/command-line.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Time the transmission times of n packets, and print the time per packet.
+ *
+ * \param name the name of the benchmark
+ * \param txTime the function calculating the transmission time of a packet
+ * \param sizes the sizes of the packets, used in turn
+ * \param n the number of packets
+ * \return the sum of the transmission times, in time steps
+ */
+template <typename F>
+static int64_t
+Run(const std::string& name, F txTime, const std::vector<uint32_t>& sizes, uint64_t n)
+{
+    const Time gap = NanoSeconds(12);
+    int64_t total = 0;
+    SystemWallClockMs timer;
+    timer.Start();
+    for (uint64_t i = 0; i < n; i++)
+    {
+        Time txCompleteTime = txTime(sizes[i % sizes.size()]) + gap;
+        total += txCompleteTime.GetTimeStep();
+    }
+    int64_t ms = timer.End();
+    std::cout << std::left << std::setw(32) << name << std::right << std::setw(10) << ms
+              << std::setw(12) << std::fixed << std::setprecision(2) << (ms * 1e6) / n
+              << std::endl;
+    return total;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t n = 10000000;
+    DataRate rate("10Gbps");
+    std::string resolution = "ps";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the calculation of the transmission times of packets");
+    cmd.AddValue("n", "number of packets of each kind", n);
+    cmd.AddValue("rate", "data rate of the device", rate);
+    cmd.AddValue("resolution", "time resolution: ns, ps or fs", resolution);
+    cmd.Parse(argc, argv);
+
+    Time::SetResolution(resolution == "fs" ? Time::FS : resolution == "ns" ? Time::NS : Time::PS);
+
+    // a mix of the sizes of acknowledgments and data segments
+    std::vector<uint32_t> sizes;
+    for (uint32_t size = 40; size <= 1500; size += 1460 / 16)
+    {
+        sizes.push_back(size);
+    }
+    sizes.push_back(1500);
+    sizes.push_back(9000);
+
+    TxTimeCalculator calculator(rate);
+    std::cout << std::left << std::setw(32) << "calculation" << std::right << std::setw(10)
+              << "ms" << std::setw(12) << "ns/packet" << std::endl;
+    int64_t reference = Run(
+        "DataRate::CalculateBytesTxTime",
+        [&rate](uint32_t size) { return rate.CalculateBytesTxTime(size); },
+        sizes,
+        n);
+    int64_t precomputed = Run(
+        "TxTimeCalculator",
+        [&calculator](uint32_t size) { return calculator.CalculateBytesTxTime(size); },
+        sizes,
+        n);
+
+    if (reference != precomputed)
+    {
+        std::cerr << "transmission times differ: " << reference << " != " << precomputed
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program samples the flows of a traffic pattern into a flow schedule
+// file, to be started by FlowScheduleApplications without sampling them
+// again at each run.
+// Sample usage:
+//   ./ns3 run 'flow-schedule-generator --hosts=128 --rate=10Gbps --load=0.5
+//       --cdf=src/mtp/examples/web-search.txt --output=flows.bin'
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t hosts = 16;
+    DataRate rate("10Gbps");
+    double load = 0.3;
+    Time start = Seconds(1);
+    Time duration = Seconds(1);
+    std::string pattern = "poisson";
+    uint32_t fanIn = 8;
+    std::string cdf = std::string(PROJECT_SOURCE_PATH) + "/src/mtp/examples/web-search.txt";
+    std::string output = "flows.bin";
+    bool text = false;
+    int64_t stream = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("hosts", "The number of hosts", hosts);
+    cmd.AddValue("rate", "The rate of the link of each host", rate);
+    cmd.AddValue("load", "The load, as a fraction of the aggregate host rate", load);
+    cmd.AddValue("start", "The start of the first flow", start);
+    cmd.AddValue("duration", "The time during which flows start", duration);
+    cmd.AddValue("pattern", "The traffic pattern: poisson, incast or all-to-all", pattern);
+    cmd.AddValue("fanIn", "The number of sources of each incast", fanIn);
+    cmd.AddValue("cdf", "The file of the CDF of the flow sizes", cdf);
+    cmd.AddValue("output", "The flow schedule file to write", output);
+    cmd.AddValue("text", "Write the text format rather than the binary one", text);
+    cmd.AddValue("stream", "The first random variable stream to use", stream);
+    cmd.Parse(argc, argv);
+
+    FlowScheduleGenerator generator(hosts, rate);
+    generator.LoadSizeCdf(cdf);
+    generator.AssignStreams(stream);
+
+    auto schedule = Create<FlowSchedule>();
+    if (pattern == "poisson")
+    {
+        generator.Poisson(schedule, load, start, start + duration);
+    }
+    else if (pattern == "incast")
+    {
+        generator.Incast(schedule, load, start, start + duration, fanIn);
+    }
+    else if (pattern == "all-to-all")
+    {
+        generator.AllToAll(schedule, load, start, start + duration);
+    }
+    else
+    {
+        NS_FATAL_ERROR("Unknown traffic pattern " << pattern);
+    }
+    schedule->Save(output, !text);
+
+    std::cout << schedule->GetNFlows() << " flows of " << schedule->GetTotalSize()
+              << " bytes (mean flow size " << generator.GetMeanSize() << ") written to " << output
+              << std::endl;
+    return 0;
+}